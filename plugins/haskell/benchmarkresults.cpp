@@ -0,0 +1,257 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "benchmarkresults.h"
+
+#include "haskelltr.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Haskell {
+namespace Internal {
+
+static QStringList splitCsvLine(const QString &line)
+{
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+    for (int i = 0; i < line.size(); ++i) {
+        const QChar c = line.at(i);
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line.at(i + 1) == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields << field;
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields << field;
+    return fields;
+}
+
+bool parseBenchmarkCsv(const QByteArray &csv,
+                       QVector<BenchmarkResult> *results,
+                       QString *errorString)
+{
+    const QStringList lines = QString::fromUtf8(csv).split('\n', Qt::SkipEmptyParts);
+    if (lines.isEmpty()) {
+        *errorString = Tr::tr("The benchmark results are empty.");
+        return false;
+    }
+    QStringList header = splitCsvLine(lines.first().trimmed());
+    for (QString &column : header)
+        column = column.trimmed();
+    const int name = header.indexOf("Name");
+    // criterion
+    const int mean = header.indexOf("Mean");
+    const int meanLower = header.indexOf("MeanLB");
+    const int meanUpper = header.indexOf("MeanUB");
+    // tasty-bench
+    const int meanPs = header.indexOf("Mean (ps)");
+    const int twoStddevPs = header.indexOf("2*Stdev (ps)");
+    const int allocated = header.indexOf("Allocated");
+    if (name < 0 || (mean < 0 && meanPs < 0)) {
+        *errorString = Tr::tr("Unknown benchmark result format: %1").arg(lines.first());
+        return false;
+    }
+
+    results->clear();
+    for (int i = 1; i < lines.size(); ++i) {
+        const QStringList fields = splitCsvLine(lines.at(i).trimmed());
+        const auto number = [&fields](int column, bool *ok) {
+            return column >= 0 && column < fields.size() ? fields.at(column).toDouble(ok) : 0;
+        };
+        BenchmarkResult result;
+        result.name = fields.value(name);
+        bool ok = false;
+        if (mean >= 0) {
+            result.mean = number(mean, &ok);
+            bool lowerOk = false;
+            bool upperOk = false;
+            const double lower = number(meanLower, &lowerOk);
+            const double upper = number(meanUpper, &upperOk);
+            if (lowerOk && upperOk)
+                result.uncertainty = (upper - lower) / 2;
+        } else {
+            result.mean = number(meanPs, &ok) / 1e12;
+            bool stddevOk = false;
+            const double twoStddev = number(twoStddevPs, &stddevOk);
+            // taken as it is, the number of measurements that would make it an interval of the
+            // mean is not in the output
+            if (stddevOk)
+                result.uncertainty = twoStddev / 1e12;
+        }
+        if (!ok) {
+            *errorString = Tr::tr("Invalid benchmark result in line %1: %2")
+                               .arg(i + 1)
+                               .arg(lines.at(i));
+            return false;
+        }
+        bool allocatedOk = false;
+        const double allocatedBytes = number(allocated, &allocatedOk);
+        if (allocatedOk)
+            result.allocated = qint64(allocatedBytes);
+        results->append(result);
+    }
+    return true;
+}
+
+const BenchmarkResult *BenchmarkRun::result(const QString &name) const
+{
+    for (const BenchmarkResult &result : results) {
+        if (result.name == name)
+            return &result;
+    }
+    return nullptr;
+}
+
+int BenchmarkHistory::addRun(const BenchmarkRun &run)
+{
+    if (!run.commit.isEmpty()) {
+        const auto sameCommit = [&run](const BenchmarkRun &r) { return r.commit == run.commit; };
+        m_runs.erase(std::remove_if(m_runs.begin(), m_runs.end(), sameCommit), m_runs.end());
+    }
+    m_runs.append(run);
+    if (m_runs.size() > m_maximumRuns)
+        m_runs.erase(m_runs.begin(), m_runs.begin() + (m_runs.size() - m_maximumRuns));
+    return m_runs.size() - 1;
+}
+
+int BenchmarkHistory::defaultBaseline(int run) const
+{
+    if (run < 0 || run >= m_runs.size())
+        return -1;
+    const QString commit = m_runs.at(run).commit;
+    for (int i = m_runs.size() - 1; i >= 0; --i) {
+        if (i != run && (commit.isEmpty() || m_runs.at(i).commit != commit))
+            return i;
+    }
+    return -1;
+}
+
+bool BenchmarkHistory::load(const QString &filePath, QString *errorString)
+{
+    m_runs.clear();
+    QFile file(filePath);
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        *errorString = error.errorString();
+        return false;
+    }
+    const QJsonArray runs = document.object().value("runs").toArray();
+    for (const QJsonValue &runValue : runs) {
+        const QJsonObject runObject = runValue.toObject();
+        BenchmarkRun run;
+        run.commit = runObject.value("commit").toString();
+        run.timestamp = QDateTime::fromString(runObject.value("timestamp").toString(),
+                                              Qt::ISODate);
+        const QJsonArray results = runObject.value("results").toArray();
+        for (const QJsonValue &resultValue : results) {
+            const QJsonObject resultObject = resultValue.toObject();
+            BenchmarkResult result;
+            result.name = resultObject.value("name").toString();
+            result.mean = resultObject.value("mean").toDouble();
+            result.uncertainty = resultObject.value("uncertainty").toDouble();
+            result.allocated = qint64(resultObject.value("allocated").toDouble(-1));
+            run.results.append(result);
+        }
+        m_runs.append(run);
+    }
+    return true;
+}
+
+bool BenchmarkHistory::save(const QString &filePath, QString *errorString) const
+{
+    QJsonArray runs;
+    for (const BenchmarkRun &run : m_runs) {
+        QJsonArray results;
+        for (const BenchmarkResult &result : run.results) {
+            QJsonObject resultObject{{"name", result.name},
+                                     {"mean", result.mean},
+                                     {"uncertainty", result.uncertainty}};
+            if (result.allocated >= 0)
+                resultObject.insert("allocated", double(result.allocated));
+            results.append(resultObject);
+        }
+        runs.append(QJsonObject{{"commit", run.commit},
+                                {"timestamp", run.timestamp.toString(Qt::ISODate)},
+                                {"results", results}});
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(QJsonObject{{"runs", runs}}).toJson());
+    if (!file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+BenchmarkComparison BenchmarkComparison::compare(const BenchmarkResult &result,
+                                                 const BenchmarkResult *baseline,
+                                                 double threshold)
+{
+    BenchmarkComparison comparison;
+    if (!baseline || baseline->mean <= 0)
+        return comparison;
+    const double difference = result.mean - baseline->mean;
+    comparison.change = difference / baseline->mean;
+    const double uncertainty = std::hypot(result.uncertainty, baseline->uncertainty);
+    if (std::abs(difference) <= uncertainty || std::abs(comparison.change) <= threshold)
+        comparison.status = Unchanged;
+    else
+        comparison.status = difference > 0 ? Regression : Improvement;
+    return comparison;
+}
+
+} // namespace Internal
+} // namespace Haskell
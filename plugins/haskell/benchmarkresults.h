@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#pragma once
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+class BenchmarkResult
+{
+public:
+    QString name;
+    double mean = 0; // seconds
+    // Seconds. Criterion reports the half width of the 95% confidence interval of the mean,
+    // tasty-bench two standard deviations of its measurements, which is a spread and no interval.
+    double uncertainty = 0;
+    qint64 allocated = -1; // bytes, -1 if unknown
+};
+
+// Parses the CSV output of criterion and tasty-bench, both written with --csv.
+// criterion: Name,Mean,MeanLB,MeanUB,Stddev,StddevLB,StddevUB in seconds.
+// tasty-bench: Name,Mean (ps),2*Stdev (ps)[,Allocated,Copied,Peak Memory].
+bool parseBenchmarkCsv(const QByteArray &csv,
+                       QVector<BenchmarkResult> *results,
+                       QString *errorString);
+
+class BenchmarkRun
+{
+public:
+    const BenchmarkResult *result(const QString &name) const;
+
+    QString commit; // empty outside of version control, "-dirty" with local changes
+    QDateTime timestamp;
+    QVector<BenchmarkResult> results;
+};
+
+// The results of previous runs of a benchmark, at most one per commit, oldest first.
+class BenchmarkHistory
+{
+public:
+    const QVector<BenchmarkRun> &runs() const { return m_runs; }
+    // Replaces the run for the same commit. Returns the index of the run.
+    int addRun(const BenchmarkRun &run);
+    // The most recent run of another commit than the run at the index, or the run before it.
+    // Returns -1 if there is none.
+    int defaultBaseline(int run) const;
+
+    void setMaximumRuns(int runs) { m_maximumRuns = runs; }
+
+    bool load(const QString &filePath, QString *errorString);
+    bool save(const QString &filePath, QString *errorString) const;
+
+private:
+    QVector<BenchmarkRun> m_runs;
+    int m_maximumRuns = 100;
+};
+
+class BenchmarkComparison
+{
+public:
+    enum Status { New, Unchanged, Improvement, Regression };
+
+    // A change counts if it is larger than the root sum square of both uncertainties, the
+    // uncertainty of the difference if they are independent, and larger than the threshold,
+    // relative to the baseline.
+    static BenchmarkComparison compare(const BenchmarkResult &result,
+                                       const BenchmarkResult *baseline,
+                                       double threshold = 0.05);
+
+    Status status = New;
+    double change = 0; // relative to the baseline
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "benchmarkview.h"
+
+#include <utils/utilsicons.h>
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLocale>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace Haskell {
+namespace Internal {
+
+enum Column { NameColumn, MeanColumn, UncertaintyColumn, BaselineColumn, ChangeColumn,
+              AllocatedColumn };
+
+static QString formatDuration(double seconds)
+{
+    const QLocale locale;
+    if (seconds < 1e-6)
+        return BenchmarkView::tr("%1 ns").arg(locale.toString(seconds * 1e9, 'f', 1));
+    if (seconds < 1e-3)
+        return BenchmarkView::tr("%1 µs").arg(locale.toString(seconds * 1e6, 'f', 1));
+    if (seconds < 1)
+        return BenchmarkView::tr("%1 ms").arg(locale.toString(seconds * 1e3, 'f', 2));
+    return BenchmarkView::tr("%1 s").arg(locale.toString(seconds, 'f', 3));
+}
+
+static QString runName(const BenchmarkRun &run)
+{
+    const QString time = QLocale().toString(run.timestamp, QLocale::ShortFormat);
+    return run.commit.isEmpty() ? time : BenchmarkView::tr("%1 (%2)").arg(run.commit, time);
+}
+
+BenchmarkView::BenchmarkView(const BenchmarkHistory &history, int run)
+    : m_history(history)
+    , m_run(run)
+    , m_baselineComboBox(new QComboBox)
+    , m_summaryLabel(new QLabel)
+    , m_resultTree(new QTreeWidget)
+{
+    m_baselineComboBox->addItem(tr("None"), -1);
+    for (int i = m_history.runs().size() - 1; i >= 0; --i) {
+        if (i != m_run)
+            m_baselineComboBox->addItem(runName(m_history.runs().at(i)), i);
+    }
+    m_baselineComboBox->setCurrentIndex(
+        m_baselineComboBox->findData(m_history.defaultBaseline(m_run)));
+
+    m_resultTree->setRootIsDecorated(false);
+    m_resultTree->setUniformRowHeights(true);
+    m_resultTree->setSortingEnabled(true);
+    m_resultTree->setHeaderLabels({tr("Benchmark"), tr("Mean"), tr("±"), tr("Baseline"),
+                                   tr("Change"), tr("Allocated")});
+    m_resultTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    auto toolBar = new QHBoxLayout;
+    toolBar->addWidget(new QLabel(tr("Compare with:")));
+    toolBar->addWidget(m_baselineComboBox);
+    toolBar->addWidget(m_summaryLabel, 1);
+
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(toolBar);
+    layout->addWidget(m_resultTree);
+
+    connect(m_baselineComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &BenchmarkView::updateResults);
+    updateResults();
+}
+
+void BenchmarkView::updateResults()
+{
+    m_resultTree->clear();
+    if (m_run < 0 || m_run >= m_history.runs().size())
+        return;
+    const int baselineIndex = m_baselineComboBox->currentData().toInt();
+    const BenchmarkRun *baseline = baselineIndex >= 0 ? &m_history.runs().at(baselineIndex)
+                                                      : nullptr;
+    const QLocale locale;
+    int regressions = 0;
+    int improvements = 0;
+    for (const BenchmarkResult &result : m_history.runs().at(m_run).results) {
+        const BenchmarkResult *baselineResult = baseline ? baseline->result(result.name)
+                                                         : nullptr;
+        const BenchmarkComparison comparison = BenchmarkComparison::compare(result,
+                                                                            baselineResult);
+        auto item = new QTreeWidgetItem(m_resultTree);
+        item->setText(NameColumn, result.name);
+        item->setText(MeanColumn, formatDuration(result.mean));
+        item->setText(UncertaintyColumn, formatDuration(result.uncertainty));
+        if (result.allocated >= 0)
+            item->setText(AllocatedColumn, locale.formattedDataSize(result.allocated));
+        for (int column = MeanColumn; column <= AllocatedColumn; ++column)
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        if (!baselineResult)
+            continue;
+        item->setText(BaselineColumn, formatDuration(baselineResult->mean));
+        item->setText(ChangeColumn,
+                      tr("%1%").arg(locale.toString(100 * comparison.change, 'f', 1)));
+        switch (comparison.status) {
+        case BenchmarkComparison::Regression:
+            ++regressions;
+            item->setIcon(NameColumn, Utils::Icons::WARNING.icon());
+            item->setForeground(ChangeColumn, QColor(200, 40, 40));
+            item->setToolTip(ChangeColumn, tr("Significantly slower than the baseline."));
+            break;
+        case BenchmarkComparison::Improvement:
+            ++improvements;
+            item->setForeground(ChangeColumn, QColor(40, 150, 40));
+            item->setToolTip(ChangeColumn, tr("Significantly faster than the baseline."));
+            break;
+        case BenchmarkComparison::Unchanged:
+            item->setToolTip(ChangeColumn, tr("Within the noise of the measurements."));
+            break;
+        case BenchmarkComparison::New:
+            break;
+        }
+    }
+    m_resultTree->sortByColumn(NameColumn, Qt::AscendingOrder);
+    m_summaryLabel->setText(baseline ? tr("%n regression(s), ", nullptr, regressions)
+                                           + tr("%n improvement(s)", nullptr, improvements)
+                                     : QString());
+}
+
+} // namespace Internal
+} // namespace Haskell
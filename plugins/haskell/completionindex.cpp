@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "completionindex.h"
+
+#include "haskelloutline.h"
+#include "haskelltokenizer.h"
+
+#include <QSet>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+// from the tokens of a line starting with "import"
+static ModuleImport parseImport(const QVector<Token> &code)
+{
+    ModuleImport import;
+    for (int i = 1; i < code.size(); ++i) {
+        const Token &token = code.at(i);
+        if (token.type == TokenType::Variable && token.text == QLatin1String("qualified")) {
+            import.qualified = true;
+        } else if (token.type == TokenType::Constructor && import.module.isEmpty()) {
+            import.module = token.text.toString();
+        } else if (token.type == TokenType::Variable && token.text == QLatin1String("as")
+                   && i + 1 < code.size() && code.at(i + 1).type == TokenType::Constructor) {
+            import.alias = code.at(++i).text.toString();
+        } else if (token.type == TokenType::Special) {
+            break; // the list of imported names
+        }
+    }
+    if (import.alias.isEmpty())
+        import.alias = import.module;
+    return import;
+}
+
+static void addIdentifiers(const QVector<Token> &code, QSet<QString> *identifiers)
+{
+    for (const Token &token : code) {
+        if (token.type != TokenType::Variable && token.type != TokenType::Constructor)
+            continue;
+        // the name of a qualified name
+        const QStringView name = token.text.mid(token.text.lastIndexOf('.') + 1);
+        if (name.size() > 1)
+            identifiers->insert(name.toString());
+    }
+}
+
+static QStringList sorted(const QSet<QString> &set)
+{
+    QStringList result(set.cbegin(), set.cend());
+    result.sort();
+    return result;
+}
+
+bool ModuleImport::operator==(const ModuleImport &other) const
+{
+    return module == other.module && alias == other.alias && qualified == other.qualified;
+}
+
+ModuleSymbols ModuleSymbols::fromSource(const QString &source)
+{
+    ModuleSymbols symbols;
+    const QStringList lines = source.split('\n');
+    HaskellOutline outline;
+    outline.update(0, 0, lines);
+    QSet<QString> topLevelNames;
+    for (const OutlineItem &item : outline.items()) {
+        switch (item.kind) {
+        case OutlineItem::Module:
+            symbols.moduleName = item.name;
+            break;
+        case OutlineItem::Type:
+        case OutlineItem::Class:
+        case OutlineItem::Function:
+            // operators are not completed
+            if (!item.name.startsWith('('))
+                topLevelNames.insert(item.name);
+            break;
+        case OutlineItem::Import:
+        case OutlineItem::Instance:
+            break;
+        }
+    }
+    symbols.topLevelNames = sorted(topLevelNames);
+
+    QSet<QString> identifiers;
+    int state = int(Tokens::State::None);
+    for (const QString &line : lines) {
+        const Tokens tokens = HaskellTokenizer::tokenize(line, state);
+        const QVector<Token> code = tokens.code();
+        if (state == int(Tokens::State::None) && !code.isEmpty() && code.first().startCol == 0
+            && code.first().isKeyword("import")) {
+            symbols.imports.append(parseImport(code));
+        }
+        addIdentifiers(code, &identifiers);
+        state = tokens.state;
+    }
+    symbols.identifiers = sorted(identifiers);
+    return symbols;
+}
+
+QStringList ModuleSymbols::identifiers(const QStringList &lines, int tokenizerState)
+{
+    QSet<QString> identifiers;
+    for (const QString &line : lines) {
+        const Tokens tokens = HaskellTokenizer::tokenize(line, tokenizerState);
+        addIdentifiers(tokens.code(), &identifiers);
+        tokenizerState = tokens.state;
+    }
+    return sorted(identifiers);
+}
+
+void CompletionIndex::setModule(const QString &filePath, const ModuleSymbols &symbols)
+{
+    removeModule(filePath);
+    m_modules.insert(filePath, symbols);
+    if (!symbols.moduleName.isEmpty())
+        m_filePaths.insert(symbols.moduleName, filePath);
+}
+
+void CompletionIndex::removeModule(const QString &filePath)
+{
+    const auto it = m_modules.find(filePath);
+    if (it == m_modules.end())
+        return;
+    if (m_filePaths.value(it->moduleName) == filePath)
+        m_filePaths.remove(it->moduleName);
+    m_modules.erase(it);
+}
+
+QVector<CompletionCandidate> CompletionIndex::candidates(const ModuleSymbols &file,
+                                                         const QString &qualifier,
+                                                         const QString &prefix) const
+{
+    static const QStringList keywords = HaskellTokenizer::keywords();
+
+    QVector<CompletionCandidate> result;
+    QSet<QString> added;
+    auto add = [&](CompletionCandidate::Kind kind, const QStringList &texts,
+                   const QString &module) {
+        for (const QString &text : texts) {
+            // what is typed already
+            if (text == prefix || added.contains(text))
+                continue;
+            added.insert(text);
+            CompletionCandidate candidate;
+            candidate.kind = kind;
+            candidate.text = text;
+            candidate.module = module;
+            result.append(candidate);
+        }
+    };
+
+    if (qualifier.isEmpty())
+        add(CompletionCandidate::Keyword, withPrefix(keywords, prefix), {});
+    for (const ModuleImport &import : file.imports) {
+        if (qualifier.isEmpty() ? import.qualified : import.alias != qualifier)
+            continue;
+        const auto module = m_modules.constFind(m_filePaths.value(import.module));
+        if (module != m_modules.cend())
+            add(CompletionCandidate::TopLevelName, withPrefix(module->topLevelNames, prefix),
+                import.module);
+    }
+    if (qualifier.isEmpty())
+        add(CompletionCandidate::Identifier, withPrefix(file.identifiers, prefix), {});
+    return result;
+}
+
+QSet<QString> CompletionIndex::importedNames(const ModuleSymbols &file) const
+{
+    QSet<QString> result;
+    for (const ModuleImport &import : file.imports) {
+        const auto module = m_modules.constFind(m_filePaths.value(import.module));
+        if (module == m_modules.cend())
+            continue;
+        for (const QString &name : module->topLevelNames) {
+            result.insert(import.alias + '.' + name);
+            if (!import.qualified)
+                result.insert(name);
+        }
+    }
+    return result;
+}
+
+QStringList CompletionIndex::withPrefix(const QStringList &sorted, const QString &prefix)
+{
+    QStringList result;
+    for (auto it = std::lower_bound(sorted.cbegin(), sorted.cend(), prefix);
+         it != sorted.cend() && it->startsWith(prefix); ++it) {
+        result.append(*it);
+    }
+    return result;
+}
+
+} // namespace Internal
+} // namespace Haskell
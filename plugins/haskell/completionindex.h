@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+class ModuleImport
+{
+public:
+    bool operator==(const ModuleImport &other) const;
+
+    QString module;
+    QString alias; // the module name without "as"
+    bool qualified = false;
+};
+
+// What a module offers to the completion, found from its tokens.
+class ModuleSymbols
+{
+public:
+    static ModuleSymbols fromSource(const QString &source);
+    // Returns the variables and constructors with at least two characters in the lines, sorted.
+    static QStringList identifiers(const QStringList &lines, int tokenizerState = -1);
+
+    QString moduleName;
+    QVector<ModuleImport> imports;
+    QStringList topLevelNames; // of functions, types and classes, sorted
+    QStringList identifiers; // sorted, without duplicates
+};
+
+class CompletionCandidate
+{
+public:
+    enum Kind { Keyword, Identifier, TopLevelName };
+
+    Kind kind = Identifier;
+    QString text;
+    QString module; // that declares a top-level name
+};
+
+// The symbols of the modules in the open projects by file. Copies share the symbols, so the
+// completion can work with a copy while the index is updated. Looking up a prefix takes a binary
+// search in the keywords, the file and each module imported by it, independent of the number of
+// modules in the index.
+class CompletionIndex
+{
+public:
+    void setModule(const QString &filePath, const ModuleSymbols &symbols);
+    void removeModule(const QString &filePath);
+    ModuleSymbols module(const QString &filePath) const { return m_modules.value(filePath); }
+    QStringList filePaths() const { return m_modules.keys(); }
+
+    // The candidates starting with the prefix in a file with the given symbols. A qualifier, like
+    // "Map" for "Map.ins", restricts them to the top-level names of the modules imported as that.
+    QVector<CompletionCandidate> candidates(const ModuleSymbols &file,
+                                            const QString &qualifier,
+                                            const QString &prefix) const;
+
+    // The top-level names of the modules imported by the file, qualified by the alias of each
+    // import, and also unqualified for imports that are not qualified.
+    QSet<QString> importedNames(const ModuleSymbols &file) const;
+
+    // Returns the strings starting with the prefix in the sorted list.
+    static QStringList withPrefix(const QStringList &sorted, const QString &prefix);
+
+private:
+    QHash<QString, ModuleSymbols> m_modules; // by file path
+    QHash<QString, QString> m_filePaths; // by module name
+};
+
+} // namespace Internal
+} // namespace Haskell
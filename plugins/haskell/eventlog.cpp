@@ -0,0 +1,536 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "eventlog.h"
+
+#include "haskelltr.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <limits>
+
+namespace Haskell {
+namespace Internal {
+
+// see rts/include/rts/EventLogFormat.h in GHC
+enum HeaderMarker : quint32 {
+    HeaderBegin = 0x68647262, // "hdrb"
+    HeaderEnd = 0x68647265, // "hdre"
+    EventTypesBegin = 0x68657462, // "hetb"
+    EventTypesEnd = 0x68657465, // "hete"
+    EventTypeBegin = 0x65746200, // "etb\0"
+    EventTypeEnd = 0x65746500, // "ete\0"
+    DataBegin = 0x64617462 // "datb"
+};
+
+enum EventType : quint16 {
+    CreateThread = 0,
+    RunThread = 1,
+    StopThread = 2,
+    MigrateThread = 4,
+    GcStart = 9,
+    GcEnd = 10,
+    BlockMarker = 18,
+    SparkCounters = 35,
+    SparkCreate = 36,
+    SparkDud = 37,
+    SparkOverflow = 38,
+    SparkRun = 39,
+    SparkSteal = 40,
+    SparkFizzle = 41,
+    SparkGc = 42,
+    CapCreate = 45,
+    DataEnd = 0xffff
+};
+
+static const int variableSize = 0xffff;
+// GC intervals that wait for the other capabilities, more are counted as separate episodes
+static const int maximumPendingGcIntervals = 1 << 16;
+
+quint16 EventlogEvent::uint16At(int offset) const
+{
+    return offset + 2 <= payloadSize ? qFromBigEndian<quint16>(payload + offset) : 0;
+}
+
+quint32 EventlogEvent::uint32At(int offset) const
+{
+    return offset + 4 <= payloadSize ? qFromBigEndian<quint32>(payload + offset) : 0;
+}
+
+quint64 EventlogEvent::uint64At(int offset) const
+{
+    return offset + 8 <= payloadSize ? qFromBigEndian<quint64>(payload + offset) : 0;
+}
+
+EventlogDecoder::EventlogDecoder(const EventHandler &handler)
+    : m_handler(handler)
+{}
+
+bool EventlogDecoder::feed(const QByteArray &data)
+{
+    if (m_state == State::Error)
+        return false;
+    if (m_state == State::End)
+        return true;
+    m_buffer.append(data);
+    const auto begin = reinterpret_cast<const uchar *>(m_buffer.constData());
+    const int size = m_buffer.size();
+    int position = 0;
+    while (m_state != State::End && m_state != State::Error) {
+        int consumed = 0;
+        bool complete = false;
+        if (m_state == State::Events)
+            complete = decodeEvent(begin + position, size - position, &consumed);
+        else if (m_state == State::EventTypes)
+            complete = decodeEventType(begin + position, size - position, &consumed);
+        else
+            complete = decodeHeader(begin + position, size - position, &consumed);
+        if (!complete)
+            break;
+        position += consumed;
+        m_offset += consumed;
+    }
+    m_buffer.remove(0, position);
+    return m_state != State::Error;
+}
+
+bool EventlogDecoder::decodeHeader(const uchar *data, int size, int *consumed)
+{
+    if (size < 4)
+        return false;
+    const quint32 marker = qFromBigEndian<quint32>(data);
+    *consumed = 4;
+    switch (m_state) {
+    case State::Header:
+        if (size < 8)
+            return false;
+        if (marker != HeaderBegin || qFromBigEndian<quint32>(data + 4) != EventTypesBegin)
+            return fail(Tr::tr("The file is not a GHC eventlog."));
+        *consumed = 8;
+        m_state = State::EventTypes;
+        return true;
+    case State::HeaderEnd:
+        if (marker != HeaderEnd)
+            return fail(Tr::tr("Invalid eventlog header."));
+        m_state = State::DataBegin;
+        return true;
+    case State::DataBegin:
+        if (marker != DataBegin)
+            return fail(Tr::tr("Invalid eventlog header."));
+        m_state = State::Events;
+        return true;
+    default:
+        return fail(Tr::tr("Invalid eventlog header."));
+    }
+}
+
+bool EventlogDecoder::decodeEventType(const uchar *data, int size, int *consumed)
+{
+    if (size < 4)
+        return false;
+    const quint32 marker = qFromBigEndian<quint32>(data);
+    if (marker == EventTypesEnd) {
+        *consumed = 4;
+        m_state = State::HeaderEnd;
+        return true;
+    }
+    if (marker != EventTypeBegin)
+        return fail(Tr::tr("Invalid event type in the eventlog header."));
+    // etb, id, size, description length, description, extra info length, extra info, ete
+    if (size < 12)
+        return false;
+    const quint16 type = qFromBigEndian<quint16>(data + 4);
+    const quint16 payloadSize = qFromBigEndian<quint16>(data + 6);
+    const quint32 descriptionSize = qFromBigEndian<quint32>(data + 8);
+    if (size < 16 + qint64(descriptionSize))
+        return false;
+    const quint32 extraSize = qFromBigEndian<quint32>(data + 12 + descriptionSize);
+    const qint64 total = 20 + qint64(descriptionSize) + extraSize;
+    if (size < total)
+        return false;
+    if (qFromBigEndian<quint32>(data + total - 4) != EventTypeEnd)
+        return fail(Tr::tr("Invalid event type in the eventlog header."));
+    m_sizes.insert(type, payloadSize);
+    m_typeNames.insert(type,
+                       QString::fromUtf8(reinterpret_cast<const char *>(data + 12),
+                                         int(descriptionSize)));
+    *consumed = int(total);
+    return true;
+}
+
+bool EventlogDecoder::decodeEvent(const uchar *data, int size, int *consumed)
+{
+    if (size < 2)
+        return false;
+    const quint16 type = qFromBigEndian<quint16>(data);
+    if (type == DataEnd) {
+        *consumed = 2;
+        m_state = State::End;
+        return true;
+    }
+    if (size < 10)
+        return false;
+    const auto it = m_sizes.constFind(type);
+    if (it == m_sizes.constEnd())
+        return fail(Tr::tr("Unknown event type %1 at offset %2.").arg(type).arg(m_offset));
+    int headerSize = 10;
+    int payloadSize = it.value();
+    if (payloadSize == variableSize) {
+        if (size < 12)
+            return false;
+        payloadSize = qFromBigEndian<quint16>(data + 10);
+        headerSize = 12;
+    }
+    if (size < headerSize + payloadSize)
+        return false;
+
+    EventlogEvent event;
+    event.type = type;
+    event.timestamp = qFromBigEndian<quint64>(data + 2);
+    event.payload = data + headerSize;
+    event.payloadSize = payloadSize;
+    if (m_offset >= m_blockEnd)
+        m_capability = -1;
+    if (type == BlockMarker) {
+        // the events up to the end of the block happened on the block's capability
+        m_blockEnd = m_offset + event.uint32At(0);
+        const quint16 capability = event.uint16At(12);
+        m_capability = capability == 0xffff ? -1 : capability;
+    }
+    event.capability = m_capability;
+    m_handler(event);
+    *consumed = headerSize + payloadSize;
+    return true;
+}
+
+bool EventlogDecoder::fail(const QString &message)
+{
+    m_state = State::Error;
+    m_errorString = message;
+    return false;
+}
+
+EventlogTimeline::EventlogTimeline(int binCount, qint64 initialBinWidth)
+    : m_binCount(binCount)
+    , m_binWidth(initialBinWidth)
+    , m_counts(CounterCount, QVector<qint64>(binCount, 0))
+{}
+
+void EventlogTimeline::addInterval(int capability, Series series, qint64 start, qint64 end)
+{
+    if (capability < 0 || end <= start)
+        return;
+    ensureCapability(capability);
+    ensureTime(end - 1);
+    QVector<qint64> &bins = m_time[capability][series];
+    int bin = int(start / m_binWidth);
+    while (start < end) {
+        const qint64 binEnd = std::min(end, (bin + 1) * m_binWidth);
+        bins[bin] += binEnd - start;
+        start = binEnd;
+        ++bin;
+    }
+    m_lastBin = std::max(m_lastBin, bin - 1);
+}
+
+void EventlogTimeline::addCount(Counter counter, qint64 time, qint64 count)
+{
+    if (count == 0)
+        return;
+    ensureTime(time);
+    const int bin = int(time / m_binWidth);
+    m_counts[counter][bin] += count;
+    m_lastBin = std::max(m_lastBin, bin);
+}
+
+qint64 EventlogTimeline::time(int capability, Series series, int bin) const
+{
+    if (capability < 0 || capability >= m_time.size() || bin < 0 || bin >= m_binCount)
+        return 0;
+    return m_time.at(capability).at(series).at(bin);
+}
+
+qint64 EventlogTimeline::count(Counter counter, int bin) const
+{
+    if (bin < 0 || bin >= m_binCount)
+        return 0;
+    return m_counts.at(counter).at(bin);
+}
+
+void EventlogTimeline::ensureCapability(int capability)
+{
+    while (m_time.size() <= capability)
+        m_time.append(QVector<QVector<qint64>>(SeriesCount, QVector<qint64>(m_binCount, 0)));
+}
+
+void EventlogTimeline::ensureTime(qint64 time)
+{
+    const auto merge = [this](QVector<qint64> &bins) {
+        for (int i = 0; i < m_binCount / 2; ++i)
+            bins[i] = bins.at(2 * i) + bins.at(2 * i + 1);
+        std::fill(bins.begin() + m_binCount / 2, bins.end(), 0);
+    };
+    while (time >= m_binWidth * m_binCount) {
+        for (QVector<QVector<qint64>> &capability : m_time) {
+            for (QVector<qint64> &bins : capability)
+                merge(bins);
+        }
+        for (QVector<qint64> &bins : m_counts)
+            merge(bins);
+        m_binWidth *= 2;
+        if (m_lastBin >= 0)
+            m_lastBin /= 2;
+    }
+}
+
+double EventlogSummary::gcPercent() const
+{
+    const qint64 elapsed = elapsedTime();
+    return elapsed > 0 ? 100.0 * gcWallTime / elapsed : 0;
+}
+
+double EventlogSummary::sparkEfficiency() const
+{
+    return sparksCreated > 0 ? 100.0 * sparksConverted / sparksCreated : -1;
+}
+
+EventlogAnalysis::EventlogAnalysis() = default;
+
+void EventlogAnalysis::addEvent(const EventlogEvent &event)
+{
+    const qint64 time = qint64(event.timestamp);
+    const int cap = event.capability;
+    ++m_summary.events;
+    if (m_summary.startTime < 0 || time < m_summary.startTime)
+        m_summary.startTime = time;
+    m_summary.endTime = std::max(m_summary.endTime, time);
+    if (cap >= 0)
+        capability(cap).lastEventTime = time;
+
+    switch (event.type) {
+    case CreateThread:
+        ++m_summary.threadsCreated;
+        break;
+    case RunThread:
+        if (cap >= 0)
+            capability(cap).runningSince = time;
+        break;
+    case StopThread:
+        if (cap >= 0) {
+            CapabilityState &state = capability(cap);
+            if (state.runningSince >= 0) {
+                m_summary.mutatorTime += time - state.runningSince;
+                m_timeline.addInterval(cap, EventlogTimeline::Mutator, state.runningSince, time);
+                state.runningSince = -1;
+            }
+        }
+        break;
+    case CapCreate:
+        // the capabilities are created before their blocks of events come
+        capability(event.uint16At(0));
+        break;
+    case MigrateThread:
+        ++m_summary.threadMigrations;
+        m_timeline.addCount(EventlogTimeline::ThreadMigrations, time);
+        break;
+    case GcStart:
+        if (cap >= 0)
+            startGc(cap, time);
+        break;
+    case GcEnd:
+        if (cap >= 0)
+            endGc(cap, time);
+        break;
+    case SparkCounters:
+        // created, dud, overflowed, converted, garbage collected, fizzled, remaining
+        if (cap >= 0 && event.payloadSize >= 7 * 8) {
+            CapabilityState &state = capability(cap);
+            QVector<qint64> counters(7);
+            for (int i = 0; i < counters.size(); ++i)
+                counters[i] = qint64(event.uint64At(8 * i));
+            const QVector<qint64> previous = state.sparkCounters.isEmpty() ? QVector<qint64>(7, 0)
+                                                                           : state.sparkCounters;
+            m_timeline.addCount(EventlogTimeline::SparksCreated, time, counters[0] - previous[0]);
+            m_timeline.addCount(EventlogTimeline::SparksConverted, time, counters[3] - previous[3]);
+            state.sparkCounters = counters;
+            m_hasSparkCounters = true;
+        }
+        break;
+    // the individual spark events only come with +RTS -lf
+    case SparkCreate:
+        ++m_sparkEvents.sparksCreated;
+        if (!m_hasSparkCounters)
+            m_timeline.addCount(EventlogTimeline::SparksCreated, time);
+        break;
+    case SparkRun:
+    case SparkSteal:
+        ++m_sparkEvents.sparksConverted;
+        if (!m_hasSparkCounters)
+            m_timeline.addCount(EventlogTimeline::SparksConverted, time);
+        break;
+    case SparkFizzle:
+        ++m_sparkEvents.sparksFizzled;
+        break;
+    case SparkGc:
+        ++m_sparkEvents.sparksGarbageCollected;
+        break;
+    case SparkDud:
+        ++m_sparkEvents.sparksDud;
+        break;
+    case SparkOverflow:
+        ++m_sparkEvents.sparksOverflowed;
+        break;
+    default:
+        if (cap >= 0)
+            capability(cap);
+        break;
+    }
+}
+
+void EventlogAnalysis::finish()
+{
+    const qint64 end = m_summary.endTime;
+    for (int cap = 0; cap < m_capabilities.size(); ++cap) {
+        CapabilityState &state = m_capabilities[cap];
+        if (state.runningSince >= 0) {
+            m_summary.mutatorTime += end - state.runningSince;
+            m_timeline.addInterval(cap, EventlogTimeline::Mutator, state.runningSince, end);
+            state.runningSince = -1;
+        }
+        endGc(cap, end);
+    }
+
+    flushGcEpisodes(std::numeric_limits<qint64>::max(), 0);
+
+    if (m_hasSparkCounters) {
+        // the counters are totals per capability
+        for (const CapabilityState &state : std::as_const(m_capabilities)) {
+            if (state.sparkCounters.isEmpty())
+                continue;
+            m_summary.sparksCreated += state.sparkCounters.at(0);
+            m_summary.sparksDud += state.sparkCounters.at(1);
+            m_summary.sparksOverflowed += state.sparkCounters.at(2);
+            m_summary.sparksConverted += state.sparkCounters.at(3);
+            m_summary.sparksGarbageCollected += state.sparkCounters.at(4);
+            m_summary.sparksFizzled += state.sparkCounters.at(5);
+        }
+    } else {
+        m_summary.sparksCreated = m_sparkEvents.sparksCreated;
+        m_summary.sparksDud = m_sparkEvents.sparksDud;
+        m_summary.sparksOverflowed = m_sparkEvents.sparksOverflowed;
+        m_summary.sparksConverted = m_sparkEvents.sparksConverted;
+        m_summary.sparksGarbageCollected = m_sparkEvents.sparksGarbageCollected;
+        m_summary.sparksFizzled = m_sparkEvents.sparksFizzled;
+    }
+}
+
+EventlogAnalysis::CapabilityState &EventlogAnalysis::capability(int capability)
+{
+    if (capability >= m_capabilities.size()) {
+        m_capabilities.resize(capability + 1);
+        m_summary.capabilities = m_capabilities.size();
+    }
+    return m_capabilities[capability];
+}
+
+void EventlogAnalysis::startGc(int cap, qint64 time)
+{
+    CapabilityState &state = capability(cap);
+    if (state.gcSince >= 0)
+        return;
+    if (state.runningSince >= 0) {
+        m_summary.mutatorTime += time - state.runningSince;
+        m_timeline.addInterval(cap, EventlogTimeline::Mutator, state.runningSince, time);
+        state.runningSince = -1;
+    }
+    state.gcSince = time;
+}
+
+void EventlogAnalysis::endGc(int cap, qint64 time)
+{
+    CapabilityState &state = capability(cap);
+    if (state.gcSince < 0)
+        return;
+    m_summary.gcTime += time - state.gcSince;
+    m_timeline.addInterval(cap, EventlogTimeline::GarbageCollection, state.gcSince, time);
+    if (state.gcSince <= m_lastGcEnd) {
+        addGcEpisode(state.gcSince, time);
+    } else {
+        const auto it = m_gcIntervals.find(state.gcSince);
+        if (it == m_gcIntervals.end())
+            m_gcIntervals.insert(state.gcSince, time);
+        else
+            it.value() = std::max(it.value(), time);
+    }
+    state.gcSince = -1;
+
+    // the events of a capability are ordered, so later intervals start after the last event of
+    // each capability, or when it started the collection that is running
+    qint64 settled = std::numeric_limits<qint64>::max();
+    for (const CapabilityState &other : std::as_const(m_capabilities))
+        settled = std::min(settled, other.gcSince >= 0 ? other.gcSince : other.lastEventTime);
+    flushGcEpisodes(settled, maximumPendingGcIntervals);
+}
+
+// A parallel collection runs on all capabilities, but pauses the program only once, so
+// overlapping intervals are one episode.
+void EventlogAnalysis::flushGcEpisodes(qint64 before, int maximumPending)
+{
+    while (!m_gcIntervals.isEmpty()) {
+        auto it = m_gcIntervals.begin();
+        const qint64 start = it.key();
+        qint64 end = it.value();
+        for (++it; it != m_gcIntervals.end() && it.key() <= end; ++it)
+            end = std::max(end, it.value());
+        // an episode that a capability can still extend waits, unless too many do
+        if (end >= before && m_gcIntervals.size() <= maximumPending)
+            return;
+        m_gcIntervals.erase(m_gcIntervals.begin(), it);
+        addGcEpisode(start, end);
+    }
+}
+
+void EventlogAnalysis::addGcEpisode(qint64 start, qint64 end)
+{
+    if (m_lastGcStart >= 0 && start <= m_lastGcEnd) {
+        // a late interval of the episode that was counted last
+        if (end <= m_lastGcEnd)
+            return;
+        m_summary.gcWallTime += end - m_lastGcEnd;
+        m_lastGcEnd = end;
+        m_summary.maxGcPause = std::max(m_summary.maxGcPause, end - m_lastGcStart);
+        return;
+    }
+    m_summary.gcWallTime += end - start;
+    m_summary.maxGcPause = std::max(m_summary.maxGcPause, end - start);
+    ++m_summary.gcCount;
+    m_timeline.addCount(EventlogTimeline::GarbageCollections, start);
+    m_lastGcStart = start;
+    m_lastGcEnd = end;
+}
+
+} // namespace Internal
+} // namespace Haskell
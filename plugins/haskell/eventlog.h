@@ -0,0 +1,193 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+namespace Haskell {
+namespace Internal {
+
+// An event from a GHC eventlog. The payload points into the decoder's buffer and is only valid
+// during the callback.
+class EventlogEvent
+{
+public:
+    quint16 type = 0;
+    quint64 timestamp = 0; // nanoseconds
+    int capability = -1; // from the enclosing block, -1 outside of blocks
+    const uchar *payload = nullptr;
+    int payloadSize = 0;
+
+    quint16 uint16At(int offset) const;
+    quint32 uint32At(int offset) const;
+    quint64 uint64At(int offset) const;
+};
+
+// Decodes the binary eventlog format incrementally, so logs of any size can be read in chunks.
+class EventlogDecoder
+{
+public:
+    using EventHandler = std::function<void(const EventlogEvent &)>;
+
+    explicit EventlogDecoder(const EventHandler &handler);
+
+    // Returns false if the data is not a valid eventlog.
+    bool feed(const QByteArray &data);
+    bool atEnd() const { return m_state == State::End; }
+    QString errorString() const { return m_errorString; }
+    QString eventTypeName(quint16 type) const { return m_typeNames.value(type); }
+
+private:
+    enum class State { Header, EventTypes, HeaderEnd, DataBegin, Events, End, Error };
+
+    bool decodeHeader(const uchar *data, int size, int *consumed);
+    bool decodeEventType(const uchar *data, int size, int *consumed);
+    bool decodeEvent(const uchar *data, int size, int *consumed);
+    bool fail(const QString &message);
+
+    EventHandler m_handler;
+    State m_state = State::Header;
+    QByteArray m_buffer;
+    qint64 m_offset = 0; // of the start of m_buffer in the stream
+    QHash<quint16, int> m_sizes; // event type -> payload size, 0xffff for variable
+    QHash<quint16, QString> m_typeNames;
+    int m_capability = -1;
+    qint64 m_blockEnd = 0;
+    QString m_errorString;
+};
+
+// Splits the time of a run into a fixed number of bins. Bins double in width when events
+// happen after the last one, so memory use does not depend on the length of the run.
+class EventlogTimeline
+{
+public:
+    enum Series { Mutator, GarbageCollection, SeriesCount };
+    enum Counter { SparksCreated, SparksConverted, ThreadMigrations, GarbageCollections,
+                   CounterCount };
+
+    explicit EventlogTimeline(int binCount = 1024, qint64 initialBinWidth = 100000);
+
+    int binCount() const { return m_binCount; }
+    qint64 binWidth() const { return m_binWidth; }
+    int capabilities() const { return m_time.size(); }
+    // Returns the index of the last bin that contains data.
+    int lastBin() const { return m_lastBin; }
+
+    void addInterval(int capability, Series series, qint64 start, qint64 end);
+    void addCount(Counter counter, qint64 time, qint64 count = 1);
+
+    // The time in nanoseconds that the capability spent in the series during the bin.
+    qint64 time(int capability, Series series, int bin) const;
+    qint64 count(Counter counter, int bin) const;
+
+private:
+    void ensureCapability(int capability);
+    void ensureTime(qint64 time);
+
+    int m_binCount;
+    qint64 m_binWidth;
+    int m_lastBin = -1;
+    QVector<QVector<QVector<qint64>>> m_time; // capability -> series -> bin
+    QVector<QVector<qint64>> m_counts; // counter -> bin
+};
+
+class EventlogSummary
+{
+public:
+    qint64 startTime = -1;
+    qint64 endTime = 0;
+    qint64 events = 0;
+    int capabilities = 0;
+    qint64 mutatorTime = 0; // summed over capabilities
+    qint64 gcTime = 0; // summed over capabilities
+    qint64 gcWallTime = 0; // time during which any capability collected garbage
+    qint64 gcCount = 0;
+    qint64 maxGcPause = 0;
+    qint64 sparksCreated = 0;
+    qint64 sparksConverted = 0;
+    qint64 sparksFizzled = 0;
+    qint64 sparksGarbageCollected = 0;
+    qint64 sparksDud = 0;
+    qint64 sparksOverflowed = 0;
+    qint64 threadsCreated = 0;
+    qint64 threadMigrations = 0;
+
+    qint64 elapsedTime() const { return startTime < 0 ? 0 : endTime - startTime; }
+    // Percentage of the elapsed time spent in garbage collection.
+    double gcPercent() const;
+    // Percentage of the created sparks that were converted, -1 without sparks.
+    double sparkEfficiency() const;
+};
+
+// Collects the summary and the timeline from the events of a decoder.
+class EventlogAnalysis
+{
+public:
+    EventlogAnalysis();
+
+    void addEvent(const EventlogEvent &event);
+    // Closes the intervals that are still open at the end of the log.
+    void finish();
+
+    const EventlogSummary &summary() const { return m_summary; }
+    const EventlogTimeline &timeline() const { return m_timeline; }
+
+private:
+    class CapabilityState
+    {
+    public:
+        qint64 runningSince = -1;
+        qint64 gcSince = -1;
+        qint64 lastEventTime = -1;
+        QVector<qint64> sparkCounters;
+    };
+
+    CapabilityState &capability(int capability);
+    void startGc(int capability, qint64 time);
+    void endGc(int capability, qint64 time);
+    void flushGcEpisodes(qint64 before, int maximumPending);
+    void addGcEpisode(qint64 start, qint64 end);
+
+    EventlogSummary m_summary;
+    EventlogTimeline m_timeline;
+    QVector<CapabilityState> m_capabilities;
+    // The GC intervals that may still overlap ones of other capabilities, by start. The events are
+    // written in blocks per capability, so intervals of other capabilities can come later.
+    QMap<qint64, qint64> m_gcIntervals;
+    qint64 m_lastGcStart = -1; // of the last counted episode, which later intervals can extend
+    qint64 m_lastGcEnd = -1;
+    EventlogSummary m_sparkEvents; // spark counts from individual events
+    bool m_hasSparkCounters = false;
+};
+
+} // namespace Internal
+} // namespace Haskell
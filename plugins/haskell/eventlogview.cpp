@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "eventlogview.h"
+
+#include <QFormLayout>
+#include <QHelpEvent>
+#include <QLabel>
+#include <QLocale>
+#include <QPainter>
+#include <QScrollArea>
+#include <QToolTip>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+static QString formatTime(qint64 nanoseconds)
+{
+    if (nanoseconds < 1000000)
+        return EventlogView::tr("%1 µs").arg(QLocale().toString(nanoseconds / 1000.0, 'f', 1));
+    if (nanoseconds < 1000000000)
+        return EventlogView::tr("%1 ms").arg(QLocale().toString(nanoseconds / 1e6, 'f', 2));
+    return EventlogView::tr("%1 s").arg(QLocale().toString(nanoseconds / 1e9, 'f', 3));
+}
+
+static const EventlogTimeline::Counter counterRows[] = {EventlogTimeline::GarbageCollections,
+                                                        EventlogTimeline::SparksCreated,
+                                                        EventlogTimeline::SparksConverted,
+                                                        EventlogTimeline::ThreadMigrations};
+
+static QColor counterColor(EventlogTimeline::Counter counter)
+{
+    switch (counter) {
+    case EventlogTimeline::GarbageCollections:
+        return QColor(230, 140, 40);
+    case EventlogTimeline::SparksCreated:
+        return QColor(70, 130, 220);
+    case EventlogTimeline::SparksConverted:
+        return QColor(60, 170, 90);
+    default:
+        return QColor(150, 90, 200);
+    }
+}
+
+EventlogTimelineWidget::EventlogTimelineWidget(const EventlogTimeline &timeline)
+    : m_timeline(timeline)
+    , m_bins(std::max(timeline.lastBin() + 1, 1))
+{
+    setMouseTracking(true);
+}
+
+QSize EventlogTimelineWidget::sizeHint() const
+{
+    return {800, rowLabels().size() * rowHeight() + 4};
+}
+
+int EventlogTimelineWidget::rowHeight() const
+{
+    return fontMetrics().height() + 6;
+}
+
+int EventlogTimelineWidget::labelWidth() const
+{
+    int width = 0;
+    for (const QString &label : rowLabels())
+        width = std::max(width, fontMetrics().horizontalAdvance(label));
+    return width + 10;
+}
+
+QStringList EventlogTimelineWidget::rowLabels() const
+{
+    QStringList labels;
+    for (int cap = 0; cap < m_timeline.capabilities(); ++cap)
+        labels.append(tr("HEC %1").arg(cap));
+    labels << tr("GC") << tr("Sparks created") << tr("Sparks converted") << tr("Migrations");
+    return labels;
+}
+
+double EventlogTimelineWidget::binLeft(int bin) const
+{
+    const int left = labelWidth();
+    return left + double(width() - left) * bin / m_bins;
+}
+
+int EventlogTimelineWidget::binAt(int x) const
+{
+    const int left = labelWidth();
+    if (x < left || width() <= left)
+        return -1;
+    return std::min(int(double(x - left) / (width() - left) * m_bins), m_bins - 1);
+}
+
+void EventlogTimelineWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    const int height = rowHeight();
+    const QStringList labels = rowLabels();
+    const qint64 binWidth = m_timeline.binWidth();
+    painter.setPen(palette().color(QPalette::Text));
+    for (int row = 0; row < labels.size(); ++row) {
+        painter.drawText(QRect(4, row * height, labelWidth(), height), Qt::AlignVCenter,
+                         labels.at(row));
+    }
+
+    // capabilities: green while running Haskell code, orange while collecting garbage
+    for (int cap = 0; cap < m_timeline.capabilities(); ++cap) {
+        const int top = cap * height + 2;
+        for (int bin = 0; bin < m_bins; ++bin) {
+            const double left = binLeft(bin);
+            const double right = std::max(binLeft(bin + 1), left + 1);
+            const double mutator = double(m_timeline.time(cap, EventlogTimeline::Mutator, bin))
+                                   / binWidth;
+            const double gc = double(
+                                  m_timeline.time(cap, EventlogTimeline::GarbageCollection, bin))
+                              / binWidth;
+            const double mutatorHeight = std::min(mutator, 1.0) * (height - 4);
+            const double gcHeight = std::min(gc, 1.0) * (height - 4);
+            painter.fillRect(QRectF(left, top + height - 4 - mutatorHeight, right - left,
+                                    mutatorHeight),
+                             QColor(60, 170, 90));
+            painter.fillRect(QRectF(left, top, right - left, gcHeight), QColor(230, 140, 40));
+        }
+    }
+
+    int row = m_timeline.capabilities();
+    for (const EventlogTimeline::Counter counter : counterRows) {
+        qint64 maximum = 0;
+        for (int bin = 0; bin < m_bins; ++bin)
+            maximum = std::max(maximum, m_timeline.count(counter, bin));
+        const int top = row * height + 2;
+        for (int bin = 0; maximum > 0 && bin < m_bins; ++bin) {
+            const double value = double(m_timeline.count(counter, bin)) / maximum * (height - 4);
+            const double left = binLeft(bin);
+            painter.fillRect(QRectF(left, top + height - 4 - value,
+                                    std::max(binLeft(bin + 1), left + 1) - left, value),
+                             counterColor(counter));
+        }
+        ++row;
+    }
+
+    painter.setPen(palette().color(QPalette::Mid));
+    for (int line = 1; line < labels.size(); ++line)
+        painter.drawLine(0, line * height, width(), line * height);
+}
+
+bool EventlogTimelineWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent *>(event);
+        const int bin = binAt(helpEvent->pos().x());
+        const int row = helpEvent->pos().y() / rowHeight();
+        if (bin < 0 || row >= rowLabels().size()) {
+            QToolTip::hideText();
+            return true;
+        }
+        const qint64 binWidth = m_timeline.binWidth();
+        QString text = tr("%1 - %2").arg(formatTime(bin * binWidth),
+                                         formatTime((bin + 1) * binWidth));
+        if (row < m_timeline.capabilities()) {
+            const qint64 mutator = m_timeline.time(row, EventlogTimeline::Mutator, bin);
+            const qint64 gc = m_timeline.time(row, EventlogTimeline::GarbageCollection, bin);
+            text += '\n' + tr("Running: %1%").arg(100 * mutator / binWidth);
+            text += '\n' + tr("Garbage collection: %1%").arg(100 * gc / binWidth);
+        } else {
+            const EventlogTimeline::Counter counter
+                = counterRows[row - m_timeline.capabilities()];
+            text += '\n' + rowLabels().at(row) + ": "
+                    + QString::number(m_timeline.count(counter, bin));
+        }
+        QToolTip::showText(helpEvent->globalPos(), text, this);
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+EventlogView::EventlogView(const EventlogSummary &summary, const EventlogTimeline &timeline)
+{
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    auto summaryWidget = new QWidget;
+    auto form = new QFormLayout(summaryWidget);
+    const QLocale locale;
+    form->addRow(tr("Elapsed time:"), new QLabel(formatTime(summary.elapsedTime())));
+    form->addRow(tr("Capabilities:"), new QLabel(QString::number(summary.capabilities)));
+    form->addRow(tr("Garbage collection:"),
+                 new QLabel(tr("%1% of the elapsed time, %2 collections, longest pause %3")
+                                .arg(locale.toString(summary.gcPercent(), 'f', 1))
+                                .arg(summary.gcCount)
+                                .arg(formatTime(summary.maxGcPause))));
+    const double efficiency = summary.sparkEfficiency();
+    form->addRow(tr("Sparks:"),
+                 new QLabel(efficiency < 0
+                                ? tr("none")
+                                : tr("%1 created, %2 converted (%3%), %4 fizzled, "
+                                     "%5 garbage collected, %6 overflowed")
+                                      .arg(summary.sparksCreated)
+                                      .arg(summary.sparksConverted)
+                                      .arg(locale.toString(efficiency, 'f', 1))
+                                      .arg(summary.sparksFizzled)
+                                      .arg(summary.sparksGarbageCollected)
+                                      .arg(summary.sparksOverflowed)));
+    form->addRow(tr("Threads:"),
+                 new QLabel(tr("%1 created, %2 migrations")
+                                .arg(summary.threadsCreated)
+                                .arg(summary.threadMigrations)));
+    layout->addWidget(summaryWidget);
+
+    auto scrollArea = new QScrollArea;
+    scrollArea->setFrameStyle(QFrame::NoFrame);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(new EventlogTimelineWidget(timeline));
+    layout->addWidget(scrollArea, 1);
+}
+
+} // namespace Internal
+} // namespace Haskell
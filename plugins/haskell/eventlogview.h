@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "eventlog.h"
+
+#include <QWidget>
+
+namespace Haskell {
+namespace Internal {
+
+// Activity of the capabilities over time, with garbage collections, sparks and thread
+// migrations below.
+class EventlogTimelineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit EventlogTimelineWidget(const EventlogTimeline &timeline);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    int rowHeight() const;
+    int labelWidth() const;
+    int binAt(int x) const;
+    double binLeft(int bin) const;
+    QStringList rowLabels() const;
+
+    EventlogTimeline m_timeline;
+    int m_bins;
+};
+
+class EventlogView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    EventlogView(const EventlogSummary &summary, const EventlogTimeline &timeline);
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "ghcdiagnostics.h"
+
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+// how much the last check counts for the average duration
+static const double durationWeight = 0.3;
+
+static bool isSnippetLine(const QString &line)
+{
+    // "   |", "12 | foo = bar" and "   |       ^^^"
+    static const QRegularExpression snippet(R"(^\s*\d*\s*\|)");
+    return snippet.match(line).hasMatch();
+}
+
+static QString unindented(const QStringList &lines)
+{
+    int indentation = -1;
+    for (const QString &line : lines) {
+        const int firstChar = int(std::find_if(line.cbegin(), line.cend(),
+                                               [](QChar c) { return !c.isSpace(); })
+                                  - line.cbegin());
+        if (firstChar < line.size())
+            indentation = indentation < 0 ? firstChar : std::min(indentation, firstChar);
+    }
+    QStringList result;
+    for (const QString &line : lines)
+        result.append(line.mid(std::max(indentation, 0)));
+    return result.join('\n').trimmed();
+}
+
+QVector<GhcDiagnostic> GhcDiagnostics::parse(const QString &output)
+{
+    // "File.hs:12:5: error:", "File.hs:12:5-10: warning: [-Wunused-matches]" and
+    // "File.hs:(12,5)-(14,3): error: [GHC-88464]"
+    static const QRegularExpression header(
+        R"(^(.+?):(?:(\d+):(\d+)(?:-(\d+))?|\((\d+),(\d+)\)-\((\d+),(\d+)\)):\s*)"
+        R"((error|warning)\s*:?(.*)$)",
+        QRegularExpression::CaseInsensitiveOption);
+
+    QVector<GhcDiagnostic> diagnostics;
+    QStringList messageLines;
+    bool inMessage = false;
+    const auto finishMessage = [&] {
+        if (inMessage)
+            diagnostics.last().message = unindented(messageLines);
+        messageLines.clear();
+        inMessage = false;
+    };
+    for (QString line : output.split('\n')) {
+        if (line.endsWith('\r'))
+            line.chop(1);
+        const QRegularExpressionMatch match = header.match(line);
+        if (match.hasMatch()) {
+            finishMessage();
+            GhcDiagnostic diagnostic;
+            diagnostic.filePath = match.captured(1);
+            if (match.capturedLength(2) > 0) {
+                diagnostic.line = diagnostic.endLine = match.captured(2).toInt();
+                diagnostic.column = match.captured(3).toInt();
+                diagnostic.endColumn = match.capturedLength(4) > 0 ? match.captured(4).toInt()
+                                                                   : diagnostic.column;
+            } else {
+                diagnostic.line = match.captured(5).toInt();
+                diagnostic.column = match.captured(6).toInt();
+                diagnostic.endLine = match.captured(7).toInt();
+                diagnostic.endColumn = match.captured(8).toInt();
+            }
+            diagnostic.severity = match.captured(9).compare("error", Qt::CaseInsensitive) == 0
+                                      ? GhcDiagnostic::Error
+                                      : GhcDiagnostic::Warning;
+            diagnostics.append(diagnostic);
+            // the flag or the code of the message, like [-Wunused-matches]
+            const QString rest = match.captured(10).trimmed();
+            if (!rest.isEmpty())
+                messageLines.append("    " + rest);
+            inMessage = true;
+        } else if (inMessage && (line.isEmpty() || line.at(0).isSpace())) {
+            if (!isSnippetLine(line))
+                messageLines.append(line);
+        } else {
+            finishMessage();
+        }
+    }
+    finishMessage();
+    return diagnostics;
+}
+
+QString GhcDiagnostics::moduleName(const QString &source)
+{
+    static const QRegularExpression module(R"(^module\s+([A-Z][\w'.]*))",
+                                           QRegularExpression::MultilineOption);
+    return module.match(source).captured(1);
+}
+
+QString GhcDiagnostics::sourceRoot(const QString &filePath, const QString &moduleName)
+{
+    QString directory = QFileInfo(filePath).absolutePath();
+    for (int i = moduleName.count('.'); i > 0; --i)
+        directory = QFileInfo(directory).path();
+    return directory;
+}
+
+int CheckScheduler::delay() const
+{
+    // a check that takes two seconds waits for a pause of one second
+    if (m_averageDuration < 0)
+        return minimumDelay;
+    return std::clamp(qRound(m_averageDuration / 2), minimumDelay, maximumDelay);
+}
+
+int CheckScheduler::startCheck()
+{
+    m_running = ++m_lastCheck;
+    return m_running;
+}
+
+bool CheckScheduler::finishCheck(int check, int msecs)
+{
+    if (check != m_running)
+        return false;
+    m_running = 0;
+    m_averageDuration = m_averageDuration < 0
+                            ? msecs
+                            : durationWeight * msecs + (1 - durationWeight) * m_averageDuration;
+    return true;
+}
+
+} // namespace Internal
+} // namespace Haskell
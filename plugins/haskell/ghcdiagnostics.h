@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+class GhcDiagnostic
+{
+public:
+    enum Severity { Error, Warning };
+
+    QString filePath;
+    Severity severity = Error;
+    // starting at 1, the end column is the last one of the span
+    int line = 0;
+    int column = 0;
+    int endLine = 0;
+    int endColumn = 0;
+    QString message;
+};
+
+class GhcDiagnostics
+{
+public:
+    // Parses the errors and warnings in the output of GHC, with or without -ferror-spans. The
+    // messages are without the code snippets that GHC shows with them.
+    static QVector<GhcDiagnostic> parse(const QString &output);
+    // The name of the module in the source, or an empty string for Main.
+    static QString moduleName(const QString &source);
+    // The directory that imports of the module are searched in, the directory of the file
+    // without the directories of the module name.
+    static QString sourceRoot(const QString &filePath, const QString &moduleName);
+};
+
+// Decides when a document is checked after an edit. Checks are superseded by later edits and
+// the delay follows how long checks take: slow checks wait for longer pauses in typing, so
+// fewer checks are started only to be cancelled.
+class CheckScheduler
+{
+public:
+    static constexpr int minimumDelay = 300;
+    static constexpr int maximumDelay = 3000;
+
+    int delay() const;
+    // Returns the id of a new check, which supersedes the running one.
+    int startCheck();
+    // Called after an edit, the running check is superseded.
+    void cancelCheck() { m_running = 0; }
+    // Returns whether the check is the current one. Its duration counts for the delay then.
+    bool finishCheck(int check, int msecs);
+    bool isChecking() const { return m_running != 0; }
+    int averageDuration() const { return qRound(m_averageDuration); }
+
+private:
+    double m_averageDuration = -1; // of the finished checks, the latest weighs most
+    int m_lastCheck = 0;
+    int m_running = 0;
+};
+
+} // namespace Internal
+} // namespace Haskell
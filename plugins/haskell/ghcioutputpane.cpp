@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "ghcioutputpane.h"
+
+#include "ghcisession.h"
+
+#include <utils/utilsicons.h>
+
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+namespace Haskell {
+namespace Internal {
+
+static GhciOutputPane *m_instance = nullptr;
+
+GhciOutputPane::GhciOutputPane(GhciSessionPool *pool)
+    : m_pool(pool)
+{
+    m_instance = this;
+
+    m_widget = new QWidget;
+    auto layout = new QVBoxLayout(m_widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    m_output = new QPlainTextEdit;
+    m_output->setReadOnly(true);
+    m_output->setFrameStyle(QFrame::NoFrame);
+    m_output->setMaximumBlockCount(100000);
+    m_output->setFont(QFont("Monospace"));
+    layout->addWidget(m_output);
+    m_input = new QLineEdit;
+    m_input->setPlaceholderText(tr("Enter GHCi command"));
+    layout->addWidget(m_input);
+    connect(m_input, &QLineEdit::returnPressed, this, &GhciOutputPane::sendInput);
+
+    m_sessionBox = new QComboBox;
+    m_sessionBox->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(m_sessionBox, QOverload<int>::of(&QComboBox::activated), this, [this](int index) {
+        setCurrentSession(m_pool->sessions().value(index));
+    });
+
+    m_clearButton = new QToolButton;
+    m_clearButton->setIcon(Utils::Icons::CLEAN_TOOLBAR.icon());
+    m_clearButton->setToolTip(tr("Clear"));
+    connect(m_clearButton, &QToolButton::clicked, this, &GhciOutputPane::clearContents);
+
+    connect(m_pool, &GhciSessionPool::sessionAdded, this, &GhciOutputPane::updateSessionBox);
+    connect(m_pool, &GhciSessionPool::sessionRemoved, this, [this](GhciSession *session) {
+        if (session == m_session) {
+            appendText(tr("GHCi session %1 closed.\n").arg(session->displayName()));
+            setCurrentSession(nullptr);
+        }
+        updateSessionBox();
+    });
+}
+
+GhciOutputPane::~GhciOutputPane()
+{
+    delete m_widget;
+    m_instance = nullptr;
+}
+
+GhciOutputPane *GhciOutputPane::instance()
+{
+    return m_instance;
+}
+
+GhciSession *GhciOutputPane::activateSession(const Utils::FilePath &projectDirectory,
+                                             const QString &component)
+{
+    GhciSession *session = m_pool->session(projectDirectory, component);
+    setCurrentSession(session);
+    updateSessionBox();
+    return session;
+}
+
+GhciSession *GhciOutputPane::session(const Utils::FilePath &projectDirectory,
+                                     const QString &component)
+{
+    return m_pool->session(projectDirectory, component);
+}
+
+void GhciOutputPane::setCurrentSession(GhciSession *session)
+{
+    if (session == m_session)
+        return;
+    if (m_session)
+        m_session->disconnect(this);
+    m_session = session;
+    if (m_session) {
+        connect(m_session, &GhciSession::outputReceived, this, &GhciOutputPane::appendText);
+        connect(m_session, &GhciSession::errorReceived, this, &GhciOutputPane::appendText);
+    }
+    updateSessionBox();
+}
+
+QWidget *GhciOutputPane::outputWidget(QWidget *parent)
+{
+    m_widget->setParent(parent);
+    return m_widget;
+}
+
+QList<QWidget *> GhciOutputPane::toolBarWidgets() const
+{
+    return {m_sessionBox, m_clearButton};
+}
+
+QString GhciOutputPane::displayName() const
+{
+    return tr("GHCi");
+}
+
+int GhciOutputPane::priorityInStatusBar() const
+{
+    return 10;
+}
+
+void GhciOutputPane::clearContents()
+{
+    m_output->clear();
+}
+
+void GhciOutputPane::setFocus()
+{
+    m_input->setFocus();
+}
+
+bool GhciOutputPane::hasFocus() const
+{
+    return m_input->hasFocus() || m_output->hasFocus();
+}
+
+bool GhciOutputPane::canFocus() const
+{
+    return true;
+}
+
+bool GhciOutputPane::canNavigate() const
+{
+    return false;
+}
+
+bool GhciOutputPane::canNext() const
+{
+    return false;
+}
+
+bool GhciOutputPane::canPrevious() const
+{
+    return false;
+}
+
+void GhciOutputPane::goToNext()
+{
+}
+
+void GhciOutputPane::goToPrev()
+{
+}
+
+void GhciOutputPane::appendText(const QString &text)
+{
+    QScrollBar *scrollBar = m_output->verticalScrollBar();
+    const bool atEnd = scrollBar->value() == scrollBar->maximum();
+    QTextCursor cursor(m_output->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text);
+    if (atEnd)
+        scrollBar->setValue(scrollBar->maximum());
+}
+
+void GhciOutputPane::sendInput()
+{
+    const QString command = m_input->text();
+    m_input->clear();
+    if (!m_session) {
+        appendText(tr("No GHCi session. Use \"Run GHCi\" to start one.\n"));
+        return;
+    }
+    appendText("> " + command + '\n');
+    m_session->enqueue(command);
+}
+
+void GhciOutputPane::updateSessionBox()
+{
+    const QList<GhciSession *> sessions = m_pool->sessions();
+    m_sessionBox->clear();
+    for (GhciSession *session : sessions)
+        m_sessionBox->addItem(session->displayName());
+    m_sessionBox->setCurrentIndex(sessions.indexOf(m_session));
+    m_sessionBox->setEnabled(!sessions.isEmpty());
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <coreplugin/ioutputpane.h>
+
+#include <utils/filepath.h>
+
+#include <QPointer>
+
+QT_BEGIN_NAMESPACE
+class QComboBox;
+class QLineEdit;
+class QPlainTextEdit;
+class QToolButton;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+class GhciSession;
+class GhciSessionPool;
+
+class GhciOutputPane : public Core::IOutputPane
+{
+    Q_OBJECT
+
+public:
+    explicit GhciOutputPane(GhciSessionPool *pool);
+    ~GhciOutputPane() override;
+
+    static GhciOutputPane *instance();
+
+    // Reuses or starts the session for the project and component and makes it current.
+    GhciSession *activateSession(const Utils::FilePath &projectDirectory, const QString &component);
+    // Like activateSession, but keeps the current session.
+    GhciSession *session(const Utils::FilePath &projectDirectory, const QString &component);
+    void setCurrentSession(GhciSession *session);
+    GhciSession *currentSession() const { return m_session; }
+
+    QWidget *outputWidget(QWidget *parent) override;
+    QList<QWidget *> toolBarWidgets() const override;
+    QString displayName() const override;
+    int priorityInStatusBar() const override;
+    void clearContents() override;
+    void setFocus() override;
+    bool hasFocus() const override;
+    bool canFocus() const override;
+    bool canNavigate() const override;
+    bool canNext() const override;
+    bool canPrevious() const override;
+    void goToNext() override;
+    void goToPrev() override;
+
+private:
+    void appendText(const QString &text);
+    void sendInput();
+    void updateSessionBox();
+
+    GhciSessionPool *m_pool;
+    QPointer<GhciSession> m_session;
+    QWidget *m_widget;
+    QPlainTextEdit *m_output;
+    QLineEdit *m_input;
+    QComboBox *m_sessionBox;
+    QToolButton *m_clearButton;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "ghciprotocol.h"
+
+static const QChar kSentinelStart(0x01);
+static const QChar kSentinelEnd(0x02);
+static const QLatin1String kSentinelTag("qtc-ghci:");
+
+namespace Haskell {
+namespace Internal {
+
+QString GhciProtocol::encode(int id, const QString &command)
+{
+    m_pending.append(id);
+    // \SOH and \STX are the Haskell escapes for kSentinelStart and kSentinelEnd
+    const QString marker = "\"\\SOH" + kSentinelTag + QString::number(id) + "\\STX\"";
+    QString result = command.contains('\n') ? ":{\n" + command + "\n:}\n" : command + '\n';
+    result += "System.IO.putStrLn " + marker + '\n';
+    result += "System.IO.hPutStrLn System.IO.stderr " + marker + '\n';
+    return result;
+}
+
+QList<GhciProtocol::Event> GhciProtocol::feed(Channel channel, const QString &text)
+{
+    ChannelState &state = channel == Channel::StdOut ? m_stdOut : m_stdErr;
+    const Event::Kind kind = channel == Channel::StdOut ? Event::Kind::Output
+                                                        : Event::Kind::ErrorOutput;
+    const auto currentId = [this, &state] {
+        return state.position < m_pending.size() ? m_pending.at(state.position) : -1;
+    };
+
+    QList<Event> events;
+    state.buffer.append(text);
+    if (state.skipLineEnd) {
+        // the line end that terminated the last sentinel arrived with this chunk
+        int skip = 0;
+        while (skip < state.buffer.size() && skip < 2
+               && (state.buffer.at(skip) == '\r' || state.buffer.at(skip) == '\n')) {
+            ++skip;
+        }
+        state.buffer.remove(0, skip);
+        state.skipLineEnd = state.buffer.isEmpty();
+    }
+
+    int start;
+    while ((start = state.buffer.indexOf(kSentinelStart)) >= 0) {
+        const int end = state.buffer.indexOf(kSentinelEnd, start);
+        if (end < 0)
+            break;
+        if (start > 0)
+            events.append({kind, currentId(), state.buffer.left(start)});
+        const QStringView sentinel = QStringView(state.buffer).mid(start + 1, end - start - 1);
+        bool ok = false;
+        const int id = sentinel.startsWith(kSentinelTag)
+                           ? sentinel.mid(kSentinelTag.size()).toInt(&ok)
+                           : -1;
+        int removeUntil = end + 1;
+        if (removeUntil < state.buffer.size() && state.buffer.at(removeUntil) == '\r')
+            ++removeUntil;
+        if (removeUntil < state.buffer.size() && state.buffer.at(removeUntil) == '\n')
+            ++removeUntil;
+        state.skipLineEnd = removeUntil == state.buffer.size();
+        state.buffer.remove(0, removeUntil);
+        if (ok) {
+            const int index = m_pending.indexOf(id, state.position);
+            if (index >= 0)
+                state.position = index + 1;
+        }
+        finishRequests(&events);
+    }
+
+    // Pass on everything that cannot be part of a sentinel, keep the rest for the next chunk
+    const int keep = start >= 0 ? state.buffer.size() - start : 0;
+    if (state.buffer.size() > keep) {
+        events.append({kind, currentId(), state.buffer.left(state.buffer.size() - keep)});
+        state.buffer.remove(0, state.buffer.size() - keep);
+    }
+    return events;
+}
+
+void GhciProtocol::reset()
+{
+    m_pending.clear();
+    m_stdOut = {};
+    m_stdErr = {};
+}
+
+QString GhciProtocol::sentinel(int id)
+{
+    return kSentinelStart + kSentinelTag + QString::number(id) + kSentinelEnd;
+}
+
+void GhciProtocol::finishRequests(QList<Event> *events)
+{
+    // a request is answered when both channels have seen its sentinel
+    while (m_stdOut.position > 0 && m_stdErr.position > 0) {
+        events->append({Event::Kind::Finished, m_pending.takeFirst(), {}});
+        --m_stdOut.position;
+        --m_stdErr.position;
+    }
+}
+
+} // namespace Internal
+} // namespace Haskell
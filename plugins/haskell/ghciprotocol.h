@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+namespace Haskell {
+namespace Internal {
+
+// Pipelines requests to GHCi over stdin. Every request is followed by statements that print a
+// sentinel with the request's id to stdout and stderr, so any number of requests can be written
+// at once, and their output is attributed to them when it comes back, in order.
+class GhciProtocol
+{
+public:
+    enum class Channel { StdOut, StdErr };
+
+    class Event
+    {
+    public:
+        enum class Kind { Output, ErrorOutput, Finished };
+
+        Kind kind = Kind::Output;
+        int id = -1; // -1 for output that doesn't belong to a request, e.g. while loading
+        QString text;
+    };
+
+    // Returns the text that needs to be written to GHCi's stdin for the request.
+    QString encode(int id, const QString &command);
+    QList<Event> feed(Channel channel, const QString &text);
+    bool hasPendingRequests() const { return !m_pending.isEmpty(); }
+    void reset();
+
+    static QString sentinel(int id);
+
+private:
+    class ChannelState
+    {
+    public:
+        QString buffer;
+        int position = 0; // index into m_pending of the request this channel is answering
+        bool skipLineEnd = false;
+    };
+
+    void finishRequests(QList<Event> *events);
+
+    QList<int> m_pending;
+    ChannelState m_stdOut;
+    ChannelState m_stdErr;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,282 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "ghcisession.h"
+
+#include "haskellmanager.h"
+
+#include <utils/algorithm.h>
+#include <utils/processenums.h>
+#include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
+
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+GhciSession::GhciSession(const FilePath &projectDirectory, const QString &component,
+                         QObject *parent)
+    : QObject(parent)
+    , m_projectDirectory(projectDirectory)
+    , m_component(component)
+{
+    m_lastUsed.start();
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &GhciSession::flush);
+}
+
+GhciSession::~GhciSession()
+{
+    if (m_process) {
+        // don't let the process report anything back while we are being destroyed
+        m_process->disconnect(this);
+        m_process->setStdOutCallback({});
+        m_process->setStdErrCallback({});
+        m_process->stop();
+        m_process->waitForFinished(1000);
+    }
+}
+
+QString GhciSession::displayName() const
+{
+    const QString project = m_projectDirectory.fileName();
+    return m_component.isEmpty() ? project : project + ':' + m_component;
+}
+
+void GhciSession::start()
+{
+    QTC_ASSERT(!m_process, return);
+    m_ready = false;
+    m_protocol.reset();
+    m_requests.clear();
+    m_loadedFile.clear();
+    m_loadedTimestamp = {};
+    m_process.reset(new QtcProcess);
+    m_process->setProcessMode(ProcessMode::Writer);
+    QStringList args{"ghci"};
+    if (!m_component.isEmpty())
+        args << m_component;
+    m_process->setCommand({HaskellManager::stackExecutable(), args});
+    m_process->setWorkingDirectory(m_projectDirectory);
+    m_process->setStdOutCallback([this](const QString &text) {
+        handleOutput(GhciProtocol::Channel::StdOut, text);
+    });
+    m_process->setStdErrCallback([this](const QString &text) {
+        handleOutput(GhciProtocol::Channel::StdErr, text);
+    });
+    connect(m_process.get(), &QtcProcess::started, this, &GhciSession::flush);
+    connect(m_process.get(), &QtcProcess::done, this, [this] {
+        if (m_process->result() != ProcessResult::FinishedWithSuccess)
+            emit errorReceived(tr("GHCi exited: \"%1\".\n").arg(m_process->errorString()));
+        m_ready = false;
+        m_protocol.reset();
+        m_requests.clear();
+        emit finished();
+    });
+
+    // GHCi reads this after loading the project, so the answer tells us that it is ready.
+    // +c collects the types of the modules that are loaded later, for :type-at.
+    m_readyId = m_nextId++;
+    m_requests.insert(m_readyId, {});
+    m_writeBuffer = ":set prompt-cont \"\"\n:set +c\n"
+                    + m_protocol.encode(m_readyId, ":set prompt \"\"");
+    m_process->start();
+}
+
+bool GhciSession::isRunning() const
+{
+    return m_process && m_process->state() != QProcess::NotRunning;
+}
+
+void GhciSession::enqueue(const QString &command, const ResponseHandler &handler)
+{
+    m_lastUsed.restart();
+    const int id = m_nextId++;
+    m_requests.insert(id, {handler, {}});
+    m_writeBuffer += m_protocol.encode(id, command);
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void GhciSession::loadFile(const FilePath &filePath)
+{
+    const auto reportErrors = [this](const Response &response) {
+        if (!response.errorOutput.isEmpty())
+            emit errorReceived(response.errorOutput);
+    };
+    m_loadedTimestamp = filePath.lastModified();
+    if (filePath == m_loadedFile) {
+        enqueue(":reload", reportErrors);
+        return;
+    }
+    m_loadedFile = filePath;
+    enqueue(":load \"" + filePath.toString() + '"', reportErrors);
+}
+
+bool GhciSession::isLoaded(const FilePath &filePath) const
+{
+    return filePath == m_loadedFile && filePath.lastModified() == m_loadedTimestamp;
+}
+
+qint64 GhciSession::idleMsecs() const
+{
+    if (m_protocol.hasPendingRequests())
+        return 0;
+    return m_lastUsed.elapsed();
+}
+
+qint64 GhciSession::residentMemory() const
+{
+    if (!isRunning())
+        return 0;
+#ifdef Q_OS_LINUX
+    QFile statm(QString("/proc/%1/statm").arg(m_process->processId()));
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1)
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+void GhciSession::handleOutput(GhciProtocol::Channel channel, const QString &text)
+{
+    for (const GhciProtocol::Event &event : m_protocol.feed(channel, text)) {
+        const auto request = m_requests.find(event.id);
+        // output of commands without handler and of GHCi itself is streamed
+        const bool stream = request == m_requests.end() || !request->handler;
+        switch (event.kind) {
+        case GhciProtocol::Event::Kind::Output:
+            if (stream)
+                emit outputReceived(event.text);
+            else
+                request->response.output += event.text;
+            break;
+        case GhciProtocol::Event::Kind::ErrorOutput:
+            if (stream)
+                emit errorReceived(event.text);
+            else
+                request->response.errorOutput += event.text;
+            break;
+        case GhciProtocol::Event::Kind::Finished: {
+            if (request == m_requests.end())
+                break;
+            const Request answered = m_requests.take(event.id);
+            m_lastUsed.restart();
+            if (event.id == m_readyId) {
+                m_ready = true;
+                emit ready();
+            } else {
+                if (answered.handler)
+                    answered.handler(answered.response);
+                emit commandFinished();
+            }
+            break;
+        }
+        }
+    }
+}
+
+void GhciSession::flush()
+{
+    if (m_writeBuffer.isEmpty() || !m_process || m_process->state() != QProcess::Running)
+        return;
+    m_process->write(m_writeBuffer);
+    m_writeBuffer.clear();
+}
+
+GhciSessionPool::GhciSessionPool(QObject *parent)
+    : QObject(parent)
+{
+    m_evictionTimer.setInterval(30 * 1000);
+    connect(&m_evictionTimer, &QTimer::timeout, this, &GhciSessionPool::evict);
+}
+
+GhciSession *GhciSessionPool::session(const FilePath &projectDirectory, const QString &component)
+{
+    GhciSession *session = Utils::findOrDefault(m_sessions, [&](GhciSession *s) {
+        return s->projectDirectory() == projectDirectory && s->component() == component;
+    });
+    if (session && session->isRunning()) {
+        // most recently used sessions are at the end
+        m_sessions.removeOne(session);
+        m_sessions.append(session);
+        return session;
+    }
+    if (session)
+        remove(session);
+    session = new GhciSession(projectDirectory, component, this);
+    connect(session, &GhciSession::finished, this, [this, session] { remove(session); });
+    m_sessions.append(session);
+    emit sessionAdded(session);
+    session->start();
+    if (!m_evictionTimer.isActive())
+        m_evictionTimer.start();
+    evict();
+    return session;
+}
+
+void GhciSessionPool::evict()
+{
+    const QList<GhciSession *> idle = Utils::filtered(m_sessions, [this](GhciSession *s) {
+        return s->idleMsecs() > m_maximumIdleMsecs;
+    });
+    for (GhciSession *session : idle)
+        remove(session);
+
+    // evict least recently used sessions until we are below the memory limit,
+    // but always keep the most recently used one
+    qint64 memory = 0;
+    for (GhciSession *session : std::as_const(m_sessions))
+        memory += session->residentMemory();
+    while (memory > m_maximumMemory && m_sessions.size() > 1) {
+        GhciSession *session = m_sessions.first();
+        memory -= session->residentMemory();
+        remove(session);
+    }
+    if (m_sessions.isEmpty())
+        m_evictionTimer.stop();
+}
+
+void GhciSessionPool::remove(GhciSession *session)
+{
+    if (!m_sessions.removeOne(session))
+        return;
+    emit sessionRemoved(session);
+    session->disconnect(this);
+    session->deleteLater();
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "ghciprotocol.h"
+
+#include <utils/filepath.h>
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+
+namespace Utils { class QtcProcess; }
+
+namespace Haskell {
+namespace Internal {
+
+class GhciSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    GhciSession(const Utils::FilePath &projectDirectory, const QString &component,
+                QObject *parent = nullptr);
+    ~GhciSession() override;
+
+    Utils::FilePath projectDirectory() const { return m_projectDirectory; }
+    QString component() const { return m_component; }
+    QString displayName() const;
+
+    class Response
+    {
+    public:
+        QString output;
+        QString errorOutput;
+    };
+    using ResponseHandler = std::function<void(const Response &)>;
+
+    void start();
+    bool isRunning() const;
+    bool isReady() const { return m_ready; }
+    bool isBusy() const { return !m_ready || m_protocol.hasPendingRequests(); }
+
+    // Commands are collected and written to GHCi together at the next event loop iteration,
+    // without waiting for the answers to previous commands.
+    // Output of commands without handler is streamed with outputReceived and errorReceived.
+    void enqueue(const QString &command, const ResponseHandler &handler = {});
+    // Loads the file, or reloads it if it is the one that was loaded last.
+    void loadFile(const Utils::FilePath &filePath);
+    Utils::FilePath loadedFile() const { return m_loadedFile; }
+    // Returns whether the file was loaded last and was not saved since.
+    bool isLoaded(const Utils::FilePath &filePath) const;
+
+    qint64 idleMsecs() const;
+    qint64 residentMemory() const;
+
+signals:
+    void outputReceived(const QString &text);
+    void errorReceived(const QString &text);
+    void ready();
+    void commandFinished();
+    void finished();
+
+private:
+    class Request
+    {
+    public:
+        ResponseHandler handler;
+        Response response;
+    };
+
+    void handleOutput(GhciProtocol::Channel channel, const QString &text);
+    void flush();
+
+    const Utils::FilePath m_projectDirectory;
+    const QString m_component;
+    std::unique_ptr<Utils::QtcProcess> m_process;
+    GhciProtocol m_protocol;
+    QHash<int, Request> m_requests;
+    QString m_writeBuffer;
+    QTimer m_flushTimer;
+    Utils::FilePath m_loadedFile;
+    QDateTime m_loadedTimestamp;
+    QElapsedTimer m_lastUsed;
+    int m_nextId = 0;
+    int m_readyId = -1;
+    bool m_ready = false;
+};
+
+class GhciSessionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GhciSessionPool(QObject *parent = nullptr);
+
+    // Returns a warm session for the project and component, starting one if necessary.
+    GhciSession *session(const Utils::FilePath &projectDirectory, const QString &component);
+    QList<GhciSession *> sessions() const { return m_sessions; }
+
+    void setMaximumIdleTime(int msecs) { m_maximumIdleMsecs = msecs; }
+    void setMaximumMemory(qint64 bytes) { m_maximumMemory = bytes; }
+
+signals:
+    void sessionAdded(GhciSession *session);
+    void sessionRemoved(GhciSession *session);
+
+private:
+    void evict();
+    void remove(GhciSession *session);
+
+    QList<GhciSession *> m_sessions;
+    QTimer m_evictionTimer;
+    int m_maximumIdleMsecs = 15 * 60 * 1000;
+    qint64 m_maximumMemory = qint64(4) * 1024 * 1024 * 1024;
+};
+
+} // namespace Internal
+} // namespace Haskell
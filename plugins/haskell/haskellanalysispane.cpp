@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellanalysispane.h"
+
+#include <utils/utilsicons.h>
+
+#include <QTabWidget>
+#include <QToolButton>
+
+namespace Haskell {
+namespace Internal {
+
+static HaskellAnalysisPane *m_instance = nullptr;
+static const char kResultId[] = "HaskellAnalysisResultId";
+
+HaskellAnalysisPane::HaskellAnalysisPane()
+{
+    m_instance = this;
+
+    m_tabWidget = new QTabWidget;
+    m_tabWidget->setDocumentMode(true);
+    m_tabWidget->setTabsClosable(true);
+    m_tabWidget->setMovable(true);
+    connect(m_tabWidget, &QTabWidget::tabCloseRequested, this, &HaskellAnalysisPane::closeTab);
+
+    m_clearButton = new QToolButton;
+    m_clearButton->setIcon(Utils::Icons::CLEAN_TOOLBAR.icon());
+    m_clearButton->setToolTip(tr("Close All Results"));
+    connect(m_clearButton, &QToolButton::clicked, this, &HaskellAnalysisPane::clearContents);
+}
+
+HaskellAnalysisPane::~HaskellAnalysisPane()
+{
+    delete m_tabWidget;
+    m_instance = nullptr;
+}
+
+HaskellAnalysisPane *HaskellAnalysisPane::instance()
+{
+    return m_instance;
+}
+
+void HaskellAnalysisPane::showResult(const QString &id, const QString &title, QWidget *widget)
+{
+    widget->setProperty(kResultId, id);
+    const int index = tabIndex(id);
+    if (index >= 0 && m_tabWidget->widget(index) == widget) {
+        m_tabWidget->setTabText(index, title);
+    } else if (index >= 0) {
+        QWidget *old = m_tabWidget->widget(index);
+        m_tabWidget->removeTab(index);
+        delete old;
+        m_tabWidget->insertTab(index, widget, title);
+    } else {
+        m_tabWidget->addTab(widget, title);
+    }
+    m_tabWidget->setCurrentWidget(widget);
+    popup(NoModeSwitch);
+}
+
+QWidget *HaskellAnalysisPane::result(const QString &id) const
+{
+    const int index = tabIndex(id);
+    return index >= 0 ? m_tabWidget->widget(index) : nullptr;
+}
+
+QWidget *HaskellAnalysisPane::outputWidget(QWidget *parent)
+{
+    m_tabWidget->setParent(parent);
+    return m_tabWidget;
+}
+
+QList<QWidget *> HaskellAnalysisPane::toolBarWidgets() const
+{
+    return {m_clearButton};
+}
+
+QString HaskellAnalysisPane::displayName() const
+{
+    return tr("Haskell Analysis");
+}
+
+int HaskellAnalysisPane::priorityInStatusBar() const
+{
+    return 5;
+}
+
+void HaskellAnalysisPane::clearContents()
+{
+    while (m_tabWidget->count() > 0)
+        closeTab(0);
+}
+
+void HaskellAnalysisPane::setFocus()
+{
+    if (QWidget *widget = m_tabWidget->currentWidget())
+        widget->setFocus();
+}
+
+bool HaskellAnalysisPane::hasFocus() const
+{
+    return m_tabWidget->isAncestorOf(m_tabWidget->focusWidget());
+}
+
+bool HaskellAnalysisPane::canFocus() const
+{
+    return m_tabWidget->count() > 0;
+}
+
+bool HaskellAnalysisPane::canNavigate() const
+{
+    return false;
+}
+
+bool HaskellAnalysisPane::canNext() const
+{
+    return false;
+}
+
+bool HaskellAnalysisPane::canPrevious() const
+{
+    return false;
+}
+
+void HaskellAnalysisPane::goToNext()
+{
+}
+
+void HaskellAnalysisPane::goToPrev()
+{
+}
+
+int HaskellAnalysisPane::tabIndex(const QString &id) const
+{
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        if (m_tabWidget->widget(i)->property(kResultId).toString() == id)
+            return i;
+    }
+    return -1;
+}
+
+void HaskellAnalysisPane::closeTab(int index)
+{
+    QWidget *widget = m_tabWidget->widget(index);
+    m_tabWidget->removeTab(index);
+    delete widget;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <coreplugin/ioutputpane.h>
+
+QT_BEGIN_NAMESPACE
+class QTabWidget;
+class QToolButton;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+// Shows the results of profiling and other analysis runs, one tab per result.
+class HaskellAnalysisPane : public Core::IOutputPane
+{
+    Q_OBJECT
+
+public:
+    HaskellAnalysisPane();
+    ~HaskellAnalysisPane() override;
+
+    static HaskellAnalysisPane *instance();
+
+    // Takes ownership of the widget. Replaces the tab with the same id, if any, unless it
+    // already shows the widget.
+    void showResult(const QString &id, const QString &title, QWidget *widget);
+    QWidget *result(const QString &id) const;
+
+    QWidget *outputWidget(QWidget *parent) override;
+    QList<QWidget *> toolBarWidgets() const override;
+    QString displayName() const override;
+    int priorityInStatusBar() const override;
+    void clearContents() override;
+    void setFocus() override;
+    bool hasFocus() const override;
+    bool canFocus() const override;
+    bool canNavigate() const override;
+    bool canNext() const override;
+    bool canPrevious() const override;
+    void goToNext() override;
+    void goToPrev() override;
+
+private:
+    int tabIndex(const QString &id) const;
+    void closeTab(int index);
+
+    QTabWidget *m_tabWidget;
+    QToolButton *m_clearButton;
+};
+
+} // namespace Internal
+} // namespace Haskell
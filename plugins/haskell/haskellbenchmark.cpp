@@ -0,0 +1,252 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "haskellbenchmark.h"
+
+#include "benchmarkresults.h"
+#include "benchmarkview.h"
+#include "haskellanalysispane.h"
+#include "haskellconstants.h"
+#include "haskellmanager.h"
+#include "haskellrunconfiguration.h"
+
+#include <coreplugin/messagemanager.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/localenvironmentaspect.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/runconfigurationaspects.h>
+#include <projectexplorer/target.h>
+#include <utils/algorithm.h>
+#include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+static const char benchmarkInfix[] = ":bench:";
+
+QString benchmarkBuildKey(const QString &package, const QString &benchmark)
+{
+    return package + benchmarkInfix + benchmark;
+}
+
+bool isBenchmarkBuildKey(const QString &buildKey)
+{
+    return buildKey.contains(benchmarkInfix);
+}
+
+static QString benchmarkName(const QString &buildKey)
+{
+    return buildKey.mid(buildKey.lastIndexOf(':') + 1);
+}
+
+// package names can't contain dots, so "package.benchmark" is unique
+static QString benchmarkFileName(const QString &buildKey)
+{
+    return "qtc-benchmark-" + QString(buildKey).replace(benchmarkInfix, ".");
+}
+
+static FilePath buildDirectory(const Target *target)
+{
+    if (BuildConfiguration *bc = target->activeBuildConfiguration())
+        return bc->buildDirectory();
+    return target->project()->projectDirectory().pathAppended(".stack-work");
+}
+
+HaskellBenchmarkRunConfiguration::HaskellBenchmarkRunConfiguration(Target *target, Utils::Id id)
+    : RunConfiguration(target, id)
+{
+    auto envAspect = addAspect<LocalEnvironmentAspect>(target);
+
+    auto benchmarkAspect = addAspect<HaskellExecutableAspect>();
+    benchmarkAspect->setLabelText(tr("Benchmark"));
+    auto argumentsAspect = addAspect<ArgumentsAspect>(macroExpander());
+    argumentsAspect->setLabelText(tr("Benchmark arguments:"));
+
+    auto workingDirAspect = addAspect<WorkingDirectoryAspect>(macroExpander(), envAspect);
+    workingDirAspect->setDefaultWorkingDirectory(target->project()->projectDirectory());
+    workingDirAspect->setVisible(false);
+
+    setUpdater([this] { aspect<HaskellExecutableAspect>()->setValue(buildTargetInfo().buildKey); });
+    connect(target, &Target::buildSystemUpdated, this, &RunConfiguration::update);
+    update();
+}
+
+FilePath HaskellBenchmarkRunConfiguration::resultsFile(const Target *target,
+                                                       const QString &buildKey)
+{
+    return buildDirectory(target).pathAppended(benchmarkFileName(buildKey) + ".csv");
+}
+
+FilePath HaskellBenchmarkRunConfiguration::historyFile(const Target *target,
+                                                       const QString &buildKey)
+{
+    return buildDirectory(target).pathAppended(benchmarkFileName(buildKey) + "-history.json");
+}
+
+Runnable HaskellBenchmarkRunConfiguration::runnable() const
+{
+    const FilePath projectDirectory = target()->project()->projectDirectory();
+    const QString buildKey = aspect<HaskellExecutableAspect>()->value();
+    Runnable r;
+    r.workingDirectory = projectDirectory;
+    r.environment = aspect<LocalEnvironmentAspect>()->environment();
+
+    // criterion and tasty-bench both understand --csv
+    QString benchmarkArguments = aspect<ArgumentsAspect>()->arguments();
+    if (!benchmarkArguments.isEmpty())
+        benchmarkArguments += ' ';
+    benchmarkArguments += "--csv \"" + resultsFile(target(), buildKey).toString() + '"';
+
+    QStringList args;
+    if (BuildConfiguration *buildConfiguration = target()->activeBuildConfiguration()) {
+        args << "--work-dir"
+             << QDir(projectDirectory.toString()).relativeFilePath(
+                    buildConfiguration->buildDirectory().toString());
+    }
+    args << "bench" << buildKey << "--benchmark-arguments" << benchmarkArguments;
+    r.command = {r.environment.searchInPath(HaskellManager::stackExecutable().toString()), args};
+    return r;
+}
+
+HaskellBenchmarkRunConfigurationFactory::HaskellBenchmarkRunConfigurationFactory()
+{
+    registerRunConfiguration<HaskellBenchmarkRunConfiguration>(
+        Constants::C_HASKELL_BENCHMARK_RUNCONFIG_ID);
+    addSupportedProjectType(Constants::C_HASKELL_PROJECT_ID);
+    addSupportedTargetDeviceType(ProjectExplorer::Constants::DESKTOP_DEVICE_TYPE);
+}
+
+QList<RunConfigurationCreationInfo> HaskellBenchmarkRunConfigurationFactory::availableCreators(
+    Target *target) const
+{
+    return Utils::filtered(RunConfigurationFactory::availableCreators(target),
+                           [](const RunConfigurationCreationInfo &info) {
+                               return isBenchmarkBuildKey(info.buildKey);
+                           });
+}
+
+HaskellBenchmarkRunner::HaskellBenchmarkRunner(RunControl *runControl)
+    : SimpleTargetRunner(runControl)
+{
+    setId("HaskellBenchmarkRunner");
+    setStartModifier([this] {
+        const auto benchmark = this->runControl()->aspect<HaskellExecutableAspect>();
+        QTC_ASSERT(benchmark, return);
+        m_buildKey = benchmark->value;
+        m_startTime = QDateTime::currentDateTime();
+        startGit();
+        // don't show the results of an earlier run if this one fails
+        HaskellBenchmarkRunConfiguration::resultsFile(this->runControl()->target(), m_buildKey)
+            .removeFile();
+    });
+    connect(runControl, &RunControl::stopped, this, [this] {
+        m_resultsPending = bool(m_git);
+        if (!m_resultsPending)
+            loadResults();
+    });
+}
+
+HaskellBenchmarkRunner::~HaskellBenchmarkRunner() = default;
+
+void HaskellBenchmarkRunner::startGit()
+{
+    // the results are labeled with the commit, looked up while the benchmark runs
+    m_commit.clear();
+    m_resultsPending = false;
+    m_git.reset(new QtcProcess);
+    m_git->setCommand({FilePath::fromString("git"), {"describe", "--always", "--dirty"}});
+    m_git->setWorkingDirectory(runControl()->project()->projectDirectory());
+    connect(m_git.get(), &QtcProcess::done, this, [this] {
+        if (m_git->result() == ProcessResult::FinishedWithSuccess)
+            m_commit = m_git->stdOut().trimmed();
+        m_git.release()->deleteLater();
+        if (m_resultsPending) {
+            m_resultsPending = false;
+            loadResults();
+        }
+    });
+    m_git->start();
+    // the results wait for it, don't let a hanging git keep them back
+    QtcProcess *git = m_git.get();
+    QTimer::singleShot(5000, git, [git] { git->kill(); });
+}
+
+void HaskellBenchmarkRunner::loadResults()
+{
+    HaskellAnalysisPane *pane = HaskellAnalysisPane::instance();
+    QTC_ASSERT(pane, return);
+    if (m_buildKey.isEmpty() || !m_startTime.isValid())
+        return;
+    const Target *target = runControl()->target();
+    const FilePath resultsFile = HaskellBenchmarkRunConfiguration::resultsFile(target, m_buildKey);
+    if (!resultsFile.exists())
+        return;
+    BenchmarkRun run;
+    run.commit = m_commit;
+    run.timestamp = m_startTime;
+    QString errorString;
+    QFile file(resultsFile.toString());
+    if (!file.open(QIODevice::ReadOnly))
+        errorString = file.errorString();
+    if (!file.isOpen() || !parseBenchmarkCsv(file.readAll(), &run.results, &errorString)) {
+        Core::MessageManager::writeFlashing(tr("Cannot read benchmark results %1: %2")
+                                                .arg(resultsFile.toUserOutput(), errorString));
+        return;
+    }
+
+    const FilePath historyFile = HaskellBenchmarkRunConfiguration::historyFile(target, m_buildKey);
+    BenchmarkHistory history;
+    if (!history.load(historyFile.toString(), &errorString)) {
+        Core::MessageManager::writeFlashing(tr("Cannot read benchmark history %1: %2")
+                                                .arg(historyFile.toUserOutput(), errorString));
+    }
+    const int runIndex = history.addRun(run);
+    if (!history.save(historyFile.toString(), &errorString)) {
+        Core::MessageManager::writeFlashing(tr("Cannot write benchmark history %1: %2")
+                                                .arg(historyFile.toUserOutput(), errorString));
+    }
+    const QString name = benchmarkName(m_buildKey);
+    pane->showResult("benchmark:" + m_buildKey,
+                     tr("Benchmark: %1").arg(name),
+                     new BenchmarkView(history, runIndex));
+}
+
+HaskellBenchmarkRunnerFactory::HaskellBenchmarkRunnerFactory()
+{
+    setProduct<HaskellBenchmarkRunner>();
+    addSupportedRunMode(ProjectExplorer::Constants::NORMAL_RUN_MODE);
+    addSupportedRunConfig(Constants::C_HASKELL_BENCHMARK_RUNCONFIG_ID);
+}
+
+} // namespace Internal
+} // namespace Haskell
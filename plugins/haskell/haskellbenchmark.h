@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#pragma once
+
+#include <projectexplorer/runconfiguration.h>
+#include <projectexplorer/runcontrol.h>
+
+#include <QDateTime>
+
+#include <memory>
+
+namespace Utils { class QtcProcess; }
+
+namespace Haskell {
+namespace Internal {
+
+// Benchmark components are application targets with build keys like "package:bench:name", the
+// stack target that builds and runs them.
+QString benchmarkBuildKey(const QString &package, const QString &benchmark);
+bool isBenchmarkBuildKey(const QString &buildKey);
+
+class HaskellBenchmarkRunConfiguration : public ProjectExplorer::RunConfiguration
+{
+    Q_OBJECT
+
+public:
+    HaskellBenchmarkRunConfiguration(ProjectExplorer::Target *target, Utils::Id id);
+
+    // The benchmark writes its results to the first, they are collected in the second. Both are
+    // named after the package and the benchmark.
+    static Utils::FilePath resultsFile(const ProjectExplorer::Target *target,
+                                       const QString &buildKey);
+    static Utils::FilePath historyFile(const ProjectExplorer::Target *target,
+                                       const QString &buildKey);
+
+private:
+    ProjectExplorer::Runnable runnable() const final;
+};
+
+class HaskellBenchmarkRunConfigurationFactory : public ProjectExplorer::RunConfigurationFactory
+{
+public:
+    HaskellBenchmarkRunConfigurationFactory();
+
+protected:
+    QList<ProjectExplorer::RunConfigurationCreationInfo> availableCreators(
+        ProjectExplorer::Target *target) const override;
+};
+
+// Runs a criterion or tasty-bench benchmark with --csv, adds the results to the history of the
+// benchmark and shows them compared with a previous run.
+class HaskellBenchmarkRunner : public ProjectExplorer::SimpleTargetRunner
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellBenchmarkRunner(ProjectExplorer::RunControl *runControl);
+    ~HaskellBenchmarkRunner() override;
+
+private:
+    void startGit();
+    void loadResults();
+
+    QString m_buildKey;
+    QString m_commit;
+    QDateTime m_startTime;
+    std::unique_ptr<Utils::QtcProcess> m_git;
+    bool m_resultsPending = false; // the benchmark stopped before "git describe" finished
+};
+
+class HaskellBenchmarkRunnerFactory : public ProjectExplorer::RunWorkerFactory
+{
+public:
+    HaskellBenchmarkRunnerFactory();
+};
+
+} // namespace Internal
+} // namespace Haskell
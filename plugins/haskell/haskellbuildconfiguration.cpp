@@ -26,6 +26,7 @@
 #include "haskellbuildconfiguration.h"
 
 #include "haskellconstants.h"
+#include "haskellmanager.h"
 #include "haskellproject.h"
 
 #include <projectexplorer/buildinfo.h>
@@ -38,7 +39,9 @@
 #include <utils/mimeutils.h>
 #include <utils/pathchooser.h>
 #include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
 
+#include <QDir>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QVBoxLayout>
@@ -78,8 +81,24 @@ HaskellBuildConfiguration::HaskellBuildConfiguration(Target *target, Utils::Id i
         setDisplayName(info.displayName);
     });
     appendInitialBuildStep(Constants::C_STACK_BUILD_STEP_ID);
+    appendInitialCleanStep(Constants::C_STACK_CLEAN_STEP_ID);
+
+    // the paths of builds before are wrong after these changes
+    connect(this, &BuildConfiguration::buildDirectoryChanged,
+            this, &HaskellBuildConfiguration::invalidateStackPaths);
+    connect(this, &BuildConfiguration::environmentChanged,
+            this, &HaskellBuildConfiguration::invalidateStackPaths);
+    m_stackYamlWatcher.addFile(
+        target->project()->projectDirectory().pathAppended("stack.yaml").toString(),
+        Utils::FileSystemWatcher::WatchModifiedDate);
+    connect(&m_stackYamlWatcher, &Utils::FileSystemWatcher::fileChanged,
+            this, &HaskellBuildConfiguration::invalidateStackPaths);
+    connect(target, &Target::buildSystemUpdated,
+            this, &HaskellBuildConfiguration::updateStackPaths);
 }
 
+HaskellBuildConfiguration::~HaskellBuildConfiguration() = default;
+
 NamedWidget *HaskellBuildConfiguration::createConfigWidget()
 {
     return new HaskellBuildConfigurationWidget(this);
@@ -95,6 +114,45 @@ void HaskellBuildConfiguration::setBuildType(BuildConfiguration::BuildType type)
     m_buildType = type;
 }
 
+void HaskellBuildConfiguration::updateStackPaths()
+{
+    if (m_stackPathsProcess) {
+        m_stackPathsOutdated = true;
+        return;
+    }
+    m_stackPathsOutdated = false;
+    const Utils::FilePath projectDirectory = project()->projectDirectory();
+    const QString workDir = QDir(projectDirectory.toString())
+                                .relativeFilePath(buildDirectory().toString());
+    m_stackPathsProcess.reset(new Utils::QtcProcess);
+    m_stackPathsProcess->setEnvironment(environment());
+    m_stackPathsProcess->setWorkingDirectory(projectDirectory);
+    m_stackPathsProcess->setCommand({HaskellManager::stackExecutable(),
+                                     QStringList{"--work-dir", workDir} + StackPaths::arguments()});
+    connect(m_stackPathsProcess.get(), &Utils::QtcProcess::done, this, [this] {
+        // a failure is kept as well, until the next parse or build
+        const StackPaths paths
+            = m_stackPathsProcess->result() == Utils::ProcessResult::FinishedWithSuccess
+                  ? StackPaths::fromOutput(m_stackPathsProcess->stdOut())
+                  : StackPaths();
+        m_stackPathsProcess.release()->deleteLater();
+        if (m_stackPathsOutdated) {
+            updateStackPaths();
+            return;
+        }
+        m_stackPaths = paths;
+        emit stackPathsChanged();
+    });
+    m_stackPathsProcess->start();
+}
+
+void HaskellBuildConfiguration::invalidateStackPaths()
+{
+    m_stackPaths = {};
+    emit stackPathsChanged();
+    updateStackPaths();
+}
+
 HaskellBuildConfigurationWidget::HaskellBuildConfigurationWidget(HaskellBuildConfiguration *bc)
     : NamedWidget(tr("General"))
     , m_buildConfiguration(bc)
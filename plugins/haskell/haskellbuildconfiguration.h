@@ -25,8 +25,15 @@
 
 #pragma once
 
+#include "stackpaths.h"
+
 #include <projectexplorer/buildconfiguration.h>
 #include <projectexplorer/namedwidget.h>
+#include <utils/filesystemwatcher.h>
+
+#include <memory>
+
+namespace Utils { class QtcProcess; }
 
 namespace Haskell {
 namespace Internal {
@@ -43,13 +50,29 @@ class HaskellBuildConfiguration : public ProjectExplorer::BuildConfiguration
 
 public:
     HaskellBuildConfiguration(ProjectExplorer::Target *target, Utils::Id id);
+    ~HaskellBuildConfiguration() override;
 
     ProjectExplorer::NamedWidget *createConfigWidget() override;
     BuildType buildType() const override;
     void setBuildType(BuildType type);
 
+    // Returns the paths of the last "stack path", which is empty until it finished and if it
+    // failed. It runs in the background after parsing and building, and when the build
+    // directory, the build environment or stack.yaml changed.
+    StackPaths stackPaths() const { return m_stackPaths; }
+    void updateStackPaths();
+
+signals:
+    void stackPathsChanged();
+
 private:
+    void invalidateStackPaths();
+
     BuildType m_buildType = BuildType::Release;
+    StackPaths m_stackPaths;
+    std::unique_ptr<Utils::QtcProcess> m_stackPathsProcess;
+    bool m_stackPathsOutdated = false; // something changed while "stack path" ran
+    Utils::FileSystemWatcher m_stackYamlWatcher;
 };
 
 class HaskellBuildConfigurationWidget : public ProjectExplorer::NamedWidget
@@ -0,0 +1,165 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellcompletionassist.h"
+
+#include "haskellcompletionindexer.h"
+#include "literatehaskell.h"
+
+#include <texteditor/codeassist/assistinterface.h>
+#include <texteditor/codeassist/assistproposalitem.h>
+#include <texteditor/codeassist/genericproposal.h>
+#include <texteditor/completionsettings.h>
+#include <texteditor/texteditorsettings.h>
+#include <utils/codemodelicon.h>
+
+#include <QTextBlock>
+#include <QTextDocument>
+
+#include <algorithm>
+
+using namespace TextEditor;
+
+namespace Haskell {
+namespace Internal {
+
+// the lines around the cursor that are scanned for identifiers typed since the file was indexed
+static const int scannedLines = 200;
+
+static bool isIdentifierChar(const QChar c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '\'';
+}
+
+IAssistProcessor *HaskellCompletionAssistProvider::createProcessor(
+    const AssistInterface * /*assistInterface*/) const
+{
+    using namespace Utils;
+    static const QVector<QIcon> icons{CodeModelIcon::iconForType(CodeModelIcon::Keyword),
+                                      CodeModelIcon::iconForType(CodeModelIcon::VarPublic),
+                                      CodeModelIcon::iconForType(CodeModelIcon::FuncPublic)};
+    HaskellCompletionIndexer *indexer = HaskellCompletionIndexer::instance();
+    return new HaskellCompletionAssistProcessor(
+        indexer ? indexer->index() : CompletionIndex(),
+        icons,
+        TextEditorSettings::completionSettings().m_characterThreshold);
+}
+
+bool HaskellCompletionAssistProvider::isActivationCharSequence(const QString &sequence) const
+{
+    // for qualified names, the processor checks for the module before
+    return sequence == ".";
+}
+
+bool HaskellCompletionAssistProvider::isContinuationChar(const QChar &c) const
+{
+    return isIdentifierChar(c);
+}
+
+HaskellCompletionAssistProcessor::HaskellCompletionAssistProcessor(const CompletionIndex &index,
+                                                                   const QVector<QIcon> &icons,
+                                                                   int characterThreshold)
+    : m_index(index)
+    , m_icons(icons)
+    , m_characterThreshold(characterThreshold)
+{}
+
+IAssistProposal *HaskellCompletionAssistProcessor::performAsync()
+{
+    const AssistInterface *assist = interface();
+    const int position = assist->position();
+    int start = position;
+    while (start > 0 && isIdentifierChar(assist->characterAt(start - 1)))
+        --start;
+    const QString prefix = assist->textAt(start, position - start);
+    if (!prefix.isEmpty() && prefix.at(0).isDigit())
+        return nullptr;
+
+    // the module qualifier, like "Map." or "Data.Map."
+    int qualifierStart = start;
+    while (qualifierStart > 0 && assist->characterAt(qualifierStart - 1) == '.') {
+        int segmentStart = qualifierStart - 1;
+        while (segmentStart > 0 && isIdentifierChar(assist->characterAt(segmentStart - 1)))
+            --segmentStart;
+        if (segmentStart == qualifierStart - 1 || !assist->characterAt(segmentStart).isUpper())
+            break;
+        qualifierStart = segmentStart;
+    }
+    const QString qualifier = qualifierStart < start
+                                  ? assist->textAt(qualifierStart, start - 1 - qualifierStart)
+                                  : QString();
+    if (assist->reason() == ActivationCharacter && qualifier.isEmpty())
+        return nullptr; // composition with "."
+    if (assist->reason() == IdleEditor && qualifier.isEmpty()
+        && prefix.size() < m_characterThreshold) {
+        return nullptr;
+    }
+
+    ModuleSymbols file = m_index.module(assist->filePath().toString());
+    const QTextBlock block = assist->textDocument()->findBlock(position);
+    const bool literate = LiterateHaskell::isLiterateFile(assist->filePath().toString());
+    const int firstLine = std::max(0, block.blockNumber() - scannedLines);
+    QStringList lines;
+    // the copy of the document has no highlighter states, the lines before tell whether the
+    // lines of literate Haskell are in a code block
+    bool inCodeBlock = false;
+    for (QTextBlock current = literate ? assist->textDocument()->firstBlock()
+                                       : assist->textDocument()->findBlockByNumber(firstLine);
+         current.isValid() && current.blockNumber() <= block.blockNumber() + scannedLines;
+         current = current.next()) {
+        if (!literate) {
+            lines.append(current.text());
+            continue;
+        }
+        // the words of prose are not identifiers
+        const LiterateHaskell::LineType type = LiterateHaskell::lineType(current.text(),
+                                                                         inCodeBlock);
+        if (type == LiterateHaskell::LineType::CodeDelimiter)
+            inCodeBlock = !inCodeBlock;
+        if (current.blockNumber() >= firstLine)
+            lines.append(LiterateHaskell::code(current.text(), type));
+    }
+    QStringList identifiers;
+    const QStringList scanned = ModuleSymbols::identifiers(lines);
+    std::set_union(file.identifiers.cbegin(), file.identifiers.cend(),
+                   scanned.cbegin(), scanned.cend(), std::back_inserter(identifiers));
+    file.identifiers = identifiers;
+
+    QList<AssistProposalItemInterface *> items;
+    for (const CompletionCandidate &candidate : m_index.candidates(file, qualifier, prefix)) {
+        auto item = new AssistProposalItem;
+        item->setText(candidate.text);
+        item->setIcon(m_icons.value(candidate.kind));
+        if (!candidate.module.isEmpty())
+            item->setDetail(candidate.module);
+        items.append(item);
+    }
+    if (items.isEmpty())
+        return nullptr;
+    return new GenericProposal(start, items);
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "completionindex.h"
+
+#include <texteditor/codeassist/asyncprocessor.h>
+#include <texteditor/codeassist/completionassistprovider.h>
+
+#include <QIcon>
+
+namespace Haskell {
+namespace Internal {
+
+// Proposes keywords, the identifiers of the file and the top-level names of the imported project
+// modules, also after a module qualifier like "Map.".
+class HaskellCompletionAssistProvider : public TextEditor::CompletionAssistProvider
+{
+    Q_OBJECT
+
+public:
+    TextEditor::IAssistProcessor *createProcessor(
+        const TextEditor::AssistInterface *assistInterface) const override;
+
+    int activationCharSequenceLength() const override { return 1; }
+    bool isActivationCharSequence(const QString &sequence) const override;
+    bool isContinuationChar(const QChar &c) const override;
+};
+
+// Works with a copy of the index in a thread of its own.
+class HaskellCompletionAssistProcessor : public TextEditor::AsyncProcessor
+{
+public:
+    HaskellCompletionAssistProcessor(const CompletionIndex &index,
+                                     const QVector<QIcon> &icons,
+                                     int characterThreshold);
+
+    TextEditor::IAssistProposal *performAsync() override;
+
+private:
+    CompletionIndex m_index;
+    QVector<QIcon> m_icons; // by kind of candidate, made in the main thread
+    int m_characterThreshold;
+};
+
+} // namespace Internal
+} // namespace Haskell
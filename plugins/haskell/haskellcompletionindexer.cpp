@@ -0,0 +1,226 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellcompletionindexer.h"
+
+#include "haskellconstants.h"
+#include "literatehaskell.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/progressmanager/progressmanager.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/session.h>
+#include <texteditor/textdocument.h>
+#include <utils/runextensions.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+// collects the changes of a project or of typing
+static const int indexDelay = 1000;
+
+static HaskellCompletionIndexer *m_instance = nullptr;
+
+static void indexFiles(QFutureInterface<IndexedFile> &futureInterface,
+                       const QStringList &filePaths,
+                       const QHash<QString, QDateTime> &lastModified)
+{
+    futureInterface.setProgressRange(0, filePaths.size());
+    for (int i = 0; i < filePaths.size(); ++i) {
+        if (futureInterface.isCanceled())
+            return;
+        futureInterface.setProgressValue(i);
+        IndexedFile indexed;
+        indexed.filePath = filePaths.at(i);
+        indexed.lastModified = QFileInfo(indexed.filePath).lastModified();
+        if (indexed.lastModified == lastModified.value(indexed.filePath))
+            continue;
+        QFile file(indexed.filePath);
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        const QString source = QString::fromUtf8(file.readAll()).remove('\r');
+        indexed.symbols = ModuleSymbols::fromSource(
+            LiterateHaskell::isLiterateFile(indexed.filePath) ? LiterateHaskell::unlit(source)
+                                                              : source);
+        futureInterface.reportResult(indexed);
+    }
+}
+
+static void indexSource(QFutureInterface<ModuleSymbols> &futureInterface,
+                        const QString &source,
+                        bool literate)
+{
+    futureInterface.reportResult(
+        ModuleSymbols::fromSource(literate ? LiterateHaskell::unlit(source) : source));
+}
+
+HaskellCompletionIndexer::HaskellCompletionIndexer()
+{
+    m_instance = this;
+    m_projectTimer.setSingleShot(true);
+    m_projectTimer.setInterval(indexDelay);
+    connect(&m_projectTimer, &QTimer::timeout, this, &HaskellCompletionIndexer::indexProjects);
+    m_documentTimer.setSingleShot(true);
+    m_documentTimer.setInterval(indexDelay);
+    connect(&m_documentTimer, &QTimer::timeout, this, &HaskellCompletionIndexer::indexDocuments);
+
+    connect(&m_projectWatcher, &QFutureWatcherBase::resultsReadyAt,
+            this, [this](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const IndexedFile file = m_projectWatcher.resultAt(i);
+            m_lastModified.insert(file.filePath, file.lastModified);
+            // the editor has the current contents of open documents
+            if (!m_documentRevisions.contains(file.filePath))
+                m_index.setModule(file.filePath, file.symbols);
+        }
+    });
+    connect(&m_projectWatcher, &QFutureWatcherBase::finished, this, [this] {
+        if (m_projectsChanged)
+            scheduleProjects();
+        emit indexChanged();
+    });
+
+    SessionManager *sessionManager = SessionManager::instance();
+    connect(sessionManager, &SessionManager::projectAdded, this, [this](Project *project) {
+        connect(project, &Project::fileListChanged,
+                this, &HaskellCompletionIndexer::scheduleProjects);
+        scheduleProjects();
+    });
+    connect(sessionManager, &SessionManager::projectRemoved,
+            this, &HaskellCompletionIndexer::scheduleProjects);
+
+    Core::EditorManager *editorManager = Core::EditorManager::instance();
+    connect(editorManager, &Core::EditorManager::documentOpened,
+            this, &HaskellCompletionIndexer::trackDocument);
+    connect(editorManager, &Core::EditorManager::documentClosed,
+            this, [this](Core::IDocument *document) {
+        const QString filePath = document->filePath().toString();
+        if (!m_documentRevisions.remove(filePath))
+            return;
+        // read again from the file, if it belongs to a project
+        m_index.removeModule(filePath);
+        m_lastModified.remove(filePath);
+        scheduleProjects();
+    });
+}
+
+HaskellCompletionIndexer::~HaskellCompletionIndexer()
+{
+    m_projectWatcher.cancel();
+    m_projectWatcher.waitForFinished();
+    m_instance = nullptr;
+}
+
+HaskellCompletionIndexer *HaskellCompletionIndexer::instance()
+{
+    return m_instance;
+}
+
+void HaskellCompletionIndexer::scheduleProjects()
+{
+    m_projectsChanged = true;
+    m_projectTimer.start();
+}
+
+void HaskellCompletionIndexer::indexProjects()
+{
+    if (m_projectWatcher.isRunning())
+        return; // again when it is finished
+    m_projectsChanged = false;
+
+    QStringList filePaths;
+    for (Project *project : SessionManager::projects()) {
+        for (const FilePath &filePath : project->files(Project::SourceFiles)) {
+            if (filePath.suffix() == "hs" || filePath.suffix() == "lhs")
+                filePaths.append(filePath.toString());
+        }
+    }
+    filePaths.removeDuplicates();
+    const QSet<QString> current(filePaths.cbegin(), filePaths.cend());
+    for (auto it = m_lastModified.begin(); it != m_lastModified.end();) {
+        if (current.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        if (!m_documentRevisions.contains(it.key()))
+            m_index.removeModule(it.key());
+        it = m_lastModified.erase(it);
+    }
+
+    const QFuture<IndexedFile> future = Utils::runAsync(indexFiles, filePaths, m_lastModified);
+    Core::ProgressManager::addTask(future, tr("Indexing Haskell Files"),
+                                   "Haskell.IndexCompletion");
+    m_projectWatcher.setFuture(future);
+}
+
+void HaskellCompletionIndexer::trackDocument(Core::IDocument *document)
+{
+    auto textDocument = qobject_cast<TextEditor::TextDocument *>(document);
+    if (!textDocument || textDocument->id() != Constants::C_HASKELLEDITOR_ID)
+        return;
+    m_documentRevisions.insert(textDocument->filePath().toString(), 0);
+    const QPointer<TextEditor::TextDocument> pointer(textDocument);
+    auto addChange = [this, pointer] {
+        if (!m_changedDocuments.contains(pointer))
+            m_changedDocuments.append(pointer);
+        m_documentTimer.start();
+    };
+    connect(textDocument, &Core::IDocument::contentsChanged, this, addChange);
+    addChange();
+}
+
+void HaskellCompletionIndexer::indexDocuments()
+{
+    const QVector<QPointer<TextEditor::TextDocument>> documents = m_changedDocuments;
+    m_changedDocuments.clear();
+    for (const QPointer<TextEditor::TextDocument> &document : documents) {
+        if (!document)
+            continue;
+        const QString filePath = document->filePath().toString();
+        const auto revision = m_documentRevisions.find(filePath);
+        if (revision == m_documentRevisions.end())
+            continue;
+        // a result of an older revision that comes late is dropped
+        const int current = ++*revision;
+        auto watcher = new QFutureWatcher<ModuleSymbols>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [=] {
+            watcher->deleteLater();
+            if (!watcher->isCanceled() && m_documentRevisions.value(filePath) == current)
+                m_index.setModule(filePath, watcher->result());
+        });
+        watcher->setFuture(Utils::runAsync(indexSource, document->plainText(),
+                                           LiterateHaskell::isLiterateFile(filePath)));
+    }
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "completionindex.h"
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
+
+namespace Core { class IDocument; }
+namespace TextEditor { class TextDocument; }
+
+namespace Haskell {
+namespace Internal {
+
+class IndexedFile
+{
+public:
+    QString filePath;
+    QDateTime lastModified;
+    ModuleSymbols symbols;
+};
+
+// Keeps the completion index of the Haskell files in the open projects, read in the background.
+// Only files that changed since they were read are read again. Open documents are indexed from
+// their editor when typing pauses.
+class HaskellCompletionIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    HaskellCompletionIndexer();
+    ~HaskellCompletionIndexer() override;
+
+    static HaskellCompletionIndexer *instance();
+
+    CompletionIndex index() const { return m_index; }
+
+signals:
+    // after the project files were read
+    void indexChanged();
+
+private:
+    void scheduleProjects();
+    void indexProjects();
+    void trackDocument(Core::IDocument *document);
+    void indexDocuments();
+
+    CompletionIndex m_index;
+    QHash<QString, QDateTime> m_lastModified; // of the project files when they were read
+    bool m_projectsChanged = false;
+    QTimer m_projectTimer;
+    QFutureWatcher<IndexedFile> m_projectWatcher;
+
+    QHash<QString, int> m_documentRevisions; // of the open documents, by file path
+    QVector<QPointer<TextEditor::TextDocument>> m_changedDocuments;
+    QTimer m_documentTimer;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -33,9 +33,22 @@ const char C_HASKELLSNIPPETSGROUP_ID[] = "Haskell";
 const char C_HASKELL_PROJECT_MIMETYPE[] = "text/x-haskell-project";
 const char C_HASKELL_PROJECT_ID[] = "Haskell.Project";
 const char C_HASKELL_RUNCONFIG_ID[] = "Haskell.RunConfiguration";
+const char C_HASKELL_BENCHMARK_RUNCONFIG_ID[] = "Haskell.BenchmarkRunConfiguration";
+const char C_HASKELL_SERVICE_STACK_RUNCONFIG_ID[] = "Haskell.ServiceStackRunConfiguration";
 const char C_STACK_BUILD_STEP_ID[] = "Haskell.Stack.Build";
+const char C_STACK_CLEAN_STEP_ID[] = "Haskell.Stack.Clean";
+const char C_HASKELL_PROFILE_RUN_MODE[] = "Haskell.ProfileRunMode";
+const char C_HASKELL_EVENTLOG_RUN_MODE[] = "Haskell.EventlogRunMode";
 const char OPTIONS_GENERAL[] = "Haskell.A.General";
 const char A_RUN_GHCI[] = "Haskell.RunGHCi";
+const char A_EVALUATE_SELECTION[] = "Haskell.EvaluateSelection";
+const char A_SHOW_TYPE[] = "Haskell.ShowType";
+const char A_PROFILE[] = "Haskell.Profile";
+const char A_RUN_WITH_EVENTLOG[] = "Haskell.RunWithEventlog";
+const char A_RUN_TESTS[] = "Haskell.RunTests";
+const char A_RUN_TESTS_WITH_COVERAGE[] = "Haskell.RunTestsWithCoverage";
+const char A_CLEAR_COVERAGE[] = "Haskell.ClearCoverage";
+const char M_HASKELL[] = "Haskell.Menu";
 
 } // namespace Haskell
 } // namespace Constants
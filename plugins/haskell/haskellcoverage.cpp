@@ -0,0 +1,386 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellcoverage.h"
+
+#include "haskellproject.h"
+
+#include <coreplugin/editormanager/documentmodel.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/idocument.h>
+#include <coreplugin/messagemanager.h>
+#include <coreplugin/progressmanager/progressmanager.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projecttree.h>
+#include <projectexplorer/session.h>
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditor.h>
+#include <texteditor/textmark.h>
+#include <utils/runextensions.h>
+#include <utils/theme/theme.h>
+#include <utils/utilsicons.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QSet>
+#include <QTextBlock>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+const char COVERAGE_ID[] = "Haskell.Coverage";
+
+static HaskellCoverage *m_instance = nullptr;
+
+static QString regionDescription(CoverageRegion::Kind kind)
+{
+    switch (kind) {
+    case CoverageRegion::NotExecuted:
+        return HaskellCoverage::tr("Never executed");
+    case CoverageRegion::AlwaysTrue:
+        return HaskellCoverage::tr("Always true");
+    case CoverageRegion::AlwaysFalse:
+        return HaskellCoverage::tr("Always false");
+    }
+    return {};
+}
+
+class CoverageMark : public TextEditor::TextMark
+{
+public:
+    CoverageMark(const FilePath &filePath, int line, CoverageRegion::Kind kind)
+        : TextMark(filePath, line, COVERAGE_ID)
+    {
+        setPriority(TextEditor::TextMark::LowPriority);
+        setToolTip(regionDescription(kind));
+        if (kind == CoverageRegion::NotExecuted) {
+            setIcon(Icons::CRITICAL.icon());
+            setColor(Theme::CodeModel_Error_TextMarkColor);
+        } else {
+            setIcon(Icons::WARNING.icon());
+            setColor(Theme::CodeModel_Warning_TextMarkColor);
+        }
+    }
+};
+
+class MixBatch
+{
+public:
+    QStringList filePaths;
+    QVector<CachedMix> mixes;
+    QStringList errors;
+};
+
+static MixBatch readMixFiles(const QStringList &filePaths)
+{
+    MixBatch batch;
+    for (const QString &filePath : filePaths) {
+        QFile file(filePath);
+        CachedMix mix;
+        mix.lastModified = QFileInfo(filePath).lastModified();
+        QString error;
+        if (!file.open(QIODevice::ReadOnly))
+            error = file.errorString();
+        else
+            parseMix(file.readAll(), &mix.module, &error);
+        if (!error.isEmpty()) {
+            batch.errors.append(QDir::toNativeSeparators(filePath) + ": " + error);
+            continue;
+        }
+        batch.filePaths.append(filePath);
+        batch.mixes.append(mix);
+    }
+    return batch;
+}
+
+static void readTixFile(const FilePath &filePath,
+                        QHash<QString, TixModule> &modules,
+                        QStringList &errors)
+{
+    // the tick lists of long test runs are big, merge them while reading
+    QFile file(filePath.toString());
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors.append(filePath.toUserOutput() + ": " + file.errorString());
+        return;
+    }
+    TixParser parser;
+    while (!file.atEnd()) {
+        if (!parser.feed(file.read(1 << 20)))
+            break;
+        mergeTixModules(modules, parser.takeModules());
+    }
+    if (!parser.finish())
+        errors.append(filePath.toUserOutput() + ": " + parser.errorString());
+    mergeTixModules(modules, parser.takeModules());
+}
+
+static void readCoverage(QFutureInterface<CoverageData> &futureInterface,
+                         const FilePath &projectDirectory,
+                         const FilePath &mixDirectory,
+                         const FilePaths &tixFiles,
+                         const QHash<QString, CachedMix> &mixCache)
+{
+    CoverageData data;
+    QHash<QString, TixModule> tixModules;
+    for (const FilePath &tixFile : tixFiles)
+        readTixFile(tixFile, tixModules, data.errors);
+
+    // Library modules are named "package-id/Module" in .tix files and have their .mix file in
+    // "package-id/Module.mix". The .mix files of executables are in a directory per component,
+    // they are told apart by their hash.
+    QHash<QString, QStringList> mixFiles;
+    const QDir mixRoot(mixDirectory.toString());
+    QDirIterator it(mixRoot.path(), {"*.mix"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        const QString relativePath = mixRoot.relativeFilePath(filePath);
+        mixFiles[relativePath.chopped(4)].append(filePath);
+        if (relativePath.contains('/'))
+            mixFiles[it.fileInfo().completeBaseName()].append(filePath);
+    }
+    QSet<QString> needed;
+    for (const TixModule &module : std::as_const(tixModules)) {
+        for (const QString &filePath : mixFiles.value(module.name))
+            needed.insert(filePath);
+    }
+
+    // parse only what changed since the last time, in parallel
+    QStringList changed;
+    for (const QString &filePath : std::as_const(needed)) {
+        const auto cached = mixCache.constFind(filePath);
+        if (cached != mixCache.constEnd()
+                && cached->lastModified == QFileInfo(filePath).lastModified()) {
+            data.mixCache.insert(filePath, *cached);
+        } else {
+            changed.append(filePath);
+        }
+    }
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    QList<QFuture<MixBatch>> batches;
+    const int batchSize = 32;
+    for (int start = 0; start < changed.size(); start += batchSize)
+        batches.append(Utils::runAsync(&pool, readMixFiles, changed.mid(start, batchSize)));
+    futureInterface.setProgressRange(0, std::max(int(batches.size()), 1));
+    for (int i = 0; i < batches.size(); ++i) {
+        if (futureInterface.isCanceled()) {
+            for (QFuture<MixBatch> &batch : batches)
+                batch.cancel();
+            return;
+        }
+        const MixBatch batch = batches[i].result();
+        for (int j = 0; j < batch.filePaths.size(); ++j)
+            data.mixCache.insert(batch.filePaths.at(j), batch.mixes.at(j));
+        data.errors += batch.errors;
+        futureInterface.setProgressValue(i + 1);
+    }
+
+    for (const TixModule &module : std::as_const(tixModules)) {
+        for (const QString &filePath : mixFiles.value(module.name)) {
+            const auto cached = data.mixCache.constFind(filePath);
+            ModuleCoverage coverage;
+            if (cached == data.mixCache.constEnd()
+                    || !ModuleCoverage::compute(cached->module, module, &coverage)) {
+                continue;
+            }
+            // a module that is compiled into several components has the best coverage shown
+            const FilePath sourceFile = projectDirectory.resolvePath(coverage.sourceFile);
+            const auto existing = data.coverage.constFind(sourceFile);
+            if (existing == data.coverage.constEnd()
+                    || existing->coveredExpressions < coverage.coveredExpressions) {
+                data.coverage.insert(sourceFile, coverage);
+            }
+        }
+    }
+    futureInterface.reportResult(data);
+}
+
+HaskellCoverage::HaskellCoverage()
+{
+    m_instance = this;
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, [this] {
+        if (m_watcher.isCanceled())
+            return;
+        const CoverageData data = m_watcher.result();
+        for (const QString &error : data.errors)
+            Core::MessageManager::writeSilently(tr("Cannot read coverage data %1").arg(error));
+        m_mixCache = data.mixCache;
+        setCoverage(data.coverage);
+    });
+    connect(Core::EditorManager::instance(), &Core::EditorManager::editorOpened,
+            this, &HaskellCoverage::updateEditor);
+}
+
+HaskellCoverage::~HaskellCoverage()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+    for (const QList<TextEditor::TextMark *> &marks : std::as_const(m_marks))
+        qDeleteAll(marks);
+    m_instance = nullptr;
+}
+
+HaskellCoverage *HaskellCoverage::instance()
+{
+    return m_instance;
+}
+
+void HaskellCoverage::load(const FilePath &projectDirectory,
+                           const FilePath &mixDirectory,
+                           const FilePaths &tixFiles)
+{
+    if (m_watcher.isRunning()) {
+        m_watcher.cancel();
+        m_watcher.waitForFinished();
+    }
+    const QFuture<CoverageData> future = Utils::runAsync(readCoverage, projectDirectory,
+                                                         mixDirectory, tixFiles, m_mixCache);
+    Core::ProgressManager::addTask(future, tr("Reading Coverage"), "Haskell.ReadCoverage");
+    m_watcher.setFuture(future);
+}
+
+void HaskellCoverage::clear()
+{
+    m_watcher.cancel();
+    setCoverage({});
+}
+
+int HaskellCoverage::percent(const FilePath &filePath)
+{
+    if (!m_instance)
+        return -1;
+    const auto it = m_instance->m_coverage.constFind(filePath);
+    return it == m_instance->m_coverage.constEnd() ? -1 : it->percent();
+}
+
+void HaskellCoverage::setCoverage(const QHash<FilePath, ModuleCoverage> &coverage)
+{
+    // only files whose coverage changed get new marks
+    QSet<FilePath> changed;
+    for (auto it = m_coverage.cbegin(); it != m_coverage.cend(); ++it) {
+        if (!coverage.contains(it.key()))
+            changed.insert(it.key());
+    }
+    for (auto it = coverage.cbegin(); it != coverage.cend(); ++it) {
+        const auto old = m_coverage.constFind(it.key());
+        if (old == m_coverage.constEnd() || !(*old == it.value()))
+            changed.insert(it.key());
+    }
+    m_coverage = coverage;
+    if (changed.isEmpty())
+        return;
+    for (const FilePath &filePath : std::as_const(changed))
+        updateMarks(filePath);
+    for (Core::IDocument *document : Core::DocumentModel::openedDocuments()) {
+        if (!changed.contains(document->filePath()))
+            continue;
+        for (Core::IEditor *editor : Core::DocumentModel::editorsForDocument(document))
+            updateEditor(editor);
+    }
+    updateProjectTrees();
+    emit coverageChanged();
+}
+
+void HaskellCoverage::updateMarks(const FilePath &filePath)
+{
+    qDeleteAll(m_marks.take(filePath));
+    const auto it = m_coverage.constFind(filePath);
+    if (it == m_coverage.constEnd())
+        return;
+    // one mark per line, text marks are added to documents when they are opened
+    QList<TextEditor::TextMark *> marks;
+    int lastLine = 0;
+    for (const CoverageRegion &region : it->regions) {
+        if (region.position.startLine == lastLine)
+            continue;
+        lastLine = region.position.startLine;
+        marks.append(new CoverageMark(filePath, lastLine, region.kind));
+    }
+    m_marks.insert(filePath, marks);
+}
+
+void HaskellCoverage::updateEditor(Core::IEditor *editor)
+{
+    auto textEditor = qobject_cast<TextEditor::BaseTextEditor *>(editor);
+    if (!textEditor)
+        return;
+    TextEditor::TextEditorWidget *widget = textEditor->editorWidget();
+    QTextDocument *document = widget->document();
+    QList<QTextEdit::ExtraSelection> selections;
+    const auto it = m_coverage.constFind(editor->document()->filePath());
+    if (it != m_coverage.constEnd()) {
+        // the colors of "hpc markup"
+        const auto position = [document](int line, int column) {
+            const QTextBlock block = document->findBlockByNumber(line - 1);
+            if (!block.isValid())
+                return -1;
+            return block.position() + std::clamp(column, 0, block.length() - 1);
+        };
+        for (const CoverageRegion &region : it->regions) {
+            const int start = position(region.position.startLine,
+                                       region.position.startColumn - 1);
+            const int end = position(region.position.endLine, region.position.endColumn);
+            if (start < 0 || end < start)
+                continue;
+            QTextEdit::ExtraSelection selection;
+            selection.cursor = QTextCursor(document);
+            selection.cursor.setPosition(start);
+            selection.cursor.setPosition(end, QTextCursor::KeepAnchor);
+            switch (region.kind) {
+            case CoverageRegion::NotExecuted:
+                selection.format.setBackground(QColor(255, 255, 0, 80));
+                break;
+            case CoverageRegion::AlwaysTrue:
+                selection.format.setBackground(QColor(0, 200, 0, 80));
+                break;
+            case CoverageRegion::AlwaysFalse:
+                selection.format.setBackground(QColor(255, 0, 0, 80));
+                break;
+            }
+            selection.format.setToolTip(regionDescription(region.kind));
+            selections.append(selection);
+        }
+    }
+    widget->setExtraSelections(COVERAGE_ID, selections);
+}
+
+void HaskellCoverage::updateProjectTrees()
+{
+    // the file nodes of Haskell projects show the percentages
+    for (ProjectExplorer::Project *project : ProjectExplorer::SessionManager::projects()) {
+        if (HaskellProject::isHaskellProject(project) && project->rootProjectNode())
+            ProjectExplorer::ProjectTree::emitSubtreeChanged(project->rootProjectNode());
+    }
+}
+
+} // namespace Internal
+} // namespace Haskell
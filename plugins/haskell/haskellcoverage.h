@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "hpccoverage.h"
+
+#include <utils/filepath.h>
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+
+namespace Core { class IEditor; }
+namespace TextEditor { class TextMark; }
+
+namespace Haskell {
+namespace Internal {
+
+class CachedMix
+{
+public:
+    QDateTime lastModified;
+    MixModule module;
+};
+
+class CoverageData
+{
+public:
+    QHash<Utils::FilePath, ModuleCoverage> coverage;
+    QHash<QString, CachedMix> mixCache; // by file path
+    QStringList errors;
+};
+
+// Shows the HPC coverage of the last test run in the editors and the project tree.
+class HaskellCoverage : public QObject
+{
+    Q_OBJECT
+
+public:
+    HaskellCoverage();
+    ~HaskellCoverage() override;
+
+    static HaskellCoverage *instance();
+
+    // Reads the coverage in the background. Only .mix files that changed since the last time
+    // are read again.
+    void load(const Utils::FilePath &projectDirectory,
+              const Utils::FilePath &mixDirectory,
+              const Utils::FilePaths &tixFiles);
+    void clear();
+
+    // Returns -1 for files without coverage.
+    static int percent(const Utils::FilePath &filePath);
+
+signals:
+    void coverageChanged();
+
+private:
+    void setCoverage(const QHash<Utils::FilePath, ModuleCoverage> &coverage);
+    void updateMarks(const Utils::FilePath &filePath);
+    void updateEditor(Core::IEditor *editor);
+    void updateProjectTrees();
+
+    QHash<Utils::FilePath, ModuleCoverage> m_coverage;
+    QHash<QString, CachedMix> m_mixCache;
+    QHash<Utils::FilePath, QList<TextEditor::TextMark *>> m_marks;
+    QFutureWatcher<CoverageData> m_watcher;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskelldocumentchecker.h"
+
+#include "haskelllanguageclient.h"
+#include "haskellmanager.h"
+#include "literatehaskell.h"
+
+#include <coreplugin/editormanager/documentmodel.h>
+#include <texteditor/fontsettings.h>
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditor.h>
+#include <texteditor/texteditorsettings.h>
+#include <texteditor/textmark.h>
+#include <utils/qtcprocess.h>
+#include <utils/theme/theme.h>
+#include <utils/utilsicons.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTextBlock>
+
+#include <algorithm>
+
+using namespace TextEditor;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+const char DIAGNOSTICS_ID[] = "Haskell.Diagnostics";
+
+class DiagnosticMark : public TextMark
+{
+public:
+    DiagnosticMark(const FilePath &filePath, const GhcDiagnostic &diagnostic)
+        : TextMark(filePath, diagnostic.line, DIAGNOSTICS_ID)
+    {
+        const bool isError = diagnostic.severity == GhcDiagnostic::Error;
+        setPriority(isError ? TextMark::HighPriority : TextMark::NormalPriority);
+        setIcon(isError ? Icons::CODEMODEL_ERROR.icon() : Icons::CODEMODEL_WARNING.icon());
+        setColor(isError ? Theme::CodeModel_Error_TextMarkColor
+                         : Theme::CodeModel_Warning_TextMarkColor);
+        setToolTip(diagnostic.message);
+        setLineAnnotation(diagnostic.message.section('\n', 0, 0));
+    }
+};
+
+HaskellDocumentChecker::HaskellDocumentChecker(TextDocument *document)
+    : QObject(document)
+    , m_document(document)
+{
+    m_checkTimer.setSingleShot(true);
+    connect(&m_checkTimer, &QTimer::timeout, this, &HaskellDocumentChecker::startCheck);
+    connect(document, &Core::IDocument::contentsChanged, this, [this] {
+        cancelCheck();
+        m_checkTimer.start(m_scheduler.delay());
+    });
+    m_checkTimer.start(m_scheduler.delay());
+}
+
+HaskellDocumentChecker::~HaskellDocumentChecker()
+{
+    cancelCheck();
+    qDeleteAll(m_marks);
+}
+
+HaskellDocumentChecker *HaskellDocumentChecker::forDocument(TextDocument *document)
+{
+    if (!document)
+        return nullptr;
+    if (auto checker = document->findChild<HaskellDocumentChecker *>())
+        return checker;
+    return new HaskellDocumentChecker(document);
+}
+
+void HaskellDocumentChecker::startCheck()
+{
+    cancelCheck();
+    const FilePath filePath = m_document->filePath();
+    const HaskellLanguageServers *servers = HaskellLanguageServers::instance();
+    if (filePath.isEmpty() || (servers && servers->clientForFile(filePath))) {
+        setDiagnostics({});
+        return;
+    }
+
+    // the copy has the path of the module below a directory that is searched for imports
+    // first, so modules that import it get the copy too
+    if (!m_copyDirectory) {
+        m_copyDirectory.reset(new QTemporaryDir);
+        if (!m_copyDirectory->isValid())
+            return;
+    }
+    const QString source = m_document->plainText();
+    const bool literate = LiterateHaskell::isLiterateFile(filePath.toString());
+    const QString moduleName = GhcDiagnostics::moduleName(literate ? LiterateHaskell::unlit(source)
+                                                                   : source);
+    // GHC unlits the copy by its suffix
+    const QString relativePath = moduleName.isEmpty()
+                                     ? filePath.fileName()
+                                     : QString(moduleName).replace('.', '/')
+                                           + (literate ? ".lhs" : ".hs");
+    m_copyPath = m_copyDirectory->filePath(relativePath);
+    QDir().mkpath(QFileInfo(m_copyPath).absolutePath());
+    QFile copy(m_copyPath);
+    if (!copy.open(QIODevice::WriteOnly))
+        return;
+    copy.write(source.toUtf8());
+    copy.close();
+
+    FilePath projectDirectory = HaskellManager::findProjectDirectory(filePath);
+    if (projectDirectory.isEmpty())
+        projectDirectory = filePath.absolutePath();
+    const QString sourceRoot = GhcDiagnostics::sourceRoot(filePath.toString(), moduleName);
+    const int check = m_scheduler.startCheck();
+    m_process.reset(new QtcProcess);
+    m_process->setCommand({HaskellManager::stackExecutable(),
+                           {"ghc", "--", "-fno-code", "-ferror-spans",
+                            "-fdiagnostics-color=never",
+                            "-outputdir", m_copyDirectory->filePath("build"),
+                            "-i" + m_copyDirectory->path(), "-i" + sourceRoot, m_copyPath}});
+    m_process->setWorkingDirectory(projectDirectory);
+    m_process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(m_process.get(), &QtcProcess::done, this, [this, check] { finishCheck(check); });
+    m_checkDuration.start();
+    m_process->start();
+}
+
+void HaskellDocumentChecker::cancelCheck()
+{
+    m_scheduler.cancelCheck();
+    if (!m_process)
+        return;
+    // stopping does not wait for the process, typing goes on
+    m_process->disconnect(this);
+    m_process->kill();
+    m_process.reset();
+}
+
+void HaskellDocumentChecker::finishCheck(int check)
+{
+    if (!m_scheduler.finishCheck(check, int(m_checkDuration.elapsed())))
+        return;
+    const QString output = m_process->cleanedStdOut();
+    if (m_process->error() == QProcess::FailedToStart)
+        return;
+    const QFileInfo copy(m_copyPath);
+    QVector<GhcDiagnostic> diagnostics;
+    for (const GhcDiagnostic &diagnostic : GhcDiagnostics::parse(output)) {
+        // errors in imported modules are found when they are opened
+        QFileInfo reported(diagnostic.filePath);
+        if (reported.isRelative())
+            reported.setFile(m_process->workingDirectory().toString(), diagnostic.filePath);
+        if (reported == copy)
+            diagnostics.append(diagnostic);
+    }
+    setDiagnostics(diagnostics);
+}
+
+void HaskellDocumentChecker::setDiagnostics(const QVector<GhcDiagnostic> &diagnostics)
+{
+    qDeleteAll(m_marks);
+    m_marks.clear();
+    m_diagnostics = diagnostics;
+    for (const GhcDiagnostic &diagnostic : diagnostics)
+        m_marks.append(new DiagnosticMark(m_document->filePath(), diagnostic));
+    for (Core::IEditor *editor : Core::DocumentModel::editorsForDocument(m_document)) {
+        if (auto textEditor = qobject_cast<BaseTextEditor *>(editor))
+            updateEditor(textEditor->editorWidget());
+    }
+}
+
+void HaskellDocumentChecker::updateEditor(TextEditorWidget *widget) const
+{
+    QTextDocument *document = widget->document();
+    const FontSettings &fontSettings = TextEditorSettings::fontSettings();
+    const auto position = [document](int line, int column) {
+        const QTextBlock block = document->findBlockByNumber(line - 1);
+        if (!block.isValid())
+            return -1;
+        return block.position() + std::clamp(column, 0, block.length() - 1);
+    };
+    QList<QTextEdit::ExtraSelection> selections;
+    for (const GhcDiagnostic &diagnostic : m_diagnostics) {
+        const int start = position(diagnostic.line, diagnostic.column - 1);
+        const int end = position(diagnostic.endLine, diagnostic.endColumn);
+        if (start < 0 || end < start)
+            continue;
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = QTextCursor(document);
+        selection.cursor.setPosition(start);
+        // at least one character
+        selection.cursor.setPosition(std::max(end, start + 1), QTextCursor::KeepAnchor);
+        selection.format = fontSettings.toTextCharFormat(
+            diagnostic.severity == GhcDiagnostic::Error ? C_ERROR : C_WARNING);
+        selection.format.setToolTip(diagnostic.message);
+        selections.append(selection);
+    }
+    widget->setExtraSelections(DIAGNOSTICS_ID, selections);
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "ghcdiagnostics.h"
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QTemporaryDir;
+QT_END_NAMESPACE
+
+namespace TextEditor {
+class TextDocument;
+class TextEditorWidget;
+class TextMark;
+} // namespace TextEditor
+namespace Utils { class QtcProcess; }
+
+namespace Haskell {
+namespace Internal {
+
+// Checks a Haskell document with GHC -fno-code on a copy of the editor contents when typing
+// pauses, and shows the errors and warnings as text marks and underlines. An edit cancels the
+// running check. Documents of a language server get the diagnostics from there instead.
+class HaskellDocumentChecker : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~HaskellDocumentChecker() override;
+
+    static HaskellDocumentChecker *forDocument(TextEditor::TextDocument *document);
+
+    void updateEditor(TextEditor::TextEditorWidget *widget) const;
+
+private:
+    explicit HaskellDocumentChecker(TextEditor::TextDocument *document);
+
+    void startCheck();
+    void cancelCheck();
+    void finishCheck(int check);
+    void setDiagnostics(const QVector<GhcDiagnostic> &diagnostics);
+
+    TextEditor::TextDocument *m_document;
+    CheckScheduler m_scheduler;
+    QTimer m_checkTimer;
+    std::unique_ptr<Utils::QtcProcess> m_process;
+    std::unique_ptr<QTemporaryDir> m_copyDirectory;
+    QString m_copyPath; // of the contents that are checked
+    QElapsedTimer m_checkDuration;
+    QVector<GhcDiagnostic> m_diagnostics;
+    QList<TextEditor::TextMark *> m_marks;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,281 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskelldocumentoutline.h"
+
+#include "literatehaskell.h"
+
+#include <texteditor/textdocument.h>
+#include <utils/codemodelicon.h>
+#include <utils/runextensions.h>
+
+#include <QTextBlock>
+#include <QTextDocument>
+
+#include <algorithm>
+
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+// waits for a pause in typing
+static const int updateDelay = 500;
+
+static void updateOutline(QFutureInterface<OutlineUpdate> &futureInterface,
+                          HaskellOutline outline,
+                          int firstLine,
+                          int removedLines,
+                          const QStringList &lines)
+{
+    outline.update(firstLine, removedLines, lines);
+    OutlineUpdate update;
+    update.items = outline.items();
+    update.outline = std::move(outline);
+    futureInterface.reportResult(update);
+}
+
+static QIcon icon(OutlineItem::Kind kind)
+{
+    switch (kind) {
+    case OutlineItem::Module:
+    case OutlineItem::Import:
+        return CodeModelIcon::iconForType(CodeModelIcon::Namespace);
+    case OutlineItem::Type:
+        return CodeModelIcon::iconForType(CodeModelIcon::Struct);
+    case OutlineItem::Class:
+        return CodeModelIcon::iconForType(CodeModelIcon::Class);
+    case OutlineItem::Instance:
+        return CodeModelIcon::iconForType(CodeModelIcon::Property);
+    case OutlineItem::Function:
+        return CodeModelIcon::iconForType(CodeModelIcon::FuncPublic);
+    }
+    return {};
+}
+
+static QString displayText(const OutlineItem &item)
+{
+    if (item.detail.isEmpty() || item.kind == OutlineItem::Instance)
+        return item.name;
+    if (item.kind == OutlineItem::Function)
+        return item.name + " :: " + item.detail;
+    return item.name + ' ' + item.detail;
+}
+
+static QString toolTip(const OutlineItem &item)
+{
+    switch (item.kind) {
+    case OutlineItem::Module:
+        return "module " + item.name;
+    case OutlineItem::Import:
+        return ("import " + item.name + ' ' + item.detail).trimmed();
+    case OutlineItem::Type:
+        return displayText(item);
+    case OutlineItem::Class:
+        return "class " + displayText(item);
+    case OutlineItem::Instance:
+        return item.detail.isEmpty() ? "instance " + item.name
+                                     : "instance " + item.detail + " => " + item.name;
+    case OutlineItem::Function:
+        return displayText(item);
+    }
+    return {};
+}
+
+HaskellDocumentOutline::HaskellDocumentOutline(TextEditor::TextDocument *document)
+    : QObject(document)
+    , m_textDocument(document)
+    , m_document(document->document())
+{
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(updateDelay);
+    connect(&m_updateTimer, &QTimer::timeout, this, &HaskellDocumentOutline::startUpdate);
+    connect(m_document, &QTextDocument::contentsChange,
+            this, [this](int position, int /*charsRemoved*/, int charsAdded) {
+        addChange(position, charsAdded);
+        m_updateTimer.start();
+    });
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, [this] {
+        if (m_watcher.isCanceled())
+            return;
+        const OutlineUpdate update = m_watcher.result();
+        m_outline = update.outline;
+        setItems(update.items);
+        // the document changed while the update ran
+        if (m_changed && !m_updateTimer.isActive())
+            m_updateTimer.start();
+    });
+    startUpdate();
+}
+
+HaskellDocumentOutline::~HaskellDocumentOutline()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+HaskellDocumentOutline *HaskellDocumentOutline::forDocument(TextEditor::TextDocument *document)
+{
+    if (!document)
+        return nullptr;
+    if (auto outline = document->findChild<HaskellDocumentOutline *>())
+        return outline;
+    return new HaskellDocumentOutline(document);
+}
+
+QModelIndex HaskellDocumentOutline::indexForLine(int line) const
+{
+    QModelIndex result;
+    for (;;) {
+        // the items are sorted by line
+        QModelIndex found;
+        for (int row = 0; row < m_model.rowCount(result); ++row) {
+            const QModelIndex index = m_model.index(row, 0, result);
+            if (index.data(LineRole).toInt() > line)
+                break;
+            found = index;
+        }
+        if (!found.isValid())
+            return result;
+        result = found;
+    }
+}
+
+void HaskellDocumentOutline::addChange(int position, int charsAdded)
+{
+    const int firstChanged = m_document->findBlock(position).blockNumber();
+    QTextBlock lastChanged = m_document->findBlock(position + charsAdded);
+    if (!lastChanged.isValid())
+        lastChanged = m_document->lastBlock();
+    const int unchangedEnd = m_document->blockCount() - 1 - lastChanged.blockNumber();
+    m_unchangedStart = m_changed ? std::min(m_unchangedStart, firstChanged) : firstChanged;
+    m_unchangedEnd = m_changed ? std::min(m_unchangedEnd, unchangedEnd) : unchangedEnd;
+    m_changed = true;
+}
+
+void HaskellDocumentOutline::startUpdate()
+{
+    if (!m_changed || m_watcher.isRunning())
+        return;
+    const int lineCount = m_document->blockCount();
+    const bool literate = LiterateHaskell::isLiterateFile(m_textDocument->filePath().toString());
+    if (literate != m_literate) {
+        // everything is read again
+        m_literate = literate;
+        m_codeBlockStarts.clear();
+        m_unchangedStart = 0;
+        m_unchangedEnd = 0;
+    }
+    const int firstLine = std::clamp(m_unchangedStart, 0, std::min(lineCount, m_lineCount));
+    int unchangedEnd = std::clamp(m_unchangedEnd, 0, std::min(lineCount, m_lineCount) - firstLine);
+    QStringList lines;
+    QVector<bool> codeBlockStarts;
+    bool inCodeBlock = m_codeBlockStarts.value(firstLine);
+    QTextBlock block = m_document->findBlockByNumber(firstLine);
+    const auto addLine = [&] {
+        const QString text = block.text();
+        block = block.next();
+        if (!literate) {
+            lines.append(text);
+            return;
+        }
+        codeBlockStarts.append(inCodeBlock);
+        const LiterateHaskell::LineType type = LiterateHaskell::lineType(text, inCodeBlock);
+        if (type == LiterateHaskell::LineType::CodeDelimiter)
+            inCodeBlock = !inCodeBlock;
+        lines.append(LiterateHaskell::code(text, type));
+    };
+    for (int i = firstLine; i < lineCount - unchangedEnd && block.isValid(); ++i)
+        addLine();
+    if (literate) {
+        // a \begin{code} or \end{code} changes what the lines after it are, up to the first line
+        // that starts in or out of a code block like before
+        while (unchangedEnd > 0 && block.isValid()
+               && inCodeBlock != m_codeBlockStarts.at(m_lineCount - unchangedEnd)) {
+            addLine();
+            --unchangedEnd;
+        }
+        m_codeBlockStarts = m_codeBlockStarts.mid(0, firstLine) + codeBlockStarts
+                            + m_codeBlockStarts.mid(m_lineCount - unchangedEnd);
+    }
+    const int removedLines = m_lineCount - firstLine - unchangedEnd;
+    m_lineCount = lineCount;
+    m_changed = false;
+    m_watcher.setFuture(Utils::runAsync(updateOutline, std::move(m_outline), firstLine,
+                                        removedLines, lines));
+}
+
+void HaskellDocumentOutline::setItems(const QVector<OutlineItem> &items)
+{
+    if (items == m_items)
+        return;
+    // an edit that only moves declarations keeps the views as they are
+    const bool sameDeclarations = std::equal(items.cbegin(), items.cend(),
+                                             m_items.cbegin(), m_items.cend(),
+                                             [](const OutlineItem &a, const OutlineItem &b) {
+        return a.kind == b.kind && a.name == b.name && a.detail == b.detail;
+    });
+    m_items = items;
+    if (sameDeclarations) {
+        for (int i = 0; i < items.size(); ++i) {
+            QStandardItem *modelItem = m_modelItems.at(i);
+            modelItem->setData(items.at(i).line, LineRole);
+            modelItem->setData(items.at(i).column, ColumnRole);
+            // the group of imports starts at the first one
+            if (QStandardItem *parent = modelItem->parent(); parent && modelItem->row() == 0)
+                parent->setData(items.at(i).line, LineRole);
+        }
+        emit outlineChanged();
+        return;
+    }
+
+    m_model.clear();
+    m_modelItems.clear();
+    QStandardItem *imports = nullptr;
+    for (const OutlineItem &item : items) {
+        auto modelItem = new QStandardItem(icon(item.kind), displayText(item));
+        modelItem->setToolTip(toolTip(item));
+        modelItem->setData(item.line, LineRole);
+        modelItem->setData(item.column, ColumnRole);
+        modelItem->setEditable(false);
+        if (item.kind == OutlineItem::Import) {
+            if (!imports) {
+                imports = new QStandardItem(icon(item.kind), tr("imports"));
+                imports->setData(item.line, LineRole);
+                imports->setData(item.column, ColumnRole);
+                imports->setEditable(false);
+                m_model.appendRow(imports);
+            }
+            imports->appendRow(modelItem);
+        } else {
+            m_model.appendRow(modelItem);
+        }
+        m_modelItems.append(modelItem);
+    }
+    emit outlineChanged();
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "haskelloutline.h"
+
+#include <QFutureWatcher>
+#include <QStandardItemModel>
+#include <QTimer>
+
+QT_BEGIN_NAMESPACE
+class QTextDocument;
+QT_END_NAMESPACE
+
+namespace TextEditor { class TextDocument; }
+
+namespace Haskell {
+namespace Internal {
+
+class OutlineUpdate
+{
+public:
+    HaskellOutline outline;
+    QVector<OutlineItem> items;
+};
+
+// The outline of a Haskell document for the outline pane and the editor tool bar, kept up to
+// date in the background. Edits are collected until typing pauses, then only the changed lines
+// are parsed again.
+class HaskellDocumentOutline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Role { LineRole = Qt::UserRole, ColumnRole };
+
+    ~HaskellDocumentOutline() override;
+
+    static HaskellDocumentOutline *forDocument(TextEditor::TextDocument *document);
+
+    QAbstractItemModel *model() { return &m_model; }
+    // the innermost item declared at or before the line
+    QModelIndex indexForLine(int line) const;
+
+signals:
+    void outlineChanged();
+
+private:
+    explicit HaskellDocumentOutline(TextEditor::TextDocument *document);
+
+    void addChange(int position, int charsAdded);
+    void startUpdate();
+    void setItems(const QVector<OutlineItem> &items);
+
+    TextEditor::TextDocument *m_textDocument;
+    QTextDocument *m_document;
+    HaskellOutline m_outline; // moved to the update while it runs
+    int m_lineCount = 0; // of the outline after the running update
+    // the changed lines are between the unchanged ones at the start and at the end
+    bool m_changed = true;
+    int m_unchangedStart = 0;
+    int m_unchangedEnd = 0;
+    bool m_literate = false;
+    QVector<bool> m_codeBlockStarts; // of literate documents, whether each line is in \begin{code}
+    QVector<OutlineItem> m_items;
+    QVector<QStandardItem *> m_modelItems;
+    QStandardItemModel m_model;
+    QTimer m_updateTimer;
+    QFutureWatcher<OutlineUpdate> m_watcher;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -25,23 +25,55 @@
 
 #include "haskelleditorfactory.h"
 
+#include "haskellcompletionassist.h"
 #include "haskellconstants.h"
+#include "haskelldocumentchecker.h"
 #include "haskellhighlighter.h"
+#include "haskellhoverhandler.h"
+#include "haskellindenter.h"
 #include "haskellmanager.h"
+#include "haskelloutlinewidget.h"
+#include "haskellsemantichighlighter.h"
+#include "literatehaskell.h"
 
 #include <coreplugin/actionmanager/commandbutton.h>
 #include <texteditor/textdocument.h>
 #include <texteditor/texteditoractionhandler.h>
-#include <texteditor/textindenter.h>
 
 #include <QCoreApplication>
 
 namespace Haskell {
 namespace Internal {
 
+class HaskellEditorWidget : public TextEditor::TextEditorWidget
+{
+protected:
+    void finalizeInitialization() override
+    {
+        // needs the document
+        insertExtraToolBarWidget(Left, new HaskellOutlineComboBox(this));
+        HaskellSemanticHighlighter::forDocument(textDocument());
+        HaskellDocumentChecker::forDocument(textDocument())->updateEditor(this);
+    }
+};
+
+static TextEditor::TextDocument *createDocument()
+{
+    auto document = new TextEditor::TextDocument(Constants::C_HASKELLEDITOR_ID);
+    // the highlighter and the indenter are created before the document gets its file
+    QObject::connect(document, &Core::IDocument::filePathChanged, document, [document] {
+        const bool literate = LiterateHaskell::isLiterateFile(document->filePath().toString());
+        if (auto highlighter = qobject_cast<HaskellHighlighter *>(document->syntaxHighlighter()))
+            highlighter->setLiterate(literate);
+        if (auto indenter = dynamic_cast<HaskellIndenter *>(document->indenter()))
+            indenter->setLiterate(literate);
+    });
+    return document;
+}
+
 static QWidget *createEditorWidget()
 {
-    auto widget = new TextEditor::TextEditorWidget;
+    auto widget = new HaskellEditorWidget;
     auto ghciButton = new Core::CommandButton(Constants::A_RUN_GHCI, widget);
     ghciButton->setText(HaskellManager::tr("GHCi"));
     QObject::connect(ghciButton, &QToolButton::clicked, HaskellManager::instance(), [widget] {
@@ -56,15 +88,19 @@ HaskellEditorFactory::HaskellEditorFactory()
     setId(Constants::C_HASKELLEDITOR_ID);
     setDisplayName(QCoreApplication::translate("OpenWith::Editors", "Haskell Editor"));
     addMimeType("text/x-haskell");
+    addMimeType("text/x-literate-haskell");
     setEditorActionHandlers(TextEditor::TextEditorActionHandler::UnCommentSelection
                             | TextEditor::TextEditorActionHandler::FollowSymbolUnderCursor);
-    setDocumentCreator([] { return new TextEditor::TextDocument(Constants::C_HASKELLEDITOR_ID); });
-    setIndenterCreator([](QTextDocument *doc) { return new TextEditor::TextIndenter(doc); });
+    setDocumentCreator(createDocument);
+    setIndenterCreator([](QTextDocument *doc) { return new HaskellIndenter(doc); });
     setEditorWidgetCreator(createEditorWidget);
     setCommentDefinition(Utils::CommentDefinition("--", "{-", "-}"));
     setParenthesesMatchingEnabled(true);
     setMarksVisible(true);
+    setCodeFoldingSupported(true);
     setSyntaxHighlighterCreator([] { return new HaskellHighlighter(); });
+    setCompletionAssistProvider(new HaskellCompletionAssistProvider);
+    addHoverHandler(new HaskellHoverHandler);
 }
 
 } // Internal
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellfolding.h"
+
+#include "haskelltokenizer.h"
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+static const int tabWidth = 8;
+// leaves room for the nesting levels of comments between the levels of adjacent columns
+static const int levelsPerColumn = 16;
+
+// the block state has the tokenizer state in the lowest 8 bits, then the import flag, the code
+// block flag, and the level, so comments nested deeper than 253 levels are cut off
+static const int tokenizerStateMask = 0xff;
+static const int inImportsFlag = 0x100;
+static const int inCodeBlockFlag = 0x200;
+static const int levelShift = 10;
+static const int maximumLevel = (1 << (31 - levelShift)) - 1;
+
+static int columnOf(const QString &line, int position)
+{
+    int column = 0;
+    for (int i = 0; i < position; ++i)
+        column = line.at(i) == '\t' ? (column / tabWidth + 1) * tabWidth : column + 1;
+    return column;
+}
+
+FoldingState FoldingState::fromBlockState(int blockState)
+{
+    FoldingState state;
+    if (blockState < 0)
+        return state;
+    state.tokenizerState = (blockState & tokenizerStateMask) - 1;
+    state.inImports = blockState & inImportsFlag;
+    state.inCodeBlock = blockState & inCodeBlockFlag;
+    state.level = blockState >> levelShift;
+    return state;
+}
+
+int FoldingState::toBlockState() const
+{
+    return std::clamp(tokenizerState + 1, 0, tokenizerStateMask)
+           | (inImports ? inImportsFlag : 0)
+           | (inCodeBlock ? inCodeBlockFlag : 0)
+           | (std::clamp(level, 0, maximumLevel) << levelShift);
+}
+
+bool FoldingState::operator==(const FoldingState &other) const
+{
+    return tokenizerState == other.tokenizerState && level == other.level
+           && inImports == other.inImports && inCodeBlock == other.inCodeBlock;
+}
+
+int HaskellFolding::foldingLevel(FoldingState &state, const QString &line, const Tokens &tokens)
+{
+    const int startState = state.tokenizerState;
+    state.tokenizerState = tokens.state;
+
+    // the rest of a multi-line comment or string is nested in the line that starts it
+    const int commentGuard = int(Tokens::State::MultiLineCommentGuard);
+    if (startState > commentGuard)
+        return state.level + std::min(startState - commentGuard, levelsPerColumn - 1);
+    if (startState == int(Tokens::State::StringGap))
+        return state.level + 1;
+
+    const auto first = std::find_if(tokens.cbegin(), tokens.cend(), [](const Token &token) {
+        return token.type != TokenType::Whitespace;
+    });
+    if (first == tokens.cend())
+        return -1;
+    const int column = columnOf(line, first->startCol);
+    const bool isComment = first->type == TokenType::SingleLineComment
+                           || first->type == TokenType::MultiLineComment;
+    const bool isDirective = line.at(first->startCol) == '#';
+    const bool isImport = first->type == TokenType::Keyword
+                          && first->text == QLatin1String("import");
+
+    int level = column * levelsPerColumn;
+    if (state.inImports) {
+        // comments and preprocessor directives between imports do not end them
+        if (column == 0 && !isImport && !isComment && !isDirective)
+            state.inImports = false;
+        else
+            ++level;
+    } else if (isImport) {
+        state.inImports = true;
+    }
+    state.level = std::min(level, maximumLevel);
+    return state.level;
+}
+
+bool HaskellFolding::isBlank(const QString &line)
+{
+    return std::all_of(line.cbegin(), line.cend(), [](const QChar c) { return c.isSpace(); });
+}
+
+} // namespace Internal
+} // namespace Haskell
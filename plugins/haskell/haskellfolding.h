@@ -0,0 +1,68 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+namespace Haskell {
+namespace Internal {
+
+class Tokens;
+
+// What the fold level of a line depends on, carried from line to line in the state of the
+// highlighted text blocks together with the state of the tokenizer and, for literate Haskell,
+// whether the line is in a \begin{code} block.
+class FoldingState
+{
+public:
+    // -1, the state of a block that was not highlighted, is the state at the start of a file.
+    static FoldingState fromBlockState(int blockState);
+    int toBlockState() const;
+
+    bool operator==(const FoldingState &other) const;
+    bool operator!=(const FoldingState &other) const { return !(*this == other); }
+
+    int tokenizerState = -1;
+    int level = 0; // of the last line with code
+    bool inImports = false;
+    bool inCodeBlock = false;
+};
+
+// Fold levels by the layout: lines are nested in the last line that is indented less, lines in a
+// multi-line comment by its nesting level in the line that opens it, and the imports after the
+// first one in that. Only the relative levels of adjacent lines matter for folding.
+class HaskellFolding
+{
+public:
+    // Returns the fold level of the line, whose tokens start in the state of the tokenizer in
+    // the given state, and sets the state to the one after the line.
+    // Returns -1 for blank lines, which belong to the deeper of the lines with code around them.
+    static int foldingLevel(FoldingState &state, const QString &line, const Tokens &tokens);
+    static bool isBlank(const QString &line);
+};
+
+} // namespace Internal
+} // namespace Haskell
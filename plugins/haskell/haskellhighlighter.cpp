@@ -25,15 +25,20 @@
 
 #include "haskellhighlighter.h"
 
+#include "haskellfolding.h"
 #include "haskelltokenizer.h"
+#include "literatehaskell.h"
 
 #include <texteditor/fontsettings.h>
+#include <texteditor/textdocumentlayout.h>
 #include <texteditor/texteditorconstants.h>
 #include <texteditor/texteditorsettings.h>
 
 #include <QDebug>
 #include <QVector>
 
+#include <algorithm>
+
 Q_GLOBAL_STATIC_WITH_ARGS(QSet<QString>, IMPORT_HIGHLIGHTS, ({
     "qualified",
     "as",
@@ -51,10 +56,68 @@ HaskellHighlighter::HaskellHighlighter()
     updateFormats(TextEditorSettings::fontSettings());
 }
 
+void HaskellHighlighter::setLiterate(bool literate)
+{
+    if (literate == m_literate)
+        return;
+    m_literate = literate;
+    rehighlight();
+}
+
+Tokens HaskellHighlighter::codeTokens(const QTextBlock &block, bool literate, int *codeColumn)
+{
+    const FoldingState state = FoldingState::fromBlockState(block.previous().userState());
+    const QString text = block.text();
+    *codeColumn = 0;
+    if (!literate)
+        return HaskellTokenizer::tokenize(text, state.tokenizerState);
+    // prose has no code
+    const LiterateHaskell::LineType type = LiterateHaskell::lineType(text, state.inCodeBlock);
+    *codeColumn = LiterateHaskell::codeColumn(text, type);
+    return HaskellTokenizer::tokenize(LiterateHaskell::code(text, type), state.tokenizerState);
+}
+
 void HaskellHighlighter::highlightBlock(const QString &text)
 {
-    const Tokens tokens = HaskellTokenizer::tokenize(text, previousBlockState());
-    setCurrentBlockState(tokens.state);
+    FoldingState foldingState = FoldingState::fromBlockState(previousBlockState());
+    if (!m_literate) {
+        highlightCode(text, 0, foldingState);
+        return;
+    }
+    // prose is not tokenized, and keeps the state of the code for the next code line
+    const LiterateHaskell::LineType type = LiterateHaskell::lineType(text,
+                                                                     foldingState.inCodeBlock);
+    switch (type) {
+    case LiterateHaskell::LineType::Prose:
+    case LiterateHaskell::LineType::CodeDelimiter:
+        if (type == LiterateHaskell::LineType::CodeDelimiter) {
+            foldingState.inCodeBlock = !foldingState.inCodeBlock;
+            setFormat(0, text.length(), formatForCategory(C_PREPROCESSOR));
+        }
+        updateFolding(HaskellFolding::isBlank(text) ? -1 : 0, foldingState.level);
+        setCurrentBlockState(foldingState.toBlockState());
+        TextDocumentLayout::setParentheses(currentBlock(), {});
+        break;
+    case LiterateHaskell::LineType::BirdTrack:
+        highlightCode(text, LiterateHaskell::codeColumn(text, type), foldingState);
+        setFormat(0, 1, formatForCategory(C_PREPROCESSOR));
+        break;
+    case LiterateHaskell::LineType::Code:
+        highlightCode(text, 0, foldingState);
+        break;
+    }
+}
+
+void HaskellHighlighter::highlightCode(const QString &text, int column,
+                                       FoldingState &foldingState)
+{
+    m_codeColumn = column;
+    const QString code = column > 0 ? text.mid(column) : text;
+    const int previousLevel = foldingState.level;
+    const Tokens tokens = HaskellTokenizer::tokenize(code, foldingState.tokenizerState);
+    updateFolding(HaskellFolding::foldingLevel(foldingState, code, tokens), previousLevel);
+    setCurrentBlockState(foldingState.toBlockState());
+    updateParentheses(tokens);
     const Token *firstNonWS = 0;
     const Token *secondNonWS = 0;
     bool inType = false;
@@ -81,7 +144,8 @@ void HaskellHighlighter::highlightBlock(const QString &text)
             break;
         case TokenType::Keyword:
             if (token.text == QLatin1String("::") && firstNonWS && !secondNonWS) { // toplevel declaration
-                setFormat(firstNonWS->startCol, firstNonWS->length, m_toplevelDeclFormat);
+                setFormat(m_codeColumn + firstNonWS->startCol, firstNonWS->length,
+                          m_toplevelDeclFormat);
                 inType = true;
             } else if (token.text == QLatin1String("import")) {
                 inImport = true;
@@ -125,6 +189,47 @@ void HaskellHighlighter::highlightBlock(const QString &text)
     }
 }
 
+static bool isBlankBlock(const QTextBlock &block)
+{
+    return HaskellFolding::isBlank(block.text())
+           && FoldingState::fromBlockState(block.userState()).tokenizerState
+                  == int(Tokens::State::None);
+}
+
+// Only touches the blank blocks right before or after the current one. Changing the level of a
+// line changes the block state, which has the following blocks highlighted again.
+void HaskellHighlighter::updateFolding(int level, int previousLevel)
+{
+    const QTextBlock block = currentBlock();
+    if (level >= 0) {
+        TextDocumentLayout::setFoldingIndent(block, level);
+        for (QTextBlock blank = block.previous(); blank.isValid() && isBlankBlock(blank);
+             blank = blank.previous()) {
+            const int levelBefore = FoldingState::fromBlockState(blank.userState()).level;
+            TextDocumentLayout::setFoldingIndent(blank, std::max(levelBefore, level));
+        }
+        return;
+    }
+    QTextBlock next = block.next();
+    while (next.isValid() && HaskellFolding::isBlank(next.text()))
+        next = next.next();
+    const int levelAfter = next.isValid() ? TextDocumentLayout::foldingIndent(next) : 0;
+    TextDocumentLayout::setFoldingIndent(block, std::max(previousLevel, levelAfter));
+}
+
+// Parentheses matching uses these instead of the text, which has brackets in strings, characters
+// and comments too.
+void HaskellHighlighter::updateParentheses(const Tokens &tokens)
+{
+    Parentheses parentheses;
+    for (const Delimiter &delimiter : tokens.delimiters()) {
+        parentheses.append(Parenthesis(delimiter.opening ? Parenthesis::Opened
+                                                         : Parenthesis::Closed,
+                                       delimiter.character, m_codeColumn + delimiter.column));
+    }
+    TextDocumentLayout::setParentheses(currentBlock(), parentheses);
+}
+
 void HaskellHighlighter::setFontSettings(const FontSettings &fontSettings)
 {
     SyntaxHighlighter::setFontSettings(fontSettings);
@@ -139,13 +244,14 @@ void HaskellHighlighter::updateFormats(const FontSettings &fontSettings)
 
 void HaskellHighlighter::setTokenFormat(const Token &token, TextStyle style)
 {
-    setFormat(token.startCol, token.length, formatForCategory(style));
+    setFormat(m_codeColumn + token.startCol, token.length, formatForCategory(style));
 }
 
 void HaskellHighlighter::setTokenFormatWithSpaces(const QString &text, const Token &token,
                                                   TextStyle style)
 {
-    setFormatWithSpaces(text, token.startCol, token.length, formatForCategory(style));
+    setFormatWithSpaces(text, m_codeColumn + token.startCol, token.length,
+                        formatForCategory(style));
 }
 
 } // Internal
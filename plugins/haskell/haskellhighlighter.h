@@ -28,12 +28,15 @@
 #include <texteditor/syntaxhighlighter.h>
 
 #include <QHash>
+#include <QTextBlock>
 #include <QTextFormat>
 
 namespace Haskell {
 namespace Internal {
 
+class FoldingState;
 class Token;
+class Tokens;
 
 class HaskellHighlighter : public TextEditor::SyntaxHighlighter
 {
@@ -42,16 +45,29 @@ class HaskellHighlighter : public TextEditor::SyntaxHighlighter
 public:
     HaskellHighlighter();
 
+    // Highlights only the code of literate Haskell.
+    void setLiterate(bool literate);
+
+    // Returns the tokens of the code in the block, starting in the state the highlighter left
+    // before it, and sets codeColumn to the column of the block at which the code starts.
+    static Tokens codeTokens(const QTextBlock &block, bool literate, int *codeColumn);
+
 protected:
     void highlightBlock(const QString &text) override;
 
 private:
     void setFontSettings(const TextEditor::FontSettings &fontSettings) override;
     void updateFormats(const TextEditor::FontSettings &fontSettings);
+    // Highlights the code of the text that starts at the column.
+    void highlightCode(const QString &text, int column, FoldingState &foldingState);
+    void updateFolding(int level, int previousLevel);
+    void updateParentheses(const Tokens &tokens);
     void setTokenFormat(const Token &token, TextEditor::TextStyle style);
     void setTokenFormatWithSpaces(const QString &text, const Token &token,
                                   TextEditor::TextStyle style);
     QTextCharFormat m_toplevelDeclFormat;
+    bool m_literate = false;
+    int m_codeColumn = 0; // of the block that is highlighted
 };
 
 } // Internal
@@ -0,0 +1,165 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellhoverhandler.h"
+
+#include "ghcisession.h"
+#include "haskellhighlighter.h"
+#include "haskelllanguageclient.h"
+#include "haskellmanager.h"
+#include "haskelltokenizer.h"
+#include "literatehaskell.h"
+
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditor.h>
+
+#include <QTextBlock>
+
+using namespace TextEditor;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+void HaskellHoverHandler::abort()
+{
+    ++m_generation;
+    m_waiting.reset();
+}
+
+void HaskellHoverHandler::identifyMatch(TextEditorWidget *editorWidget, int pos,
+                                        ReportPriority report)
+{
+    ++m_generation;
+    m_waiting.reset();
+    const TextDocument *document = editorWidget->textDocument();
+    const FilePath filePath = document->filePath();
+    const HaskellLanguageServers *servers = HaskellLanguageServers::instance();
+    if (filePath.isEmpty() || (servers && servers->clientForFile(filePath))) {
+        report(Priority_None);
+        return;
+    }
+
+    // only the hovered line is tokenized, starting in the state the highlighter left before it
+    const QTextBlock block = document->document()->findBlock(pos);
+    int codeColumn = 0;
+    const Tokens tokens = HaskellHighlighter::codeTokens(
+        block, LiterateHaskell::isLiterateFile(filePath.toString()), &codeColumn);
+    const Token token = tokens.tokenAtColumn(pos - block.position() - codeColumn);
+    Request request;
+    request.expression = token.expression();
+    if (request.expression.isEmpty()) {
+        report(Priority_None);
+        return;
+    }
+    request.filePath = filePath;
+    request.key = {request.filePath.toString(), document->document()->revision(),
+                   block.blockNumber(), codeColumn + token.startCol, token.length};
+    request.modified = document->isModified();
+    request.generation = m_generation;
+    request.widget = editorWidget;
+    request.report = report;
+
+    if (const QString *type = m_cache.find(request.key)) {
+        reportType(request, *type);
+        return;
+    }
+    if (m_runningSession && m_runningSession->isRunning())
+        m_waiting = request; // sent when the answer of the running request came
+    else
+        send(request);
+}
+
+void HaskellHoverHandler::send(const Request &request)
+{
+    // hovering must not change the session the GHCi pane shows
+    GhciSession *session = HaskellManager::ghciSession(
+        request.filePath, HaskellManager::SessionActivation::Background);
+    if (!session) {
+        reportType(request, {});
+        return;
+    }
+    m_runningSession = session;
+    // :type-at answers for the file as it was loaded, reload it after it was saved
+    if (!session->isLoaded(request.filePath))
+        session->loadFile(request.filePath);
+
+    // the saved file must match the document for the span of the token
+    QStringList commands;
+    if (!request.modified) {
+        commands.append(QString(":type-at \"%1\" %2 %3 %2 %4 %5")
+                            .arg(request.filePath.toString())
+                            .arg(request.key.line + 1)
+                            .arg(request.key.column + 1)
+                            .arg(request.key.column + request.key.length + 1)
+                            .arg(request.expression));
+    }
+    // for names of other modules, and if GHCi did not collect the types of the file
+    commands.append(":type " + request.expression);
+    query(session, request, commands);
+}
+
+void HaskellHoverHandler::query(GhciSession *session, const Request &request,
+                                QStringList commands)
+{
+    const QString command = commands.takeFirst();
+    const QPointer<GhciSession> guard(session);
+    session->enqueue(command, [this, guard, request, commands](
+                                  const GhciSession::Response &response) {
+        const QString type = response.output.trimmed();
+        if (type.isEmpty() && !commands.isEmpty() && guard)
+            query(guard, request, commands);
+        else
+            finish(request, type);
+    });
+}
+
+void HaskellHoverHandler::finish(const Request &request, const QString &type)
+{
+    m_runningSession.clear();
+    m_cache.insert(request.key, type);
+    if (request.generation == m_generation)
+        reportType(request, type);
+    if (m_waiting) {
+        const Request next = *m_waiting;
+        m_waiting.reset();
+        send(next);
+    }
+}
+
+void HaskellHoverHandler::reportType(const Request &request, const QString &type)
+{
+    if (!request.widget)
+        return;
+    if (type.isEmpty()) {
+        request.report(Priority_None);
+        return;
+    }
+    setToolTip(type, Qt::PlainText);
+    request.report(Priority_Tooltip);
+}
+
+} // namespace Internal
+} // namespace Haskell
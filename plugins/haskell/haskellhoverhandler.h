@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "hovercache.h"
+
+#include <texteditor/basehoverhandler.h>
+#include <utils/filepath.h>
+
+#include <QPointer>
+
+#include <optional>
+
+namespace TextEditor { class TextEditorWidget; }
+
+namespace Haskell {
+namespace Internal {
+
+class GhciSession;
+
+// Shows the type of the hovered identifier, as GHCi tells it. The types are cached for the
+// revision of the document, so hovering the same token again answers at once. Only one request
+// is sent to GHCi at a time, and of the hovers meanwhile only the latest one is sent after it.
+// Documents of a language server are left to the hover handler of the language client.
+class HaskellHoverHandler : public TextEditor::BaseHoverHandler
+{
+public:
+    void abort() override;
+
+private:
+    class Request
+    {
+    public:
+        HoverKey key;
+        Utils::FilePath filePath;
+        QString expression;
+        bool modified = false; // the saved file differs from the document
+        int generation = 0;
+        QPointer<TextEditor::TextEditorWidget> widget;
+        ReportPriority report;
+    };
+
+    void identifyMatch(TextEditor::TextEditorWidget *editorWidget, int pos,
+                       ReportPriority report) override;
+    void send(const Request &request);
+    void query(GhciSession *session, const Request &request, QStringList commands);
+    void finish(const Request &request, const QString &type);
+    void reportType(const Request &request, const QString &type);
+
+    HoverCache m_cache;
+    std::optional<Request> m_waiting;
+    QPointer<GhciSession> m_runningSession; // that answers the request in flight
+    int m_generation = 0; // of the latest hover, older answers are only cached
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "haskellindentation.h"
+
+#include "haskelltokenizer.h"
+
+#include <QSet>
+
+#include <functional>
+
+namespace Haskell {
+namespace Internal {
+
+static const int tabWidth = 8;
+
+static QString expandTabs(const QString &line)
+{
+    if (!line.contains('\t'))
+        return line;
+    QString result;
+    for (const QChar c : line) {
+        if (c == '\t')
+            result += QString(tabWidth - result.size() % tabWidth, ' ');
+        else
+            result += c;
+    }
+    return result;
+}
+
+static bool opensBlock(const QVector<Token> &tokens, int index)
+{
+    static const QSet<QString> keywords{"where", "let", "do", "of", "mdo", "rec"};
+    const Token &token = tokens.at(index);
+    if (token.type != TokenType::Keyword)
+        return false;
+    if (keywords.contains(token.text.toString()))
+        return true;
+    // LambdaCase
+    return token.isKeyword("case") && index > 0 && tokens.at(index - 1).isKeyword("\\");
+}
+
+// Operators at the end of a line that the next line continues.
+static bool isContinuation(const Token &token)
+{
+    static const QSet<QString> keywords{"=", "->", "<-", "=>", "::", "|", "\\"};
+    if (token.type == TokenType::Operator || token.type == TokenType::OperatorConstructor)
+        return true;
+    return token.type == TokenType::Keyword && keywords.contains(token.text.toString());
+}
+
+static bool isLeadingOperator(const Token &token)
+{
+    static const QSet<QString> keywords{"=", "->", "=>", "::", "|"};
+    if (token.type == TokenType::Operator || token.type == TokenType::OperatorConstructor)
+        return true;
+    return token.type == TokenType::Keyword && keywords.contains(token.text.toString());
+}
+
+static bool isExpressionBlock(const LayoutContext &context)
+{
+    return context.kind == LayoutContext::If
+           || (context.kind == LayoutContext::Block && context.opener != "where"
+               && context.opener != "let");
+}
+
+// The column of the innermost layout block that encloses the top context.
+static int enclosingColumn(const QVector<LayoutContext> &contexts)
+{
+    for (int i = contexts.size() - 2; i >= 0; --i) {
+        if (contexts.at(i).kind == LayoutContext::Block && contexts.at(i).column >= 0)
+            return contexts.at(i).column;
+    }
+    return 0;
+}
+
+bool LayoutContext::operator==(const LayoutContext &other) const
+{
+    return kind == other.kind && opener == other.opener && column == other.column
+           && keywordColumn == other.keywordColumn && lineIndentation == other.lineIndentation
+           && contentColumn == other.contentColumn;
+}
+
+bool LayoutState::operator==(const LayoutState &other) const
+{
+    return contexts == other.contexts && tokenizerState == other.tokenizerState
+           && inModuleHeader == other.inModuleHeader && lineIndentation == other.lineIndentation
+           && startsWithOperator == other.startsWithOperator && continues == other.continues;
+}
+
+LayoutState HaskellIndentation::nextState(const LayoutState &state, const QString &line)
+{
+    LayoutState result = state;
+    const Tokens lineTokens = HaskellTokenizer::tokenize(expandTabs(line), state.tokenizerState);
+    result.tokenizerState = lineTokens.state;
+    const QVector<Token> tokens = lineTokens.code();
+    if (tokens.isEmpty())
+        return result;
+    QVector<LayoutContext> &contexts = result.contexts;
+    const Token &first = tokens.first();
+    const int column = first.startCol;
+
+    // a block's column is the column of the first token after the keyword, a block is empty
+    // if that is not to the right of the enclosing block
+    if (!contexts.isEmpty() && contexts.last().kind == LayoutContext::Block
+        && contexts.last().column < 0) {
+        if (column > enclosingColumn(contexts))
+            contexts.last().column = column;
+        else
+            contexts.removeLast();
+    }
+    // the offside rule closes the blocks to the right of the line
+    const bool continuesIf = first.isKeyword("then") || first.isKeyword("else");
+    while (!contexts.isEmpty() && contexts.last().kind != LayoutContext::Bracket) {
+        const LayoutContext &context = contexts.last();
+        if (context.column < column
+            || (context.column == column
+                && (context.kind == LayoutContext::Block || continuesIf))) {
+            break;
+        }
+        contexts.removeLast();
+    }
+    if (contexts.isEmpty() && first.isKeyword("module"))
+        result.inModuleHeader = true;
+
+    for (int i = 0; i < tokens.size(); ++i) {
+        const Token &token = tokens.at(i);
+        const Token *next = i + 1 < tokens.size() ? &tokens.at(i + 1) : nullptr;
+        if (opensBlock(tokens, i)) {
+            if (token.isKeyword("where") && result.inModuleHeader) {
+                result.inModuleHeader = false;
+                continue;
+            }
+            // where belongs to a declaration, not to the expression before it
+            if (token.isKeyword("where")) {
+                while (!contexts.isEmpty() && isExpressionBlock(contexts.last()))
+                    contexts.removeLast();
+            }
+            // explicit braces are a bracket
+            if (next && next->isSpecial("{"))
+                continue;
+            LayoutContext context;
+            context.opener = token.text.toString();
+            context.column = next ? next->startCol : -1;
+            context.keywordColumn = token.startCol;
+            context.lineIndentation = column;
+            contexts.append(context);
+        } else if (token.isKeyword("in")) {
+            for (int j = contexts.size() - 1; j >= 0; --j) {
+                if (contexts.at(j).kind == LayoutContext::Bracket)
+                    break;
+                if (contexts.at(j).opener == "let") {
+                    contexts.resize(j);
+                    break;
+                }
+            }
+        } else if (token.isKeyword("if")) {
+            LayoutContext context;
+            context.kind = LayoutContext::If;
+            context.opener = "if";
+            context.column = token.startCol;
+            context.keywordColumn = token.startCol;
+            context.lineIndentation = column;
+            contexts.append(context);
+        } else if (token.isSpecial("([{")) {
+            LayoutContext context;
+            context.kind = LayoutContext::Bracket;
+            context.opener = token.text.toString();
+            context.column = token.startCol;
+            context.keywordColumn = token.startCol;
+            context.lineIndentation = column;
+            if (next && !next->isSpecial(")]}"))
+                context.contentColumn = next->startCol;
+            contexts.append(context);
+        } else if (token.isSpecial(")]}")) {
+            // closes the blocks in the bracket as well
+            for (int j = contexts.size() - 1; j >= 0; --j) {
+                if (contexts.at(j).kind == LayoutContext::Bracket) {
+                    contexts.resize(j);
+                    break;
+                }
+            }
+        }
+    }
+
+    result.lineIndentation = column;
+    result.startsWithOperator = isLeadingOperator(first);
+    result.continues = isContinuation(tokens.last());
+    return result;
+}
+
+int HaskellIndentation::indentation(const LayoutState &state, const QString &line,
+                                    int indentSize)
+{
+    if (state.tokenizerState != int(Tokens::State::None))
+        return -1;
+    const QVector<Token> tokens = HaskellTokenizer::tokenize(expandTabs(line),
+                                                             state.tokenizerState).code();
+    const QVector<LayoutContext> &contexts = state.contexts;
+    const auto innermost = [&contexts](const std::function<bool(const LayoutContext &)> &match,
+                                       bool stopAtBracket) -> const LayoutContext * {
+        for (int i = contexts.size() - 1; i >= 0; --i) {
+            if (match(contexts.at(i)))
+                return &contexts.at(i);
+            if (stopAtBracket && contexts.at(i).kind == LayoutContext::Bracket)
+                break;
+        }
+        return nullptr;
+    };
+    const auto isBracket = [](const LayoutContext &context) {
+        return context.kind == LayoutContext::Bracket;
+    };
+
+    if (!tokens.isEmpty()) {
+        const Token &first = tokens.first();
+        // closing brackets and leading commas line up with the opening bracket
+        if (first.isSpecial(")]},")) {
+            if (const LayoutContext *bracket = innermost(isBracket, false))
+                return bracket->column;
+        }
+        if (first.isKeyword("where")) {
+            const LayoutContext *declarations = innermost(
+                [](const LayoutContext &context) {
+                    return context.kind == LayoutContext::Block && context.column >= 0
+                           && !isExpressionBlock(context);
+                },
+                true);
+            return (declarations ? declarations->column : 0) + indentSize;
+        }
+        if (first.isKeyword("then") || first.isKeyword("else")) {
+            const LayoutContext *ifContext = innermost(
+                [](const LayoutContext &context) { return context.kind == LayoutContext::If; },
+                true);
+            if (ifContext)
+                return ifContext->column + indentSize;
+        }
+        if (first.isKeyword("in")) {
+            const LayoutContext *let = innermost(
+                [](const LayoutContext &context) { return context.opener == "let"; }, true);
+            if (let)
+                return let->keywordColumn;
+        }
+        // guards, the constructors of data declarations and operator chains line up
+        if (isLeadingOperator(first) && !state.continues) {
+            if (state.startsWithOperator)
+                return state.lineIndentation;
+            return state.lineIndentation + indentSize;
+        }
+    }
+
+    if (contexts.isEmpty() || contexts.last().kind == LayoutContext::Block) {
+        if (state.continues)
+            return state.lineIndentation + indentSize;
+    }
+    if (contexts.isEmpty())
+        return state.inModuleHeader ? indentSize : 0;
+    const LayoutContext &top = contexts.last();
+    switch (top.kind) {
+    case LayoutContext::Block:
+        // the keyword ended the line
+        if (top.column < 0)
+            return top.lineIndentation + indentSize;
+        return top.column;
+    case LayoutContext::Bracket:
+        if (top.contentColumn >= 0)
+            return top.contentColumn;
+        return top.lineIndentation + indentSize;
+    case LayoutContext::If:
+        // then and else are expected
+        break;
+    }
+    return top.column + indentSize;
+}
+
+bool HaskellIndentation::isElectricLine(const QString &line, QChar typedChar)
+{
+    const QString trimmed = line.trimmed();
+    if (trimmed.isEmpty())
+        return false;
+    if (QString(")]},|").contains(typedChar))
+        return trimmed.startsWith(typedChar);
+    static const QStringList keywords{"then", "else", "where", "in"};
+    for (const QString &keyword : keywords) {
+        if (keyword.endsWith(typedChar) && trimmed == keyword)
+            return true;
+    }
+    return false;
+}
+
+} // namespace Internal
+} // namespace Haskell
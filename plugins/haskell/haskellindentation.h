@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+// A block of the layout rule, opened by where, let, do, of, \case, mdo or rec, a bracket, or an
+// if whose then and else are on later lines.
+class LayoutContext
+{
+public:
+    enum Kind { Block, Bracket, If };
+
+    bool operator==(const LayoutContext &other) const;
+    bool operator!=(const LayoutContext &other) const { return !(*this == other); }
+
+    Kind kind = Block;
+    QString opener;
+    int column = -1; // of the first token in a block, -1 until a token follows the keyword
+    int keywordColumn = 0; // of the keyword or bracket
+    int lineIndentation = 0; // of the line with the keyword or bracket
+    int contentColumn = -1; // of the first token after a bracket on the same line
+};
+
+// The open layout contexts after a line, and what is needed to indent the next line.
+class LayoutState
+{
+public:
+    bool operator==(const LayoutState &other) const;
+    bool operator!=(const LayoutState &other) const { return !(*this == other); }
+
+    QVector<LayoutContext> contexts;
+    int tokenizerState = -1;
+    bool inModuleHeader = false; // between "module" and its "where"
+    // of the last line with code
+    int lineIndentation = 0;
+    bool startsWithOperator = false;
+    bool continues = false; // ended with an operator, "=", "->" and the like
+};
+
+// The layout rule of Haskell, applied line by line so the state after each line can be kept.
+// Columns count tabs to the next multiple of 8, like the compiler does.
+class HaskellIndentation
+{
+public:
+    static LayoutState nextState(const LayoutState &state, const QString &line);
+    // Returns -1 if the line is in a multi-line comment or string, which is left alone.
+    static int indentation(const LayoutState &state, const QString &line, int indentSize);
+    // Whether typing the character can change the indentation of the line, like the last
+    // letter of "then" at its start.
+    static bool isElectricLine(const QString &line, QChar typedChar);
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "haskellindenter.h"
+
+#include "literatehaskell.h"
+
+#include <texteditor/tabsettings.h>
+#include <texteditor/textdocumentlayout.h>
+
+#include <QTextDocument>
+
+#include <algorithm>
+
+using namespace TextEditor;
+
+namespace Haskell {
+namespace Internal {
+
+class LayoutStateData : public CodeFormatterData
+{
+public:
+    LayoutState state;
+    bool inCodeBlock = false; // of literate Haskell
+};
+
+static const LayoutStateData *cachedState(const QTextBlock &block)
+{
+    const TextBlockUserData *userData = TextDocumentLayout::textUserData(block);
+    return userData ? static_cast<const LayoutStateData *>(userData->codeFormatterData())
+                    : nullptr;
+}
+
+HaskellIndenter::HaskellIndenter(QTextDocument *doc)
+    : TextIndenter(doc)
+{
+    m_contentsChangeConnection = QObject::connect(doc, &QTextDocument::contentsChange, doc,
+                                                  [this](int position) {
+        m_firstInvalidBlock = std::min(m_firstInvalidBlock,
+                                       m_doc->findBlock(position).blockNumber());
+    });
+}
+
+HaskellIndenter::~HaskellIndenter()
+{
+    QObject::disconnect(m_contentsChangeConnection);
+}
+
+void HaskellIndenter::setLiterate(bool literate)
+{
+    if (literate == m_literate)
+        return;
+    m_literate = literate;
+    m_firstInvalidBlock = 0;
+}
+
+bool HaskellIndenter::isElectricCharacter(const QChar &ch) const
+{
+    // the last characters of then, else, where and in
+    return QString(")]},|en").contains(ch);
+}
+
+void HaskellIndenter::indentBlock(const QTextBlock &block,
+                                  const QChar &typedChar,
+                                  const TabSettings &tabSettings,
+                                  int cursorPositionInEditor)
+{
+    if (!typedChar.isNull() && !HaskellIndentation::isElectricLine(block.text(), typedChar))
+        return;
+    const int indent = indentFor(block, tabSettings, cursorPositionInEditor);
+    if (indent >= 0)
+        tabSettings.indentLine(block, indent);
+}
+
+int HaskellIndenter::indentFor(const QTextBlock &block,
+                               const TabSettings &tabSettings,
+                               int /*cursorPositionInEditor*/)
+{
+    const QTextBlock previous = block.previous();
+    bool inCodeBlock = false;
+    const LayoutState state = previous.isValid() ? stateAfter(previous, &inCodeBlock)
+                                                 : LayoutState();
+    if (m_literate
+        && LiterateHaskell::lineType(block.text(), inCodeBlock)
+               != LiterateHaskell::LineType::Code) {
+        return -1;
+    }
+    return HaskellIndentation::indentation(state, block.text(), tabSettings.m_indentSize);
+}
+
+LayoutState HaskellIndenter::stateAfter(const QTextBlock &block, bool *inCodeBlock)
+{
+    QTextBlock start = block;
+    while (start.isValid()
+           && (start.blockNumber() >= m_firstInvalidBlock || !cachedState(start))) {
+        start = start.previous();
+    }
+    LayoutState state = start.isValid() ? cachedState(start)->state : LayoutState();
+    *inCodeBlock = start.isValid() && cachedState(start)->inCodeBlock;
+    for (QTextBlock current = start.isValid() ? start.next() : m_doc->firstBlock();
+         current.isValid() && current.blockNumber() <= block.blockNumber();
+         current = current.next()) {
+        const QString text = current.text();
+        if (!m_literate) {
+            state = HaskellIndentation::nextState(state, text);
+        } else {
+            // prose keeps the state of the code for the next code line
+            const LiterateHaskell::LineType type = LiterateHaskell::lineType(text, *inCodeBlock);
+            if (type == LiterateHaskell::LineType::CodeDelimiter)
+                *inCodeBlock = !*inCodeBlock;
+            else if (type != LiterateHaskell::LineType::Prose)
+                state = HaskellIndentation::nextState(state, LiterateHaskell::code(text, type));
+        }
+        auto data = new LayoutStateData;
+        data->state = state;
+        data->inCodeBlock = *inCodeBlock;
+        TextDocumentLayout::userData(current)->setCodeFormatterData(data);
+    }
+    m_firstInvalidBlock = std::max(m_firstInvalidBlock, block.blockNumber() + 1);
+    return state;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,67 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "haskellindentation.h"
+
+#include <texteditor/textindenter.h>
+
+#include <QMetaObject>
+
+namespace Haskell {
+namespace Internal {
+
+// Indents by the layout rule. The layout state after each block is kept with the block, only
+// the blocks from the first changed one up to the indented one are scanned again. Of literate
+// Haskell, only the lines in \begin{code} blocks are indented, prose and bird track lines are
+// left as they are.
+class HaskellIndenter : public TextEditor::TextIndenter
+{
+public:
+    explicit HaskellIndenter(QTextDocument *doc);
+    ~HaskellIndenter() override;
+
+    void setLiterate(bool literate);
+
+    bool isElectricCharacter(const QChar &ch) const override;
+    void indentBlock(const QTextBlock &block,
+                     const QChar &typedChar,
+                     const TextEditor::TabSettings &tabSettings,
+                     int cursorPositionInEditor = -1) override;
+    int indentFor(const QTextBlock &block,
+                  const TextEditor::TabSettings &tabSettings,
+                  int cursorPositionInEditor = -1) override;
+
+private:
+    LayoutState stateAfter(const QTextBlock &block, bool *inCodeBlock);
+
+    QMetaObject::Connection m_contentsChangeConnection;
+    int m_firstInvalidBlock = 0; // the states of the blocks before are up to date
+    bool m_literate = false;
+};
+
+} // namespace Internal
+} // namespace Haskell
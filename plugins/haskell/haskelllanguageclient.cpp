@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskelllanguageclient.h"
+
+#include "haskellmanager.h"
+
+#include <coreplugin/editormanager/documentmodel.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/messagemanager.h>
+#include <languageclient/languageclientinterface.h>
+#include <languageclient/languageclientmanager.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/session.h>
+#include <texteditor/textdocument.h>
+#include <utils/algorithm.h>
+#include <utils/mimeutils.h>
+
+#include <QJsonObject>
+
+using namespace LanguageClient;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+// collects the changes of typing into one didChange notification
+static const int documentChangeThreshold = 300;
+
+static HaskellLanguageServers *m_instance = nullptr;
+
+static BaseClientInterface *createInterface(const FilePath &executable, const FilePath &root)
+{
+    auto interface = new StdIOClientInterface;
+    interface->setCommandLine(CommandLine(executable, {"--lsp"}));
+    interface->setWorkingDirectory(root);
+    return interface;
+}
+
+HaskellLanguageClient::HaskellLanguageClient(const FilePath &executable, const FilePath &root)
+    : Client(createInterface(executable, root))
+    , m_root(root)
+{
+    setName(tr("Haskell Language Server (%1)").arg(root.fileName()));
+    LanguageFilter filter;
+    filter.mimeTypes = QStringList{"text/x-haskell", "text/x-literate-haskell"};
+    setSupportedLanguage(filter);
+    setActivateDocumentAutomatically(true);
+    setDocumentChangeUpdateThreshold(documentChangeThreshold);
+    // the semantic tokens of haskell-language-server are off by default
+    const QJsonObject semanticTokens{{"globalOn", true}};
+    const QJsonObject plugin{{"semanticTokens", semanticTokens}};
+    setInitializationOptions(QJsonObject{{"haskell", QJsonObject{{"plugin", plugin}}}});
+    setCurrentProject(Utils::findOrDefault(ProjectExplorer::SessionManager::projects(),
+                                           [root](ProjectExplorer::Project *project) {
+                                               return project->projectDirectory() == root;
+                                           }));
+}
+
+bool HaskellLanguageClient::providesSemanticTokens() const
+{
+    return reachable() && capabilities().semanticTokensProvider().has_value();
+}
+
+HaskellLanguageServers::HaskellLanguageServers()
+{
+    m_instance = this;
+    connect(Core::EditorManager::instance(), &Core::EditorManager::documentOpened,
+            this, &HaskellLanguageServers::openDocument);
+    connect(HaskellManager::instance(), &HaskellManager::hlsExecutableChanged,
+            this, &HaskellLanguageServers::restart);
+}
+
+HaskellLanguageServers::~HaskellLanguageServers()
+{
+    m_instance = nullptr;
+}
+
+HaskellLanguageServers *HaskellLanguageServers::instance()
+{
+    return m_instance;
+}
+
+static FilePath rootForFile(const FilePath &filePath)
+{
+    const FilePath projectDirectory = HaskellManager::findProjectDirectory(filePath);
+    return projectDirectory.isEmpty() ? filePath.absolutePath() : projectDirectory;
+}
+
+HaskellLanguageClient *HaskellLanguageServers::clientForFile(const FilePath &filePath) const
+{
+    HaskellLanguageClient *client = m_clients.value(rootForFile(filePath));
+    return client && client->reachable() ? client : nullptr;
+}
+
+void HaskellLanguageServers::openDocument(Core::IDocument *document)
+{
+    auto textDocument = qobject_cast<TextEditor::TextDocument *>(document);
+    const MimeType mimeType = mimeTypeForName(document->mimeType());
+    if (!textDocument
+        || !(mimeType.inherits("text/x-haskell") || mimeType.inherits("text/x-literate-haskell"))) {
+        return;
+    }
+    const FilePath root = rootForFile(document->filePath());
+    HaskellLanguageClient *client = m_clients.value(root);
+    if (!client) {
+        client = startClient(root);
+        if (!client)
+            return;
+        m_clients.insert(root, client);
+    }
+    LanguageClientManager::openDocumentWithClient(textDocument, client);
+}
+
+HaskellLanguageClient *HaskellLanguageServers::startClient(const FilePath &root)
+{
+    const FilePath configured = HaskellManager::hlsExecutable();
+    if (configured.isEmpty())
+        return nullptr;
+    const FilePath executable = configured.searchInPath();
+    if (!executable.isExecutableFile()) {
+        if (!m_reportedMissingExecutable) {
+            Core::MessageManager::writeSilently(
+                tr("Haskell language server \"%1\" was not found.")
+                    .arg(configured.toUserOutput()));
+            m_reportedMissingExecutable = true;
+        }
+        return nullptr;
+    }
+    auto client = new HaskellLanguageClient(executable, root);
+    LanguageClientManager::startClient(client);
+    return client;
+}
+
+void HaskellLanguageServers::restart()
+{
+    for (const QPointer<HaskellLanguageClient> &client : qAsConst(m_clients)) {
+        if (client)
+            LanguageClientManager::shutdownClient(client);
+    }
+    m_clients.clear();
+    m_reportedMissingExecutable = false;
+    for (Core::IDocument *document : Core::DocumentModel::openedDocuments())
+        openDocument(document);
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <languageclient/client.h>
+#include <utils/filepath.h>
+
+#include <QHash>
+#include <QPointer>
+
+namespace Core { class IDocument; }
+
+namespace Haskell {
+namespace Internal {
+
+// A haskell-language-server for the Haskell files of one project directory.
+class HaskellLanguageClient : public LanguageClient::Client
+{
+    Q_OBJECT
+
+public:
+    HaskellLanguageClient(const Utils::FilePath &executable, const Utils::FilePath &root);
+
+    Utils::FilePath root() const { return m_root; }
+    // The language client highlights the documents then.
+    bool providesSemanticTokens() const;
+
+private:
+    Utils::FilePath m_root;
+};
+
+// Starts a language server for a project directory when the first Haskell file in it is opened,
+// and restarts them when the executable changes.
+class HaskellLanguageServers : public QObject
+{
+    Q_OBJECT
+
+public:
+    HaskellLanguageServers();
+    ~HaskellLanguageServers() override;
+
+    static HaskellLanguageServers *instance();
+
+    // Returns the running client for the file, if any.
+    HaskellLanguageClient *clientForFile(const Utils::FilePath &filePath) const;
+
+private:
+    void openDocument(Core::IDocument *document);
+    HaskellLanguageClient *startClient(const Utils::FilePath &root);
+    void restart();
+
+    QHash<Utils::FilePath, QPointer<HaskellLanguageClient>> m_clients; // by project directory
+    bool m_reportedMissingExecutable = false;
+};
+
+} // namespace Internal
+} // namespace Haskell
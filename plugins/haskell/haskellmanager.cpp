@@ -25,13 +25,13 @@
 
 #include "haskellmanager.h"
 
-#include <coreplugin/messagemanager.h>
+#include "ghcioutputpane.h"
+#include "ghcisession.h"
+
 #include <utils/algorithm.h>
-#include <utils/commandline.h>
 #include <utils/hostosinfo.h>
 #include <utils/mimeutils.h>
-#include <utils/processenums.h>
-#include <utils/qtcprocess.h>
+#include <utils/qtcassert.h>
 
 #include <QCoreApplication>
 #include <QDir>
@@ -41,6 +41,7 @@
 #include <unordered_map>
 
 static const char kStackExecutableKey[] = "Haskell/StackExecutable";
+static const char kHlsExecutableKey[] = "Haskell/HlsExecutable";
 
 using namespace Utils;
 
@@ -51,6 +52,7 @@ class HaskellManagerPrivate
 {
 public:
     FilePath stackExecutable;
+    FilePath hlsExecutable;
 };
 
 Q_GLOBAL_STATIC(HaskellManagerPrivate, m_d)
@@ -99,26 +101,50 @@ void HaskellManager::setStackExecutable(const FilePath &filePath)
     emit m_instance->stackExecutableChanged(m_d->stackExecutable);
 }
 
+FilePath defaultHlsExecutable()
+{
+    // the wrapper chooses the server that matches the GHC version of the project
+    return FilePath::fromString("haskell-language-server-wrapper");
+}
+
+FilePath HaskellManager::hlsExecutable()
+{
+    return m_d->hlsExecutable;
+}
+
+void HaskellManager::setHlsExecutable(const FilePath &filePath)
+{
+    if (filePath == m_d->hlsExecutable)
+        return;
+    m_d->hlsExecutable = filePath;
+    emit m_instance->hlsExecutableChanged(m_d->hlsExecutable);
+}
+
+GhciSession *HaskellManager::ghciSession(const FilePath &haskellFile,
+                                         SessionActivation activation)
+{
+    GhciOutputPane *pane = GhciOutputPane::instance();
+    QTC_ASSERT(pane, return nullptr);
+    FilePath projectDirectory = findProjectDirectory(haskellFile);
+    if (projectDirectory.isEmpty())
+        projectDirectory = haskellFile.absolutePath();
+    if (activation == SessionActivation::Background)
+        return pane->session(projectDirectory, {});
+    return pane->activateSession(projectDirectory, {});
+}
+
 void HaskellManager::openGhci(const FilePath &haskellFile)
 {
     const QList<MimeType> mimeTypes = mimeTypesForFileName(haskellFile.toString());
     const bool isHaskell = Utils::anyOf(mimeTypes, [](const MimeType &mt) {
         return mt.inherits("text/x-haskell") || mt.inherits("text/x-literate-haskell");
     });
-    const auto args = QStringList{"ghci"}
-                      + (isHaskell ? QStringList{haskellFile.fileName()} : QStringList());
-    auto p = new QtcProcess(m_instance);
-    p->setTerminalMode(TerminalMode::On);
-    p->setCommand({stackExecutable(), args});
-    p->setWorkingDirectory(haskellFile.absolutePath());
-    connect(p, &QtcProcess::done, p, [p] {
-        if (p->result() != ProcessResult::FinishedWithSuccess) {
-            Core::MessageManager::writeDisrupting(
-                tr("Failed to run GHCi: \"%1\".").arg(p->errorString()));
-        }
-        p->deleteLater();
-    });
-    p->start();
+    GhciSession *session = ghciSession(haskellFile);
+    QTC_ASSERT(session, return);
+    if (isHaskell)
+        session->loadFile(haskellFile);
+    GhciOutputPane::instance()->popup(Core::IOutputPane::ModeSwitch
+                                      | Core::IOutputPane::WithFocus);
 }
 
 void HaskellManager::readSettings(QSettings *settings)
@@ -127,6 +153,9 @@ void HaskellManager::readSettings(QSettings *settings)
                 settings->value(kStackExecutableKey,
                                 defaultStackExecutable().toString()).toString());
     emit m_instance->stackExecutableChanged(m_d->stackExecutable);
+    m_d->hlsExecutable = FilePath::fromString(
+                settings->value(kHlsExecutableKey, defaultHlsExecutable().toString()).toString());
+    emit m_instance->hlsExecutableChanged(m_d->hlsExecutable);
 }
 
 void HaskellManager::writeSettings(QSettings *settings)
@@ -135,6 +164,10 @@ void HaskellManager::writeSettings(QSettings *settings)
         settings->remove(kStackExecutableKey);
     else
         settings->setValue(kStackExecutableKey, m_d->stackExecutable.toString());
+    if (m_d->hlsExecutable == defaultHlsExecutable())
+        settings->remove(kHlsExecutableKey);
+    else
+        settings->setValue(kHlsExecutableKey, m_d->hlsExecutable.toString());
 }
 
 } // namespace Internal
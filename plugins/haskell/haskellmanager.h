@@ -36,22 +36,32 @@ QT_END_NAMESPACE
 namespace Haskell {
 namespace Internal {
 
+class GhciSession;
+
 class HaskellManager : public QObject
 {
     Q_OBJECT
 
 public:
+    enum class SessionActivation { Activate, Background };
+
     static HaskellManager *instance();
 
     static Utils::FilePath findProjectDirectory(const Utils::FilePath &filePath);
     static Utils::FilePath stackExecutable();
     static void setStackExecutable(const Utils::FilePath &filePath);
+    static Utils::FilePath hlsExecutable();
+    static void setHlsExecutable(const Utils::FilePath &filePath);
+    // The session of the file's project. Background sessions don't switch the GHCi pane to them.
+    static GhciSession *ghciSession(const Utils::FilePath &haskellFile,
+                                    SessionActivation activation = SessionActivation::Activate);
     static void openGhci(const Utils::FilePath &haskellFile);
     static void readSettings(QSettings *settings);
     static void writeSettings(QSettings *settings);
 
 signals:
     void stackExecutableChanged(const Utils::FilePath &filePath);
+    void hlsExecutableChanged(const Utils::FilePath &filePath);
 };
 
 } // namespace Internal
@@ -0,0 +1,370 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskelloutline.h"
+
+#include "haskelltokenizer.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+using Line = HaskellOutline::Line;
+
+static bool isConstructor(const Token &token)
+{
+    return token.type == TokenType::Constructor || token.type == TokenType::OperatorConstructor;
+}
+
+// the code from the token at "from" up to the one before "to"
+static QString codeText(const QString &text, const QVector<Token> &code, int from, int to)
+{
+    if (from >= to)
+        return {};
+    const int start = code.at(from).startCol;
+    const int end = code.at(to - 1).startCol + code.at(to - 1).length;
+    return text.mid(start, end - start).simplified();
+}
+
+template<typename Predicate>
+static int findToken(const QVector<Token> &code, int from, int to, Predicate predicate)
+{
+    const auto end = code.cbegin() + to;
+    return std::find_if(code.cbegin() + std::min(from, to), end, predicate) - code.cbegin();
+}
+
+// a variable or an operator in parentheses, which can be declared at the top level
+static QString nameAt(const QVector<Token> &code, int *index)
+{
+    const int i = *index;
+    if (i < code.size() && code.at(i).type == TokenType::Variable
+        && !code.at(i).text.contains('.')) {
+        *index += 1;
+        return code.at(i).text.toString();
+    }
+    if (i + 2 < code.size() && code.at(i).isSpecial("(")
+        && code.at(i + 1).type == TokenType::Operator && code.at(i + 2).isSpecial(")")) {
+        *index += 3;
+        return '(' + code.at(i + 1).text.toString() + ')';
+    }
+    return {};
+}
+
+static void parseType(Line &line, const QVector<Token> &code)
+{
+    int i = 1;
+    bool isInstance = false;
+    for (; i < code.size(); ++i) {
+        if (code.at(i).isKeyword("instance"))
+            isInstance = true;
+        else if (!code.at(i).isKeyword("family"))
+            break;
+    }
+    const int end = findToken(code, i, code.size(), [](const Token &token) {
+        return token.isKeyword("=") || token.isKeyword("where") || token.isKeyword("::")
+               || token.isKeyword("deriving");
+    });
+    if (isInstance) {
+        line.kind = Line::Instance;
+        line.names = QStringList(codeText(line.text, code, i, end));
+        return;
+    }
+    const int name = findToken(code, i, end, &isConstructor);
+    if (name == end)
+        return;
+    line.kind = Line::Type;
+    line.names = QStringList(code.at(name).text.toString());
+    line.detail = codeText(line.text, code, name + 1, end);
+}
+
+static void parseClass(Line &line, const QVector<Token> &code)
+{
+    const int end = findToken(code, 1, code.size(), [](const Token &token) {
+        return token.isKeyword("where") || token.isKeyword("|");
+    });
+    const int arrow = findToken(code, 1, end, [](const Token &t) { return t.isKeyword("=>"); });
+    const int name = findToken(code, arrow < end ? arrow + 1 : 1, end, &isConstructor);
+    if (name == end)
+        return;
+    line.kind = Line::Class;
+    line.names = QStringList(code.at(name).text.toString());
+    line.detail = codeText(line.text, code, name + 1, end);
+}
+
+static void parseInstance(Line &line, const QVector<Token> &code, int keyword)
+{
+    const int end = findToken(code, keyword + 1, code.size(), [](const Token &token) {
+        return token.isKeyword("where");
+    });
+    const int arrow = findToken(code, keyword + 1, end, [](const Token &token) {
+        return token.isKeyword("=>");
+    });
+    const QString head = codeText(line.text, code, arrow < end ? arrow + 1 : keyword + 1, end);
+    if (head.isEmpty())
+        return;
+    line.kind = Line::Instance;
+    line.names = QStringList(head);
+    if (arrow < end)
+        line.detail = codeText(line.text, code, keyword + 1, arrow);
+}
+
+static void parseFunction(Line &line, const QVector<Token> &code)
+{
+    int i = 0;
+    // pattern synonyms
+    if (code.size() > 1 && code.at(0).type == TokenType::Variable
+        && code.at(0).text == QLatin1String("pattern") && isConstructor(code.at(1))) {
+        line.names = QStringList(code.at(1).text.toString());
+        i = 2;
+    } else {
+        for (QString name = nameAt(code, &i); !name.isEmpty(); name = nameAt(code, &i)) {
+            line.names.append(name);
+            if (i >= code.size() || !code.at(i).isSpecial(","))
+                break;
+            ++i;
+        }
+    }
+    if (line.names.isEmpty())
+        return;
+    if (i < code.size() && code.at(i).isKeyword("::")) {
+        line.kind = Line::Signature;
+        line.detail = codeText(line.text, code, i + 1, code.size());
+        return;
+    }
+    if (line.names.size() > 1)
+        return;
+    // operators defined infix, like "x <+> y = ..." or "x `op` y = ..."
+    if (i < code.size() && code.at(i).type == TokenType::Operator) {
+        line.names = QStringList('(' + code.at(i).text.toString() + ')');
+    } else if (i + 2 < code.size() && code.at(i).isSpecial("`")
+               && code.at(i + 1).type == TokenType::Variable && code.at(i + 2).isSpecial("`")) {
+        line.names = QStringList(code.at(i + 1).text.toString());
+    }
+    const int equals = findToken(code, i, code.size(), [](const Token &token) {
+        return token.isKeyword("=") || token.isKeyword("|");
+    });
+    line.kind = equals < code.size() ? Line::Function : Line::Head;
+}
+
+static void parseDeclaration(Line &line, const QVector<Token> &code)
+{
+    const Token &first = code.first();
+    if (first.isKeyword("module")) {
+        const int name = findToken(code, 1, code.size(), &isConstructor);
+        if (name < code.size()) {
+            line.kind = Line::Module;
+            line.names = QStringList(code.at(name).text.toString());
+        }
+    } else if (first.isKeyword("import")) {
+        // skips "qualified", "safe", package names and the like
+        const int name = findToken(code, 1, code.size(), &isConstructor);
+        if (name < code.size()) {
+            line.kind = Line::Import;
+            line.names = QStringList(code.at(name).text.toString());
+            line.detail = codeText(line.text, code, name + 1, code.size());
+        }
+    } else if (first.isKeyword("data") || first.isKeyword("newtype")
+               || first.isKeyword("type")) {
+        parseType(line, code);
+    } else if (first.isKeyword("class")) {
+        parseClass(line, code);
+    } else if (first.isKeyword("instance")) {
+        parseInstance(line, code, 0);
+    } else if (first.isKeyword("deriving")) {
+        // standalone deriving, with an optional strategy
+        const int keyword = findToken(code, 1, std::min(3, int(code.size())), [](const Token &t) {
+            return t.isKeyword("instance");
+        });
+        if (keyword < std::min(3, int(code.size())))
+            parseInstance(line, code, keyword);
+    } else if (first.isKeyword("foreign")) {
+        const int signature = findToken(code, 1, code.size(), [](const Token &token) {
+            return token.isKeyword("::");
+        });
+        if (signature > 1 && signature < code.size()
+            && code.at(signature - 1).type == TokenType::Variable) {
+            line.kind = Line::Signature;
+            line.names = QStringList(code.at(signature - 1).text.toString());
+            line.detail = codeText(line.text, code, signature + 1, code.size());
+        }
+    } else {
+        parseFunction(line, code);
+    }
+}
+
+bool OutlineItem::operator==(const OutlineItem &other) const
+{
+    return kind == other.kind && name == other.name && detail == other.detail
+           && line == other.line && column == other.column;
+}
+
+bool HaskellOutline::LineState::operator==(const LineState &other) const
+{
+    return tokenizerState == other.tokenizerState && continues == other.continues;
+}
+
+Line HaskellOutline::parseLine(const QString &text, const LineState &startState)
+{
+    Line line;
+    line.text = text;
+    line.startState = startState;
+    const Tokens tokens = HaskellTokenizer::tokenize(text, startState.tokenizerState);
+    line.endState.tokenizerState = tokens.state;
+    line.endState.continues = startState.continues;
+    // the rest of a comment or string belongs to the line that starts it
+    if (startState.tokenizerState != int(Tokens::State::None))
+        return line;
+    const QVector<Token> code = tokens.code();
+    if (code.isEmpty())
+        return line;
+    if (code.first().startCol > 0) {
+        if (startState.continues) {
+            line.kind = Line::Continuation;
+            line.detail = codeText(text, code, 0, code.size());
+        }
+        return line;
+    }
+    parseDeclaration(line, code);
+    line.endState.continues = line.kind == Line::Signature || line.kind == Line::Head;
+    return line;
+}
+
+void HaskellOutline::update(int firstLine, int removedLines, const QStringList &lines)
+{
+    firstLine = std::clamp(firstLine, 0, int(m_lines.size()));
+    removedLines = std::clamp(removedLines, 0, int(m_lines.size()) - firstLine);
+    LineState state = firstLine > 0 ? m_lines.at(firstLine - 1).endState : LineState();
+    QVector<Line> parsed;
+    parsed.reserve(lines.size());
+    for (const QString &text : lines) {
+        parsed.append(parseLine(text, state));
+        state = parsed.last().endState;
+    }
+
+    const auto first = m_lines.begin() + firstLine;
+    const int common = std::min(removedLines, int(parsed.size()));
+    if (removedLines > common)
+        m_lines.erase(first + common, first + removedLines);
+    else if (parsed.size() > common)
+        m_lines.insert(first + common, parsed.size() - common, Line());
+    std::move(parsed.begin(), parsed.end(), m_lines.begin() + firstLine);
+
+    for (int i = firstLine + parsed.size(); i < m_lines.size(); ++i) {
+        if (m_lines.at(i).startState == state)
+            break;
+        m_lines[i] = parseLine(m_lines.at(i).text, state);
+        state = m_lines.at(i).endState;
+    }
+}
+
+// the code of the lines continuing the declaration in the given line
+QString HaskellOutline::continuation(int line) const
+{
+    QStringList parts;
+    for (int i = line + 1; i < m_lines.size() && m_lines.at(i).startState.continues; ++i) {
+        const Line &current = m_lines.at(i);
+        if (current.kind == Line::Continuation)
+            parts.append(current.detail);
+        else if (current.kind != Line::None)
+            break;
+    }
+    return parts.join(' ');
+}
+
+QVector<OutlineItem> HaskellOutline::items() const
+{
+    QVector<OutlineItem> result;
+    auto addItem = [&result](OutlineItem::Kind kind, const QString &name, const QString &detail,
+                             int line) {
+        OutlineItem item;
+        item.kind = kind;
+        item.name = name;
+        item.detail = detail;
+        item.line = line;
+        result.append(item);
+    };
+    // the equations of a function and its signature give one item
+    QHash<QString, int> functions;
+    auto addFunction = [&](const QString &name, const QString &signature, int line) {
+        const auto it = functions.constFind(name);
+        if (it == functions.cend()) {
+            functions.insert(name, result.size());
+            addItem(OutlineItem::Function, name, signature, line);
+        } else if (result.at(*it).detail.isEmpty()) {
+            result[*it].detail = signature;
+        }
+    };
+
+    for (int i = 0; i < m_lines.size(); ++i) {
+        const Line &line = m_lines.at(i);
+        switch (line.kind) {
+        case Line::Module:
+            addItem(OutlineItem::Module, line.names.first(), line.detail, i);
+            break;
+        case Line::Import:
+            addItem(OutlineItem::Import, line.names.first(), line.detail, i);
+            break;
+        case Line::Type:
+            addItem(OutlineItem::Type, line.names.first(), line.detail, i);
+            break;
+        case Line::Class:
+            addItem(OutlineItem::Class, line.names.first(), line.detail, i);
+            break;
+        case Line::Instance:
+            addItem(OutlineItem::Instance, line.names.first(), line.detail, i);
+            break;
+        case Line::Signature: {
+            const QString signature = (line.detail + ' ' + continuation(i)).trimmed();
+            for (const QString &name : line.names)
+                addFunction(name, signature, i);
+            break;
+        }
+        case Line::Head: {
+            // "name" followed by ":: type", or a function with guards or "=" on the next line
+            const QString rest = continuation(i);
+            if (rest.startsWith("::")) {
+                for (const QString &name : line.names)
+                    addFunction(name, rest.mid(2).trimmed(), i);
+            } else if (rest.startsWith('|') || rest.contains('=')) {
+                addFunction(line.names.first(), {}, i);
+            }
+            break;
+        }
+        case Line::Function:
+            addFunction(line.names.first(), {}, i);
+            break;
+        case Line::None:
+        case Line::Continuation:
+            break;
+        }
+    }
+    return result;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+// A top-level declaration of a module.
+class OutlineItem
+{
+public:
+    enum Kind { Module, Import, Type, Class, Instance, Function };
+
+    bool operator==(const OutlineItem &other) const;
+    bool operator!=(const OutlineItem &other) const { return !(*this == other); }
+
+    Kind kind = Function;
+    QString name;
+    QString detail; // the type signature of functions, the parameters of types and classes
+    int line = 0; // from 0
+    int column = 0;
+};
+
+// The declarations of a module, found line by line from the tokens of the lines. Each line keeps
+// what it declares and the state at its start, so an edit only scans the changed lines, and the
+// lines after them only while the state at their start changes, like when a comment is opened.
+class HaskellOutline
+{
+public:
+    int lineCount() const { return m_lines.size(); }
+    // Replaces removedLines lines starting at firstLine with the given lines.
+    void update(int firstLine, int removedLines, const QStringList &lines);
+    QVector<OutlineItem> items() const;
+
+    class LineState
+    {
+    public:
+        bool operator==(const LineState &other) const;
+        bool operator!=(const LineState &other) const { return !(*this == other); }
+
+        int tokenizerState = -1;
+        bool continues = false; // in a type signature or a declaration continued on this line
+    };
+
+    class Line
+    {
+    public:
+        enum Kind {
+            None,
+            Module,
+            Import,
+            Type,
+            Class,
+            Instance,
+            Signature,
+            Function,
+            Head, // a name at the start of a line, the next lines tell what it is
+            Continuation
+        };
+
+        QString text;
+        LineState startState;
+        LineState endState;
+        Kind kind = None;
+        QStringList names;
+        QString detail; // the code of continuations
+    };
+
+    static Line parseLine(const QString &text, const LineState &startState);
+
+private:
+    QString continuation(int line) const;
+
+    QVector<Line> m_lines;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskelloutlinewidget.h"
+
+#include "haskellconstants.h"
+#include "haskelldocumentoutline.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditor.h>
+#include <utils/navigationtreeview.h>
+
+#include <QVBoxLayout>
+
+using namespace TextEditor;
+
+namespace Haskell {
+namespace Internal {
+
+static void gotoDeclaration(TextEditorWidget *editorWidget, const QModelIndex &index)
+{
+    if (!index.isValid())
+        return;
+    Core::EditorManager::cutForwardNavigationHistory();
+    Core::EditorManager::addCurrentPositionToNavigationHistory();
+    editorWidget->gotoLine(index.data(HaskellDocumentOutline::LineRole).toInt() + 1,
+                           index.data(HaskellDocumentOutline::ColumnRole).toInt());
+    editorWidget->setFocus();
+}
+
+HaskellOutlineWidget::HaskellOutlineWidget(TextEditorWidget *editorWidget)
+    : m_editorWidget(editorWidget)
+    , m_outline(HaskellDocumentOutline::forDocument(editorWidget->textDocument()))
+    , m_view(new Utils::NavigationTreeView(this))
+{
+    m_view->setModel(m_outline->model());
+    m_view->setHeaderHidden(true);
+    m_view->setExpandsOnDoubleClick(false);
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    layout->addWidget(m_view);
+
+    connect(m_view, &QAbstractItemView::activated, this, &HaskellOutlineWidget::gotoItem);
+    connect(editorWidget, &QPlainTextEdit::cursorPositionChanged,
+            this, &HaskellOutlineWidget::updateSelection);
+    connect(m_outline, &HaskellDocumentOutline::outlineChanged,
+            this, &HaskellOutlineWidget::updateSelection);
+}
+
+void HaskellOutlineWidget::setCursorSynchronization(bool syncWithCursor)
+{
+    m_syncWithCursor = syncWithCursor;
+    updateSelection();
+}
+
+void HaskellOutlineWidget::updateSelection()
+{
+    if (!m_syncWithCursor || m_blockCursorSync || !m_editorWidget)
+        return;
+    const QModelIndex index = m_outline->indexForLine(m_editorWidget->textCursor().blockNumber());
+    if (!index.isValid()) {
+        m_view->clearSelection();
+        return;
+    }
+    m_view->setCurrentIndex(index);
+    m_view->scrollTo(index);
+}
+
+void HaskellOutlineWidget::gotoItem(const QModelIndex &index)
+{
+    if (!m_editorWidget)
+        return;
+    m_blockCursorSync = true;
+    gotoDeclaration(m_editorWidget, index);
+    m_blockCursorSync = false;
+}
+
+bool HaskellOutlineWidgetFactory::supportsEditor(Core::IEditor *editor) const
+{
+    return qobject_cast<BaseTextEditor *>(editor)
+           && editor->document()->id() == Constants::C_HASKELLEDITOR_ID;
+}
+
+IOutlineWidget *HaskellOutlineWidgetFactory::createWidget(Core::IEditor *editor)
+{
+    auto textEditor = qobject_cast<BaseTextEditor *>(editor);
+    return textEditor ? new HaskellOutlineWidget(textEditor->editorWidget()) : nullptr;
+}
+
+HaskellOutlineComboBox::HaskellOutlineComboBox(TextEditorWidget *editorWidget)
+    : m_editorWidget(editorWidget)
+    , m_outline(HaskellDocumentOutline::forDocument(editorWidget->textDocument()))
+{
+    setModel(m_outline->model());
+    setMinimumContentsLength(22);
+    setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setMaxVisibleItems(40);
+    setToolTip(tr("Declarations"));
+
+    connect(this, QOverload<int>::of(&QComboBox::activated), this, [this](int row) {
+        gotoDeclaration(m_editorWidget, m_outline->model()->index(row, 0));
+    });
+    connect(editorWidget, &QPlainTextEdit::cursorPositionChanged,
+            this, &HaskellOutlineComboBox::updateIndex);
+    connect(m_outline, &HaskellDocumentOutline::outlineChanged,
+            this, &HaskellOutlineComboBox::updateIndex);
+}
+
+void HaskellOutlineComboBox::updateIndex()
+{
+    // only shows the top-level items, like the group of imports
+    QModelIndex index = m_outline->indexForLine(m_editorWidget->textCursor().blockNumber());
+    while (index.parent().isValid())
+        index = index.parent();
+    setCurrentIndex(index.isValid() ? index.row() : -1);
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <texteditor/ioutlinewidget.h>
+
+#include <QComboBox>
+#include <QPointer>
+
+namespace TextEditor { class TextEditorWidget; }
+namespace Utils { class NavigationTreeView; }
+
+namespace Haskell {
+namespace Internal {
+
+class HaskellDocumentOutline;
+
+class HaskellOutlineWidget : public TextEditor::IOutlineWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellOutlineWidget(TextEditor::TextEditorWidget *editorWidget);
+
+    QList<QAction *> filterMenuActions() const override { return {}; }
+    void setCursorSynchronization(bool syncWithCursor) override;
+
+private:
+    void updateSelection();
+    void gotoItem(const QModelIndex &index);
+
+    QPointer<TextEditor::TextEditorWidget> m_editorWidget;
+    HaskellDocumentOutline *m_outline;
+    Utils::NavigationTreeView *m_view;
+    bool m_syncWithCursor = false;
+    bool m_blockCursorSync = false;
+};
+
+class HaskellOutlineWidgetFactory : public TextEditor::IOutlineWidgetFactory
+{
+    Q_OBJECT
+
+public:
+    bool supportsEditor(Core::IEditor *editor) const override;
+    TextEditor::IOutlineWidget *createWidget(Core::IEditor *editor) override;
+};
+
+// The declarations of the document in the editor tool bar, with the one at the cursor selected.
+class HaskellOutlineComboBox : public QComboBox
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellOutlineComboBox(TextEditor::TextEditorWidget *editorWidget);
+
+private:
+    void updateIndex();
+
+    TextEditor::TextEditorWidget *m_editorWidget;
+    HaskellDocumentOutline *m_outline;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskelloutputrunner.h"
+
+#include "haskellanalysispane.h"
+#include "haskellconstants.h"
+#include "haskellrunconfiguration.h"
+#include "outputlog.h"
+#include "outputlogview.h"
+#include "rtsstatssampler.h"
+
+#include <projectexplorer/runconfigurationaspects.h>
+#include <utils/qtcassert.h>
+#include <utils/temporarydirectory.h>
+
+#include <QDateTime>
+#include <QDir>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+HaskellOutputRunner::HaskellOutputRunner(RunControl *runControl)
+    : RunWorker(runControl)
+{
+    setId("HaskellOutputRunner");
+    m_process.setStdOutCallback([this](const QString &text) {
+        m_log->addOutput(text, OutputLog::Channel::StdOut);
+    });
+    m_process.setStdErrCallback([this](const QString &text) {
+        m_log->addOutput(text, OutputLog::Channel::StdErr);
+    });
+    connect(&m_process, &QtcProcess::started, this, &RunWorker::reportStarted);
+    connect(&m_process, &QtcProcess::done, this, [this] {
+        m_log->finish();
+        if (m_process.error() == QProcess::FailedToStart) {
+            reportFailure(m_process.errorString());
+            return;
+        }
+        appendMessage(m_process.exitMessage() + '\n', NormalMessageFormat);
+        reportStopped();
+    });
+}
+
+HaskellOutputRunner::~HaskellOutputRunner() = default;
+
+void HaskellOutputRunner::start()
+{
+    HaskellAnalysisPane *pane = HaskellAnalysisPane::instance();
+    QTC_ASSERT(pane, reportFailure(); return);
+    const QString name = runControl()->displayName();
+    const QString spillFilePath = QString("%1/output-%2.log")
+                                      .arg(TemporaryDirectory::masterDirectoryPath())
+                                      .arg(QDateTime::currentMSecsSinceEpoch());
+    m_log = std::make_shared<OutputLog>();
+    if (!m_log->openSpillFile(spillFilePath)) {
+        appendMessage(tr("Cannot write the output log %1, only the recent output is kept.\n")
+                          .arg(QDir::toNativeSeparators(spillFilePath)),
+                      ErrorMessageFormat);
+    }
+    pane->showResult("output:" + name, tr("Output: %1").arg(name), new OutputLogView(m_log));
+
+    m_process.setCommand(runControl()->commandLine());
+    m_process.setWorkingDirectory(runControl()->workingDirectory());
+    m_process.setEnvironment(runControl()->environment());
+    appendMessage(tr("Starting %1, the output goes to the Haskell Analysis pane.\n")
+                      .arg(m_process.commandLine().toUserOutput()),
+                  NormalMessageFormat);
+    m_process.start();
+}
+
+void HaskellOutputRunner::stop()
+{
+    if (m_process.state() == QProcess::NotRunning) {
+        reportStopped();
+        return;
+    }
+    m_process.stop();
+}
+
+HaskellRunWorkerFactory::HaskellRunWorkerFactory()
+{
+    setProducer([](RunControl *runControl) -> RunWorker * {
+        // programs in a terminal keep their output there
+        const auto outputLog = runControl->aspect<HaskellOutputLogAspect>();
+        const auto terminal = runControl->aspect<TerminalAspect>();
+        RunWorker *worker = nullptr;
+        if (outputLog && outputLog->value && !(terminal && terminal->useTerminal))
+            worker = new HaskellOutputRunner(runControl);
+        else
+            worker = new SimpleTargetRunner(runControl);
+        const auto rtsStats = runControl->aspect<HaskellRtsStatsAspect>();
+        if (rtsStats && rtsStats->value)
+            worker->addStartDependency(new RtsStatsSampler(runControl, rtsStats->statsFilePath));
+        return worker;
+    });
+    addSupportedRunMode(ProjectExplorer::Constants::NORMAL_RUN_MODE);
+    addSupportedRunConfig(Constants::C_HASKELL_RUNCONFIG_ID);
+}
+
+} // namespace Internal
+} // namespace Haskell
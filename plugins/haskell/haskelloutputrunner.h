@@ -0,0 +1,65 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <projectexplorer/runcontrol.h>
+#include <utils/qtcprocess.h>
+
+#include <memory>
+
+namespace Haskell {
+namespace Internal {
+
+class OutputLog;
+
+// Runs a program with its output going to a bounded output log in the analysis pane instead
+// of the application output, for services that write a lot of output over a long time.
+class HaskellOutputRunner : public ProjectExplorer::RunWorker
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellOutputRunner(ProjectExplorer::RunControl *runControl);
+    ~HaskellOutputRunner() override;
+
+private:
+    void start() override;
+    void stop() override;
+
+    Utils::QtcProcess m_process;
+    std::shared_ptr<OutputLog> m_log;
+};
+
+// Uses the bounded output log and samples runtime statistics if the run configuration asks
+// for it.
+class HaskellRunWorkerFactory : public ProjectExplorer::RunWorkerFactory
+{
+public:
+    HaskellRunWorkerFactory();
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -25,23 +25,48 @@
 
 #include "haskellplugin.h"
 
+#include "ghcioutputpane.h"
+#include "ghcisession.h"
+#include "haskellanalysispane.h"
+#include "haskellbenchmark.h"
 #include "haskellbuildconfiguration.h"
+#include "haskellcompletionindexer.h"
 #include "haskellconstants.h"
+#include "haskellcoverage.h"
 #include "haskelleditorfactory.h"
+#include "haskellhighlighter.h"
+#include "haskelllanguageclient.h"
 #include "haskellmanager.h"
+#include "haskelloutlinewidget.h"
+#include "haskelloutputrunner.h"
+#include "haskellprofiler.h"
 #include "haskellproject.h"
 #include "haskellrunconfiguration.h"
+#include "haskellservicestack.h"
+#include "haskelltokenizer.h"
+#include "literatehaskell.h"
 #include "optionspage.h"
 #include "stackbuildstep.h"
+#include "testresultsview.h"
 
+#include <coreplugin/actionmanager/actioncontainer.h>
 #include <coreplugin/actionmanager/actionmanager.h>
+#include <coreplugin/coreconstants.h>
 #include <coreplugin/editormanager/editormanager.h>
 #include <coreplugin/icore.h>
+#include <projectexplorer/projectexplorer.h>
 #include <projectexplorer/projectmanager.h>
+#include <projectexplorer/session.h>
 #include <projectexplorer/jsonwizard/jsonwizardfactory.h>
 #include <texteditor/snippets/snippetprovider.h>
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditor.h>
+#include <utils/qtcassert.h>
+#include <utils/tooltip/tooltip.h>
 
 #include <QAction>
+#include <QMenu>
+#include <QPointer>
 
 namespace Haskell {
 namespace Internal {
@@ -49,12 +74,25 @@ namespace Internal {
 class HaskellPluginPrivate
 {
 public:
+    GhciSessionPool ghciSessionPool;
+    GhciOutputPane ghciOutputPane{&ghciSessionPool};
+    HaskellAnalysisPane analysisPane;
+    HaskellCoverage coverage;
+    HaskellCompletionIndexer completionIndexer;
     HaskellEditorFactory editorFactory;
+    HaskellOutlineWidgetFactory outlineWidgetFactory;
+    HaskellLanguageServers languageServers;
     OptionsPage optionsPage;
     HaskellBuildConfigurationFactory buildConfigFactory;
     StackBuildStepFactory stackBuildStepFactory;
+    StackCleanStepFactory stackCleanStepFactory;
     HaskellRunConfigurationFactory runConfigFactory;
-    ProjectExplorer::SimpleTargetRunnerFactory runWorkerFactory{{Constants::C_HASKELL_RUNCONFIG_ID}};
+    HaskellRunWorkerFactory runWorkerFactory;
+    HaskellProfilerFactory profilerFactory;
+    HaskellBenchmarkRunConfigurationFactory benchmarkRunConfigFactory;
+    HaskellBenchmarkRunnerFactory benchmarkRunnerFactory;
+    HaskellServiceStackRunConfigurationFactory serviceStackRunConfigFactory;
+    HaskellServiceStackRunnerFactory serviceStackRunnerFactory;
 };
 
 HaskellPlugin::~HaskellPlugin()
@@ -62,14 +100,132 @@ HaskellPlugin::~HaskellPlugin()
     delete d;
 }
 
-static void registerGhciAction()
+static QString expressionUnderCursor(TextEditor::TextEditorWidget *widget)
 {
+    const QTextCursor cursor = widget->textCursor();
+    if (cursor.hasSelection())
+        return cursor.selectedText().replace(QChar::ParagraphSeparator, '\n');
+    int codeColumn = 0;
+    const Tokens tokens = HaskellHighlighter::codeTokens(
+        cursor.block(),
+        LiterateHaskell::isLiterateFile(widget->textDocument()->filePath().toString()),
+        &codeColumn);
+    const int column = cursor.positionInBlock() - codeColumn;
+    const QString expression = tokens.tokenAtColumn(column).expression();
+    // the cursor might be right behind the identifier
+    return expression.isEmpty() ? tokens.tokenAtColumn(column - 1).expression() : expression;
+}
+
+static void evaluateInGhci(bool showType)
+{
+    TextEditor::TextEditorWidget *widget = TextEditor::TextEditorWidget::currentTextEditorWidget();
+    if (!widget)
+        return;
+    const QString expression = expressionUnderCursor(widget);
+    if (expression.trimmed().isEmpty())
+        return;
+    const Utils::FilePath filePath = widget->textDocument()->filePath();
+    GhciSession *session = HaskellManager::ghciSession(filePath);
+    QTC_ASSERT(session, return);
+    session->loadFile(filePath);
+    const QPointer<TextEditor::TextEditorWidget> guard(widget);
+    const int position = widget->textCursor().selectionEnd();
+    const QString command = showType ? ":type " + expression : expression;
+    session->enqueue(command, [guard, position](const GhciSession::Response &response) {
+        if (!guard)
+            return;
+        const QString text = (response.output + response.errorOutput).trimmed();
+        QTextCursor cursor(guard->document());
+        cursor.setPosition(std::min(position, guard->document()->characterCount() - 1));
+        const QPoint pos = guard->viewport()->mapToGlobal(guard->cursorRect(cursor).bottomLeft());
+        Utils::ToolTip::show(pos, text.isEmpty() ? HaskellManager::tr("<no output>") : text,
+                             guard);
+    });
+}
+
+static void registerGhciActions()
+{
+    Core::ActionContainer *menu = Core::ActionManager::createMenu(Constants::M_HASKELL);
+    menu->menu()->setTitle(HaskellManager::tr("&Haskell"));
+    Core::ActionManager::actionContainer(Core::Constants::M_TOOLS)->addMenu(menu);
+
     QAction *action = new QAction(HaskellManager::tr("Run GHCi"), HaskellManager::instance());
-    Core::ActionManager::registerAction(action, Constants::A_RUN_GHCI);
+    Core::Command *command = Core::ActionManager::registerAction(action, Constants::A_RUN_GHCI);
+    menu->addAction(command);
     QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
         if (Core::IDocument *doc = Core::EditorManager::currentDocument())
             HaskellManager::openGhci(doc->filePath());
     });
+
+    const Core::Context editorContext(Constants::C_HASKELLEDITOR_ID);
+    action = new QAction(HaskellManager::tr("Evaluate Selection in GHCi"),
+                         HaskellManager::instance());
+    command = Core::ActionManager::registerAction(action, Constants::A_EVALUATE_SELECTION,
+                                                  editorContext);
+    command->setDefaultKeySequence(QKeySequence(HaskellManager::tr("Ctrl+Alt+E")));
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        evaluateInGhci(false);
+    });
+
+    action = new QAction(HaskellManager::tr("Show Type in GHCi"), HaskellManager::instance());
+    command = Core::ActionManager::registerAction(action, Constants::A_SHOW_TYPE, editorContext);
+    command->setDefaultKeySequence(QKeySequence(HaskellManager::tr("Ctrl+Alt+T")));
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        evaluateInGhci(true);
+    });
+}
+
+static void registerAnalysisActions()
+{
+    Core::ActionContainer *menu = Core::ActionManager::actionContainer(Constants::M_HASKELL);
+    QTC_ASSERT(menu, return);
+    menu->addSeparator();
+
+    QAction *action = new QAction(HaskellManager::tr("Run with Profiling"),
+                                  HaskellManager::instance());
+    Core::Command *command = Core::ActionManager::registerAction(action, Constants::A_PROFILE);
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        ProjectExplorer::ProjectExplorerPlugin::runStartupProject(
+            Constants::C_HASKELL_PROFILE_RUN_MODE);
+    });
+
+    action = new QAction(HaskellManager::tr("Run with Eventlog"), HaskellManager::instance());
+    command = Core::ActionManager::registerAction(action, Constants::A_RUN_WITH_EVENTLOG);
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        ProjectExplorer::ProjectExplorerPlugin::runStartupProject(
+            Constants::C_HASKELL_EVENTLOG_RUN_MODE);
+    });
+
+    action = new QAction(HaskellManager::tr("Run Tests"), HaskellManager::instance());
+    command = Core::ActionManager::registerAction(action, Constants::A_RUN_TESTS);
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        ProjectExplorer::Project *project = ProjectExplorer::SessionManager::startupProject();
+        if (HaskellProject::isHaskellProject(project))
+            TestResultsView::runTests(project);
+    });
+
+    action = new QAction(HaskellManager::tr("Run Tests with Coverage"),
+                         HaskellManager::instance());
+    command = Core::ActionManager::registerAction(action, Constants::A_RUN_TESTS_WITH_COVERAGE);
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        ProjectExplorer::Project *project = ProjectExplorer::SessionManager::startupProject();
+        if (HaskellProject::isHaskellProject(project))
+            TestResultsView::runTests(project, true);
+    });
+
+    action = new QAction(HaskellManager::tr("Clear Coverage"), HaskellManager::instance());
+    command = Core::ActionManager::registerAction(action, Constants::A_CLEAR_COVERAGE);
+    menu->addAction(command);
+    QObject::connect(action, &QAction::triggered, HaskellManager::instance(), [] {
+        if (HaskellCoverage *coverage = HaskellCoverage::instance())
+            coverage->clear();
+    });
 }
 
 bool HaskellPlugin::initialize(const QStringList &arguments, QString *errorString)
@@ -88,7 +244,8 @@ bool HaskellPlugin::initialize(const QStringList &arguments, QString *errorStrin
         HaskellManager::writeSettings(Core::ICore::settings());
     });
 
-    registerGhciAction();
+    registerGhciActions();
+    registerAnalysisActions();
 
     HaskellManager::readSettings(Core::ICore::settings());
 
@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellprofiler.h"
+
+#include "eventlog.h"
+#include "eventlogview.h"
+#include "haskellanalysispane.h"
+#include "haskellconstants.h"
+#include "haskellmanager.h"
+#include "haskellrunconfiguration.h"
+#include "profileparser.h"
+#include "profileview.h"
+
+#include <coreplugin/messagemanager.h>
+#include <coreplugin/progressmanager/progressmanager.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/runconfigurationaspects.h>
+#include <projectexplorer/target.h>
+#include <utils/qtcassert.h>
+#include <utils/runextensions.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFutureWatcher>
+
+#include <optional>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+class ProfileData
+{
+public:
+    std::optional<TimeProfile> timeProfile;
+    std::optional<HeapProfile> heapProfile;
+    QStringList errors;
+};
+
+static ProfileData readProfiles(const FilePath &timeFile,
+                               const FilePath &heapFile,
+                               const QDateTime &startTime)
+{
+    // files from earlier runs are not interesting
+    ProfileData data;
+    QString error;
+    QFile time(timeFile.toString());
+    if (timeFile.lastModified() >= startTime && time.open(QIODevice::ReadOnly)) {
+        TimeProfile profile;
+        if (parseTimeProfile(&time, &profile, &error))
+            data.timeProfile = std::move(profile);
+        else
+            data.errors.append(timeFile.toUserOutput() + ": " + error);
+    }
+    QFile heap(heapFile.toString());
+    if (heapFile.lastModified() >= startTime && heap.open(QIODevice::ReadOnly)) {
+        HeapProfile profile;
+        if (parseHeapProfile(&heap, &profile, &error))
+            data.heapProfile = std::move(profile);
+        else
+            data.errors.append(heapFile.toUserOutput() + ": " + error);
+    }
+    return data;
+}
+
+class EventlogData
+{
+public:
+    EventlogSummary summary;
+    EventlogTimeline timeline;
+    QString errorString;
+};
+
+static void readEventlog(QFutureInterface<EventlogData> &futureInterface, const FilePath &filePath)
+{
+    // eventlogs of long runs are huge, decode them in chunks
+    EventlogData data;
+    QFile file(filePath.toString());
+    if (!file.open(QIODevice::ReadOnly)) {
+        data.errorString = file.errorString();
+        futureInterface.reportResult(data);
+        return;
+    }
+    EventlogAnalysis analysis;
+    EventlogDecoder decoder([&analysis](const EventlogEvent &event) { analysis.addEvent(event); });
+    const qint64 size = std::max(file.size(), qint64(1));
+    futureInterface.setProgressRange(0, 1000);
+    while (!file.atEnd() && !futureInterface.isCanceled()) {
+        if (!decoder.feed(file.read(1 << 20))) {
+            data.errorString = decoder.errorString();
+            break;
+        }
+        futureInterface.setProgressValue(int(1000 * file.pos() / size));
+    }
+    analysis.finish();
+    data.summary = analysis.summary();
+    data.timeline = analysis.timeline();
+    futureInterface.reportResult(data);
+}
+
+ProfilingBuilder::ProfilingBuilder(RunControl *runControl,
+                                   const QString &variant,
+                                   const QStringList &buildArguments)
+    : RunWorker(runControl)
+    , m_variant(variant)
+    , m_buildArguments(buildArguments)
+{
+    setId("HaskellProfilingBuilder");
+    m_buildProcess.setStdOutCallback([this](const QString &text) {
+        appendMessage(text, StdOutFormat, false);
+    });
+    m_buildProcess.setStdErrCallback([this](const QString &text) {
+        appendMessage(text, StdErrFormat, false);
+    });
+    connect(&m_buildProcess, &QtcProcess::done, this, [this] {
+        if (m_buildProcess.result() != ProcessResult::FinishedWithSuccess) {
+            reportFailure(tr("Building the %1 variant failed.").arg(m_variant));
+            return;
+        }
+        setupProcess(&m_pathProcess, StackPaths::arguments());
+        m_pathProcess.start();
+    });
+    connect(&m_pathProcess, &QtcProcess::done, this, [this] {
+        if (m_pathProcess.result() != ProcessResult::FinishedWithSuccess) {
+            reportFailure(tr("Cannot find the %1 build: %2")
+                              .arg(m_variant)
+                              .arg(m_pathProcess.stdErr().trimmed()));
+            return;
+        }
+        m_stackPaths = StackPaths::fromOutput(m_pathProcess.stdOut());
+        reportStarted();
+    });
+}
+
+FilePath ProfilingBuilder::workDirectory(const FilePath &buildDirectory, const QString &variant)
+{
+    return buildDirectory.parentDir().pathAppended(buildDirectory.fileName() + '-' + variant);
+}
+
+void ProfilingBuilder::start()
+{
+    setupProcess(&m_buildProcess, m_buildArguments);
+    appendMessage(tr("Building for %1: %2\n")
+                      .arg(m_variant)
+                      .arg(m_buildProcess.commandLine().toUserOutput()),
+                  NormalMessageFormat);
+    m_buildProcess.start();
+}
+
+void ProfilingBuilder::stop()
+{
+    m_buildProcess.close();
+    m_pathProcess.close();
+    reportStopped();
+}
+
+void ProfilingBuilder::setupProcess(QtcProcess *process, const QStringList &arguments)
+{
+    const FilePath projectDirectory = runControl()->project()->projectDirectory();
+    BuildConfiguration *bc = runControl()->target()->activeBuildConfiguration();
+    const FilePath buildDirectory = bc ? bc->buildDirectory()
+                                       : projectDirectory.pathAppended(".stack-work");
+    const FilePath variantDirectory = workDirectory(buildDirectory, m_variant);
+    const QString workDir = QDir(projectDirectory.toString())
+                                .relativeFilePath(variantDirectory.toString());
+    process->setCommand(
+        {HaskellManager::stackExecutable(), QStringList{"--work-dir", workDir} + arguments});
+    process->setWorkingDirectory(projectDirectory);
+    process->setEnvironment(bc ? bc->environment() : Environment::systemEnvironment());
+}
+
+static ProfilingBuilder *createBuilder(RunControl *runControl, bool eventlog)
+{
+    // the eventlog RTS is the default since GHC 9.4, -rtsopts is needed for +RTS -l
+    if (eventlog)
+        return new ProfilingBuilder(runControl, "eventlog",
+                                    {"build", "--ghc-options=-eventlog -rtsopts"});
+    return new ProfilingBuilder(runControl, "profile", {"build", "--profile"});
+}
+
+HaskellProfiler::HaskellProfiler(RunControl *runControl)
+    : SimpleTargetRunner(runControl)
+    , m_eventlog(runControl->runMode() == Constants::C_HASKELL_EVENTLOG_RUN_MODE)
+    , m_builder(createBuilder(runControl, m_eventlog))
+{
+    setId("HaskellProfiler");
+    addStartDependency(m_builder);
+    setStartModifier([this] {
+        const auto executable = this->runControl()->aspect<HaskellExecutableAspect>();
+        const auto profilingOptions = this->runControl()->aspect<HaskellProfilingAspect>();
+        const auto tuningOptions = this->runControl()->aspect<HaskellRtsOptionsAspect>();
+        const auto arguments = this->runControl()->aspect<ArgumentsAspect>();
+        QTC_ASSERT(executable && profilingOptions && tuningOptions && arguments, return);
+        const QString rtsOptions = m_eventlog ? QString("-l") : profilingOptions->value;
+        const StackPaths paths = m_builder->stackPaths();
+        m_program = executable->value;
+        FilePath binary = paths.executable(m_program);
+        if (binary.isEmpty()) // let the start fail with a sensible message
+            binary = paths.localInstallRoot.pathAppended("bin/" + m_program);
+        CommandLine command(binary, QStringList("+RTS") + tuningOptions->arguments);
+        command.addArgs(rtsOptions, CommandLine::Raw);
+        command.addArg("-RTS");
+        command.addArgs(arguments->arguments, CommandLine::Raw);
+        setCommandLine(command);
+        Environment environment = this->runControl()->environment();
+        paths.addToEnvironment(environment);
+        setEnvironment(environment);
+        m_workingDirectory = this->runControl()->workingDirectory();
+        m_startTime = QDateTime::currentDateTime();
+    });
+    connect(runControl, &RunControl::stopped, this, [this] {
+        if (m_eventlog)
+            loadEventlog();
+        else
+            loadProfiles();
+    });
+}
+
+void HaskellProfiler::loadProfiles()
+{
+    HaskellAnalysisPane *pane = HaskellAnalysisPane::instance();
+    QTC_ASSERT(pane, return);
+    if (m_program.isEmpty() || !m_startTime.isValid())
+        return;
+    // the RTS names the profiles after the program and writes them to the working directory
+    const FilePath timeFile = m_workingDirectory.pathAppended(m_program + ".prof");
+    const FilePath heapFile = m_workingDirectory.pathAppended(m_program + ".hp");
+    const FilePath sourceDirectory = runControl()->project()->projectDirectory();
+    const QString program = m_program;
+    auto watcher = new QFutureWatcher<ProfileData>(pane);
+    connect(watcher, &QFutureWatcherBase::finished, pane, [=] {
+        const ProfileData data = watcher->result();
+        watcher->deleteLater();
+        for (const QString &error : data.errors)
+            Core::MessageManager::writeFlashing(tr("Cannot read profile %1").arg(error));
+        if (!data.timeProfile && !data.heapProfile)
+            return;
+        pane->showResult("profile:" + program,
+                         tr("Profile: %1").arg(program),
+                         new ProfileView(data.timeProfile ? &*data.timeProfile : nullptr,
+                                         data.heapProfile ? &*data.heapProfile : nullptr,
+                                         sourceDirectory));
+    });
+    watcher->setFuture(Utils::runAsync(readProfiles, timeFile, heapFile, m_startTime));
+}
+
+void HaskellProfiler::loadEventlog()
+{
+    HaskellAnalysisPane *pane = HaskellAnalysisPane::instance();
+    QTC_ASSERT(pane, return);
+    if (m_program.isEmpty() || !m_startTime.isValid())
+        return;
+    const FilePath eventlogFile = m_workingDirectory.pathAppended(m_program + ".eventlog");
+    if (eventlogFile.lastModified() < m_startTime)
+        return;
+    const QString program = m_program;
+    auto watcher = new QFutureWatcher<EventlogData>(pane);
+    connect(watcher, &QFutureWatcherBase::finished, pane, [=] {
+        watcher->deleteLater();
+        if (watcher->isCanceled())
+            return;
+        const EventlogData data = watcher->result();
+        if (!data.errorString.isEmpty()) {
+            Core::MessageManager::writeFlashing(tr("Cannot read eventlog %1: %2")
+                                                    .arg(eventlogFile.toUserOutput(),
+                                                         data.errorString));
+        }
+        if (data.summary.events == 0)
+            return;
+        pane->showResult("eventlog:" + program,
+                         tr("Eventlog: %1").arg(program),
+                         new EventlogView(data.summary, data.timeline));
+    });
+    const QFuture<EventlogData> future = Utils::runAsync(readEventlog, eventlogFile);
+    Core::ProgressManager::addTask(future, tr("Reading Eventlog"), "Haskell.ReadEventlog");
+    watcher->setFuture(future);
+}
+
+HaskellProfilerFactory::HaskellProfilerFactory()
+{
+    setProduct<HaskellProfiler>();
+    addSupportedRunMode(Constants::C_HASKELL_PROFILE_RUN_MODE);
+    addSupportedRunMode(Constants::C_HASKELL_EVENTLOG_RUN_MODE);
+    addSupportedRunConfig(Constants::C_HASKELL_RUNCONFIG_ID);
+}
+
+} // namespace Internal
+} // namespace Haskell
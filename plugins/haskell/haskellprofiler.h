@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "haskellbuildconfiguration.h"
+
+#include <projectexplorer/runcontrol.h>
+
+#include <utils/qtcprocess.h>
+
+#include <QDateTime>
+
+namespace Haskell {
+namespace Internal {
+
+// Builds a variant of the project, e.g. with profiling, in a separate stack work directory, so
+// switching between variants and normal runs doesn't rebuild everything, and finds out where
+// the executables were installed.
+class ProfilingBuilder : public ProjectExplorer::RunWorker
+{
+    Q_OBJECT
+
+public:
+    ProfilingBuilder(ProjectExplorer::RunControl *runControl,
+                     const QString &variant,
+                     const QStringList &buildArguments);
+
+    StackPaths stackPaths() const { return m_stackPaths; }
+
+    static Utils::FilePath workDirectory(const Utils::FilePath &buildDirectory,
+                                         const QString &variant);
+
+private:
+    void start() override;
+    void stop() override;
+    void setupProcess(Utils::QtcProcess *process, const QStringList &arguments);
+
+    QString m_variant;
+    QStringList m_buildArguments;
+    Utils::QtcProcess m_buildProcess;
+    Utils::QtcProcess m_pathProcess;
+    StackPaths m_stackPaths;
+};
+
+// Runs the executable built for profiling with the profiling RTS options and shows the time and
+// heap profiles it writes when it finishes. In the eventlog run mode, runs it with an eventlog
+// and shows the eventlog instead.
+class HaskellProfiler : public ProjectExplorer::SimpleTargetRunner
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellProfiler(ProjectExplorer::RunControl *runControl);
+
+private:
+    void loadProfiles();
+    void loadEventlog();
+
+    bool m_eventlog;
+    ProfilingBuilder *m_builder;
+    QString m_program;
+    Utils::FilePath m_workingDirectory;
+    QDateTime m_startTime;
+};
+
+class HaskellProfilerFactory : public ProjectExplorer::RunWorkerFactory
+{
+public:
+    HaskellProfilerFactory();
+};
+
+} // namespace Internal
+} // namespace Haskell
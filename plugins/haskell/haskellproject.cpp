@@ -25,7 +25,9 @@
 
 #include "haskellproject.h"
 
+#include "haskellbenchmark.h"
 #include "haskellconstants.h"
+#include "haskellcoverage.h"
 
 #include <coreplugin/iversioncontrol.h>
 #include <coreplugin/vcsmanager.h>
@@ -47,24 +49,94 @@ using namespace Utils;
 namespace Haskell {
 namespace Internal {
 
-static QVector<QString> parseExecutableNames(const FilePath &projectFilePath)
+class CabalComponents
 {
+public:
+    QString packageName;
+    QVector<QString> executables;
+    QVector<QString> benchmarks;
+    QVector<HaskellTestSuite> testSuites;
+};
+
+static CabalComponents parseComponents(const FilePath &projectFilePath)
+{
+    static const QString NAME = "name:";
     static const QString EXECUTABLE = "executable";
-    static const int EXECUTABLE_LEN = EXECUTABLE.length();
-    QVector<QString> result;
+    static const QString BENCHMARK = "benchmark";
+    static const QString TEST_SUITE = "test-suite";
+    const auto componentName = [](const QString &line, const QString &keyword) {
+        if (line.length() > keyword.length() && line.startsWith(keyword)
+                && line.at(keyword.length()).isSpace())
+            return line.mid(keyword.length() + 1).trimmed();
+        return QString();
+    };
+    CabalComponents result;
     QFile file(projectFilePath.toString());
-    if (file.open(QFile::ReadOnly)) {
-        QTextStream stream(&file);
-        while (!stream.atEnd()) {
-            const QString line = stream.readLine().trimmed();
-            if (line.length() > EXECUTABLE_LEN && line.startsWith(EXECUTABLE)
-                    && line.at(EXECUTABLE_LEN).isSpace())
-                result.append(line.mid(EXECUTABLE_LEN + 1).trimmed());
+    if (!file.open(QFile::ReadOnly))
+        return result;
+    QTextStream stream(&file);
+    // the test framework is guessed from the dependencies in the stanza
+    QString testSuiteStanza;
+    const auto finishTestSuite = [&result, &testSuiteStanza] {
+        if (!result.testSuites.isEmpty() && !testSuiteStanza.isEmpty()) {
+            result.testSuites.last().framework = TestOutputParser::detectFramework(
+                testSuiteStanza);
+        }
+        testSuiteStanza.clear();
+    };
+    bool inTestSuite = false;
+    while (!stream.atEnd()) {
+        const QString rawLine = stream.readLine();
+        const QString line = rawLine.trimmed();
+        if (inTestSuite && !rawLine.isEmpty() && !rawLine.at(0).isSpace()) {
+            finishTestSuite();
+            inTestSuite = false;
+        }
+        if (inTestSuite) {
+            testSuiteStanza += line + '\n';
+            continue;
+        }
+        if (result.packageName.isEmpty() && line.startsWith(NAME, Qt::CaseInsensitive)) {
+            result.packageName = line.mid(NAME.length()).trimmed();
+            continue;
+        }
+        const QString executable = componentName(line, EXECUTABLE);
+        if (!executable.isEmpty()) {
+            result.executables.append(executable);
+            continue;
+        }
+        const QString benchmark = componentName(line, BENCHMARK);
+        if (!benchmark.isEmpty()) {
+            result.benchmarks.append(benchmark);
+            continue;
+        }
+        const QString testSuite = componentName(line, TEST_SUITE);
+        if (!testSuite.isEmpty()) {
+            result.testSuites.append({testSuite, TestOutputParser::Plain});
+            inTestSuite = true;
         }
     }
+    finishTestSuite();
     return result;
 }
 
+// Shows the test coverage of the module next to the file name.
+class HaskellFileNode : public FileNode
+{
+public:
+    HaskellFileNode(const FilePath &filePath, FileType fileType)
+        : FileNode(filePath, fileType)
+    {}
+
+    QString displayName() const override
+    {
+        const int percent = HaskellCoverage::percent(filePath());
+        if (percent < 0)
+            return FileNode::displayName();
+        return HaskellProject::tr("%1 (%2%)").arg(FileNode::displayName()).arg(percent);
+    }
+};
+
 HaskellProject::HaskellProject(const Utils::FilePath &fileName)
     : Project(Constants::C_HASKELL_PROJECT_MIMETYPE, fileName)
 {
@@ -86,7 +158,9 @@ HaskellBuildSystem::HaskellBuildSystem(Target *t)
         root->setDisplayName(target()->project()->displayName());
         std::vector<std::unique_ptr<FileNode>> nodePtrs
             = Utils::transform<std::vector>(m_scanner.release().allFiles, [](FileNode *fn) {
-                  return std::unique_ptr<FileNode>(fn);
+                  const std::unique_ptr<FileNode> scanned(fn);
+                  return std::unique_ptr<FileNode>(
+                      new HaskellFileNode(scanned->filePath(), scanned->fileType()));
               });
         root->addNestedNodes(std::move(nodePtrs));
         setRootProjectNode(std::move(root));
@@ -115,19 +189,31 @@ void HaskellBuildSystem::triggerParsing()
 
 void HaskellBuildSystem::updateApplicationTargets()
 {
-    const QVector<QString> executables = parseExecutableNames(projectFilePath());
+    const CabalComponents components = parseComponents(projectFilePath());
     const Utils::FilePath projFilePath = projectFilePath();
-    const QList<BuildTargetInfo> appTargets
-        = Utils::transform<QList>(executables, [projFilePath](const QString &executable) {
+    QList<BuildTargetInfo> appTargets
+        = Utils::transform<QList>(components.executables, [projFilePath](const QString &name) {
               BuildTargetInfo bti;
-              bti.displayName = executable;
-              bti.buildKey = executable;
-              bti.targetFilePath = FilePath::fromString(executable);
+              bti.displayName = name;
+              bti.buildKey = name;
+              bti.targetFilePath = FilePath::fromString(name);
               bti.projectFilePath = projFilePath;
               bti.isQtcRunnable = true;
               return bti;
           });
+    if (!components.packageName.isEmpty()) {
+        for (const QString &benchmark : components.benchmarks) {
+            BuildTargetInfo bti;
+            bti.displayName = tr("%1 (Benchmark)").arg(benchmark);
+            bti.buildKey = benchmarkBuildKey(components.packageName, benchmark);
+            bti.targetFilePath = FilePath::fromString(benchmark);
+            bti.projectFilePath = projFilePath;
+            bti.isQtcRunnable = true;
+            appTargets.append(bti);
+        }
+    }
     setApplicationTargets(appTargets);
+    m_testSuites = components.testSuites;
     target()->updateDefaultRunConfigurations();
 }
 
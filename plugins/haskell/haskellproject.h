@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "haskelltestrunner.h"
+
 #include <projectexplorer/buildsystem.h>
 #include <projectexplorer/project.h>
 #include <projectexplorer/projectnodes.h>
@@ -53,6 +55,8 @@ public:
     void triggerParsing() override;
     QString name() const final { return QLatin1String("haskell"); }
 
+    QVector<HaskellTestSuite> testSuites() const { return m_testSuites; }
+
 private:
     void updateApplicationTargets();
     void refresh();
@@ -60,6 +64,7 @@ private:
 private:
     ParseGuard m_parseGuard;
     ProjectExplorer::TreeScanner m_scanner;
+    QVector<HaskellTestSuite> m_testSuites;
 };
 
 } // namespace Internal
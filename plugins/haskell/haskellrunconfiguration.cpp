@@ -25,6 +25,8 @@
 
 #include "haskellrunconfiguration.h"
 
+#include "haskellbenchmark.h"
+#include "haskellbuildconfiguration.h"
 #include "haskellconstants.h"
 #include "haskellmanager.h"
 #include "haskellproject.h"
@@ -34,6 +36,17 @@
 #include <projectexplorer/runconfigurationaspects.h>
 #include <projectexplorer/runcontrol.h>
 #include <projectexplorer/target.h>
+#include <utils/algorithm.h>
+#include <utils/infolabel.h>
+#include <utils/layoutbuilder.h>
+#include <utils/qtcprocess.h>
+#include <utils/temporarydirectory.h>
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QSpinBox>
 
 using namespace ProjectExplorer;
 
@@ -47,12 +60,272 @@ HaskellRunConfigurationFactory::HaskellRunConfigurationFactory()
     addSupportedTargetDeviceType(ProjectExplorer::Constants::DESKTOP_DEVICE_TYPE);
 }
 
+QList<RunConfigurationCreationInfo> HaskellRunConfigurationFactory::availableCreators(
+    Target *target) const
+{
+    // benchmarks have their own run configuration
+    return Utils::filtered(RunConfigurationFactory::availableCreators(target),
+                           [](const RunConfigurationCreationInfo &info) {
+                               return !isBenchmarkBuildKey(info.buildKey);
+                           });
+}
+
 HaskellExecutableAspect::HaskellExecutableAspect()
 {
     setSettingsKey("Haskell.Executable");
     setLabelText(tr("Executable"));
 }
 
+HaskellProfilingAspect::HaskellProfilingAspect()
+{
+    setSettingsKey("Haskell.ProfilingRtsOptions");
+    setLabelText(tr("Profiling RTS options"));
+    setDisplayStyle(LineEditDisplay);
+    setDefaultValue("-p -hT -l");
+    setToolTip(tr("Options that are passed to the runtime system between +RTS and -RTS when "
+                  "profiling. -p writes a time and allocation profile, -hT a heap profile "
+                  "and -l an eventlog."));
+}
+
+HaskellOutputLogAspect::HaskellOutputLogAspect()
+{
+    setSettingsKey("Haskell.OutputLog");
+    setLabel(tr("Keep output in a bounded log"), LabelPlacement::AtCheckBox);
+    setToolTip(tr("Shows the output in the Haskell Analysis pane, where only the recent output "
+                  "is kept in memory. The whole output is written to a file and can be "
+                  "searched."));
+}
+
+HaskellRtsStatsAspect::HaskellRtsStatsAspect()
+{
+    static int count = 0;
+    // the same file for every run of the configuration, which removes the old one first
+    m_statsFilePath = QString("%1/rts-stats-%2.txt")
+                          .arg(Utils::TemporaryDirectory::masterDirectoryPath())
+                          .arg(++count);
+    setSettingsKey("Haskell.RtsStats");
+    setLabel(tr("Sample runtime statistics"), LabelPlacement::AtCheckBox);
+    setToolTip(tr("Passes -S to the runtime system and shows the heap size, allocation rate, "
+                  "garbage collections and productivity while the program runs. The program "
+                  "needs to be linked with -rtsopts."));
+    addDataExtractor(this, &HaskellRtsStatsAspect::statsFilePath, &Data::statsFilePath);
+}
+
+QStringList HaskellRtsStatsAspect::rtsArguments() const
+{
+    if (!value())
+        return {};
+    return {"-S" + m_statsFilePath};
+}
+
+HaskellRtsOptionsAspect::HaskellRtsOptionsAspect()
+{
+    setSettingsKey("Haskell.RtsOptions");
+    setDisplayName(tr("RTS Options"));
+    addDataExtractor(this, &HaskellRtsOptionsAspect::arguments, &Data::arguments);
+}
+
+HaskellRtsOptionsAspect::~HaskellRtsOptionsAspect() = default;
+
+void HaskellRtsOptionsAspect::setOptions(const RtsOptions &options)
+{
+    if (options == m_options)
+        return;
+    m_options = options;
+    updateWidgets();
+    emit changed();
+}
+
+void HaskellRtsOptionsAspect::setExecutableProvider(
+    const std::function<Utils::FilePath()> &provider)
+{
+    m_executableProvider = provider;
+}
+
+void HaskellRtsOptionsAspect::addToLayout(Utils::LayoutBuilder &builder)
+{
+    auto widget = createSubWidget<QWidget>();
+    auto layout = new QFormLayout(widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_presetComboBox = new QComboBox;
+    for (int i = 0; i < RtsOptions::PresetCount; ++i)
+        m_presetComboBox->addItem(RtsOptions::presetName(RtsOptions::Preset(i)));
+    layout->addRow(tr("Preset:"), m_presetComboBox.data());
+
+    m_capabilitiesSpinBox = new QSpinBox;
+    m_capabilitiesSpinBox->setRange(-1, 1024);
+    m_capabilitiesSpinBox->setSpecialValueText(tr("Default"));
+    m_capabilitiesSpinBox->setToolTip(tr("-N: the number of capabilities, 0 for one per core."));
+    layout->addRow(tr("Capabilities (-N):"), m_capabilitiesSpinBox.data());
+
+    const auto addSizeLineEdit = [layout](const QString &label, const QString &toolTip) {
+        auto lineEdit = new QLineEdit;
+        lineEdit->setPlaceholderText(tr("Default"));
+        lineEdit->setToolTip(toolTip);
+        layout->addRow(label, lineEdit);
+        return lineEdit;
+    };
+    m_allocationAreaLineEdit = addSizeLineEdit(tr("Allocation area (-A):"),
+                                               tr("The size of the nursery per capability, "
+                                                  "e.g. 64m."));
+    m_allocationChunkSizeLineEdit = addSizeLineEdit(tr("Allocation chunks (-n):"),
+                                                    tr("Divides the allocation area into chunks "
+                                                       "of this size, e.g. 4m."));
+    m_suggestedHeapSizeLineEdit = addSizeLineEdit(tr("Suggested heap size (-H):"),
+                                                  tr("The heap size that the garbage collector "
+                                                     "may use from the start, e.g. 1g."));
+    m_maximumHeapSizeLineEdit = addSizeLineEdit(tr("Maximum heap size (-M):"),
+                                                tr("The program fails with a heap overflow "
+                                                   "above this size, e.g. 2g."));
+
+    m_parallelGcCheckBox = new QCheckBox(tr("Parallel garbage collection"));
+    m_parallelGcCheckBox->setToolTip(tr("Unchecked passes -qg."));
+    m_idleGcCheckBox = new QCheckBox(tr("Idle garbage collection"));
+    m_idleGcCheckBox->setToolTip(tr("Unchecked passes -I0."));
+    m_nonmovingGcCheckBox = new QCheckBox(tr("Nonmoving garbage collector"));
+    m_nonmovingGcCheckBox->setToolTip(tr("Passes --nonmoving-gc, which collects the old "
+                                         "generation concurrently to reduce pauses."));
+    layout->addRow(QString(), m_parallelGcCheckBox.data());
+    layout->addRow(QString(), m_idleGcCheckBox.data());
+    layout->addRow(QString(), m_nonmovingGcCheckBox.data());
+
+    m_additionalOptionsLineEdit = new QLineEdit;
+    layout->addRow(tr("Additional options:"), m_additionalOptionsLineEdit.data());
+
+    m_problemsLabel = new Utils::InfoLabel({}, Utils::InfoLabel::Warning);
+    m_problemsLabel->setElideMode(Qt::ElideNone);
+    m_problemsLabel->setWordWrap(true);
+    layout->addRow(QString(), m_problemsLabel.data());
+
+    updateWidgets();
+
+    connect(m_presetComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HaskellRtsOptionsAspect::applyPreset);
+    connect(m_capabilitiesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &HaskellRtsOptionsAspect::readWidgets);
+    for (QLineEdit *lineEdit : {m_allocationAreaLineEdit.data(),
+                                m_allocationChunkSizeLineEdit.data(),
+                                m_suggestedHeapSizeLineEdit.data(),
+                                m_maximumHeapSizeLineEdit.data(),
+                                m_additionalOptionsLineEdit.data()}) {
+        connect(lineEdit, &QLineEdit::textEdited, this, &HaskellRtsOptionsAspect::readWidgets);
+    }
+    for (QCheckBox *checkBox : {m_parallelGcCheckBox.data(),
+                                m_idleGcCheckBox.data(),
+                                m_nonmovingGcCheckBox.data()}) {
+        connect(checkBox, &QCheckBox::toggled, this, &HaskellRtsOptionsAspect::readWidgets);
+    }
+
+    builder.addRow({tr("RTS options:"), widget});
+    probeExecutable();
+}
+
+void HaskellRtsOptionsAspect::fromMap(const QVariantMap &map)
+{
+    m_options = RtsOptions::fromMap(map.value(settingsKey()).toMap());
+    updateWidgets();
+}
+
+void HaskellRtsOptionsAspect::toMap(QVariantMap &map) const
+{
+    map.insert(settingsKey(), m_options.toMap());
+}
+
+void HaskellRtsOptionsAspect::applyPreset(int index)
+{
+    if (m_updatingWidgets || index == RtsOptions::Custom)
+        return;
+    RtsOptions options = RtsOptions::preset(RtsOptions::Preset(index));
+    options.additionalOptions = m_options.additionalOptions;
+    setOptions(options);
+}
+
+void HaskellRtsOptionsAspect::readWidgets()
+{
+    if (m_updatingWidgets || !m_presetComboBox)
+        return;
+    RtsOptions options;
+    options.capabilities = m_capabilitiesSpinBox->value();
+    options.allocationArea = m_allocationAreaLineEdit->text().trimmed();
+    options.allocationChunkSize = m_allocationChunkSizeLineEdit->text().trimmed();
+    options.suggestedHeapSize = m_suggestedHeapSizeLineEdit->text().trimmed();
+    options.maximumHeapSize = m_maximumHeapSizeLineEdit->text().trimmed();
+    options.parallelGc = m_parallelGcCheckBox->isChecked();
+    options.idleGc = m_idleGcCheckBox->isChecked();
+    options.nonmovingGc = m_nonmovingGcCheckBox->isChecked();
+    options.additionalOptions = m_additionalOptionsLineEdit->text();
+    if (options == m_options)
+        return;
+    m_options = options;
+    m_updatingWidgets = true;
+    m_presetComboBox->setCurrentIndex(m_options.matchingPreset());
+    m_updatingWidgets = false;
+    updateProblems();
+    emit changed();
+}
+
+void HaskellRtsOptionsAspect::updateWidgets()
+{
+    if (!m_presetComboBox)
+        return;
+    m_updatingWidgets = true;
+    m_presetComboBox->setCurrentIndex(m_options.matchingPreset());
+    m_capabilitiesSpinBox->setValue(m_options.capabilities);
+    m_allocationAreaLineEdit->setText(m_options.allocationArea);
+    m_allocationChunkSizeLineEdit->setText(m_options.allocationChunkSize);
+    m_suggestedHeapSizeLineEdit->setText(m_options.suggestedHeapSize);
+    m_maximumHeapSizeLineEdit->setText(m_options.maximumHeapSize);
+    m_parallelGcCheckBox->setChecked(m_options.parallelGc);
+    m_idleGcCheckBox->setChecked(m_options.idleGc);
+    m_nonmovingGcCheckBox->setChecked(m_options.nonmovingGc);
+    m_additionalOptionsLineEdit->setText(m_options.additionalOptions);
+    m_updatingWidgets = false;
+    updateProblems();
+}
+
+void HaskellRtsOptionsAspect::updateProblems()
+{
+    if (!m_problemsLabel)
+        return;
+    const QStringList problems = m_options.problems(m_rtsInfo);
+    m_problemsLabel->setText(problems.join('\n'));
+    m_problemsLabel->setVisible(!problems.isEmpty());
+}
+
+void HaskellRtsOptionsAspect::probeExecutable()
+{
+    if (!m_problemsLabel)
+        return;
+    const Utils::FilePath executable = m_executableProvider ? m_executableProvider()
+                                                            : Utils::FilePath();
+    if (executable.isEmpty() || !executable.exists()) {
+        m_rtsInfo = {};
+        m_probedExecutable = {};
+        updateProblems();
+        return;
+    }
+    const QDateTime timestamp = executable.lastModified();
+    if (executable == m_probedExecutable && timestamp == m_probedTimestamp) {
+        updateProblems();
+        return;
+    }
+    m_probedExecutable = executable;
+    m_probedTimestamp = timestamp;
+    m_rtsInfo = {};
+    updateProblems();
+
+    // the runtime system answers before the program runs
+    m_probe.reset(new Utils::QtcProcess);
+    m_probe->setCommand({executable, RtsInfo::probeArguments()});
+    connect(m_probe.get(), &Utils::QtcProcess::done, this, [this] {
+        m_rtsInfo = RtsInfo::fromOutput(m_probe->stdOut(), m_probe->stdErr());
+        m_probe.release()->deleteLater();
+        updateProblems();
+    });
+    m_probe->start();
+}
+
 HaskellRunConfiguration::HaskellRunConfiguration(Target *target, Utils::Id id)
     : RunConfiguration(target, id)
 {
@@ -60,12 +333,35 @@ HaskellRunConfiguration::HaskellRunConfiguration(Target *target, Utils::Id id)
 
     addAspect<HaskellExecutableAspect>();
     addAspect<ArgumentsAspect>(macroExpander());
+    auto rtsOptionsAspect = addAspect<HaskellRtsOptionsAspect>();
+    // the stack paths are cached by the build configuration, probe again when they changed
+    rtsOptionsAspect->setExecutableProvider([this]() -> Utils::FilePath {
+        auto bc = qobject_cast<HaskellBuildConfiguration *>(
+            this->target()->activeBuildConfiguration());
+        if (!bc)
+            return {};
+        return bc->stackPaths().executable(aspect<HaskellExecutableAspect>()->value());
+    });
+    const auto watchStackPaths = [rtsOptionsAspect](BuildConfiguration *buildConfiguration) {
+        if (auto bc = qobject_cast<HaskellBuildConfiguration *>(buildConfiguration)) {
+            connect(bc, &HaskellBuildConfiguration::stackPathsChanged,
+                    rtsOptionsAspect, &HaskellRtsOptionsAspect::probeExecutable);
+        }
+    };
+    for (BuildConfiguration *buildConfiguration : target->buildConfigurations())
+        watchStackPaths(buildConfiguration);
+    connect(target, &Target::addedBuildConfiguration, this, watchStackPaths);
+    connect(target, &Target::activeBuildConfigurationChanged,
+            rtsOptionsAspect, &HaskellRtsOptionsAspect::probeExecutable);
+    addAspect<HaskellProfilingAspect>();
 
     auto workingDirAspect = addAspect<WorkingDirectoryAspect>(macroExpander(), envAspect);
     workingDirAspect->setDefaultWorkingDirectory(target->project()->projectDirectory());
     workingDirAspect->setVisible(false);
 
     addAspect<TerminalAspect>();
+    addAspect<HaskellOutputLogAspect>();
+    addAspect<HaskellRtsStatsAspect>();
 
     setUpdater([this] { aspect<HaskellExecutableAspect>()->setValue(buildTargetInfo().buildKey); });
     connect(target, &Target::buildSystemUpdated, this, &RunConfiguration::update);
@@ -74,23 +370,58 @@ HaskellRunConfiguration::HaskellRunConfiguration(Target *target, Utils::Id id)
 
 Runnable HaskellRunConfiguration::runnable() const
 {
-    const Utils::FilePath projectDirectory = target()->project()->projectDirectory();
     Runnable r;
+    r.workingDirectory = target()->project()->projectDirectory();
+    r.environment = aspect<LocalEnvironmentAspect>()->environment();
+    r.command = commandLine(target(),
+                            aspect<HaskellExecutableAspect>()->value(),
+                            aspect<HaskellRtsOptionsAspect>()->arguments()
+                                + aspect<HaskellRtsStatsAspect>()->rtsArguments(),
+                            aspect<ArgumentsAspect>()->arguments(),
+                            &r.environment);
+    return r;
+}
+
+Utils::CommandLine HaskellRunConfiguration::commandLine(Target *target,
+                                                        const QString &executable,
+                                                        const QStringList &rtsOptions,
+                                                        const QString &arguments,
+                                                        Utils::Environment *environment)
+{
+    const Utils::FilePath projectDirectory = target->project()->projectDirectory();
+    const QStringList rtsArguments = rtsOptions.isEmpty()
+                                         ? QStringList()
+                                         : QStringList("+RTS") + rtsOptions + QStringList("-RTS");
+
+    // start the built executable directly, "stack exec" takes a while to start up
+    if (auto bc = qobject_cast<HaskellBuildConfiguration *>(target->activeBuildConfiguration())) {
+        const StackPaths paths = bc->stackPaths();
+        const Utils::FilePath binary = paths.executable(executable);
+        if (!binary.isEmpty()) {
+            paths.addToEnvironment(*environment);
+            Utils::CommandLine command(binary, rtsArguments);
+            command.addArgs(arguments, Utils::CommandLine::Raw);
+            return command;
+        }
+    }
+
     QStringList args;
-    if (BuildConfiguration *buildConfiguration = target()->activeBuildConfiguration()) {
+    if (BuildConfiguration *buildConfiguration = target->activeBuildConfiguration()) {
         args << "--work-dir"
              << QDir(projectDirectory.toString()).relativeFilePath(
                     buildConfiguration->buildDirectory().toString());
     }
-    args << "exec" << aspect<HaskellExecutableAspect>()->value();
-    const QString arguments = aspect<ArgumentsAspect>()->arguments();
+    args << "exec" << executable;
+    if (!rtsArguments.isEmpty()) {
+        // keep stack's own runtime system from taking the options
+        args << "--RTS" << "--" << rtsArguments;
+    } else if (!arguments.isEmpty()) {
+        args << "--";
+    }
     if (!arguments.isEmpty())
-        args << "--" << arguments;
+        args << arguments;
 
-    r.workingDirectory = projectDirectory;
-    r.environment = aspect<LocalEnvironmentAspect>()->environment();
-    r.command = {r.environment.searchInPath(HaskellManager::stackExecutable().toString()), args};
-    return r;
+    return {environment->searchInPath(HaskellManager::stackExecutable().toString()), args};
 }
 
 } // namespace Internal
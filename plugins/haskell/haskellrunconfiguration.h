@@ -25,11 +25,31 @@
 
 #pragma once
 
+#include "rtsoptions.h"
+
 #include <projectexplorer/projectexplorerconstants.h>
 #include <projectexplorer/runconfigurationaspects.h>
 #include <projectexplorer/runcontrol.h>
 #include <utils/aspects.h>
 
+#include <QDateTime>
+#include <QPointer>
+
+#include <functional>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QCheckBox;
+class QComboBox;
+class QLineEdit;
+class QSpinBox;
+QT_END_NAMESPACE
+
+namespace Utils {
+class InfoLabel;
+class QtcProcess;
+} // namespace Utils
+
 namespace Haskell {
 namespace Internal {
 
@@ -40,6 +60,14 @@ class HaskellRunConfiguration : public ProjectExplorer::RunConfiguration
 public:
     HaskellRunConfiguration(ProjectExplorer::Target *target, Utils::Id id);
 
+    // Runs the built executable if there is one, "stack exec" otherwise. Adds the paths of the
+    // build to the environment.
+    static Utils::CommandLine commandLine(ProjectExplorer::Target *target,
+                                          const QString &executable,
+                                          const QStringList &rtsOptions,
+                                          const QString &arguments,
+                                          Utils::Environment *environment);
+
 private:
     ProjectExplorer::Runnable runnable() const final;
 };
@@ -48,6 +76,10 @@ class HaskellRunConfigurationFactory : public ProjectExplorer::RunConfigurationF
 {
 public:
     HaskellRunConfigurationFactory();
+
+protected:
+    QList<ProjectExplorer::RunConfigurationCreationInfo> availableCreators(
+        ProjectExplorer::Target *target) const override;
 };
 
 class HaskellExecutableAspect : public Utils::StringAspect
@@ -58,5 +90,99 @@ public:
     HaskellExecutableAspect();
 };
 
+// RTS options for runs in the profile run mode.
+class HaskellProfilingAspect : public Utils::StringAspect
+{
+    Q_OBJECT
+
+public:
+    HaskellProfilingAspect();
+};
+
+// Whether the output goes to a bounded output log instead of the application output.
+class HaskellOutputLogAspect : public Utils::BoolAspect
+{
+    Q_OBJECT
+
+public:
+    HaskellOutputLogAspect();
+};
+
+// Whether the runtime system writes statistics of each garbage collection to a file, which are
+// shown live in the Haskell Analysis pane.
+class HaskellRtsStatsAspect : public Utils::BoolAspect
+{
+    Q_OBJECT
+
+public:
+    HaskellRtsStatsAspect();
+
+    QString statsFilePath() const { return m_statsFilePath; }
+    QStringList rtsArguments() const;
+
+    struct Data : BoolAspect::Data
+    {
+        QString statsFilePath;
+    };
+
+private:
+    QString m_statsFilePath;
+};
+
+// Tuning options for the runtime system, with presets. They are checked against what the
+// executable's runtime system supports when the settings are shown.
+class HaskellRtsOptionsAspect : public Utils::BaseAspect
+{
+    Q_OBJECT
+
+public:
+    HaskellRtsOptionsAspect();
+    ~HaskellRtsOptionsAspect() override;
+
+    RtsOptions options() const { return m_options; }
+    void setOptions(const RtsOptions &options);
+    QStringList arguments() const { return m_options.arguments(); }
+
+    // The provider must not block, it is asked whenever the settings are shown.
+    void setExecutableProvider(const std::function<Utils::FilePath()> &provider);
+    // Checks the options against the executable again, if the settings are shown.
+    void probeExecutable();
+
+    void addToLayout(Utils::LayoutBuilder &builder) override;
+    void fromMap(const QVariantMap &map) override;
+    void toMap(QVariantMap &map) const override;
+
+    struct Data : BaseAspect::Data
+    {
+        QStringList arguments;
+    };
+
+private:
+    void applyPreset(int index);
+    void readWidgets();
+    void updateWidgets();
+    void updateProblems();
+
+    RtsOptions m_options;
+    std::function<Utils::FilePath()> m_executableProvider;
+    std::unique_ptr<Utils::QtcProcess> m_probe;
+    Utils::FilePath m_probedExecutable;
+    QDateTime m_probedTimestamp;
+    RtsInfo m_rtsInfo;
+    bool m_updatingWidgets = false;
+
+    QPointer<QComboBox> m_presetComboBox;
+    QPointer<QSpinBox> m_capabilitiesSpinBox;
+    QPointer<QLineEdit> m_allocationAreaLineEdit;
+    QPointer<QLineEdit> m_allocationChunkSizeLineEdit;
+    QPointer<QLineEdit> m_suggestedHeapSizeLineEdit;
+    QPointer<QLineEdit> m_maximumHeapSizeLineEdit;
+    QPointer<QCheckBox> m_parallelGcCheckBox;
+    QPointer<QCheckBox> m_idleGcCheckBox;
+    QPointer<QCheckBox> m_nonmovingGcCheckBox;
+    QPointer<QLineEdit> m_additionalOptionsLineEdit;
+    QPointer<Utils::InfoLabel> m_problemsLabel;
+};
+
 } // namespace Internal
 } // namespace Haskell
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "haskellsemantichighlighter.h"
+
+#include "completionindex.h"
+#include "haskellcompletionindexer.h"
+#include "haskelllanguageclient.h"
+#include "literatehaskell.h"
+
+#include <texteditor/fontsettings.h>
+#include <texteditor/syntaxhighlighter.h>
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditorsettings.h>
+#include <utils/qtcassert.h>
+#include <utils/runextensions.h>
+
+#include <QTextBlock>
+#include <QTextDocument>
+
+#include <algorithm>
+
+using namespace TextEditor;
+
+namespace Haskell {
+namespace Internal {
+
+// waits for a pause in typing, the lexical highlighting is shown before
+static const int updateDelay = 300;
+
+static void findTokens(QFutureInterface<SemanticUpdate> &futureInterface,
+                       const QString &text,
+                       bool literate,
+                       const CompletionIndex &index)
+{
+    // the code of literate Haskell has the lines of the text, bird tracks move its columns
+    QVector<int> codeColumns;
+    const QString source = literate ? LiterateHaskell::unlit(text, &codeColumns) : text;
+    const ModuleSymbols symbols = ModuleSymbols::fromSource(source);
+    QSet<QString> functionNames = index.importedNames(symbols);
+    for (const QString &name : symbols.topLevelNames)
+        functionNames.insert(name);
+    SemanticUpdate update;
+    update.tokens = SemanticTokens::fromLines(source.split('\n'), functionNames);
+    for (SemanticToken &token : update.tokens)
+        token.column += codeColumns.value(token.line);
+    update.data = SemanticTokens::encode(update.tokens);
+    futureInterface.reportResult(update);
+}
+
+HaskellSemanticHighlighter::HaskellSemanticHighlighter(TextDocument *document)
+    : QObject(document)
+    , m_document(document)
+{
+    updateFormats();
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(updateDelay);
+    connect(&m_updateTimer, &QTimer::timeout, this, &HaskellSemanticHighlighter::startUpdate);
+    connect(document, &Core::IDocument::contentsChanged,
+            &m_updateTimer, qOverload<>(&QTimer::start));
+    if (HaskellCompletionIndexer *indexer = HaskellCompletionIndexer::instance()) {
+        connect(indexer, &HaskellCompletionIndexer::indexChanged,
+                &m_updateTimer, qOverload<>(&QTimer::start));
+    }
+    connect(TextEditorSettings::instance(), &TextEditorSettings::fontSettingsChanged,
+            this, [this] {
+        updateFormats();
+        applyLines(SemanticTokens::decode(m_data), LineRange());
+    });
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, [this] {
+        if (m_watcher.isCanceled())
+            return;
+        // the document changed while the update ran, the timer runs again
+        if (m_revision != m_document->document()->revision())
+            return;
+        const SemanticUpdate update = m_watcher.result();
+        const SemanticTokensEdit edit = SemanticTokens::diff(m_data, update.data);
+        if (edit.isEmpty())
+            return;
+        m_data = update.data;
+        applyLines(update.tokens, SemanticTokens::changedLines(update.tokens, edit));
+    });
+    m_updateTimer.start();
+}
+
+HaskellSemanticHighlighter::~HaskellSemanticHighlighter()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+HaskellSemanticHighlighter *HaskellSemanticHighlighter::forDocument(TextDocument *document)
+{
+    if (!document)
+        return nullptr;
+    if (auto highlighter = document->findChild<HaskellSemanticHighlighter *>())
+        return highlighter;
+    return new HaskellSemanticHighlighter(document);
+}
+
+void HaskellSemanticHighlighter::startUpdate()
+{
+    if (m_watcher.isRunning()) {
+        m_updateTimer.start();
+        return;
+    }
+    const HaskellLanguageServers *servers = HaskellLanguageServers::instance();
+    const HaskellLanguageClient *client = servers ? servers->clientForFile(m_document->filePath())
+                                                  : nullptr;
+    if (client && client->providesSemanticTokens()) {
+        // its formats replace these
+        m_data.clear();
+        return;
+    }
+    const HaskellCompletionIndexer *indexer = HaskellCompletionIndexer::instance();
+    m_revision = m_document->document()->revision();
+    m_watcher.setFuture(Utils::runAsync(findTokens, m_document->plainText(),
+                                        LiterateHaskell::isLiterateFile(
+                                            m_document->filePath().toString()),
+                                        indexer ? indexer->index() : CompletionIndex()));
+}
+
+void HaskellSemanticHighlighter::applyLines(const QVector<SemanticToken> &tokens,
+                                            const LineRange &lines)
+{
+    SyntaxHighlighter *highlighter = m_document->syntaxHighlighter();
+    QTC_ASSERT(highlighter, return);
+    auto token = std::lower_bound(tokens.cbegin(), tokens.cend(), lines.first,
+                                  [](const SemanticToken &token, int line) {
+                                      return token.line < line;
+                                  });
+    int line = lines.first;
+    for (QTextBlock block = m_document->document()->findBlockByNumber(line);
+         block.isValid() && (lines.last < 0 || line <= lines.last);
+         block = block.next(), ++line) {
+        QVector<QTextLayout::FormatRange> formats;
+        for (; token != tokens.cend() && token->line == line; ++token) {
+            QTextLayout::FormatRange range;
+            range.start = token->column;
+            range.length = token->length;
+            range.format = m_formats.value(token->kind);
+            formats.append(range);
+        }
+        if (formats.isEmpty())
+            highlighter->clearExtraFormats(block);
+        else
+            highlighter->setExtraFormats(block, std::move(formats));
+    }
+}
+
+void HaskellSemanticHighlighter::updateFormats()
+{
+    const FontSettings &fontSettings = TextEditorSettings::fontSettings();
+    m_formats.insert(SemanticToken::Function, fontSettings.toTextCharFormat(C_FUNCTION));
+    m_formats.insert(SemanticToken::FunctionDeclaration,
+                     fontSettings.toTextCharFormat(
+                         TextStyles::mixinStyle(C_FUNCTION, C_DECLARATION)));
+    m_formats.insert(SemanticToken::Parameter, fontSettings.toTextCharFormat(C_PARAMETER));
+}
+
+} // namespace Internal
+} // namespace Haskell
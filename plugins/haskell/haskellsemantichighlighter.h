@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "semantictokens.h"
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QTextCharFormat>
+#include <QTimer>
+
+namespace TextEditor { class TextDocument; }
+
+namespace Haskell {
+namespace Internal {
+
+class SemanticUpdate
+{
+public:
+    QVector<SemanticToken> tokens;
+    QVector<int> data; // the encoded tokens
+};
+
+// Highlights the functions and parameters of a Haskell document on top of the formats of the
+// HaskellHighlighter, which paints first. The tokens are found in the background when typing
+// pauses, from the document and the modules it imports in the completion index. Only the lines
+// with tokens that changed are formatted again. Documents of a language server that provides
+// semantic tokens are left to the language client.
+class HaskellSemanticHighlighter : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~HaskellSemanticHighlighter() override;
+
+    static HaskellSemanticHighlighter *forDocument(TextEditor::TextDocument *document);
+
+private:
+    explicit HaskellSemanticHighlighter(TextEditor::TextDocument *document);
+
+    void startUpdate();
+    void applyLines(const QVector<SemanticToken> &tokens, const LineRange &lines);
+    void updateFormats();
+
+    TextEditor::TextDocument *m_document;
+    int m_revision = 0; // of the document for the running update
+    QVector<int> m_data; // the applied tokens, encoded
+    QHash<int, QTextCharFormat> m_formats; // by kind
+    QTimer m_updateTimer;
+    QFutureWatcher<SemanticUpdate> m_watcher;
+};
+
+} // namespace Internal
+} // namespace Haskell
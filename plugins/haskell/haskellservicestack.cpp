@@ -0,0 +1,563 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "haskellservicestack.h"
+
+#include "haskellbenchmark.h"
+#include "haskellconstants.h"
+#include "haskellrunconfiguration.h"
+
+#include <projectexplorer/buildsystem.h>
+#include <projectexplorer/localenvironmentaspect.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/runconfigurationaspects.h>
+#include <projectexplorer/target.h>
+#include <utils/algorithm.h>
+#include <utils/infolabel.h>
+#include <utils/layoutbuilder.h>
+#include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QHostAddress>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QVBoxLayout>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+enum Column { EnabledColumn, ExecutableColumn, TagColumn, ArgumentsColumn, RtsOptionsColumn,
+              AfterColumn, ReadinessColumn, ConditionColumn, ColumnCount };
+
+// how often an open port is checked for
+static const int portProbeInterval = 200;
+
+HaskellServiceStackAspect::HaskellServiceStackAspect()
+{
+    setSettingsKey("Haskell.ServiceStack");
+    setDisplayName(tr("Services"));
+    addDataExtractor(this, &HaskellServiceStackAspect::stack, &Data::stack);
+}
+
+void HaskellServiceStackAspect::setStack(const ServiceStack &stack)
+{
+    if (stack == m_stack)
+        return;
+    m_stack = stack;
+    updateWidgets();
+    emit changed();
+}
+
+void HaskellServiceStackAspect::setExecutablesProvider(
+    const std::function<QStringList()> &provider)
+{
+    m_executablesProvider = provider;
+}
+
+void HaskellServiceStackAspect::addToLayout(LayoutBuilder &builder)
+{
+    auto widget = createSubWidget<QWidget>();
+    auto layout = new QVBoxLayout(widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({QString(), tr("Executable"), tr("Tag"), tr("Arguments"),
+                                        tr("RTS Options"), tr("Start After"), tr("Ready When"),
+                                        tr("Pattern or Port")});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setToolTip(tr("Services start at once unless they wait for other services to be "
+                           "ready. \"Start After\" takes a comma separated list of tags, a "
+                           "service is ready when it started, when a line of its output "
+                           "matches the pattern, or when the port on the local host accepts "
+                           "connections."));
+    layout->addWidget(m_table.data());
+
+    auto addButton = new QPushButton(tr("Add"));
+    auto removeButton = new QPushButton(tr("Remove"));
+    auto buttons = new QHBoxLayout;
+    buttons->addWidget(addButton);
+    buttons->addWidget(removeButton);
+    buttons->addStretch();
+    layout->addLayout(buttons);
+
+    m_problemsLabel = new InfoLabel({}, InfoLabel::Warning);
+    m_problemsLabel->setElideMode(Qt::ElideNone);
+    m_problemsLabel->setWordWrap(true);
+    layout->addWidget(m_problemsLabel.data());
+
+    updateWidgets();
+
+    connect(m_table, &QTableWidget::itemChanged, this, &HaskellServiceStackAspect::readWidgets);
+    connect(addButton, &QPushButton::clicked, this, &HaskellServiceStackAspect::addService);
+    connect(removeButton, &QPushButton::clicked, this, &HaskellServiceStackAspect::removeService);
+
+    builder.addRow({tr("Services:"), widget});
+}
+
+void HaskellServiceStackAspect::fromMap(const QVariantMap &map)
+{
+    m_stack = ServiceStack::fromList(map.value(settingsKey()).toList());
+    updateWidgets();
+}
+
+void HaskellServiceStackAspect::toMap(QVariantMap &map) const
+{
+    map.insert(settingsKey(), m_stack.toList());
+}
+
+void HaskellServiceStackAspect::addRow(const ServiceSpec &spec)
+{
+    const int row = m_table->rowCount();
+    m_table->insertRow(row);
+
+    auto enabledItem = new QTableWidgetItem;
+    enabledItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable | Qt::ItemIsSelectable);
+    enabledItem->setCheckState(spec.enabled ? Qt::Checked : Qt::Unchecked);
+    m_table->setItem(row, EnabledColumn, enabledItem);
+
+    auto executableComboBox = new QComboBox;
+    QStringList executables = m_executablesProvider ? m_executablesProvider() : QStringList();
+    if (!spec.executable.isEmpty() && !executables.contains(spec.executable))
+        executables.append(spec.executable);
+    executableComboBox->addItems(executables);
+    executableComboBox->setCurrentIndex(executables.indexOf(spec.executable));
+    m_table->setCellWidget(row, ExecutableColumn, executableComboBox);
+    connect(executableComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HaskellServiceStackAspect::readWidgets);
+
+    m_table->setItem(row, TagColumn, new QTableWidgetItem(spec.tag));
+    m_table->setItem(row, ArgumentsColumn, new QTableWidgetItem(spec.arguments));
+    m_table->setItem(row, RtsOptionsColumn, new QTableWidgetItem(spec.rtsOptions));
+    m_table->setItem(row, AfterColumn, new QTableWidgetItem(spec.after.join(", ")));
+
+    auto readinessComboBox = new QComboBox;
+    for (int i = 0; i < ServiceSpec::ReadinessCount; ++i)
+        readinessComboBox->addItem(ServiceSpec::readinessName(ServiceSpec::Readiness(i)));
+    readinessComboBox->setCurrentIndex(spec.readiness);
+    m_table->setCellWidget(row, ReadinessColumn, readinessComboBox);
+    connect(readinessComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &HaskellServiceStackAspect::readWidgets);
+
+    QString condition;
+    if (spec.readiness == ServiceSpec::WhenOutputMatches)
+        condition = spec.readyPattern;
+    else if (spec.readiness == ServiceSpec::WhenPortOpen && spec.readyPort > 0)
+        condition = QString::number(spec.readyPort);
+    m_table->setItem(row, ConditionColumn, new QTableWidgetItem(condition));
+}
+
+void HaskellServiceStackAspect::addService()
+{
+    // the first executable that is not in the stack yet
+    ServiceSpec spec;
+    const QStringList executables = m_executablesProvider ? m_executablesProvider()
+                                                          : QStringList();
+    for (const QString &executable : executables) {
+        const bool used = Utils::anyOf(m_stack.services, [executable](const ServiceSpec &s) {
+            return s.executable == executable;
+        });
+        if (!used) {
+            spec.executable = executable;
+            break;
+        }
+    }
+    if (spec.executable.isEmpty() && !executables.isEmpty())
+        spec.executable = executables.first();
+    m_updatingWidgets = true;
+    addRow(spec);
+    m_updatingWidgets = false;
+    readWidgets();
+}
+
+void HaskellServiceStackAspect::removeService()
+{
+    const int row = m_table->currentRow();
+    if (row < 0)
+        return;
+    m_table->removeRow(row);
+    readWidgets();
+}
+
+void HaskellServiceStackAspect::readWidgets()
+{
+    if (m_updatingWidgets || !m_table)
+        return;
+    const auto text = [this](int row, int column) {
+        const QTableWidgetItem *item = m_table->item(row, column);
+        return item ? item->text().trimmed() : QString();
+    };
+    ServiceStack stack;
+    for (int row = 0; row < m_table->rowCount(); ++row) {
+        ServiceSpec spec;
+        const QTableWidgetItem *enabledItem = m_table->item(row, EnabledColumn);
+        spec.enabled = enabledItem && enabledItem->checkState() == Qt::Checked;
+        if (auto comboBox = qobject_cast<QComboBox *>(m_table->cellWidget(row,
+                                                                         ExecutableColumn))) {
+            spec.executable = comboBox->currentText();
+        }
+        spec.tag = text(row, TagColumn);
+        spec.arguments = text(row, ArgumentsColumn);
+        spec.rtsOptions = text(row, RtsOptionsColumn);
+        for (const QString &name : text(row, AfterColumn).split(',', Qt::SkipEmptyParts)) {
+            if (!name.trimmed().isEmpty())
+                spec.after << name.trimmed();
+        }
+        if (auto comboBox = qobject_cast<QComboBox *>(m_table->cellWidget(row,
+                                                                         ReadinessColumn))) {
+            spec.readiness = ServiceSpec::Readiness(std::max(comboBox->currentIndex(), 0));
+        }
+        const QString condition = text(row, ConditionColumn);
+        if (spec.readiness == ServiceSpec::WhenOutputMatches)
+            spec.readyPattern = condition;
+        else if (spec.readiness == ServiceSpec::WhenPortOpen)
+            spec.readyPort = condition.toInt();
+        stack.services.append(spec);
+    }
+    if (stack == m_stack)
+        return;
+    m_stack = stack;
+    updateProblems();
+    emit changed();
+}
+
+void HaskellServiceStackAspect::updateWidgets()
+{
+    if (!m_table)
+        return;
+    m_updatingWidgets = true;
+    m_table->setRowCount(0);
+    for (const ServiceSpec &spec : std::as_const(m_stack.services))
+        addRow(spec);
+    m_updatingWidgets = false;
+    updateProblems();
+}
+
+void HaskellServiceStackAspect::updateProblems()
+{
+    if (!m_problemsLabel)
+        return;
+    const QStringList problems = m_stack.problems();
+    m_problemsLabel->setText(problems.join('\n'));
+    m_problemsLabel->setVisible(!problems.isEmpty());
+}
+
+HaskellServiceStackRunConfiguration::HaskellServiceStackRunConfiguration(Target *target,
+                                                                         Utils::Id id)
+    : RunConfiguration(target, id)
+{
+    setDefaultDisplayName(tr("Service Stack"));
+    auto envAspect = addAspect<LocalEnvironmentAspect>(target);
+
+    auto stackAspect = addAspect<HaskellServiceStackAspect>();
+    stackAspect->setExecutablesProvider([this] { return executables(this->target()); });
+
+    auto workingDirAspect = addAspect<WorkingDirectoryAspect>(macroExpander(), envAspect);
+    workingDirAspect->setDefaultWorkingDirectory(target->project()->projectDirectory());
+    workingDirAspect->setVisible(false);
+
+    // a new stack runs all executables
+    setUpdater([this, stackAspect] {
+        if (!stackAspect->stack().services.isEmpty())
+            return;
+        ServiceStack stack;
+        for (const QString &executable : executables(this->target())) {
+            ServiceSpec spec;
+            spec.executable = executable;
+            stack.services.append(spec);
+        }
+        stackAspect->setStack(stack);
+    });
+    connect(target, &Target::buildSystemUpdated, this, &RunConfiguration::update);
+    update();
+}
+
+QStringList HaskellServiceStackRunConfiguration::executables(const Target *target)
+{
+    QStringList result;
+    if (!target || !target->buildSystem())
+        return result;
+    for (const BuildTargetInfo &info : target->buildSystem()->applicationTargets()) {
+        if (!isBenchmarkBuildKey(info.buildKey))
+            result << info.buildKey;
+    }
+    return result;
+}
+
+Runnable HaskellServiceStackRunConfiguration::runnable() const
+{
+    Runnable r;
+    r.workingDirectory = target()->project()->projectDirectory();
+    r.environment = aspect<LocalEnvironmentAspect>()->environment();
+    // the services are started by the runner, this is what is shown for the run
+    const QVector<ServiceSpec> services = aspect<HaskellServiceStackAspect>()->stack()
+                                              .enabledServices();
+    if (!services.isEmpty()) {
+        Environment environment = r.environment;
+        r.command = HaskellRunConfiguration::commandLine(target(),
+                                                         services.first().executable,
+                                                         services.first().rtsArguments(),
+                                                         services.first().arguments,
+                                                         &environment);
+    }
+    return r;
+}
+
+HaskellServiceStackRunConfigurationFactory::HaskellServiceStackRunConfigurationFactory()
+{
+    registerRunConfiguration<HaskellServiceStackRunConfiguration>(
+        Constants::C_HASKELL_SERVICE_STACK_RUNCONFIG_ID);
+    addSupportedProjectType(Constants::C_HASKELL_PROJECT_ID);
+    addSupportedTargetDeviceType(ProjectExplorer::Constants::DESKTOP_DEVICE_TYPE);
+}
+
+QList<RunConfigurationCreationInfo> HaskellServiceStackRunConfigurationFactory::availableCreators(
+    Target *target) const
+{
+    // only offered for projects with several executables, and never created automatically
+    if (HaskellServiceStackRunConfiguration::executables(target).size() < 2)
+        return {};
+    RunConfigurationCreationInfo info;
+    info.factory = this;
+    info.buildKey = "service-stack";
+    info.displayName = HaskellServiceStackRunConfiguration::tr("Service Stack");
+    info.creationMode = RunConfigurationCreationInfo::ManualCreationOnly;
+    info.projectFilePath = target->project()->projectFilePath();
+    return {info};
+}
+
+class HaskellServiceStackRunner::Service
+{
+public:
+    ServiceSpec spec;
+    QtcProcess process;
+    std::unique_ptr<ServiceOutput> stdOut;
+    std::unique_ptr<ServiceOutput> stdErr;
+    QTcpSocket probe;
+    QTimer probeTimer;
+    bool ready = false;
+    bool finished = false;
+};
+
+HaskellServiceStackRunner::HaskellServiceStackRunner(RunControl *runControl)
+    : RunWorker(runControl)
+{
+    setId("HaskellServiceStackRunner");
+}
+
+HaskellServiceStackRunner::~HaskellServiceStackRunner() = default;
+
+void HaskellServiceStackRunner::start()
+{
+    const auto stackData = runControl()->aspect<HaskellServiceStackAspect>();
+    QTC_ASSERT(stackData, reportFailure(); return);
+    m_stack = stackData->stack;
+    const QStringList problems = m_stack.problems();
+    if (!problems.isEmpty()) {
+        reportFailure(problems.join('\n'));
+        return;
+    }
+    if (m_stack.enabledServices().isEmpty()) {
+        reportFailure(tr("The service stack has no enabled services."));
+        return;
+    }
+    m_startTime.start();
+    startServices();
+    reportStarted();
+}
+
+void HaskellServiceStackRunner::stop()
+{
+    m_stopping = true;
+    // all at once, services can take a while to shut down
+    for (const std::unique_ptr<Service> &service : m_services) {
+        service->probeTimer.stop();
+        service->probe.abort();
+        if (!service->finished)
+            service->process.stop();
+    }
+    checkFinished();
+}
+
+void HaskellServiceStackRunner::startServices()
+{
+    for (const QString &name : m_stack.startable(m_started, m_ready)) {
+        if (const ServiceSpec *spec = m_stack.service(name))
+            startService(*spec);
+    }
+}
+
+void HaskellServiceStackRunner::startService(const ServiceSpec &spec)
+{
+    const QString name = spec.name();
+    m_started.insert(name);
+    auto service = std::make_unique<Service>();
+    Service *s = service.get();
+    s->spec = spec;
+    const QString readyPattern = spec.readiness == ServiceSpec::WhenOutputMatches
+                                     ? spec.readyPattern
+                                     : QString();
+    s->stdOut = std::make_unique<ServiceOutput>(name, readyPattern);
+    s->stdErr = std::make_unique<ServiceOutput>(name, readyPattern);
+
+    Environment environment = runControl()->environment();
+    const CommandLine command = HaskellRunConfiguration::commandLine(runControl()->target(),
+                                                                     spec.executable,
+                                                                     spec.rtsArguments(),
+                                                                     spec.arguments,
+                                                                     &environment);
+    s->process.setCommand(command);
+    s->process.setWorkingDirectory(runControl()->workingDirectory());
+    s->process.setEnvironment(environment);
+    s->process.setStdOutCallback([this, s](const QString &text) {
+        const QString output = s->stdOut->addOutput(text);
+        if (!output.isEmpty())
+            appendMessage(output, StdOutFormat, false);
+        if (s->stdOut->isReady())
+            setReady(s);
+    });
+    s->process.setStdErrCallback([this, s](const QString &text) {
+        const QString output = s->stdErr->addOutput(text);
+        if (!output.isEmpty())
+            appendMessage(output, StdErrFormat, false);
+        if (s->stdErr->isReady())
+            setReady(s);
+    });
+    connect(&s->process, &QtcProcess::started, this, [this, s] {
+        if (s->spec.readiness == ServiceSpec::WhenStarted)
+            setReady(s);
+        else if (s->spec.readiness == ServiceSpec::WhenPortOpen)
+            probePort(s);
+    });
+    connect(&s->process, &QtcProcess::done, this, [this, s] { finishService(s); });
+
+    s->probeTimer.setSingleShot(true);
+    s->probeTimer.setInterval(portProbeInterval);
+    connect(&s->probeTimer, &QTimer::timeout, this, [this, s] { probePort(s); });
+    connect(&s->probe, &QTcpSocket::connected, this, [this, s] {
+        s->probe.abort();
+        setReady(s);
+    });
+    connect(&s->probe, &QTcpSocket::errorOccurred, this, [this, s] {
+        s->probe.abort();
+        if (!s->ready && !s->finished && !m_stopping)
+            s->probeTimer.start();
+    });
+
+    appendMessage(tr("Starting %1: %2").arg(name, command.toUserOutput()), NormalMessageFormat);
+    m_services.push_back(std::move(service));
+    s->process.start();
+}
+
+void HaskellServiceStackRunner::probePort(Service *service)
+{
+    if (service->ready || service->finished || m_stopping)
+        return;
+    service->probe.abort();
+    service->probe.connectToHost(QHostAddress(QHostAddress::LocalHost),
+                                 quint16(service->spec.readyPort));
+}
+
+void HaskellServiceStackRunner::setReady(Service *service)
+{
+    if (service->ready)
+        return;
+    service->ready = true;
+    service->probeTimer.stop();
+    const QString name = service->spec.name();
+    m_ready.insert(name);
+    appendMessage(tr("%1 is ready after %2 ms.").arg(name).arg(m_startTime.elapsed()),
+                  NormalMessageFormat);
+    if (m_ready.size() == m_stack.enabledServices().size()) {
+        appendMessage(tr("All services are ready after %1 ms.").arg(m_startTime.elapsed()),
+                      NormalMessageFormat);
+    }
+    if (!m_stopping)
+        startServices();
+}
+
+void HaskellServiceStackRunner::finishService(Service *service)
+{
+    const QString stdOut = service->stdOut->finish();
+    if (!stdOut.isEmpty())
+        appendMessage(stdOut, StdOutFormat, false);
+    const QString stdErr = service->stdErr->finish();
+    if (!stdErr.isEmpty())
+        appendMessage(stdErr, StdErrFormat, false);
+    service->finished = true;
+    service->probeTimer.stop();
+    service->probe.abort();
+
+    const QString name = service->spec.name();
+    appendMessage(QString("[%1] %2").arg(name, service->process.exitMessage()),
+                  m_stopping ? NormalMessageFormat : ErrorMessageFormat);
+    if (!service->ready && !m_stopping) {
+        const QStringList waiting = Utils::transform<QStringList>(
+            Utils::filtered(m_stack.enabledServices(), [this, name](const ServiceSpec &spec) {
+                return spec.after.contains(name) && !m_started.contains(spec.name());
+            }),
+            &ServiceSpec::name);
+        if (!waiting.isEmpty()) {
+            appendMessage(tr("%1 exited before it was ready, %2 will not start.")
+                              .arg(name, waiting.join(", ")),
+                          ErrorMessageFormat);
+        }
+    }
+    checkFinished();
+}
+
+void HaskellServiceStackRunner::checkFinished()
+{
+    if (m_stopped)
+        return;
+    const bool running = Utils::anyOf(m_services, [](const std::unique_ptr<Service> &service) {
+        return !service->finished;
+    });
+    if (running)
+        return;
+    m_stopped = true;
+    reportStopped();
+}
+
+HaskellServiceStackRunnerFactory::HaskellServiceStackRunnerFactory()
+{
+    setProduct<HaskellServiceStackRunner>();
+    addSupportedRunMode(ProjectExplorer::Constants::NORMAL_RUN_MODE);
+    addSupportedRunConfig(Constants::C_HASKELL_SERVICE_STACK_RUNCONFIG_ID);
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "servicestack.h"
+
+#include <projectexplorer/runconfiguration.h>
+#include <projectexplorer/runcontrol.h>
+#include <utils/aspects.h>
+
+#include <QElapsedTimer>
+#include <QPointer>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QTableWidget;
+QT_END_NAMESPACE
+
+namespace Utils { class InfoLabel; }
+
+namespace Haskell {
+namespace Internal {
+
+// The executables of a service stack, edited in a table.
+class HaskellServiceStackAspect : public Utils::BaseAspect
+{
+    Q_OBJECT
+
+public:
+    HaskellServiceStackAspect();
+
+    ServiceStack stack() const { return m_stack; }
+    void setStack(const ServiceStack &stack);
+
+    void setExecutablesProvider(const std::function<QStringList()> &provider);
+
+    void addToLayout(Utils::LayoutBuilder &builder) override;
+    void fromMap(const QVariantMap &map) override;
+    void toMap(QVariantMap &map) const override;
+
+    struct Data : BaseAspect::Data
+    {
+        ServiceStack stack;
+    };
+
+private:
+    void addRow(const ServiceSpec &spec);
+    void addService();
+    void removeService();
+    void readWidgets();
+    void updateWidgets();
+    void updateProblems();
+
+    ServiceStack m_stack;
+    std::function<QStringList()> m_executablesProvider;
+    bool m_updatingWidgets = false;
+    QPointer<QTableWidget> m_table;
+    QPointer<Utils::InfoLabel> m_problemsLabel;
+};
+
+// Starts several executables of the project together, for running a local service stack.
+class HaskellServiceStackRunConfiguration : public ProjectExplorer::RunConfiguration
+{
+    Q_OBJECT
+
+public:
+    HaskellServiceStackRunConfiguration(ProjectExplorer::Target *target, Utils::Id id);
+
+    static QStringList executables(const ProjectExplorer::Target *target);
+
+private:
+    ProjectExplorer::Runnable runnable() const final;
+};
+
+class HaskellServiceStackRunConfigurationFactory : public ProjectExplorer::RunConfigurationFactory
+{
+public:
+    HaskellServiceStackRunConfigurationFactory();
+
+protected:
+    QList<ProjectExplorer::RunConfigurationCreationInfo> availableCreators(
+        ProjectExplorer::Target *target) const override;
+};
+
+// Runs the services in parallel. A service starts as soon as the services it waits for are
+// ready, its output goes to the application output with its tag in front of each line.
+class HaskellServiceStackRunner : public ProjectExplorer::RunWorker
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellServiceStackRunner(ProjectExplorer::RunControl *runControl);
+    ~HaskellServiceStackRunner() override;
+
+private:
+    class Service;
+
+    void start() override;
+    void stop() override;
+    void startServices();
+    void startService(const ServiceSpec &spec);
+    void probePort(Service *service);
+    void setReady(Service *service);
+    void finishService(Service *service);
+    void checkFinished();
+
+    ServiceStack m_stack;
+    std::vector<std::unique_ptr<Service>> m_services;
+    QSet<QString> m_started;
+    QSet<QString> m_ready;
+    QElapsedTimer m_startTime;
+    bool m_stopping = false;
+    bool m_stopped = false;
+};
+
+class HaskellServiceStackRunnerFactory : public ProjectExplorer::RunWorkerFactory
+{
+public:
+    HaskellServiceStackRunnerFactory();
+};
+
+} // namespace Internal
+} // namespace Haskell
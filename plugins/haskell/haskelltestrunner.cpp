@@ -0,0 +1,287 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "haskelltestrunner.h"
+
+#include "haskellmanager.h"
+#include "haskellprofiler.h"
+#include "haskellproject.h"
+
+#include <projectexplorer/project.h>
+#include <projectexplorer/target.h>
+#include <utils/algorithm.h>
+#include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
+
+#include <QDir>
+#include <QThread>
+
+#include <algorithm>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace Haskell {
+namespace Internal {
+
+// the output is kept for showing it with the results of the suite
+static const int maximumOutputSize = 1024 * 1024;
+
+HaskellTestRunner::HaskellTestRunner(QObject *parent)
+    : QObject(parent)
+{}
+
+HaskellTestRunner::~HaskellTestRunner()
+{
+    blockSignals(true);
+    cancel();
+}
+
+QVector<HaskellTestSuite> HaskellTestRunner::testSuites(Project *project)
+{
+    Target *target = project ? project->activeTarget() : nullptr;
+    auto buildSystem = target ? qobject_cast<HaskellBuildSystem *>(target->buildSystem())
+                              : nullptr;
+    return buildSystem ? buildSystem->testSuites() : QVector<HaskellTestSuite>();
+}
+
+void HaskellTestRunner::run(Project *project, const Selection &selection)
+{
+    QTC_ASSERT(!m_running, return);
+    m_project = project;
+    m_pendingSuites.clear();
+    m_tixFiles.clear();
+    QStringList names;
+    for (const HaskellTestSuite &suite : testSuites(project)) {
+        if (!selection.contains(suite.name))
+            continue;
+        auto running = std::make_unique<RunningSuite>();
+        running->suite = suite;
+        running->paths = selection.value(suite.name);
+        m_pendingSuites.push_back(std::move(running));
+        names << suite.name;
+    }
+    if (m_pendingSuites.empty()) {
+        emit message(tr("No test suites to run.\n"));
+        emit finished();
+        return;
+    }
+    m_running = true;
+    emit started(names);
+    startBuild();
+}
+
+void HaskellTestRunner::cancel()
+{
+    if (!m_running)
+        return;
+    m_pendingSuites.clear();
+    if (m_buildProcess) {
+        m_buildProcess->disconnect(this);
+        m_buildProcess->setStdOutCallback({});
+        m_buildProcess.reset();
+    }
+    for (const std::unique_ptr<RunningSuite> &suite : m_activeSuites) {
+        suite->process->disconnect(this);
+        suite->process->setStdOutCallback({});
+    }
+    m_activeSuites.clear();
+    emit message(tr("Canceled.\n"));
+    finishRun();
+}
+
+void HaskellTestRunner::startBuild()
+{
+    Target *target = m_project ? m_project->activeTarget() : nullptr;
+    auto bc = target ? qobject_cast<HaskellBuildConfiguration *>(
+                           target->activeBuildConfiguration())
+                     : nullptr;
+    if (!bc) {
+        emit message(tr("The project has no build configuration.\n"));
+        finishRun();
+        return;
+    }
+    m_projectDirectory = m_project->projectDirectory();
+    m_environment = bc->environment();
+    // instrumented builds go to their own work directory, to not rebuild everything afterwards
+    m_workDirectory = m_coverage
+                          ? ProfilingBuilder::workDirectory(bc->buildDirectory(), "coverage")
+                          : bc->buildDirectory();
+
+    // builds all suites in one go, without running them
+    QStringList arguments{"build", "--test", "--no-run-tests"};
+    if (m_coverage)
+        arguments << "--coverage";
+    setupStack(arguments);
+    m_buildProcess->setProcessChannelMode(QProcess::MergedChannels);
+    m_buildProcess->setStdOutCallback([this](const QString &text) { emit message(text); });
+    const QPointer<HaskellBuildConfiguration> buildConfiguration(bc);
+    connect(m_buildProcess.get(), &QtcProcess::done, this, [this, buildConfiguration] {
+        const bool success = m_buildProcess->result() == ProcessResult::FinishedWithSuccess;
+        m_buildProcess.release()->deleteLater();
+        if (!success || !buildConfiguration) {
+            emit message(tr("Building the test suites failed.\n"));
+            finishRun();
+            return;
+        }
+        if (!m_coverage) {
+            m_stackPaths = buildConfiguration->stackPaths();
+            // the build configuration's paths are still being updated in the background
+            if (!m_stackPaths.localInstallRoot.isEmpty()) {
+                startSuites();
+                return;
+            }
+        }
+        setupStack(StackPaths::arguments());
+        connect(m_buildProcess.get(), &QtcProcess::done, this, [this] {
+            const bool success = m_buildProcess->result() == ProcessResult::FinishedWithSuccess;
+            m_stackPaths = StackPaths::fromOutput(m_buildProcess->stdOut());
+            m_buildProcess.release()->deleteLater();
+            if (!success) {
+                emit message(m_coverage ? tr("Cannot find the instrumented build.\n")
+                                        : tr("Cannot find the build.\n"));
+                finishRun();
+                return;
+            }
+            startSuites();
+        });
+        m_buildProcess->start();
+    });
+    emit message(tr("Building the test suites: %1\n")
+                     .arg(m_buildProcess->commandLine().toUserOutput()));
+    m_buildProcess->start();
+}
+
+void HaskellTestRunner::setupStack(const QStringList &arguments)
+{
+    const QString workDir = QDir(m_projectDirectory.toString())
+                                .relativeFilePath(m_workDirectory.toString());
+    m_buildProcess.reset(new QtcProcess);
+    m_buildProcess->setCommand({HaskellManager::stackExecutable(),
+                                QStringList{"--work-dir", workDir} + arguments});
+    m_buildProcess->setWorkingDirectory(m_projectDirectory);
+    m_buildProcess->setEnvironment(m_environment);
+}
+
+void HaskellTestRunner::startSuites()
+{
+    m_stackPaths.addToEnvironment(m_environment);
+    const int parallelSuites = std::max(1, QThread::idealThreadCount());
+    for (int i = 0; i < parallelSuites && m_running; ++i)
+        startNextSuite();
+}
+
+void HaskellTestRunner::startNextSuite()
+{
+    while (!m_pendingSuites.empty()) {
+        std::unique_ptr<RunningSuite> suite = std::move(m_pendingSuites.front());
+        m_pendingSuites.erase(m_pendingSuites.begin());
+        const QString name = suite->suite.name;
+        const FilePath executable = m_stackPaths.buildExecutable(m_projectDirectory, name);
+        if (executable.isEmpty()) {
+            emit suiteFinished(name, false, tr("Cannot find the executable of the test suite."));
+            continue;
+        }
+
+        RunningSuite *running = suite.get();
+        const TestOutputParser::Framework framework = running->suite.framework;
+        running->parser.reset(new TestOutputParser(framework));
+        running->process.reset(new QtcProcess);
+        running->process->setCommand(
+            {executable,
+             TestOutputParser::arguments(framework)
+                 + TestOutputParser::filterArguments(framework, running->paths)});
+        running->process->setWorkingDirectory(m_projectDirectory);
+        Environment environment = m_environment;
+        if (m_coverage) {
+            // the runtime adds to existing tick counts otherwise
+            const FilePath tixFile = coverageDirectory().pathAppended(name + ".tix");
+            tixFile.removeFile();
+            tixFile.parentDir().createDir();
+            environment.set("HPCTIXFILE", tixFile.toString());
+            m_tixFiles.append(tixFile);
+        }
+        running->process->setEnvironment(environment);
+        running->process->setProcessChannelMode(QProcess::MergedChannels);
+        running->process->setStdOutCallback([this, running](const QString &text) {
+            if (running->output.size() < maximumOutputSize)
+                running->output += text;
+            const QVector<TestCaseResult> results = running->parser->addOutput(text);
+            if (!results.isEmpty())
+                emit resultsReady(running->suite.name, results);
+        });
+        connect(running->process.get(), &QtcProcess::done, this, [this, running] {
+            finishSuite(running);
+        });
+        m_activeSuites.push_back(std::move(suite));
+        running->process->start();
+        return;
+    }
+    if (!m_activeSuites.empty())
+        return;
+    if (m_coverage) {
+        const FilePaths tixFiles = Utils::filtered(m_tixFiles, &FilePath::exists);
+        if (!tixFiles.isEmpty()) {
+            const FilePath mixDirectory = m_projectDirectory.resolvePath(
+                m_stackPaths.distDirectory + "/hpc");
+            emit coverageReady(mixDirectory, tixFiles);
+        }
+    }
+    finishRun();
+}
+
+FilePath HaskellTestRunner::coverageDirectory() const
+{
+    return m_workDirectory.pathAppended("coverage");
+}
+
+void HaskellTestRunner::finishSuite(RunningSuite *suite)
+{
+    const QVector<TestCaseResult> results = suite->parser->finish();
+    if (!results.isEmpty())
+        emit resultsReady(suite->suite.name, results);
+    const bool success = suite->process->result() == ProcessResult::FinishedWithSuccess;
+    emit suiteFinished(suite->suite.name, success, suite->output);
+
+    // we are in a signal of the process
+    suite->process.release()->deleteLater();
+    const auto it = std::find_if(m_activeSuites.begin(), m_activeSuites.end(),
+                                 [suite](const std::unique_ptr<RunningSuite> &s) {
+                                     return s.get() == suite;
+                                 });
+    QTC_ASSERT(it != m_activeSuites.end(), return);
+    m_activeSuites.erase(it);
+    startNextSuite();
+}
+
+void HaskellTestRunner::finishRun()
+{
+    if (!m_running)
+        return;
+    m_running = false;
+    emit finished();
+}
+
+} // namespace Internal
+} // namespace Haskell
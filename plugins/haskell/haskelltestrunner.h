@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#pragma once
+
+#include "haskellbuildconfiguration.h"
+#include "testoutputparser.h"
+
+#include <utils/environment.h>
+#include <utils/filepath.h>
+
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+
+#include <memory>
+#include <vector>
+
+namespace ProjectExplorer { class Project; }
+namespace Utils { class QtcProcess; }
+
+namespace Haskell {
+namespace Internal {
+
+class HaskellTestSuite
+{
+public:
+    QString name;
+    TestOutputParser::Framework framework = TestOutputParser::Plain;
+};
+
+// Builds the test suites of a project once, then runs their executables directly and in
+// parallel, reporting the result of each test as soon as it is known.
+class HaskellTestRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HaskellTestRunner(QObject *parent = nullptr);
+    ~HaskellTestRunner() override;
+
+    // Maps suite names to the paths of the tests to run, all tests of a suite if there are none.
+    using Selection = QMap<QString, QVector<QStringList>>;
+
+    void run(ProjectExplorer::Project *project, const Selection &selection);
+    void cancel();
+    bool isRunning() const { return m_running; }
+    // Builds the suites with HPC instrumentation and reports the coverage after they ran.
+    void setCoverage(bool coverage) { m_coverage = coverage; }
+
+    static QVector<HaskellTestSuite> testSuites(ProjectExplorer::Project *project);
+
+signals:
+    void started(const QStringList &suites);
+    void message(const QString &text);
+    void resultsReady(const QString &suite, const QVector<TestCaseResult> &results);
+    void suiteFinished(const QString &suite, bool success, const QString &output);
+    void finished();
+    void coverageReady(const Utils::FilePath &mixDirectory, const Utils::FilePaths &tixFiles);
+
+private:
+    class RunningSuite
+    {
+    public:
+        HaskellTestSuite suite;
+        QVector<QStringList> paths;
+        std::unique_ptr<Utils::QtcProcess> process;
+        std::unique_ptr<TestOutputParser> parser;
+        QString output;
+    };
+
+    void startBuild();
+    void setupStack(const QStringList &arguments);
+    void startSuites();
+    void startNextSuite();
+    void finishSuite(RunningSuite *suite);
+    void finishRun();
+    Utils::FilePath coverageDirectory() const;
+
+    QPointer<ProjectExplorer::Project> m_project;
+    Utils::FilePath m_projectDirectory;
+    Utils::FilePath m_workDirectory;
+    Utils::Environment m_environment;
+    StackPaths m_stackPaths;
+    std::vector<std::unique_ptr<RunningSuite>> m_pendingSuites;
+    std::vector<std::unique_ptr<RunningSuite>> m_activeSuites;
+    std::unique_ptr<Utils::QtcProcess> m_buildProcess;
+    Utils::FilePaths m_tixFiles;
+    bool m_running = false;
+    bool m_coverage = false;
+};
+
+} // namespace Internal
+} // namespace Haskell
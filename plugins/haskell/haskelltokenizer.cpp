@@ -163,6 +163,45 @@ Token Tokens::tokenAtColumn(int col) const
     return Token();
 }
 
+QVector<Token> Tokens::code() const
+{
+    QVector<Token> result;
+    for (const Token &token : *this) {
+        if (token.type != TokenType::Whitespace && token.type != TokenType::SingleLineComment
+            && token.type != TokenType::MultiLineComment) {
+            result.append(token);
+        }
+    }
+    return result;
+}
+
+QVector<Delimiter> Tokens::delimiters() const
+{
+    QVector<Delimiter> result;
+    for (const Token &token : *this) {
+        if (token.type == TokenType::Special) {
+            const QChar c = token.text.at(0);
+            if (c == '(' || c == '[' || c == '{')
+                result.append({c, token.startCol, true});
+            else if (c == ')' || c == ']' || c == '}')
+                result.append({c, token.startCol, false});
+        } else if (token.type == TokenType::MultiLineComment) {
+            // steps like the tokenizer, which takes {- and -} as a whole
+            for (int i = 0; i + 1 < token.length; ++i) {
+                const QStringView pair = token.text.mid(i, 2);
+                if (pair == QLatin1String("{-")) {
+                    result.append({QLatin1Char('{'), token.startCol + i, true});
+                    ++i;
+                } else if (pair == QLatin1String("-}")) {
+                    result.append({QLatin1Char('}'), token.startCol + i + 1, false});
+                    ++i;
+                }
+            }
+        }
+    }
+    return result;
+}
+
 static int grab(const QString &line, int begin,
                 const std::function<bool(const QChar&)> &test)
 {
@@ -634,10 +673,43 @@ Tokens HaskellTokenizer::tokenize(const QString &line, int startState)
     return result;
 }
 
+QStringList HaskellTokenizer::keywords()
+{
+    QStringList result(RESERVED_ID->cbegin(), RESERVED_ID->cend());
+    result.removeOne("_");
+    result.sort();
+    return result;
+}
+
 bool Token::isValid() const
 {
     return type != TokenType::Unknown;
 }
 
+bool Token::isKeyword(const char *keyword) const
+{
+    return type == TokenType::Keyword && text == QLatin1String(keyword);
+}
+
+bool Token::isSpecial(const char *characters) const
+{
+    return type == TokenType::Special && text.size() == 1
+           && QLatin1String(characters).contains(text.at(0));
+}
+
+QString Token::expression() const
+{
+    switch (type) {
+    case TokenType::Variable:
+    case TokenType::Constructor:
+        return text.toString();
+    case TokenType::Operator:
+    case TokenType::OperatorConstructor:
+        return '(' + text.toString() + ')';
+    default:
+        return {};
+    }
+}
+
 } // Internal
 } // Haskell
@@ -27,6 +27,7 @@
 
 #include <QChar>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 #include <memory>
@@ -57,6 +58,11 @@ enum class TokenType {
 class Token {
 public:
     bool isValid() const;
+    bool isKeyword(const char *keyword) const;
+    // Whether the token is one of the brackets or punctuation characters.
+    bool isSpecial(const char *characters) const;
+    // The identifier or operator as GHCi takes it, operators in parentheses. Empty for others.
+    QString expression() const;
 
     TokenType type = TokenType::Unknown;
     int startCol = -1;
@@ -66,6 +72,14 @@ public:
     std::shared_ptr<QString> source; // keep the string ref alive
 };
 
+class Delimiter
+{
+public:
+    QChar character; // the braces of {- and -} for comments
+    int column = -1;
+    bool opening = false;
+};
+
 class Tokens : public QVector<Token>
 {
 public:
@@ -78,6 +92,11 @@ public:
     Tokens(std::shared_ptr<QString> source);
 
     Token tokenAtColumn(int col) const;
+    // The tokens without whitespace and comments.
+    QVector<Token> code() const;
+    // The brackets of Special tokens and the braces of the {- and -} that nest comments.
+    // Brackets in strings, characters and comments are not delimiters.
+    QVector<Delimiter> delimiters() const;
 
     std::shared_ptr<QString> source;
     int state = int(State::None);
@@ -87,6 +106,7 @@ class HaskellTokenizer
 {
 public:
     static Tokens tokenize(const QString &line, int startState);
+    static QStringList keywords(); // sorted
 };
 
 } // Internal
@@ -0,0 +1,61 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "hovercache.h"
+
+#include <QHash>
+
+namespace Haskell {
+namespace Internal {
+
+bool HoverKey::operator==(const HoverKey &other) const
+{
+    return filePath == other.filePath && revision == other.revision && line == other.line
+           && column == other.column && length == other.length;
+}
+
+uint qHash(const HoverKey &key, uint seed)
+{
+    return qHash(key.filePath, seed) ^ qHash(key.revision, seed) ^ qHash(key.line << 10, seed)
+           ^ qHash(key.column, seed) ^ qHash(key.length << 20, seed);
+}
+
+HoverCache::HoverCache(int capacity)
+    : m_cache(capacity)
+{
+}
+
+const QString *HoverCache::find(const HoverKey &key)
+{
+    return m_cache.object(key);
+}
+
+void HoverCache::insert(const HoverKey &key, const QString &text)
+{
+    m_cache.insert(key, new QString(text));
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QCache>
+#include <QString>
+
+namespace Haskell {
+namespace Internal {
+
+class HoverKey
+{
+public:
+    bool operator==(const HoverKey &other) const;
+
+    QString filePath;
+    int revision = 0; // of the document
+    int line = 0;
+    int column = 0;
+    int length = 0; // of the token
+};
+
+uint qHash(const HoverKey &key, uint seed = 0);
+
+// Keeps the texts of the latest hovers and drops the least recently used ones. The keys contain
+// the document revision, so after an edit the texts of the document are not found anymore and
+// make room over time.
+class HoverCache
+{
+public:
+    explicit HoverCache(int capacity = 500);
+
+    // Returns nullptr if the text is not cached. The text becomes the most recently used one.
+    const QString *find(const HoverKey &key);
+    void insert(const HoverKey &key, const QString &text);
+    int size() const { return m_cache.size(); }
+
+private:
+    QCache<HoverKey, QString> m_cache;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,460 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "hpccoverage.h"
+
+#include "haskelltr.h"
+
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace Haskell {
+namespace Internal {
+
+namespace {
+
+// Reads the values that "show" writes for the HPC data types.
+class Reader
+{
+public:
+    explicit Reader(const QByteArray &data, int position = 0)
+        : m_data(data)
+        , m_position(position)
+    {}
+
+    int position() const { return m_position; }
+    void setPosition(int position) { m_position = position; }
+
+    bool atEnd()
+    {
+        skipSpace();
+        return m_position >= m_data.size();
+    }
+
+    bool accept(char c)
+    {
+        skipSpace();
+        if (m_position >= m_data.size() || m_data.at(m_position) != c)
+            return false;
+        ++m_position;
+        return true;
+    }
+
+    QByteArray readWord()
+    {
+        skipSpace();
+        const int start = m_position;
+        while (m_position < m_data.size() && isWordCharacter(m_data.at(m_position)))
+            ++m_position;
+        return m_data.mid(start, m_position - start);
+    }
+
+    bool readInt(qint64 *value)
+    {
+        skipSpace();
+        const int start = m_position;
+        qint64 result = 0;
+        while (m_position < m_data.size() && isDigit(m_data.at(m_position)))
+            result = 10 * result + (m_data.at(m_position++) - '0');
+        *value = result;
+        return m_position > start;
+    }
+
+    bool readInt(int *value)
+    {
+        qint64 result;
+        if (!readInt(&result))
+            return false;
+        *value = int(result);
+        return true;
+    }
+
+    bool readString(QString *value)
+    {
+        if (!accept('"'))
+            return false;
+        QByteArray utf8;
+        while (m_position < m_data.size()) {
+            const char c = m_data.at(m_position++);
+            if (c == '"') {
+                *value = QString::fromUtf8(utf8);
+                return true;
+            }
+            if (c != '\\') {
+                utf8.append(c);
+                continue;
+            }
+            if (m_position >= m_data.size())
+                return false;
+            // non-ASCII characters are escaped as decimal code points, "\&" separates them from
+            // following digits
+            const char escaped = m_data.at(m_position);
+            if (isDigit(escaped)) {
+                int codePoint;
+                readInt(&codePoint);
+                const uint ucs4 = uint(codePoint);
+                utf8.append(QString::fromUcs4(&ucs4, 1).toUtf8());
+                continue;
+            }
+            ++m_position;
+            switch (escaped) {
+            case '&':
+                break;
+            case 'n':
+                utf8.append('\n');
+                break;
+            case 't':
+                utf8.append('\t');
+                break;
+            default:
+                utf8.append(escaped);
+                break;
+            }
+        }
+        return false;
+    }
+
+    bool readPosition(HpcPosition *position)
+    {
+        return readInt(&position->startLine) && accept(':') && readInt(&position->startColumn)
+               && accept('-') && readInt(&position->endLine) && accept(':')
+               && readInt(&position->endColumn);
+    }
+
+    bool readStringList(QStringList *list)
+    {
+        if (!accept('['))
+            return false;
+        if (accept(']'))
+            return true;
+        do {
+            QString value;
+            if (!readString(&value))
+                return false;
+            list->append(value);
+        } while (accept(','));
+        return accept(']');
+    }
+
+private:
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static bool isWordCharacter(char c)
+    {
+        return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    void skipSpace()
+    {
+        while (m_position < m_data.size() && QChar::isSpace(uchar(m_data.at(m_position))))
+            ++m_position;
+    }
+
+    const QByteArray &m_data;
+    int m_position;
+};
+
+} // namespace
+
+bool HpcPosition::contains(const HpcPosition &other) const
+{
+    return std::make_tuple(startLine, startColumn)
+               <= std::make_tuple(other.startLine, other.startColumn)
+           && std::make_tuple(other.endLine, other.endColumn)
+                  <= std::make_tuple(endLine, endColumn);
+}
+
+bool HpcPosition::operator==(const HpcPosition &other) const
+{
+    return startLine == other.startLine && startColumn == other.startColumn
+           && endLine == other.endLine && endColumn == other.endColumn;
+}
+
+bool HpcPosition::operator<(const HpcPosition &other) const
+{
+    return std::make_tuple(startLine, startColumn, endLine, endColumn)
+           < std::make_tuple(other.startLine, other.startColumn, other.endLine, other.endColumn);
+}
+
+static bool readMixEntry(Reader &reader, MixModule::Entry *entry)
+{
+    // (12:5-12:20,ExpBox False), (3:1-9:30,TopLevelBox ["go"]), (7:8-7:12,BinBox CondBinBox True)
+    if (!reader.accept('(') || !reader.readPosition(&entry->position) || !reader.accept(','))
+        return false;
+    const QByteArray kind = reader.readWord();
+    QStringList names;
+    if (kind == "ExpBox") {
+        entry->kind = MixModule::Entry::Expression;
+        reader.readWord(); // whether it is an alternative
+    } else if (kind == "TopLevelBox") {
+        entry->kind = MixModule::Entry::TopLevel;
+        if (!reader.readStringList(&names))
+            return false;
+    } else if (kind == "LocalBox") {
+        entry->kind = MixModule::Entry::Local;
+        if (!reader.readStringList(&names))
+            return false;
+    } else if (kind == "BinBox") {
+        entry->kind = MixModule::Entry::Binary;
+        reader.readWord(); // guard, condition or qualifier
+        entry->value = reader.readWord() == "True";
+    } else {
+        return false;
+    }
+    return reader.accept(')');
+}
+
+bool parseMix(const QByteArray &data, MixModule *module, QString *errorString)
+{
+    // Mix "src/Foo.hs" 2024-05-01 10:20:30.123456789 UTC 1234567 8 [(...),(...)]
+    Reader reader(data);
+    if (reader.readWord() != "Mix" || !reader.readString(&module->sourceFile)) {
+        *errorString = Tr::tr("The file is not a .mix file.");
+        return false;
+    }
+    // the hash identifies the version of the module, the time stamp is not needed
+    const int timeStampEnd = data.indexOf(" UTC", reader.position());
+    int tabStop;
+    module->entries.clear();
+    if (timeStampEnd >= 0)
+        reader.setPosition(timeStampEnd + 4);
+    if (timeStampEnd < 0 || !reader.readInt(&module->hash) || !reader.readInt(&tabStop)
+            || !reader.accept('[')) {
+        *errorString = Tr::tr("The .mix file has no valid header.");
+        return false;
+    }
+    if (reader.accept(']'))
+        return true;
+    do {
+        MixModule::Entry entry;
+        if (!readMixEntry(reader, &entry)) {
+            *errorString = Tr::tr("The .mix file has an invalid entry at offset %1.")
+                               .arg(reader.position());
+            return false;
+        }
+        module->entries.append(entry);
+    } while (reader.accept(','));
+    if (!reader.accept(']')) {
+        *errorString = Tr::tr("The .mix file ends unexpectedly.");
+        return false;
+    }
+    return true;
+}
+
+bool TixParser::feed(const QByteArray &data)
+{
+    if (!m_errorString.isEmpty())
+        return false;
+    m_buffer.append(data);
+    return parseModules();
+}
+
+bool TixParser::finish()
+{
+    if (!m_errorString.isEmpty() || !parseModules())
+        return false;
+    if (!m_finished) {
+        m_errorString = Tr::tr("The .tix file ends unexpectedly.");
+        return false;
+    }
+    return true;
+}
+
+QVector<TixModule> TixParser::takeModules()
+{
+    QVector<TixModule> modules;
+    modules.swap(m_modules);
+    return modules;
+}
+
+bool TixParser::parseModules()
+{
+    // Tix [TixModule "Main" 1234567 3 [1,0,2],TixModule "pkg-0.1-inplace/Foo" 89 1 [0]]
+    Reader reader(m_buffer);
+    if (!m_started) {
+        if (m_buffer.indexOf('[') < 0)
+            return true;
+        if (reader.readWord() != "Tix" || !reader.accept('[')) {
+            m_errorString = Tr::tr("The file is not a .tix file.");
+            return false;
+        }
+        m_started = true;
+    }
+    int consumed = reader.position();
+    while (!m_finished && !reader.atEnd()) {
+        reader.accept(',');
+        if (reader.accept(']')) {
+            m_finished = true;
+            consumed = reader.position();
+            break;
+        }
+        // the end of the tick list is the first ']' of a module, wait until it is there
+        if (m_buffer.indexOf(']', reader.position()) < 0)
+            break;
+        TixModule module;
+        int count;
+        if (reader.readWord() != "TixModule" || !reader.readString(&module.name)
+                || !reader.readInt(&module.hash) || !reader.readInt(&count)
+                || !reader.accept('[')) {
+            m_errorString = Tr::tr("The .tix file has an invalid module.");
+            return false;
+        }
+        module.ticks.reserve(count);
+        if (!reader.accept(']')) {
+            do {
+                qint64 ticks;
+                if (!reader.readInt(&ticks))
+                    break;
+                module.ticks.append(ticks);
+            } while (reader.accept(','));
+            if (!reader.accept(']') || module.ticks.size() != count) {
+                m_errorString = Tr::tr("The .tix file has invalid ticks for module %1.")
+                                    .arg(module.name);
+                return false;
+            }
+        }
+        m_modules.append(module);
+        consumed = reader.position();
+    }
+    m_buffer.remove(0, consumed);
+    return true;
+}
+
+void mergeTixModules(QHash<QString, TixModule> &modules, const QVector<TixModule> &additional)
+{
+    for (const TixModule &module : additional) {
+        // the Main modules of different components share the name
+        const QString key = module.name + '#' + QString::number(module.hash);
+        const auto it = modules.find(key);
+        if (it == modules.end() || it->ticks.size() != module.ticks.size()) {
+            modules.insert(key, module);
+            continue;
+        }
+        for (int i = 0; i < module.ticks.size(); ++i)
+            it->ticks[i] += module.ticks.at(i);
+    }
+}
+
+bool CoverageRegion::operator==(const CoverageRegion &other) const
+{
+    return position == other.position && kind == other.kind;
+}
+
+int ModuleCoverage::percent() const
+{
+    return expressions > 0 ? 100 * coveredExpressions / expressions : 100;
+}
+
+bool ModuleCoverage::operator==(const ModuleCoverage &other) const
+{
+    return sourceFile == other.sourceFile && expressions == other.expressions
+           && coveredExpressions == other.coveredExpressions
+           && topLevelDefinitions == other.topLevelDefinitions
+           && coveredTopLevelDefinitions == other.coveredTopLevelDefinitions
+           && regions == other.regions;
+}
+
+bool ModuleCoverage::compute(const MixModule &module, const TixModule &ticks,
+                             ModuleCoverage *result)
+{
+    if (module.hash != ticks.hash || module.entries.size() != ticks.ticks.size())
+        return false;
+    class Condition
+    {
+    public:
+        bool hasTrue = false;
+        bool hasFalse = false;
+        bool wasTrue = false;
+        bool wasFalse = false;
+    };
+    std::map<HpcPosition, Condition> conditions;
+    ModuleCoverage coverage;
+    coverage.sourceFile = module.sourceFile;
+    QVector<CoverageRegion> notExecuted;
+    for (int i = 0; i < module.entries.size(); ++i) {
+        const MixModule::Entry &entry = module.entries.at(i);
+        const bool ticked = ticks.ticks.at(i) > 0;
+        switch (entry.kind) {
+        case MixModule::Entry::Expression:
+            ++coverage.expressions;
+            if (ticked)
+                ++coverage.coveredExpressions;
+            else
+                notExecuted.append({entry.position, CoverageRegion::NotExecuted});
+            break;
+        case MixModule::Entry::TopLevel:
+            ++coverage.topLevelDefinitions;
+            if (ticked)
+                ++coverage.coveredTopLevelDefinitions;
+            break;
+        case MixModule::Entry::Local:
+            break;
+        case MixModule::Entry::Binary: {
+            // each condition has a box for either outcome
+            Condition &condition = conditions[entry.position];
+            if (entry.value) {
+                condition.hasTrue = true;
+                condition.wasTrue = ticked;
+            } else {
+                condition.hasFalse = true;
+                condition.wasFalse = ticked;
+            }
+            break;
+        }
+        }
+    }
+
+    // only the outermost code that was not executed is interesting
+    std::sort(notExecuted.begin(), notExecuted.end(),
+              [](const CoverageRegion &a, const CoverageRegion &b) {
+                  return std::make_tuple(a.position.startLine, a.position.startColumn,
+                                         b.position.endLine, b.position.endColumn)
+                         < std::make_tuple(b.position.startLine, b.position.startColumn,
+                                           a.position.endLine, a.position.endColumn);
+              });
+    for (const CoverageRegion &region : std::as_const(notExecuted)) {
+        if (coverage.regions.isEmpty() || !coverage.regions.last().position.contains(
+                region.position)) {
+            coverage.regions.append(region);
+        }
+    }
+    for (const auto &[position, condition] : conditions) {
+        if (condition.hasTrue && condition.hasFalse && condition.wasTrue != condition.wasFalse) {
+            coverage.regions.append({position, condition.wasTrue ? CoverageRegion::AlwaysTrue
+                                                                 : CoverageRegion::AlwaysFalse});
+        }
+    }
+    std::stable_sort(coverage.regions.begin(), coverage.regions.end(),
+                     [](const CoverageRegion &a, const CoverageRegion &b) {
+                         return a.position < b.position;
+                     });
+    *result = coverage;
+    return true;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+// A source range as HPC writes it, "line:column-line:column", 1-based and inclusive.
+class HpcPosition
+{
+public:
+    int startLine = 0;
+    int startColumn = 0;
+    int endLine = 0;
+    int endColumn = 0;
+
+    bool contains(const HpcPosition &other) const;
+    bool operator==(const HpcPosition &other) const;
+    bool operator<(const HpcPosition &other) const;
+};
+
+// The tickable expressions of a module, read from its .mix file.
+class MixModule
+{
+public:
+    class Entry
+    {
+    public:
+        enum Kind { Expression, TopLevel, Local, Binary };
+
+        HpcPosition position;
+        Kind kind = Expression;
+        bool value = false; // the branch of a binary box
+    };
+
+    QString sourceFile; // relative to the package directory
+    qint64 hash = 0;
+    QVector<Entry> entries;
+};
+
+bool parseMix(const QByteArray &data, MixModule *module, QString *errorString);
+
+// The tick counts of a module, read from a .tix file.
+class TixModule
+{
+public:
+    QString name; // "package-id/Module" for library modules
+    qint64 hash = 0;
+    QVector<qint64> ticks;
+};
+
+// Reads .tix files in chunks. The tick lists of large test runs are long, only complete modules
+// are parsed.
+class TixParser
+{
+public:
+    bool feed(const QByteArray &data);
+    bool finish();
+
+    QVector<TixModule> takeModules();
+    QString errorString() const { return m_errorString; }
+
+private:
+    bool parseModules();
+
+    QByteArray m_buffer;
+    QVector<TixModule> m_modules;
+    QString m_errorString;
+    bool m_started = false;
+    bool m_finished = false;
+};
+
+// Adds the ticks of modules with the same name and hash, from several runs. The modules are
+// keyed by name and hash.
+void mergeTixModules(QHash<QString, TixModule> &modules, const QVector<TixModule> &additional);
+
+// Code that was not evaluated, or conditions that were always the same, like "hpc markup"
+// shows them.
+class CoverageRegion
+{
+public:
+    enum Kind { NotExecuted, AlwaysTrue, AlwaysFalse };
+
+    HpcPosition position;
+    Kind kind = NotExecuted;
+
+    bool operator==(const CoverageRegion &other) const;
+};
+
+class ModuleCoverage
+{
+public:
+    QString sourceFile;
+    int expressions = 0;
+    int coveredExpressions = 0;
+    int topLevelDefinitions = 0;
+    int coveredTopLevelDefinitions = 0;
+    QVector<CoverageRegion> regions; // ordered by position
+
+    // The percentage of evaluated expressions, which is what "hpc report" shows first.
+    int percent() const;
+    bool operator==(const ModuleCoverage &other) const;
+
+    // Returns false if the ticks do not belong to the module.
+    static bool compute(const MixModule &module, const TixModule &ticks, ModuleCoverage *result);
+};
+
+} // namespace Internal
+} // namespace Haskell
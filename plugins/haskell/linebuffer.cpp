@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "linebuffer.h"
+
+namespace Haskell {
+namespace Internal {
+
+void LineBuffer::addText(const QString &text, const LineHandler &handler)
+{
+    m_incompleteLine.append(text);
+    int start = 0;
+    int newline;
+    while ((newline = m_incompleteLine.indexOf('\n', start)) >= 0) {
+        int end = newline;
+        if (end > start && m_incompleteLine.at(end - 1) == '\r')
+            --end;
+        handler(m_incompleteLine.mid(start, end - start));
+        start = newline + 1;
+    }
+    m_incompleteLine.remove(0, start);
+    if (m_maximumLineLength <= 0)
+        return;
+    while (m_incompleteLine.size() > m_maximumLineLength) {
+        handler(m_incompleteLine.left(m_maximumLineLength));
+        m_incompleteLine.remove(0, m_maximumLineLength);
+    }
+}
+
+void LineBuffer::finish(const LineHandler &handler)
+{
+    if (m_incompleteLine.isEmpty())
+        return;
+    const QString line = m_incompleteLine;
+    m_incompleteLine.clear();
+    handler(line);
+}
+
+} // namespace Internal
+} // namespace Haskell
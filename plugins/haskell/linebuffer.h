@@ -0,0 +1,55 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+#include <functional>
+
+namespace Haskell {
+namespace Internal {
+
+// Splits text that arrives in pieces into lines, without the line endings.
+class LineBuffer
+{
+public:
+    using LineHandler = std::function<void(const QString &line)>;
+
+    // Lines without a newline that get longer than the maximum are broken up.
+    void setMaximumLineLength(int length) { m_maximumLineLength = length; }
+
+    void addText(const QString &text, const LineHandler &handler);
+    // Treats an incomplete last line as complete.
+    void finish(const LineHandler &handler);
+    bool hasIncompleteLine() const { return !m_incompleteLine.isEmpty(); }
+
+private:
+    QString m_incompleteLine;
+    int m_maximumLineLength = -1;
+};
+
+} // namespace Internal
+} // namespace Haskell
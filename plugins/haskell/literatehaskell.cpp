@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "literatehaskell.h"
+
+#include <QStringList>
+
+namespace Haskell {
+namespace Internal {
+
+bool LiterateHaskell::isLiterateFile(const QString &filePath)
+{
+    return filePath.endsWith(".lhs");
+}
+
+LiterateHaskell::LineType LiterateHaskell::lineType(const QString &line, bool inCodeBlock)
+{
+    if (inCodeBlock)
+        return line.startsWith("\\end{code}") ? LineType::CodeDelimiter : LineType::Code;
+    if (line.startsWith('>'))
+        return LineType::BirdTrack;
+    if (line.startsWith("\\begin{code}"))
+        return LineType::CodeDelimiter;
+    return LineType::Prose;
+}
+
+QString LiterateHaskell::code(const QString &line, LineType type)
+{
+    switch (type) {
+    case LineType::Prose:
+    case LineType::CodeDelimiter:
+        return {};
+    case LineType::BirdTrack:
+        return line.mid(codeColumn(line, type));
+    case LineType::Code:
+        return line;
+    }
+    return {};
+}
+
+int LiterateHaskell::codeColumn(const QString &line, LineType type)
+{
+    if (type != LineType::BirdTrack)
+        return 0;
+    return line.startsWith("> ") ? 2 : 1;
+}
+
+QString LiterateHaskell::unlit(const QString &source, QVector<int> *codeColumns)
+{
+    QStringList lines = source.split('\n');
+    bool inCodeBlock = false;
+    for (QString &line : lines) {
+        const LineType type = lineType(line, inCodeBlock);
+        if (type == LineType::CodeDelimiter)
+            inCodeBlock = !inCodeBlock;
+        if (codeColumns)
+            codeColumns->append(codeColumn(line, type));
+        line = code(line, type);
+    }
+    return lines.join('\n');
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,60 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+// Literate Haskell has code in the lines that start with a bird track, a > in the first column,
+// and in the lines between \begin{code} and \end{code}. All other lines are prose. The code of a
+// literate document keeps the lines of the document. The code of a bird track line starts after
+// the > and the space that usually follows it, so top-level declarations start in the first
+// column in both styles.
+class LiterateHaskell
+{
+public:
+    enum class LineType { Prose, BirdTrack, CodeDelimiter, Code };
+
+    static bool isLiterateFile(const QString &filePath);
+
+    // Returns the type of the line, which is in a \begin{code} block if inCodeBlock.
+    // A CodeDelimiter line starts a code block if not inCodeBlock, and ends it otherwise.
+    static LineType lineType(const QString &line, bool inCodeBlock);
+    // Returns the code in the line: a blank line for prose and delimiters, and the line after
+    // the bird track for bird track lines.
+    static QString code(const QString &line, LineType type);
+    // Returns the column of the line at which its code starts.
+    static int codeColumn(const QString &line, LineType type);
+    // Returns the code in the lines of the source, and the column at which the code of each line
+    // starts if codeColumns is given.
+    static QString unlit(const QString &source, QVector<int> *codeColumns = nullptr);
+};
+
+} // namespace Internal
+} // namespace Haskell
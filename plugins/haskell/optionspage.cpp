@@ -28,9 +28,8 @@
 #include "haskellconstants.h"
 #include "haskellmanager.h"
 
+#include <QFormLayout>
 #include <QGroupBox>
-#include <QHBoxLayout>
-#include <QLabel>
 #include <QVBoxLayout>
 #include <QWidget>
 
@@ -56,15 +55,22 @@ QWidget *OptionsPage::widget()
         auto generalBox = new QGroupBox(tr("General"));
         topLayout->addWidget(generalBox);
         topLayout->addStretch(10);
-        auto boxLayout = new QHBoxLayout;
+        auto boxLayout = new QFormLayout;
         generalBox->setLayout(boxLayout);
-        boxLayout->addWidget(new QLabel(tr("Stack executable:")));
         m_stackPath = new PathChooser();
         m_stackPath->setExpectedKind(PathChooser::ExistingCommand);
         m_stackPath->setPromptDialogTitle(tr("Choose Stack Executable"));
         m_stackPath->setFilePath(HaskellManager::stackExecutable());
         m_stackPath->setCommandVersionArguments({"--version"});
-        boxLayout->addWidget(m_stackPath);
+        boxLayout->addRow(tr("Stack executable:"), m_stackPath);
+        m_hlsPath = new PathChooser();
+        m_hlsPath->setExpectedKind(PathChooser::ExistingCommand);
+        m_hlsPath->setPromptDialogTitle(tr("Choose Haskell Language Server Executable"));
+        m_hlsPath->setFilePath(HaskellManager::hlsExecutable());
+        m_hlsPath->setCommandVersionArguments({"--version"});
+        m_hlsPath->setToolTip(tr("Provides diagnostics, types on hover and the definitions of "
+                                 "symbols. Leave empty to not use a language server."));
+        boxLayout->addRow(tr("Haskell language server:"), m_hlsPath);
     }
     return m_widget;
 }
@@ -74,6 +80,7 @@ void OptionsPage::apply()
     if (!m_widget)
         return;
     HaskellManager::setStackExecutable(m_stackPath->rawFilePath());
+    HaskellManager::setHlsExecutable(m_hlsPath->rawFilePath());
 }
 
 void OptionsPage::finish()
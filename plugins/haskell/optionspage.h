@@ -47,6 +47,7 @@ public:
 private:
     QPointer<QWidget> m_widget;
     QPointer<Utils::PathChooser> m_stackPath;
+    QPointer<Utils::PathChooser> m_hlsPath;
 };
 
 } // namespace Internal
@@ -0,0 +1,274 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "outputlog.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+// lines without a newline are broken up, to keep the memory bounded
+static const int maximumLineLength = 64 * 1024;
+// beyond this, most searches read the block anyway
+static const int maximumBlockTrigrams = 1024;
+
+// each line of the spill file starts with its channel
+static const char stdOutMarker = 'O';
+static const char stdErrMarker = 'E';
+
+static QChar foldCase(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= 'A' && u <= 'Z')
+        return QChar(u + ('a' - 'A'));
+    return u < 128 ? c : c.toLower();
+}
+
+static int trigramHash(QChar a, QChar b, QChar c)
+{
+    const uint hash = (a.unicode() * 0x9E3779B1u) ^ (b.unicode() * 0x85EBCA77u)
+                      ^ (c.unicode() * 0xC2B2AE3Du);
+    return int(hash >> 20);
+}
+
+static qint64 memoryUsage(const OutputLog::Line &line)
+{
+    return qint64(sizeof(OutputLog::Line)) + 2 * line.text.size();
+}
+
+OutputLog::OutputLog(int memoryLimit)
+    : m_memoryLimit(memoryLimit)
+{
+    for (LineBuffer &lines : m_lines)
+        lines.setMaximumLineLength(maximumLineLength);
+}
+
+OutputLog::~OutputLog()
+{
+    if (m_spillFile.isOpen()) {
+        m_spillFile.close();
+        m_spillFile.remove();
+    }
+}
+
+bool OutputLog::openSpillFile(const QString &filePath)
+{
+    m_spillFile.close();
+    m_spillFile.setFileName(filePath);
+    m_blocks.clear();
+    m_blockTrigramCount = 0;
+    m_spillSize = 0;
+    return m_spillFile.open(QIODevice::ReadWrite | QIODevice::Truncate);
+}
+
+void OutputLog::addOutput(const QString &text, Channel channel)
+{
+    m_lines[int(channel)].addText(text, [this, channel](const QString &line) {
+        addLine(line, channel);
+    });
+}
+
+void OutputLog::finish()
+{
+    m_lines[int(Channel::StdOut)].finish([this](const QString &line) {
+        addLine(line, Channel::StdOut);
+    });
+    m_lines[int(Channel::StdErr)].finish([this](const QString &line) {
+        addLine(line, Channel::StdErr);
+    });
+    m_spillFile.flush();
+}
+
+QVector<OutputLog::Line> OutputLog::takeNewLines()
+{
+    const int count = int(std::min(m_newLines, qint64(m_recentLines.size())));
+    m_newLines = 0;
+    return QVector<Line>(m_recentLines.end() - count, m_recentLines.end());
+}
+
+QVector<OutputLog::Block> OutputLog::blocks()
+{
+    m_spillFile.flush();
+    return m_blocks;
+}
+
+void OutputLog::addLine(const QString &text, Channel channel)
+{
+    if (m_spillFile.isOpen()) {
+        if (m_blocks.isEmpty() || m_blocks.last().lineCount >= m_blockSize
+            || m_blockTrigramCount >= maximumBlockTrigrams) {
+            if (m_blocks.size() >= m_maximumBlockCount)
+                mergeBlocks();
+            m_blocks.append({m_spillSize, m_lineCount, 0, {}});
+            m_blockTrigramCount = 0;
+        }
+        Block &block = m_blocks.last();
+        ++block.lineCount;
+        for (int i = 2; i < text.size(); ++i) {
+            const int trigram = trigramHash(foldCase(text.at(i - 2)),
+                                            foldCase(text.at(i - 1)),
+                                            foldCase(text.at(i)));
+            if (!block.trigrams.test(trigram)) {
+                block.trigrams.set(trigram);
+                ++m_blockTrigramCount;
+            }
+        }
+        QByteArray utf8(1, channel == Channel::StdErr ? stdErrMarker : stdOutMarker);
+        utf8.append(text.toUtf8());
+        utf8.append('\n');
+        m_spillFile.write(utf8);
+        m_spillSize += utf8.size();
+    }
+
+    m_recentLines.push_back({m_lineCount, channel, text});
+    m_recentSize += memoryUsage(m_recentLines.back());
+    ++m_lineCount;
+    ++m_newLines;
+    while (m_recentSize > m_memoryLimit && m_recentLines.size() > 1) {
+        m_recentSize -= memoryUsage(m_recentLines.front());
+        m_recentLines.pop_front();
+    }
+}
+
+// Halves the index, the merged blocks are read by more searches.
+void OutputLog::mergeBlocks()
+{
+    int count = 0;
+    for (int i = 0; i < m_blocks.size(); i += 2) {
+        Block block = m_blocks.at(i);
+        if (i + 1 < m_blocks.size()) {
+            block.lineCount += m_blocks.at(i + 1).lineCount;
+            block.trigrams |= m_blocks.at(i + 1).trigrams;
+        }
+        m_blocks[count++] = block;
+    }
+    m_blocks.resize(count);
+}
+
+int OutputLog::search(const QString &spillFilePath,
+                      const QVector<Block> &blocks,
+                      const QRegularExpression &pattern,
+                      const std::function<bool(const Line &)> &callback)
+{
+    QFile file(spillFilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+    QVector<int> requiredTrigrams;
+    const QString literal = requiredLiteral(pattern.pattern());
+    for (int i = 2; i < literal.size(); ++i) {
+        requiredTrigrams.append(trigramHash(foldCase(literal.at(i - 2)),
+                                            foldCase(literal.at(i - 1)),
+                                            foldCase(literal.at(i))));
+    }
+    int readBlocks = 0;
+    for (const Block &block : blocks) {
+        const bool canMatch = std::all_of(requiredTrigrams.cbegin(), requiredTrigrams.cend(),
+                                          [&block](int trigram) {
+                                              return block.trigrams.test(trigram);
+                                          });
+        if (!canMatch)
+            continue;
+        ++readBlocks;
+        if (!file.seek(block.offset))
+            break;
+        for (int i = 0; i < block.lineCount; ++i) {
+            QByteArray bytes = file.readLine();
+            if (bytes.isEmpty())
+                return readBlocks;
+            if (bytes.endsWith('\n'))
+                bytes.chop(1);
+            const Channel channel = bytes.startsWith(stdErrMarker) ? Channel::StdErr
+                                                                   : Channel::StdOut;
+            Line line{block.firstLine + i, channel, QString::fromUtf8(bytes.mid(1))};
+            if (pattern.match(line.text).hasMatch() && !callback(line))
+                return readBlocks;
+        }
+    }
+    return readBlocks;
+}
+
+QString OutputLog::requiredLiteral(const QString &pattern)
+{
+    // alternatives can match without any of the text
+    if (pattern.contains('|'))
+        return {};
+    QString best;
+    QString current;
+    int depth = 0;
+    const auto finishRun = [&] {
+        if (depth == 0 && current.size() > best.size())
+            best = current;
+        current.clear();
+    };
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+        if (c == '\\' && i + 1 < pattern.size()) {
+            // escaped letters and digits are classes, assertions or references
+            const QChar escaped = pattern.at(++i);
+            if (escaped.isLetterOrNumber())
+                finishRun();
+            else
+                current += escaped;
+        } else if (c == '[') {
+            finishRun();
+            ++i;
+            if (i < pattern.size() && pattern.at(i) == '^')
+                ++i;
+            if (i < pattern.size() && pattern.at(i) == ']')
+                ++i;
+            for (; i < pattern.size() && pattern.at(i) != ']'; ++i) {
+                if (pattern.at(i) == '\\')
+                    ++i;
+            }
+        } else if (c == '?' || c == '*' || c == '{') {
+            // the character before is optional
+            current.chop(1);
+            finishRun();
+            if (c == '{') {
+                while (i + 1 < pattern.size() && pattern.at(i) != '}')
+                    ++i;
+            }
+        } else if (c == '(') {
+            finishRun();
+            ++depth;
+        } else if (c == ')') {
+            // groups can be optional, their contents do not count
+            current.clear();
+            depth = std::max(0, depth - 1);
+        } else if (c == '.' || c == '^' || c == '$' || c == '+') {
+            finishRun();
+        } else {
+            current += c;
+        }
+    }
+    finishRun();
+    return best;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "linebuffer.h"
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <bitset>
+#include <deque>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QRegularExpression;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+// Keeps the output of long-running programs with bounded memory.
+// Only the most recent lines stay in memory, all lines are written to a spill file. The spill
+// file is indexed in blocks of lines, each with the set of trigrams that occur in it, so that
+// searches can skip the blocks that cannot match. A block ends early when its set fills up,
+// and neighbouring blocks are merged when there are too many of them.
+class OutputLog
+{
+public:
+    enum class Channel { StdOut, StdErr };
+
+    class Line
+    {
+    public:
+        qint64 number = 0;
+        Channel channel = Channel::StdOut;
+        QString text;
+    };
+
+    class Block
+    {
+    public:
+        qint64 offset = 0;
+        qint64 firstLine = 0;
+        int lineCount = 0;
+        std::bitset<4096> trigrams; // hashed, case insensitive
+    };
+
+    explicit OutputLog(int memoryLimit = 8 * 1024 * 1024);
+    ~OutputLog();
+
+    bool openSpillFile(const QString &filePath);
+    QString spillFilePath() const { return m_spillFile.fileName(); }
+    void setBlockSize(int lines) { m_blockSize = lines; }
+    void setMaximumBlockCount(int count) { m_maximumBlockCount = count; }
+
+    void addOutput(const QString &text, Channel channel);
+    // Treats incomplete last lines as complete.
+    void finish();
+
+    qint64 lineCount() const { return m_lineCount; }
+    const std::deque<Line> &recentLines() const { return m_recentLines; }
+    // Returns the lines added since the last call, as far as they are still in memory.
+    QVector<Line> takeNewLines();
+    // Flushes the spill file, the blocks cover all lines written so far.
+    QVector<Block> blocks();
+
+    // Calls the callback for the lines of the spill file that match, until it returns false.
+    // Returns the number of blocks that were read.
+    static int search(const QString &spillFilePath,
+                      const QVector<Block> &blocks,
+                      const QRegularExpression &pattern,
+                      const std::function<bool(const Line &)> &callback);
+    // Returns the longest text that every match of the pattern contains, if it is easy to tell.
+    static QString requiredLiteral(const QString &pattern);
+
+private:
+    void addLine(const QString &text, Channel channel);
+    void mergeBlocks();
+
+    QFile m_spillFile;
+    QVector<Block> m_blocks;
+    std::deque<Line> m_recentLines;
+    LineBuffer m_lines[2];
+    qint64 m_recentSize = 0;
+    qint64 m_lineCount = 0;
+    qint64 m_spillSize = 0;
+    qint64 m_newLines = 0;
+    int m_memoryLimit;
+    int m_blockSize = 1024;
+    int m_maximumBlockCount = 4096;
+    int m_blockTrigramCount = 0;
+};
+
+} // namespace Internal
+} // namespace Haskell
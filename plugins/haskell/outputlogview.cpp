@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "outputlogview.h"
+
+#include <utils/runextensions.h>
+
+#include <QCheckBox>
+#include <QDir>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QTextCursor>
+#include <QVBoxLayout>
+
+#include <climits>
+
+namespace Haskell {
+namespace Internal {
+
+// the view is updated in batches, which keeps the load flat for programs with lots of output
+static const int updateInterval = 100;
+static const int maximumLines = 20000;
+static const int maximumMatches = 10000;
+
+static void searchLog(QFutureInterface<OutputLog::Line> &futureInterface,
+                      const QString &spillFilePath,
+                      const QVector<OutputLog::Block> &blocks,
+                      const QRegularExpression &pattern)
+{
+    int matches = 0;
+    OutputLog::search(spillFilePath, blocks, pattern, [&](const OutputLog::Line &line) {
+        futureInterface.reportResult(line);
+        return ++matches < maximumMatches && !futureInterface.isCanceled();
+    });
+}
+
+OutputLogView::OutputLogView(const std::shared_ptr<OutputLog> &log)
+    : m_log(log)
+    , m_filterLineEdit(new QLineEdit)
+    , m_caseSensitiveCheckBox(new QCheckBox(tr("Case sensitive")))
+    , m_statusLabel(new QLabel)
+    , m_output(new QPlainTextEdit)
+{
+    m_filterLineEdit->setPlaceholderText(tr("Filter (regular expression)"));
+    m_filterLineEdit->setClearButtonEnabled(true);
+    m_output->setReadOnly(true);
+    m_output->setUndoRedoEnabled(false);
+    m_output->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_output->setMaximumBlockCount(maximumLines);
+    m_output->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto toolBar = new QHBoxLayout;
+    toolBar->addWidget(m_filterLineEdit, 1);
+    toolBar->addWidget(m_caseSensitiveCheckBox);
+    toolBar->addWidget(m_statusLabel);
+
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(toolBar);
+    layout->addWidget(m_output);
+
+    connect(m_filterLineEdit, &QLineEdit::editingFinished, this, &OutputLogView::applyFilter);
+    connect(m_caseSensitiveCheckBox, &QCheckBox::toggled, this, &OutputLogView::applyFilter);
+    connect(&m_search, &QFutureWatcherBase::resultsReadyAt, this, [this](int begin, int end) {
+        QVector<OutputLog::Line> lines;
+        for (int i = begin; i < end; ++i)
+            lines.append(m_search.resultAt(i));
+        m_matches += lines.size();
+        appendLines(lines);
+        updateStatus();
+    });
+    connect(&m_search, &QFutureWatcherBase::finished, this, &OutputLogView::updateStatus);
+    connect(&m_updateTimer, &QTimer::timeout, this, &OutputLogView::updateOutput);
+    m_updateTimer.start(updateInterval);
+    applyFilter();
+}
+
+OutputLogView::~OutputLogView()
+{
+    m_search.cancel();
+    m_search.waitForFinished();
+}
+
+void OutputLogView::updateOutput()
+{
+    const QVector<OutputLog::Line> lines = m_log->takeNewLines();
+    if (lines.isEmpty())
+        return;
+    if (m_filter.pattern().isEmpty()) {
+        appendLines(lines);
+    } else {
+        // lines up to the end of the search come from the search
+        QVector<OutputLog::Line> matches;
+        for (const OutputLog::Line &line : lines) {
+            if (line.number >= m_searchEnd && m_filter.match(line.text).hasMatch())
+                matches.append(line);
+        }
+        m_matches += matches.size();
+        appendLines(matches);
+    }
+    updateStatus();
+}
+
+void OutputLogView::applyFilter()
+{
+    const QRegularExpression filter(m_filterLineEdit->text(),
+                                    m_caseSensitiveCheckBox->isChecked()
+                                        ? QRegularExpression::NoPatternOption
+                                        : QRegularExpression::CaseInsensitiveOption);
+    if (!filter.isValid()) {
+        m_statusLabel->setText(tr("Invalid pattern: %1").arg(filter.errorString()));
+        return;
+    }
+    m_search.cancel();
+    m_search.waitForFinished();
+    m_filter = filter;
+    m_output->clear();
+    m_matches = 0;
+    m_log->takeNewLines();
+    if (m_filter.pattern().isEmpty()) {
+        const std::deque<OutputLog::Line> &recentLines = m_log->recentLines();
+        const auto first = recentLines.size() > size_t(maximumLines)
+                               ? recentLines.end() - maximumLines
+                               : recentLines.begin();
+        appendLines(QVector<OutputLog::Line>(first, recentLines.end()));
+    } else {
+        // lines that are added while searching are filtered as they come
+        m_searchEnd = m_log->lineCount();
+        m_search.setFuture(Utils::runAsync(searchLog, m_log->spillFilePath(), m_log->blocks(),
+                                           m_filter));
+    }
+    updateStatus();
+}
+
+void OutputLogView::appendLines(const QVector<OutputLog::Line> &lines)
+{
+    if (lines.isEmpty())
+        return;
+    QScrollBar *scrollBar = m_output->verticalScrollBar();
+    const bool atEnd = scrollBar->value() == scrollBar->maximum();
+    // older lines would be dropped right away
+    const int first = std::max(0, lines.size() - maximumLines);
+    QTextCharFormat normalFormat;
+    QTextCharFormat errorFormat;
+    errorFormat.setForeground(QColor(200, 40, 40));
+    QTextCursor cursor(m_output->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    QString text;
+    OutputLog::Channel channel = lines.at(first).channel;
+    const bool filtered = !m_filter.pattern().isEmpty();
+    for (int i = first; i < lines.size(); ++i) {
+        const OutputLog::Line &line = lines.at(i);
+        if (line.channel != channel) {
+            cursor.insertText(text, channel == OutputLog::Channel::StdErr ? errorFormat
+                                                                          : normalFormat);
+            text.clear();
+            channel = line.channel;
+        }
+        if (!m_output->document()->isEmpty() || !text.isEmpty())
+            text += '\n';
+        if (filtered)
+            text += tr("%1: ").arg(line.number + 1);
+        text += line.text;
+    }
+    cursor.insertText(text, channel == OutputLog::Channel::StdErr ? errorFormat : normalFormat);
+    cursor.endEditBlock();
+    if (atEnd)
+        scrollBar->setValue(scrollBar->maximum());
+}
+
+void OutputLogView::updateStatus()
+{
+    QString status;
+    if (m_filter.pattern().isEmpty()) {
+        const qint64 lines = m_log->lineCount();
+        status = tr("%n line(s)", nullptr, int(std::min<qint64>(lines, INT_MAX)));
+    } else {
+        status = tr("%n match(es)", nullptr, m_matches);
+        if (m_search.isRunning())
+            status += tr(", searching...");
+        else if (m_matches >= maximumMatches)
+            status += tr(", showing the first ones");
+    }
+    m_statusLabel->setText(status);
+    m_statusLabel->setToolTip(tr("The whole output is in %1.")
+                                  .arg(QDir::toNativeSeparators(m_log->spillFilePath())));
+}
+
+} // namespace Internal
+} // namespace Haskell
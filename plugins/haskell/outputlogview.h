@@ -0,0 +1,76 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "outputlog.h"
+
+#include <QFutureWatcher>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QWidget>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+// Follows an output log that is being written, or shows the lines of the whole log that
+// match a filter.
+class OutputLogView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit OutputLogView(const std::shared_ptr<OutputLog> &log);
+    ~OutputLogView() override;
+
+private:
+    void updateOutput();
+    void applyFilter();
+    void appendLines(const QVector<OutputLog::Line> &lines);
+    void updateStatus();
+
+    std::shared_ptr<OutputLog> m_log;
+    QLineEdit *m_filterLineEdit;
+    QCheckBox *m_caseSensitiveCheckBox;
+    QLabel *m_statusLabel;
+    QPlainTextEdit *m_output;
+    QTimer m_updateTimer;
+    QRegularExpression m_filter;
+    QFutureWatcher<OutputLog::Line> m_search;
+    qint64 m_searchEnd = 0; // the first line that is not covered by the search
+    int m_matches = 0;
+};
+
+} // namespace Internal
+} // namespace Haskell
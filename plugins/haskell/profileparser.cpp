@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "profileparser.h"
+
+#include "haskelltr.h"
+
+#include <QIODevice>
+#include <QRegularExpression>
+#include <QVector>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+static QString readLine(QIODevice *device)
+{
+    QString line = QString::fromUtf8(device->readLine());
+    while (line.endsWith('\n') || line.endsWith('\r'))
+        line.chop(1);
+    return line;
+}
+
+static int indentation(const QString &line)
+{
+    int indent = 0;
+    while (indent < line.size() && line.at(indent) == ' ')
+        ++indent;
+    return indent;
+}
+
+static QString unquoted(const QString &text)
+{
+    const QString trimmed = text.trimmed();
+    if (trimmed.size() >= 2 && trimmed.startsWith('"') && trimmed.endsWith('"'))
+        return trimmed.mid(1, trimmed.size() - 2);
+    return trimmed;
+}
+
+bool parseTimeProfile(QIODevice *device, TimeProfile *profile, QString *errorString)
+{
+    // total time  =        0.12 secs   (120 ticks @ 1000 us, 1 processor)
+    static const QRegularExpression totalTime(
+        R"(^\s*total time\s*=\s*([\d.]+) secs\s*\((\d+) ticks)");
+    // total alloc = 123,456,789 bytes  (excludes profiling overheads)
+    static const QRegularExpression totalAlloc(R"(^\s*total alloc\s*=\s*([\d,]+) bytes)");
+
+    *profile = {};
+    bool expectCommand = false;
+    bool inTree = false;
+    bool hasSource = false;
+    int numberColumns = 0; // "no." and the columns after it
+    int lineNumber = 0;
+    // the path from the root to the last cost centre, with the indentation of each
+    QList<QPair<CostCentre *, int>> path{{&profile->root, -1}};
+    while (!device->atEnd()) {
+        const QString line = readLine(device);
+        ++lineNumber;
+        if (line.trimmed().isEmpty())
+            continue;
+        const QStringList tokens = line.split(' ', Qt::SkipEmptyParts);
+        if (!inTree) {
+            if (expectCommand) {
+                profile->command = line.trimmed();
+                expectCommand = false;
+            } else if (line.contains("Profiling Report")) {
+                expectCommand = true;
+            } else if (const QRegularExpressionMatch timeMatch = totalTime.match(line);
+                       timeMatch.hasMatch()) {
+                profile->totalTime = timeMatch.captured(1).toDouble();
+                profile->totalTicks = timeMatch.captured(2).toLongLong();
+            } else if (const QRegularExpressionMatch allocMatch = totalAlloc.match(line);
+                       allocMatch.hasMatch()) {
+                profile->totalAlloc = allocMatch.captured(1).remove(',').toLongLong();
+            } else if (line.startsWith("COST CENTRE") && tokens.contains("no.")) {
+                // the flat list at the top has the same header, but without "no."
+                inTree = true;
+                hasSource = tokens.contains("SRC");
+                numberColumns = tokens.size() - tokens.indexOf("no.");
+            }
+            continue;
+        }
+
+        const int first = tokens.size() - numberColumns;
+        if (numberColumns < 6 || first < 2) {
+            *errorString = Tr::tr("Unexpected cost centre in line %1.").arg(lineNumber);
+            return false;
+        }
+        CostCentre costCentre;
+        costCentre.name = tokens.at(0);
+        costCentre.module = tokens.at(1);
+        if (hasSource)
+            costCentre.source = tokens.mid(2, first - 2).join(' ');
+        bool ok = true;
+        const auto number = [&tokens, &ok, first](int column) {
+            bool columnOk = false;
+            const double value = tokens.at(first + column).toDouble(&columnOk);
+            ok = ok && columnOk;
+            return value;
+        };
+        costCentre.number = int(number(0));
+        costCentre.entries = qint64(number(1));
+        costCentre.individualTime = number(2);
+        costCentre.individualAlloc = number(3);
+        costCentre.inheritedTime = number(4);
+        costCentre.inheritedAlloc = number(5);
+        if (numberColumns >= 8) {
+            costCentre.ticks = qint64(number(6));
+            costCentre.bytes = qint64(number(7));
+        }
+        if (!ok) {
+            *errorString = Tr::tr("Unexpected cost centre in line %1.").arg(lineNumber);
+            return false;
+        }
+
+        // children are indented by one more space than their parent
+        const int indent = indentation(line);
+        while (path.last().second >= indent)
+            path.removeLast();
+        std::vector<CostCentre> &siblings = path.last().first->children;
+        siblings.push_back(std::move(costCentre));
+        path.append({&siblings.back(), indent});
+    }
+    if (!inTree) {
+        *errorString = Tr::tr("The file does not contain a cost centre tree.");
+        return false;
+    }
+    return true;
+}
+
+QList<int> HeapProfile::bandsByPeak() const
+{
+    QVector<qint64> peaks(bands.size(), 0);
+    for (const HeapSample &sample : samples) {
+        for (auto it = sample.values.cbegin(); it != sample.values.cend(); ++it)
+            peaks[it.key()] = std::max(peaks.at(it.key()), it.value());
+    }
+    QList<int> result;
+    for (int i = 0; i < bands.size(); ++i)
+        result.append(i);
+    std::stable_sort(result.begin(), result.end(), [&peaks](int a, int b) {
+        return peaks.at(a) > peaks.at(b);
+    });
+    return result;
+}
+
+bool parseHeapProfile(QIODevice *device, HeapProfile *profile, QString *errorString)
+{
+    static const QRegularExpression whitespace(R"(\s)");
+    *profile = {};
+    QHash<QString, int> bandIndexes;
+    bool inSample = false;
+    int lineNumber = 0;
+    while (!device->atEnd()) {
+        const QString line = readLine(device);
+        ++lineNumber;
+        if (line.trimmed().isEmpty())
+            continue;
+        if (lineNumber == 1 && !line.startsWith("JOB ")) {
+            *errorString = Tr::tr("The file is not a heap profile.");
+            return false;
+        }
+        if (line.startsWith("JOB ")) {
+            profile->job = unquoted(line.mid(4));
+        } else if (line.startsWith("DATE ")) {
+            profile->date = unquoted(line.mid(5));
+        } else if (line.startsWith("SAMPLE_UNIT ")) {
+            profile->sampleUnit = unquoted(line.mid(12));
+        } else if (line.startsWith("VALUE_UNIT ")) {
+            profile->valueUnit = unquoted(line.mid(11));
+        } else if (line.startsWith("MARK ")) {
+            profile->marks.append(line.mid(5).toDouble());
+        } else if (line.startsWith("BEGIN_SAMPLE ")) {
+            profile->samples.append({line.mid(13).toDouble(), {}});
+            inSample = true;
+        } else if (line.startsWith("END_SAMPLE ")) {
+            inSample = false;
+        } else if (inSample) {
+            // the band name can contain spaces, the value is separated by a tab
+            const int separator = line.lastIndexOf(whitespace);
+            bool ok = false;
+            const qint64 value = separator > 0 ? line.mid(separator + 1).toLongLong(&ok) : 0;
+            if (!ok) {
+                *errorString = Tr::tr("Unexpected sample value in line %1.").arg(lineNumber);
+                return false;
+            }
+            const QString band = line.left(separator).trimmed();
+            auto it = bandIndexes.find(band);
+            if (it == bandIndexes.end()) {
+                it = bandIndexes.insert(band, profile->bands.size());
+                profile->bands.append(band);
+            }
+            profile->samples.last().values[it.value()] += value;
+        }
+    }
+    if (profile->job.isEmpty()) {
+        *errorString = Tr::tr("The file is not a heap profile.");
+        return false;
+    }
+    return true;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+// A node of the cost-centre tree from a GHC time and allocation profile (.prof).
+// Percentages are relative to the whole program.
+class CostCentre
+{
+public:
+    QString name;
+    QString module;
+    QString source; // empty for profiles from GHC < 8
+    int number = 0;
+    qint64 entries = 0;
+    double individualTime = 0;
+    double individualAlloc = 0;
+    double inheritedTime = 0;
+    double inheritedAlloc = 0;
+    qint64 ticks = -1; // only with +RTS -P
+    qint64 bytes = -1; // only with +RTS -P
+    std::vector<CostCentre> children;
+};
+
+class TimeProfile
+{
+public:
+    QString command;
+    double totalTime = 0; // seconds
+    qint64 totalTicks = 0;
+    qint64 totalAlloc = 0; // bytes
+    CostCentre root; // unnamed, usually with MAIN as only child
+};
+
+class HeapSample
+{
+public:
+    double time = 0;
+    QHash<int, qint64> values; // band index -> value
+};
+
+// A heap profile (.hp) as written by +RTS -h.
+class HeapProfile
+{
+public:
+    QString job;
+    QString date;
+    QString sampleUnit;
+    QString valueUnit;
+    QStringList bands;
+    QList<HeapSample> samples;
+    QList<double> marks;
+
+    // Returns the band indexes ordered by their peak value, largest first.
+    QList<int> bandsByPeak() const;
+};
+
+// Both read the device line by line. They return false and set errorString for input that
+// is not a profile.
+bool parseTimeProfile(QIODevice *device, TimeProfile *profile, QString *errorString);
+bool parseHeapProfile(QIODevice *device, HeapProfile *profile, QString *errorString);
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,274 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "profileview.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+
+#include <utils/link.h>
+
+#include <QHeaderView>
+#include <QHelpEvent>
+#include <QLocale>
+#include <QPainter>
+#include <QPainterPath>
+#include <QRegularExpression>
+#include <QToolTip>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+enum CostCentreColumn {
+    NameColumn,
+    ModuleColumn,
+    EntriesColumn,
+    IndividualTimeColumn,
+    IndividualAllocColumn,
+    InheritedTimeColumn,
+    InheritedAllocColumn,
+    SourceColumn
+};
+
+static const int maximumBands = 8;
+
+static void addCostCentres(QTreeWidgetItem *parent, const CostCentre &costCentre)
+{
+    for (const CostCentre &child : costCentre.children) {
+        auto item = new QTreeWidgetItem(parent);
+        item->setText(NameColumn, child.name);
+        item->setText(ModuleColumn, child.module);
+        // numbers as data, so sorting is numeric
+        item->setData(EntriesColumn, Qt::DisplayRole, child.entries);
+        item->setData(IndividualTimeColumn, Qt::DisplayRole, child.individualTime);
+        item->setData(IndividualAllocColumn, Qt::DisplayRole, child.individualAlloc);
+        item->setData(InheritedTimeColumn, Qt::DisplayRole, child.inheritedTime);
+        item->setData(InheritedAllocColumn, Qt::DisplayRole, child.inheritedAlloc);
+        item->setText(SourceColumn, child.source);
+        for (int column = EntriesColumn; column <= InheritedAllocColumn; ++column)
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        addCostCentres(item, child);
+    }
+}
+
+CostCentreTree::CostCentreTree(const TimeProfile &profile, const Utils::FilePath &sourceDirectory)
+    : m_sourceDirectory(sourceDirectory)
+{
+    setHeaderLabels({tr("Cost Centre"),
+                     tr("Module"),
+                     tr("Entries"),
+                     tr("Individual Time %"),
+                     tr("Individual Alloc %"),
+                     tr("Inherited Time %"),
+                     tr("Inherited Alloc %"),
+                     tr("Source")});
+    setUniformRowHeights(true);
+    setFrameStyle(QFrame::NoFrame);
+    addCostCentres(invisibleRootItem(), profile.root);
+    setSortingEnabled(true);
+    sortByColumn(InheritedTimeColumn, Qt::DescendingOrder);
+    expandToDepth(1);
+    header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    connect(this, &QTreeWidget::itemActivated, this, &CostCentreTree::openSource);
+}
+
+void CostCentreTree::openSource(QTreeWidgetItem *item)
+{
+    // app/Main.hs:9:1-40 or app/Main.hs:(5,1)-(7,20)
+    static const QRegularExpression location(R"(^(.+):(?:\((\d+),(\d+)\)|(\d+):(\d+)))");
+    const QRegularExpressionMatch match = location.match(item->text(SourceColumn));
+    if (!match.hasMatch())
+        return;
+    const bool isSpan = !match.captured(2).isEmpty();
+    const int line = match.captured(isSpan ? 2 : 4).toInt();
+    const int column = match.captured(isSpan ? 3 : 5).toInt();
+    Core::EditorManager::openEditorAt(
+        Utils::Link(m_sourceDirectory.resolvePath(match.captured(1)), line, column - 1));
+}
+
+static QString formatValue(qint64 value, const QString &unit)
+{
+    if (unit == "bytes")
+        return QLocale().formattedDataSize(value);
+    return QLocale().toString(value) + ' ' + unit;
+}
+
+HeapChart::HeapChart(const HeapProfile &profile)
+    : m_valueUnit(profile.valueUnit)
+{
+    setMouseTracking(true);
+    const QList<int> bands = profile.bandsByPeak();
+    const int shownBands = std::min(int(bands.size()), maximumBands);
+    QHash<int, int> column; // band -> chart band
+    for (int i = 0; i < bands.size(); ++i)
+        column.insert(bands.at(i), std::min(i, shownBands));
+    for (int i = 0; i < shownBands; ++i)
+        m_bands.append(profile.bands.at(bands.at(i)));
+    if (bands.size() > shownBands)
+        m_bands.append(tr("(other)"));
+
+    for (const HeapSample &sample : profile.samples) {
+        QVector<qint64> values(m_bands.size(), 0);
+        qint64 total = 0;
+        for (auto it = sample.values.cbegin(); it != sample.values.cend(); ++it) {
+            values[column.value(it.key())] += it.value();
+            total += it.value();
+        }
+        m_times.append(sample.time);
+        m_values.append(values);
+        m_maximum = std::max(m_maximum, total);
+    }
+}
+
+QSize HeapChart::sizeHint() const
+{
+    return {600, 200};
+}
+
+static QColor bandColor(int band, int bandCount)
+{
+    return QColor::fromHsv(band * 300 / std::max(bandCount, 1), 160, 220);
+}
+
+void HeapChart::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    const QRect plot = plotRect();
+    if (m_times.size() < 2 || m_maximum <= 0 || !plot.isValid()) {
+        painter.drawText(rect(), Qt::AlignCenter, tr("No heap samples."));
+        return;
+    }
+
+    const double duration = std::max(m_times.last() - m_times.first(), 1e-9);
+    const auto x = [&](int sample) {
+        return plot.left() + (m_times.at(sample) - m_times.first()) / duration * plot.width();
+    };
+    const auto y = [&](qint64 value) {
+        return plot.bottom() - double(value) / m_maximum * plot.height();
+    };
+
+    // stacked areas, the largest band at the bottom
+    painter.setRenderHint(QPainter::Antialiasing);
+    QVector<qint64> lower(m_times.size(), 0);
+    for (int band = 0; band < m_bands.size(); ++band) {
+        QVector<qint64> upper = lower;
+        QPainterPath path;
+        for (int sample = 0; sample < m_times.size(); ++sample) {
+            upper[sample] += m_values.at(sample).at(band);
+            const QPointF point(x(sample), y(upper.at(sample)));
+            if (sample == 0)
+                path.moveTo(point);
+            else
+                path.lineTo(point);
+        }
+        for (int sample = m_times.size() - 1; sample >= 0; --sample)
+            path.lineTo(x(sample), y(lower.at(sample)));
+        path.closeSubpath();
+        painter.fillPath(path, bandColor(band, m_bands.size()));
+        lower = upper;
+    }
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawLine(plot.bottomLeft(), plot.bottomRight());
+    painter.drawLine(plot.bottomLeft(), plot.topLeft());
+    const QFontMetrics fm = painter.fontMetrics();
+    painter.drawText(QRect(0, plot.top(), plot.left() - 4, fm.height()),
+                     Qt::AlignRight | Qt::AlignVCenter, formatValue(m_maximum, m_valueUnit));
+    painter.drawText(QRect(plot.left(), plot.bottom() + 2, plot.width(), fm.height()),
+                     Qt::AlignRight | Qt::AlignTop,
+                     tr("%1 s").arg(QLocale().toString(m_times.last(), 'f', 2)));
+
+    // legend
+    int legendY = plot.top();
+    const int legendX = plot.right() + 10;
+    for (int band = 0; band < m_bands.size(); ++band) {
+        painter.fillRect(legendX, legendY + 2, fm.height() - 4, fm.height() - 4,
+                         bandColor(band, m_bands.size()));
+        painter.drawText(QRect(legendX + fm.height(), legendY, width() - legendX - fm.height(),
+                               fm.height()),
+                         Qt::AlignLeft | Qt::AlignVCenter,
+                         fm.elidedText(m_bands.at(band), Qt::ElideMiddle,
+                                       width() - legendX - fm.height()));
+        legendY += fm.height();
+    }
+}
+
+bool HeapChart::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent *>(event);
+        const int sample = sampleAt(helpEvent->pos().x());
+        if (sample < 0) {
+            QToolTip::hideText();
+            return true;
+        }
+        QStringList lines{tr("%1 s").arg(QLocale().toString(m_times.at(sample), 'f', 2))};
+        for (int band = m_bands.size() - 1; band >= 0; --band) {
+            lines.append(m_bands.at(band) + ": "
+                         + formatValue(m_values.at(sample).at(band), m_valueUnit));
+        }
+        QToolTip::showText(helpEvent->globalPos(), lines.join('\n'), this);
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+QRect HeapChart::plotRect() const
+{
+    const QFontMetrics fm = fontMetrics();
+    const int left = fm.horizontalAdvance(formatValue(m_maximum, m_valueUnit)) + 8;
+    const int legendWidth = std::min(width() / 3, 250);
+    return QRect(left, fm.height() / 2, width() - left - legendWidth,
+                 height() - 2 * fm.height() - 4);
+}
+
+int HeapChart::sampleAt(int x) const
+{
+    const QRect plot = plotRect();
+    if (m_times.isEmpty() || x < plot.left() || x > plot.right())
+        return -1;
+    const double time = m_times.first()
+                        + double(x - plot.left()) / plot.width()
+                              * (m_times.last() - m_times.first());
+    const auto it = std::lower_bound(m_times.cbegin(), m_times.cend(), time);
+    return std::min(int(it - m_times.cbegin()), int(m_times.size()) - 1);
+}
+
+ProfileView::ProfileView(const TimeProfile *timeProfile,
+                         const HeapProfile *heapProfile,
+                         const Utils::FilePath &sourceDirectory)
+    : QSplitter(Qt::Vertical)
+{
+    if (timeProfile)
+        addWidget(new CostCentreTree(*timeProfile, sourceDirectory));
+    if (heapProfile)
+        addWidget(new HeapChart(*heapProfile));
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "profileparser.h"
+
+#include <utils/filepath.h>
+
+#include <QSplitter>
+#include <QTreeWidget>
+
+namespace Haskell {
+namespace Internal {
+
+// The cost-centre tree of a time profile. Double-clicking a cost centre opens its source.
+class CostCentreTree : public QTreeWidget
+{
+    Q_OBJECT
+
+public:
+    CostCentreTree(const TimeProfile &profile, const Utils::FilePath &sourceDirectory);
+
+private:
+    void openSource(QTreeWidgetItem *item);
+
+    Utils::FilePath m_sourceDirectory;
+};
+
+// Stacked area chart of a heap profile, with the largest bands shown separately.
+class HeapChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HeapChart(const HeapProfile &profile);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    QRect plotRect() const;
+    int sampleAt(int x) const;
+
+    QStringList m_bands; // the largest bands, then "other"
+    QList<double> m_times;
+    QList<QVector<qint64>> m_values; // per sample, per band
+    qint64 m_maximum = 0;
+    QString m_valueUnit;
+};
+
+class ProfileView : public QSplitter
+{
+    Q_OBJECT
+
+public:
+    // Either profile can be null.
+    ProfileView(const TimeProfile *timeProfile,
+                const HeapProfile *heapProfile,
+                const Utils::FilePath &sourceDirectory);
+};
+
+} // namespace Internal
+} // namespace Haskell
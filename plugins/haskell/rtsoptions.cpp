@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "rtsoptions.h"
+
+#include "haskelltr.h"
+
+#include <QPair>
+#include <QRegularExpression>
+#include <QVersionNumber>
+
+namespace Haskell {
+namespace Internal {
+
+QStringList RtsInfo::probeArguments()
+{
+    return {"+RTS", "-A1m", "--info", "-RTS"};
+}
+
+RtsInfo RtsInfo::fromOutput(const QString &output, const QString &errorOutput)
+{
+    // [("GHC RTS", "YES")
+    // ,("GHC version", "9.4.7")
+    // ,("RTS way", "rts_thr")
+    // ...
+    static const QRegularExpression field(R"re(\("([^"]*)",\s*"([^"]*)"\))re");
+    RtsInfo info;
+    QRegularExpressionMatchIterator it = field.globalMatch(output);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        const QString name = match.captured(1);
+        const QString value = match.captured(2);
+        if (name == "GHC RTS")
+            info.valid = value == "YES";
+        else if (name == "GHC version")
+            info.ghcVersion = value;
+        else if (name == "RTS way")
+            info.threaded = value.contains("_thr");
+    }
+    // "the flag -A1m requires the program to be built with -rtsopts"
+    info.rtsOptionsEnabled = !errorOutput.contains("rtsopts");
+    return info;
+}
+
+RtsOptions RtsOptions::preset(Preset preset)
+{
+    RtsOptions options;
+    switch (preset) {
+    case Throughput:
+        // large allocation areas mean fewer collections, parallel GC rarely pays off
+        options.capabilities = 0;
+        options.allocationArea = "64m";
+        options.allocationChunkSize = "4m";
+        options.parallelGc = false;
+        break;
+    case LowLatency:
+        // the old generation is collected concurrently, no idle collections
+        options.capabilities = 0;
+        options.allocationArea = "16m";
+        options.idleGc = false;
+        options.nonmovingGc = true;
+        break;
+    case LowMemory:
+        options.allocationArea = "1m";
+        options.parallelGc = false;
+        break;
+    case Custom:
+    case PresetCount:
+        break;
+    }
+    return options;
+}
+
+QString RtsOptions::presetName(Preset preset)
+{
+    switch (preset) {
+    case Throughput:
+        return Tr::tr("Throughput");
+    case LowLatency:
+        return Tr::tr("Low latency");
+    case LowMemory:
+        return Tr::tr("Low memory");
+    case Custom:
+    case PresetCount:
+        break;
+    }
+    return Tr::tr("Custom");
+}
+
+RtsOptions::Preset RtsOptions::matchingPreset() const
+{
+    for (int i = Custom + 1; i < PresetCount; ++i) {
+        RtsOptions candidate = preset(Preset(i));
+        candidate.additionalOptions = additionalOptions;
+        if (*this == candidate)
+            return Preset(i);
+    }
+    return Custom;
+}
+
+QStringList RtsOptions::arguments() const
+{
+    QStringList result;
+    if (capabilities == 0)
+        result << "-N";
+    else if (capabilities > 0)
+        result << "-N" + QString::number(capabilities);
+    if (!allocationArea.isEmpty())
+        result << "-A" + allocationArea;
+    if (!allocationChunkSize.isEmpty())
+        result << "-n" + allocationChunkSize;
+    if (!parallelGc)
+        result << "-qg";
+    if (!suggestedHeapSize.isEmpty())
+        result << "-H" + suggestedHeapSize;
+    if (!maximumHeapSize.isEmpty())
+        result << "-M" + maximumHeapSize;
+    if (!idleGc)
+        result << "-I0";
+    if (nonmovingGc)
+        result << "--nonmoving-gc";
+    result << additionalOptions.split(' ', Qt::SkipEmptyParts);
+    return result;
+}
+
+QStringList RtsOptions::problems(const RtsInfo &info) const
+{
+    QStringList result;
+    const QPair<QString, QString> sizes[] = {{"-A", allocationArea},
+                                             {"-n", allocationChunkSize},
+                                             {"-H", suggestedHeapSize},
+                                             {"-M", maximumHeapSize}};
+    for (const auto &size : sizes) {
+        if (!isValidSize(size.second))
+            result << Tr::tr("\"%1\" is not a valid size for %2.").arg(size.second, size.first);
+    }
+    if (!info.valid || arguments().isEmpty())
+        return result;
+    if (!info.rtsOptionsEnabled) {
+        result << Tr::tr("The executable was not linked with -rtsopts "
+                         "and will reject the options.");
+        return result;
+    }
+    if (!info.threaded) {
+        if (capabilities >= 0)
+            result << Tr::tr("-N requires an executable that was linked with -threaded.");
+        if (!parallelGc)
+            result << Tr::tr("-qg has no effect without -threaded.");
+    }
+    if (nonmovingGc && !info.ghcVersion.isEmpty()
+            && QVersionNumber::fromString(info.ghcVersion) < QVersionNumber(8, 10)) {
+        result << Tr::tr("The nonmoving garbage collector requires GHC 8.10 or later.");
+    }
+    return result;
+}
+
+QVariantMap RtsOptions::toMap() const
+{
+    QVariantMap map;
+    map.insert("Capabilities", capabilities);
+    map.insert("AllocationArea", allocationArea);
+    map.insert("AllocationChunkSize", allocationChunkSize);
+    map.insert("ParallelGc", parallelGc);
+    map.insert("SuggestedHeapSize", suggestedHeapSize);
+    map.insert("MaximumHeapSize", maximumHeapSize);
+    map.insert("IdleGc", idleGc);
+    map.insert("NonmovingGc", nonmovingGc);
+    map.insert("AdditionalOptions", additionalOptions);
+    return map;
+}
+
+RtsOptions RtsOptions::fromMap(const QVariantMap &map)
+{
+    RtsOptions options;
+    options.capabilities = map.value("Capabilities", -1).toInt();
+    options.allocationArea = map.value("AllocationArea").toString();
+    options.allocationChunkSize = map.value("AllocationChunkSize").toString();
+    options.parallelGc = map.value("ParallelGc", true).toBool();
+    options.suggestedHeapSize = map.value("SuggestedHeapSize").toString();
+    options.maximumHeapSize = map.value("MaximumHeapSize").toString();
+    options.idleGc = map.value("IdleGc", true).toBool();
+    options.nonmovingGc = map.value("NonmovingGc", false).toBool();
+    options.additionalOptions = map.value("AdditionalOptions").toString();
+    return options;
+}
+
+bool RtsOptions::isValidSize(const QString &size)
+{
+    static const QRegularExpression sizePattern(R"(^\d+(\.\d+)?[kKmMgG]?$)");
+    return size.isEmpty() || sizePattern.match(size).hasMatch();
+}
+
+bool RtsOptions::operator==(const RtsOptions &other) const
+{
+    return capabilities == other.capabilities && allocationArea == other.allocationArea
+           && allocationChunkSize == other.allocationChunkSize
+           && parallelGc == other.parallelGc && suggestedHeapSize == other.suggestedHeapSize
+           && maximumHeapSize == other.maximumHeapSize && idleGc == other.idleGc
+           && nonmovingGc == other.nonmovingGc && additionalOptions == other.additionalOptions;
+}
+
+} // namespace Internal
+} // namespace Haskell
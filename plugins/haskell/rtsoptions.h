@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace Haskell {
+namespace Internal {
+
+// What an executable's runtime system supports, from "+RTS --info".
+class RtsInfo
+{
+public:
+    // -A1m is rejected without -rtsopts, --info exits before the program runs.
+    static QStringList probeArguments();
+    static RtsInfo fromOutput(const QString &output, const QString &errorOutput);
+
+    bool valid = false;
+    bool threaded = false;
+    bool rtsOptionsEnabled = false;
+    QString ghcVersion;
+};
+
+// Tuning options for the runtime system, passed between +RTS and -RTS.
+class RtsOptions
+{
+public:
+    enum Preset { Custom, Throughput, LowLatency, LowMemory, PresetCount };
+
+    static RtsOptions preset(Preset preset);
+    static QString presetName(Preset preset);
+    // Returns Custom if the options don't match a preset. Additional options are ignored.
+    Preset matchingPreset() const;
+
+    QStringList arguments() const;
+    // Returns the reasons why an executable would reject the options or ignore some of them.
+    // The executable is only checked if the info is valid.
+    QStringList problems(const RtsInfo &info = {}) const;
+
+    QVariantMap toMap() const;
+    static RtsOptions fromMap(const QVariantMap &map);
+
+    // Sizes like "64m", "1g" or "4096".
+    static bool isValidSize(const QString &size);
+
+    bool operator==(const RtsOptions &other) const;
+    bool operator!=(const RtsOptions &other) const { return !(*this == other); }
+
+    int capabilities = -1; // -N<n>, 0 for -N, -1 for the default
+    QString allocationArea; // -A
+    QString allocationChunkSize; // -n
+    bool parallelGc = true; // -qg if false
+    QString suggestedHeapSize; // -H
+    QString maximumHeapSize; // -M
+    bool idleGc = true; // -I0 if false
+    bool nonmovingGc = false; // --nonmoving-gc
+    QString additionalOptions;
+};
+
+} // namespace Internal
+} // namespace Haskell
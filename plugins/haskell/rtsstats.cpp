@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "rtsstats.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Haskell {
+namespace Internal {
+
+static qint64 toBytes(QString text)
+{
+    return text.remove(',').toLongLong();
+}
+
+QVector<GcSample> RtsStatsParser::addOutput(const QString &text)
+{
+    QVector<GcSample> samples;
+    m_lines.addText(text, [&](const QString &line) { addLine(line, &samples); });
+    return samples;
+}
+
+QVector<GcSample> RtsStatsParser::finish()
+{
+    QVector<GcSample> samples;
+    m_lines.finish([&](const QString &line) { addLine(line, &samples); });
+    return samples;
+}
+
+RtsSummary RtsStatsParser::summary() const
+{
+    RtsSummary summary = m_summary;
+    // the machine readable format has no productivity
+    if (summary.productivity < 0 && summary.mutatorElapsedTime >= 0
+        && summary.totalElapsedTime > 0) {
+        summary.productivity = 100 * summary.mutatorElapsedTime / summary.totalElapsedTime;
+    }
+    return summary;
+}
+
+void RtsStatsParser::addLine(const QString &line, QVector<GcSample> *samples)
+{
+    //     Alloc    Copied     Live     GC     GC      TOT      TOT  Page Flts
+    //     bytes     bytes     bytes   user   elap     user     elap
+    //   4194304    762024    818544  0.002  0.002    0.003    0.003    0    0  (Gen:  0)
+    static const QRegularExpression gc(
+        R"(^\s*(\d+)\s+(\d+)\s+(\d+)\s+([\d.]+)\s+([\d.]+)\s+([\d.]+)\s+([\d.]+)\s+\d+\s+\d+)"
+        R"(\s+\(Gen:\s*(\d+)\))");
+    //  [("bytes allocated", "52429720")
+    //  ,("num_GCs", "13")
+    static const QRegularExpression machineReadable(
+        R"re(^\s*[\[,]\s*\("([^"]+)",\s*"([^"]*)"\))re");
+    //      52,429,720 bytes allocated in the heap
+    static const QRegularExpression bytes(
+        R"(^\s*([\d,]+) bytes (allocated in the heap|maximum residency))");
+    //   Gen  0        12 colls,     0 par    0.003s   0.003s     0.0003s    0.0009s
+    static const QRegularExpression generation(
+        R"(^\s*Gen\s+\d+\s+(\d+) colls,.*\s([\d.]+)s\s*$)");
+    //   MUT     time    0.015s  (  0.016s elapsed)
+    static const QRegularExpression time(
+        R"(^\s*(MUT|GC|Total)\s+time\s+[\d.]+s\s+\(\s*([\d.]+)s elapsed\))");
+    //   Productivity  81.2% of total user, 80.6% of total elapsed
+    static const QRegularExpression productivity(
+        R"(^\s*Productivity\s+[\d.]+% of total user,\s+([\d.]+)% of total elapsed)");
+
+    QRegularExpressionMatch match = gc.match(line);
+    if (match.hasMatch()) {
+        GcSample sample;
+        sample.allocatedBytes = match.captured(1).toLongLong();
+        sample.copiedBytes = match.captured(2).toLongLong();
+        sample.liveBytes = match.captured(3).toLongLong();
+        sample.gcCpuTime = match.captured(4).toDouble();
+        sample.gcElapsedTime = match.captured(5).toDouble();
+        sample.totalCpuTime = match.captured(6).toDouble();
+        sample.totalElapsedTime = match.captured(7).toDouble();
+        sample.generation = match.captured(8).toInt();
+        samples->append(sample);
+        return;
+    }
+    if ((match = machineReadable.match(line)).hasMatch()) {
+        addSummaryValue(match.captured(1), match.captured(2));
+    } else if ((match = bytes.match(line)).hasMatch()) {
+        if (match.captured(2) == "allocated in the heap")
+            m_summary.bytesAllocated = toBytes(match.captured(1));
+        else
+            m_summary.maximumResidency = toBytes(match.captured(1));
+    } else if ((match = generation.match(line)).hasMatch()) {
+        m_summary.collections = std::max(m_summary.collections, 0) + match.captured(1).toInt();
+        m_summary.maximumPause = std::max(m_summary.maximumPause, match.captured(2).toDouble());
+    } else if ((match = time.match(line)).hasMatch()) {
+        addSummaryValue(match.captured(1), match.captured(2));
+    } else if ((match = productivity.match(line)).hasMatch()) {
+        m_summary.productivity = match.captured(1).toDouble();
+    }
+}
+
+void RtsStatsParser::addSummaryValue(const QString &key, const QString &value)
+{
+    if (key == "bytes allocated")
+        m_summary.bytesAllocated = value.toLongLong();
+    else if (key == "max_bytes_used")
+        m_summary.maximumResidency = value.toLongLong();
+    else if (key == "num_GCs")
+        m_summary.collections = value.toInt();
+    else if (key == "mutator_wall_seconds" || key == "MUT")
+        m_summary.mutatorElapsedTime = value.toDouble();
+    else if (key == "GC_wall_seconds" || key == "GC")
+        m_summary.gcElapsedTime = value.toDouble();
+    else if (key == "total_wall_seconds" || key == "Total")
+        m_summary.totalElapsedTime = value.toDouble();
+}
+
+RtsStatsSeries::RtsStatsSeries(double interval, int maximumPoints)
+    : m_interval(interval)
+    , m_maximumPoints(maximumPoints)
+{}
+
+void RtsStatsSeries::addSample(const GcSample &sample)
+{
+    const double time = sample.totalElapsedTime;
+    if (m_points.isEmpty() || time >= m_points.last().time + m_interval) {
+        Point point;
+        point.time = std::floor(time / m_interval) * m_interval;
+        m_points.append(point);
+        m_pointStart = m_points.size() > 1 ? m_lastElapsedTime : 0;
+        m_gcTime = 0;
+        if (m_points.size() > m_maximumPoints)
+            m_points.removeFirst();
+    }
+    Point &point = m_points.last();
+    point.liveBytes = std::max(point.liveBytes, sample.liveBytes);
+    point.allocationRate += sample.allocatedBytes / m_interval;
+    ++point.collections;
+    point.maximumPause = std::max(point.maximumPause, sample.gcElapsedTime);
+    m_gcTime += sample.gcElapsedTime;
+    m_lastElapsedTime = time;
+    updateProductivity();
+
+    ++m_collections;
+    m_peakLiveBytes = std::max(m_peakLiveBytes, sample.liveBytes);
+    m_maximumPause = std::max(m_maximumPause, sample.gcElapsedTime);
+}
+
+// The share of the elapsed time in the interval that was not spent collecting garbage.
+void RtsStatsSeries::updateProductivity()
+{
+    const double duration = m_lastElapsedTime - m_pointStart;
+    if (duration <= 0)
+        return;
+    m_points.last().productivity = std::clamp(100 * (1 - m_gcTime / duration), 0.0, 100.0);
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "linebuffer.h"
+
+#include <QString>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+// One line of "+RTS -S" output, written after each garbage collection.
+class GcSample
+{
+public:
+    qint64 allocatedBytes = 0; // since the previous collection
+    qint64 copiedBytes = 0;
+    qint64 liveBytes = 0;
+    double gcCpuTime = 0;
+    double gcElapsedTime = 0;
+    double totalCpuTime = 0;
+    double totalElapsedTime = 0; // since the start of the program
+    int generation = 0;
+};
+
+// The statistics the runtime system prints at exit, from "-s" or "-s --machine-readable".
+// Values that were not found are negative.
+class RtsSummary
+{
+public:
+    qint64 bytesAllocated = -1;
+    qint64 maximumResidency = -1;
+    int collections = -1;
+    double mutatorElapsedTime = -1;
+    double gcElapsedTime = -1;
+    double totalElapsedTime = -1;
+    double maximumPause = -1;
+    double productivity = -1; // percent of the elapsed time
+
+    bool isValid() const { return bytesAllocated >= 0; }
+};
+
+class RtsStatsParser
+{
+public:
+    // Returns the samples of the complete lines.
+    QVector<GcSample> addOutput(const QString &text);
+    QVector<GcSample> finish();
+
+    RtsSummary summary() const;
+
+private:
+    void addLine(const QString &line, QVector<GcSample> *samples);
+    void addSummaryValue(const QString &key, const QString &value);
+
+    LineBuffer m_lines;
+    RtsSummary m_summary;
+};
+
+// Samples aggregated to fixed intervals for charting. Only the most recent intervals are kept.
+class RtsStatsSeries
+{
+public:
+    class Point
+    {
+    public:
+        double time = 0; // the start of the interval
+        qint64 liveBytes = 0; // the maximum after the collections in the interval
+        double allocationRate = 0; // bytes per second
+        int collections = 0;
+        double maximumPause = 0;
+        double productivity = 100; // percent of the elapsed time
+    };
+
+    explicit RtsStatsSeries(double interval = 1, int maximumPoints = 3600);
+
+    void addSample(const GcSample &sample);
+
+    double interval() const { return m_interval; }
+    const QVector<Point> &points() const { return m_points; }
+    int collections() const { return m_collections; }
+    qint64 peakLiveBytes() const { return m_peakLiveBytes; }
+    double maximumPause() const { return m_maximumPause; }
+
+private:
+    void updateProductivity();
+
+    double m_interval;
+    int m_maximumPoints;
+    QVector<Point> m_points;
+    double m_pointStart = 0; // the elapsed time of the last collection before the interval
+    double m_gcTime = 0; // in the current interval
+    double m_lastElapsedTime = 0;
+    int m_collections = 0;
+    qint64 m_peakLiveBytes = 0;
+    double m_maximumPause = 0;
+};
+
+} // namespace Internal
+} // namespace Haskell
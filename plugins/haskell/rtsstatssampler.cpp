@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "rtsstatssampler.h"
+
+#include "haskellanalysispane.h"
+#include "rtsstatsview.h"
+
+#include <utils/qtcassert.h>
+
+#include <QDir>
+#include <QFile>
+
+using namespace ProjectExplorer;
+
+namespace Haskell {
+namespace Internal {
+
+RtsStatsSampler::RtsStatsSampler(RunControl *runControl, const QString &statsFilePath)
+    : RunWorker(runControl)
+    , m_statsFilePath(statsFilePath)
+{
+    setId("RtsStatsSampler");
+    m_timer.setInterval(1000);
+    connect(&m_timer, &QTimer::timeout, this, &RtsStatsSampler::readStats);
+    // the program can exit on its own, the summary is written at exit
+    connect(runControl, &RunControl::stopped, this, &RtsStatsSampler::finish);
+}
+
+void RtsStatsSampler::start()
+{
+    HaskellAnalysisPane *pane = HaskellAnalysisPane::instance();
+    QTC_ASSERT(pane, reportFailure(); return);
+    // the file of the previous run
+    QFile::remove(m_statsFilePath);
+    m_offset = 0;
+    m_parser = {};
+    m_finished = false;
+    const QString name = runControl()->displayName();
+    m_view = new RtsStatsView(QDir::toNativeSeparators(m_statsFilePath));
+    pane->showResult("rtsstats:" + name, tr("Statistics: %1").arg(name), m_view);
+    m_timer.start();
+    reportStarted();
+}
+
+void RtsStatsSampler::stop()
+{
+    finish();
+    reportStopped();
+}
+
+void RtsStatsSampler::readStats()
+{
+    QFile file(m_statsFilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    if (file.size() < m_offset) {
+        // written anew
+        m_offset = 0;
+        m_parser = {};
+    }
+    if (file.size() == m_offset || !file.seek(m_offset))
+        return;
+    const QByteArray data = file.readAll();
+    m_offset += data.size();
+    const QVector<GcSample> samples = m_parser.addOutput(QString::fromLatin1(data));
+    if (m_view)
+        m_view->addSamples(samples);
+}
+
+void RtsStatsSampler::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+    m_timer.stop();
+    readStats();
+    const QVector<GcSample> samples = m_parser.finish();
+    if (!m_view)
+        return;
+    m_view->addSamples(samples);
+    m_view->setSummary(m_parser.summary());
+    if (m_offset == 0) {
+        m_view->setMessage(tr("The runtime system wrote no statistics. The program needs to be "
+                              "linked with -rtsopts to accept the option -S."));
+    }
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,65 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "rtsstats.h"
+
+#include <projectexplorer/runcontrol.h>
+
+#include <QPointer>
+#include <QTimer>
+
+namespace Haskell {
+namespace Internal {
+
+class RtsStatsView;
+
+// Follows the statistics file that the runtime system of a running program writes with
+// "+RTS -S<file>", and shows them in the Haskell Analysis pane. Only the new part of the file
+// is read, once a second.
+class RtsStatsSampler : public ProjectExplorer::RunWorker
+{
+    Q_OBJECT
+
+public:
+    RtsStatsSampler(ProjectExplorer::RunControl *runControl, const QString &statsFilePath);
+
+private:
+    void start() override;
+    void stop() override;
+    void readStats();
+    void finish();
+
+    QString m_statsFilePath;
+    qint64 m_offset = 0;
+    RtsStatsParser m_parser;
+    QPointer<RtsStatsView> m_view;
+    QTimer m_timer;
+    bool m_finished = false;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,291 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "rtsstatsview.h"
+
+#include <QEvent>
+#include <QHelpEvent>
+#include <QLabel>
+#include <QLocale>
+#include <QPainter>
+#include <QScrollArea>
+#include <QToolTip>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+enum Row { HeapRow, AllocationRow, CollectionsRow, PauseRow, ProductivityRow, RowCount };
+
+static QString rowLabel(int row)
+{
+    switch (row) {
+    case HeapRow:
+        return RtsStatsChartWidget::tr("Live heap");
+    case AllocationRow:
+        return RtsStatsChartWidget::tr("Allocation rate");
+    case CollectionsRow:
+        return RtsStatsChartWidget::tr("Collections");
+    case PauseRow:
+        return RtsStatsChartWidget::tr("Longest pause");
+    case ProductivityRow:
+        return RtsStatsChartWidget::tr("Productivity");
+    }
+    return {};
+}
+
+static QColor rowColor(int row)
+{
+    switch (row) {
+    case HeapRow:
+        return QColor(70, 120, 200);
+    case AllocationRow:
+        return QColor(150, 90, 190);
+    case CollectionsRow:
+    case PauseRow:
+        return QColor(230, 140, 40);
+    }
+    return QColor(60, 170, 90);
+}
+
+static double rowValue(const RtsStatsSeries::Point &point, int row)
+{
+    switch (row) {
+    case HeapRow:
+        return point.liveBytes;
+    case AllocationRow:
+        return point.allocationRate;
+    case CollectionsRow:
+        return point.collections;
+    case PauseRow:
+        return point.maximumPause;
+    case ProductivityRow:
+        return point.productivity;
+    }
+    return 0;
+}
+
+static QString formatPause(double seconds)
+{
+    const QLocale locale;
+    if (seconds < 1)
+        return RtsStatsView::tr("%1 ms").arg(locale.toString(seconds * 1e3, 'f', 1));
+    return RtsStatsView::tr("%1 s").arg(locale.toString(seconds, 'f', 2));
+}
+
+static QString formatRate(double bytesPerSecond)
+{
+    return RtsStatsView::tr("%1/s").arg(QLocale().formattedDataSize(qint64(bytesPerSecond)));
+}
+
+RtsStatsChartWidget::RtsStatsChartWidget(const RtsStatsSeries *series)
+    : m_series(series)
+{}
+
+QSize RtsStatsChartWidget::sizeHint() const
+{
+    return {800, RowCount * rowHeight() + 4};
+}
+
+int RtsStatsChartWidget::rowHeight() const
+{
+    return 2 * fontMetrics().height() + 6;
+}
+
+int RtsStatsChartWidget::labelWidth() const
+{
+    int width = 0;
+    for (int row = 0; row < RowCount; ++row)
+        width = std::max(width, fontMetrics().horizontalAdvance(rowLabel(row)));
+    return width + 10;
+}
+
+// The points are drawn over the time from the first to the end of the last one.
+double RtsStatsChartWidget::timeLeft(double time) const
+{
+    const QVector<RtsStatsSeries::Point> &points = m_series->points();
+    const int left = labelWidth();
+    if (points.isEmpty())
+        return left;
+    const double start = points.first().time;
+    const double duration = points.last().time + m_series->interval() - start;
+    return left + (width() - left) * (time - start) / duration;
+}
+
+int RtsStatsChartWidget::pointAt(int x) const
+{
+    const QVector<RtsStatsSeries::Point> &points = m_series->points();
+    if (points.isEmpty() || x < labelWidth())
+        return -1;
+    const auto it = std::upper_bound(points.begin(), points.end(), x,
+                                     [this](int x, const RtsStatsSeries::Point &point) {
+                                         return x < timeLeft(point.time);
+                                     });
+    if (it == points.begin())
+        return -1;
+    const int index = int(it - points.begin()) - 1;
+    // intervals without collections have no point
+    if (x >= timeLeft(points.at(index).time + m_series->interval()) + 1)
+        return -1;
+    return index;
+}
+
+void RtsStatsChartWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    const int height = rowHeight();
+    const QVector<RtsStatsSeries::Point> &points = m_series->points();
+    for (int row = 0; row < RowCount; ++row) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRect(4, row * height, labelWidth(), height), Qt::AlignVCenter,
+                         rowLabel(row));
+        double maximum = row == ProductivityRow ? 100 : 0;
+        for (const RtsStatsSeries::Point &point : points)
+            maximum = std::max(maximum, rowValue(point, row));
+        const int top = row * height + 2;
+        for (int i = 0; maximum > 0 && i < points.size(); ++i) {
+            const RtsStatsSeries::Point &point = points.at(i);
+            const double value = rowValue(point, row) / maximum * (height - 4);
+            const double left = timeLeft(point.time);
+            const double right = std::max(timeLeft(point.time + m_series->interval()), left + 1);
+            painter.fillRect(QRectF(left, top + height - 4 - value, right - left, value),
+                             rowColor(row));
+        }
+    }
+
+    painter.setPen(palette().color(QPalette::Mid));
+    for (int line = 1; line < RowCount; ++line)
+        painter.drawLine(0, line * height, width(), line * height);
+}
+
+bool RtsStatsChartWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent *>(event);
+        const int index = pointAt(helpEvent->pos().x());
+        if (index < 0) {
+            QToolTip::hideText();
+            return true;
+        }
+        const RtsStatsSeries::Point &point = m_series->points().at(index);
+        const QLocale locale;
+        const QString text
+            = tr("At %1 s:\nLive heap: %2\nAllocation rate: %3\nCollections: %4\n"
+                 "Longest pause: %5\nProductivity: %6%")
+                  .arg(locale.toString(point.time, 'f', 0),
+                       locale.formattedDataSize(point.liveBytes),
+                       formatRate(point.allocationRate))
+                  .arg(point.collections)
+                  .arg(formatPause(point.maximumPause),
+                       locale.toString(point.productivity, 'f', 1));
+        QToolTip::showText(helpEvent->globalPos(), text, this);
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+RtsStatsView::RtsStatsView(const QString &statsFilePath)
+    : m_statsFilePath(statsFilePath)
+    , m_statusLabel(new QLabel)
+    , m_summaryLabel(new QLabel)
+    , m_chart(new RtsStatsChartWidget(&m_series))
+{
+    m_summaryLabel->setVisible(false);
+    m_summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_statusLabel);
+    layout->addWidget(m_summaryLabel);
+
+    auto scrollArea = new QScrollArea;
+    scrollArea->setFrameStyle(QFrame::NoFrame);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(m_chart);
+    layout->addWidget(scrollArea, 1);
+    updateStatus();
+}
+
+void RtsStatsView::addSamples(const QVector<GcSample> &samples)
+{
+    if (samples.isEmpty())
+        return;
+    for (const GcSample &sample : samples)
+        m_series.addSample(sample);
+    updateStatus();
+    m_chart->update();
+}
+
+void RtsStatsView::setSummary(const RtsSummary &summary)
+{
+    if (!summary.isValid())
+        return;
+    const QLocale locale;
+    QString text = tr("Allocated %1 in total, maximum residency %2")
+                       .arg(locale.formattedDataSize(summary.bytesAllocated),
+                            locale.formattedDataSize(std::max(summary.maximumResidency,
+                                                              qint64(0))));
+    if (summary.collections >= 0)
+        text += tr(", %n collection(s)", nullptr, summary.collections);
+    if (summary.maximumPause >= 0)
+        text += tr(", longest pause %1").arg(formatPause(summary.maximumPause));
+    if (summary.productivity >= 0) {
+        text += tr(", productivity %1% of the elapsed time")
+                    .arg(locale.toString(summary.productivity, 'f', 1));
+    }
+    m_summaryLabel->setText(text);
+    m_summaryLabel->setVisible(true);
+}
+
+void RtsStatsView::setMessage(const QString &message)
+{
+    m_statusLabel->setText(message);
+}
+
+void RtsStatsView::updateStatus()
+{
+    const QVector<RtsStatsSeries::Point> &points = m_series.points();
+    if (points.isEmpty()) {
+        m_statusLabel->setText(tr("Waiting for the runtime system to write %1.")
+                                   .arg(m_statsFilePath));
+        return;
+    }
+    const RtsStatsSeries::Point &last = points.last();
+    const QLocale locale;
+    m_statusLabel->setText(
+        tr("Live heap %1 (peak %2), allocating %3, %4 collections, longest pause %5, "
+           "productivity %6%")
+            .arg(locale.formattedDataSize(last.liveBytes),
+                 locale.formattedDataSize(m_series.peakLiveBytes()),
+                 formatRate(last.allocationRate))
+            .arg(m_series.collections())
+            .arg(formatPause(m_series.maximumPause()),
+                 locale.toString(last.productivity, 'f', 1)));
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "rtsstats.h"
+
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+// The live heap, allocation rate, garbage collections, pauses and productivity over time.
+class RtsStatsChartWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RtsStatsChartWidget(const RtsStatsSeries *series);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    int rowHeight() const;
+    int labelWidth() const;
+    double timeLeft(double time) const;
+    int pointAt(int x) const;
+
+    const RtsStatsSeries *m_series;
+};
+
+// Statistics of a running program, from the garbage collections its runtime system reports.
+class RtsStatsView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RtsStatsView(const QString &statsFilePath);
+
+    void addSamples(const QVector<GcSample> &samples);
+    void setSummary(const RtsSummary &summary);
+    void setMessage(const QString &message);
+
+private:
+    void updateStatus();
+
+    RtsStatsSeries m_series;
+    QString m_statsFilePath;
+    QLabel *m_statusLabel;
+    QLabel *m_summaryLabel;
+    RtsStatsChartWidget *m_chart;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "semantictokens.h"
+
+#include "haskelltokenizer.h"
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+static const int integersPerToken = 5;
+
+static bool isBinder(const Token &token)
+{
+    return token.type == TokenType::Variable && !token.text.contains('.');
+}
+
+class EquationHead
+{
+public:
+    bool isSignature = false;
+    int name = -1; // the index of the declared name, if it is a variable
+    QSet<QString> parameters;
+};
+
+// from the tokens of a line starting a top-level declaration
+static EquationHead parseHead(const QVector<Token> &code)
+{
+    EquationHead head;
+    // the head ends at = or a guard
+    int end = 0;
+    int depth = 0;
+    bool infix = false;
+    for (; end < code.size(); ++end) {
+        const Token &token = code.at(end);
+        if (token.isSpecial("([{"))
+            ++depth;
+        else if (token.isSpecial(")]}"))
+            depth = std::max(0, depth - 1);
+        if (depth > 0)
+            continue;
+        if (token.isKeyword("=") || token.isKeyword("|"))
+            break;
+        if (token.isKeyword("::")) {
+            head.isSignature = true;
+            return head;
+        }
+        if (end > 0 && token.type == TokenType::Operator && token.text != QLatin1String("!")) {
+            infix = true;
+        } else if (end > 0 && token.isSpecial("`") && end + 1 < code.size()
+                   && code.at(end + 1).type == TokenType::Variable) {
+            infix = true;
+            head.name = end + 1;
+        }
+    }
+    if (!infix && code.first().type == TokenType::Variable)
+        head.name = 0;
+    else if (!infix && !(code.first().isSpecial("(") && code.size() > 1
+                         && code.at(1).type == TokenType::Operator))
+        return head; // not the definition of a function, like a pattern binding
+    for (int i = 0; i < end; ++i) {
+        if (i != head.name && isBinder(code.at(i)))
+            head.parameters.insert(code.at(i).text.toString());
+    }
+    return head;
+}
+
+bool SemanticToken::operator==(const SemanticToken &other) const
+{
+    return line == other.line && column == other.column && length == other.length
+           && kind == other.kind;
+}
+
+QVector<SemanticToken> SemanticTokens::fromLines(const QStringList &lines,
+                                                 const QSet<QString> &functionNames)
+{
+    QVector<SemanticToken> result;
+    QSet<QString> parameters; // of the current top-level equation
+    bool inTypes = false; // in a declaration of types, like a signature or data
+    int state = int(Tokens::State::None);
+    for (int line = 0; line < lines.size(); ++line) {
+        const bool startsInCode = state == int(Tokens::State::None);
+        const Tokens tokens = HaskellTokenizer::tokenize(lines.at(line), state);
+        state = tokens.state;
+        const QVector<Token> code = tokens.code();
+        if (code.isEmpty())
+            continue;
+        int name = -1;
+        if (startsInCode && code.first().startCol == 0) {
+            // the next top-level declaration
+            parameters.clear();
+            const Token &first = code.first();
+            if (first.isKeyword("class") || first.isKeyword("instance")) {
+                // only the methods are code
+                inTypes = false;
+                continue;
+            }
+            inTypes = first.type == TokenType::Keyword;
+            if (!inTypes) {
+                EquationHead head = parseHead(code);
+                inTypes = head.isSignature;
+                name = head.name;
+                parameters = head.parameters;
+            }
+        }
+        if (inTypes)
+            continue;
+        for (int i = 0; i < code.size(); ++i) {
+            const Token &token = code.at(i);
+            if (token.isKeyword("::"))
+                break; // the rest of the line is a type
+            if (token.type != TokenType::Variable)
+                continue;
+            SemanticToken semanticToken;
+            semanticToken.line = line;
+            semanticToken.column = token.startCol;
+            semanticToken.length = token.length;
+            const QString text = token.text.toString();
+            if (i == name)
+                semanticToken.kind = SemanticToken::FunctionDeclaration;
+            else if (parameters.contains(text))
+                semanticToken.kind = SemanticToken::Parameter;
+            else if (functionNames.contains(text))
+                semanticToken.kind = SemanticToken::Function;
+            else
+                continue;
+            result.append(semanticToken);
+        }
+    }
+    return result;
+}
+
+QVector<int> SemanticTokens::encode(const QVector<SemanticToken> &tokens)
+{
+    QVector<int> data;
+    data.reserve(tokens.size() * integersPerToken);
+    int line = 0;
+    int column = 0;
+    for (const SemanticToken &token : tokens) {
+        const int deltaLine = token.line - line;
+        data << deltaLine << (deltaLine == 0 ? token.column - column : token.column)
+             << token.length << token.kind << 0;
+        line = token.line;
+        column = token.column;
+    }
+    return data;
+}
+
+QVector<SemanticToken> SemanticTokens::decode(const QVector<int> &data)
+{
+    QVector<SemanticToken> tokens;
+    tokens.reserve(data.size() / integersPerToken);
+    int line = 0;
+    int column = 0;
+    for (int i = 0; i + integersPerToken <= data.size(); i += integersPerToken) {
+        const int deltaLine = data.at(i);
+        line += deltaLine;
+        column = deltaLine == 0 ? column + data.at(i + 1) : data.at(i + 1);
+        SemanticToken token;
+        token.line = line;
+        token.column = column;
+        token.length = data.at(i + 2);
+        token.kind = SemanticToken::Kind(data.at(i + 3));
+        tokens.append(token);
+    }
+    return tokens;
+}
+
+static bool sameToken(const QVector<int> &data, int token, const QVector<int> &otherData,
+                      int otherToken)
+{
+    return std::equal(data.cbegin() + token * integersPerToken,
+                      data.cbegin() + (token + 1) * integersPerToken,
+                      otherData.cbegin() + otherToken * integersPerToken);
+}
+
+SemanticTokensEdit SemanticTokens::diff(const QVector<int> &before, const QVector<int> &after)
+{
+    const int tokensBefore = before.size() / integersPerToken;
+    const int tokensAfter = after.size() / integersPerToken;
+    const int common = std::min(tokensBefore, tokensAfter);
+    int start = 0;
+    while (start < common && sameToken(before, start, after, start))
+        ++start;
+    int end = 0;
+    while (start + end < common
+           && sameToken(before, tokensBefore - 1 - end, after, tokensAfter - 1 - end)) {
+        ++end;
+    }
+    SemanticTokensEdit edit;
+    edit.start = start * integersPerToken;
+    edit.deleteCount = (tokensBefore - start - end) * integersPerToken;
+    edit.data = after.mid(edit.start, (tokensAfter - start - end) * integersPerToken);
+    return edit;
+}
+
+QVector<int> SemanticTokens::apply(const QVector<int> &data, const SemanticTokensEdit &edit)
+{
+    return data.mid(0, edit.start) + edit.data + data.mid(edit.start + edit.deleteCount);
+}
+
+LineRange SemanticTokens::changedLines(const QVector<SemanticToken> &after,
+                                       const SemanticTokensEdit &edit)
+{
+    // from the last token before the edit to the first one after it, their lines can have
+    // changed tokens too
+    const int first = edit.start / integersPerToken;
+    const int end = first + edit.data.size() / integersPerToken;
+    LineRange range;
+    range.first = first > 0 ? after.at(first - 1).line : 0;
+    range.last = end < after.size() ? after.at(end).line : -1;
+    return range;
+}
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+class SemanticToken
+{
+public:
+    enum Kind { Function, FunctionDeclaration, Parameter };
+
+    bool operator==(const SemanticToken &other) const;
+
+    int line = 0;
+    int column = 0;
+    int length = 0;
+    Kind kind = Function;
+};
+
+// Replaces deleteCount integers at start of encoded tokens by data, like the edits of
+// textDocument/semanticTokens/full/delta in the Language Server Protocol.
+class SemanticTokensEdit
+{
+public:
+    bool isEmpty() const { return deleteCount == 0 && data.isEmpty(); }
+
+    int start = 0;
+    int deleteCount = 0;
+    QVector<int> data;
+};
+
+class LineRange
+{
+public:
+    int first = 0;
+    int last = -1; // to the end of the document
+};
+
+// What the tokens of the lexical highlighter mean, encoded like the semantic tokens of the
+// Language Server Protocol: five integers per token, the line relative to the previous token, the
+// column relative to the previous token in the same line, the length, the kind and no modifiers.
+// Since positions are relative, tokens only change where the code changed, also when lines are
+// inserted or removed before them.
+class SemanticTokens
+{
+public:
+    // Finds the semantic tokens of the lines, sorted. Variables with one of the names are
+    // functions, the variables bound in the head of a top-level equation are its parameters.
+    static QVector<SemanticToken> fromLines(const QStringList &lines,
+                                            const QSet<QString> &functionNames);
+
+    static QVector<int> encode(const QVector<SemanticToken> &tokens);
+    static QVector<SemanticToken> decode(const QVector<int> &data);
+
+    // Returns the edit that replaces the tokens between the ones that before and after have in
+    // common at their start and end.
+    static SemanticTokensEdit diff(const QVector<int> &before, const QVector<int> &after);
+    static QVector<int> apply(const QVector<int> &data, const SemanticTokensEdit &edit);
+    // The lines with tokens that changed by the edit, which gave the tokens after.
+    static LineRange changedLines(const QVector<SemanticToken> &after,
+                                  const SemanticTokensEdit &edit);
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,234 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "servicestack.h"
+
+#include "haskelltr.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <functional>
+
+namespace Haskell {
+namespace Internal {
+
+QString ServiceSpec::readinessName(Readiness readiness)
+{
+    switch (readiness) {
+    case WhenStarted:
+        return Tr::tr("Started");
+    case WhenOutputMatches:
+        return Tr::tr("Output matches");
+    case WhenPortOpen:
+        return Tr::tr("Port open");
+    case ReadinessCount:
+        break;
+    }
+    return {};
+}
+
+QStringList ServiceSpec::rtsArguments() const
+{
+    return rtsOptions.split(' ', Qt::SkipEmptyParts);
+}
+
+QVariantMap ServiceSpec::toMap() const
+{
+    QVariantMap map;
+    map.insert("Enabled", enabled);
+    map.insert("Executable", executable);
+    map.insert("Tag", tag);
+    map.insert("Arguments", arguments);
+    map.insert("RtsOptions", rtsOptions);
+    map.insert("After", after);
+    map.insert("Readiness", int(readiness));
+    map.insert("ReadyPattern", readyPattern);
+    map.insert("ReadyPort", readyPort);
+    return map;
+}
+
+ServiceSpec ServiceSpec::fromMap(const QVariantMap &map)
+{
+    ServiceSpec spec;
+    spec.enabled = map.value("Enabled", true).toBool();
+    spec.executable = map.value("Executable").toString();
+    spec.tag = map.value("Tag").toString();
+    spec.arguments = map.value("Arguments").toString();
+    spec.rtsOptions = map.value("RtsOptions").toString();
+    spec.after = map.value("After").toStringList();
+    const int readiness = map.value("Readiness", int(WhenStarted)).toInt();
+    spec.readiness = readiness >= 0 && readiness < ReadinessCount ? Readiness(readiness)
+                                                                  : WhenStarted;
+    spec.readyPattern = map.value("ReadyPattern").toString();
+    spec.readyPort = map.value("ReadyPort", 0).toInt();
+    return spec;
+}
+
+bool ServiceSpec::operator==(const ServiceSpec &other) const
+{
+    return enabled == other.enabled && executable == other.executable && tag == other.tag
+           && arguments == other.arguments && rtsOptions == other.rtsOptions
+           && after == other.after && readiness == other.readiness
+           && readyPattern == other.readyPattern && readyPort == other.readyPort;
+}
+
+QVector<ServiceSpec> ServiceStack::enabledServices() const
+{
+    QVector<ServiceSpec> result;
+    for (const ServiceSpec &spec : services) {
+        if (spec.enabled)
+            result.append(spec);
+    }
+    return result;
+}
+
+const ServiceSpec *ServiceStack::service(const QString &name) const
+{
+    for (const ServiceSpec &spec : services) {
+        if (spec.enabled && spec.name() == name)
+            return &spec;
+    }
+    return nullptr;
+}
+
+QStringList ServiceStack::problems() const
+{
+    QStringList result;
+    QSet<QString> names;
+    const QVector<ServiceSpec> enabled = enabledServices();
+    for (const ServiceSpec &spec : enabled) {
+        const QString name = spec.name();
+        if (name.isEmpty()) {
+            result << Tr::tr("A service has no executable.");
+            continue;
+        }
+        if (names.contains(name))
+            result << Tr::tr("There is more than one service named \"%1\".").arg(name);
+        names.insert(name);
+        if (spec.readiness == ServiceSpec::WhenOutputMatches) {
+            // the services that wait for it would never start
+            if (spec.readyPattern.isEmpty())
+                result << Tr::tr("The output pattern of \"%1\" is empty.").arg(name);
+            else if (!QRegularExpression(spec.readyPattern).isValid())
+                result << Tr::tr("The output pattern of \"%1\" is invalid.").arg(name);
+        }
+        if (spec.readiness == ServiceSpec::WhenPortOpen
+            && (spec.readyPort <= 0 || spec.readyPort > 65535)) {
+            result << Tr::tr("The port of \"%1\" is invalid.").arg(name);
+        }
+    }
+
+    // follows the services to wait for, the ones on the path must not come up again
+    enum State { Unvisited, Visiting, Done };
+    QHash<QString, State> states;
+    std::function<bool(const QString &)> hasCycle = [&](const QString &name) {
+        const State state = states.value(name, Unvisited);
+        if (state != Unvisited)
+            return state == Visiting;
+        states.insert(name, Visiting);
+        const ServiceSpec *spec = service(name);
+        for (const QString &dependency : spec ? spec->after : QStringList()) {
+            if (names.contains(dependency) && hasCycle(dependency))
+                return true;
+        }
+        states.insert(name, Done);
+        return false;
+    };
+    for (const ServiceSpec &spec : enabled) {
+        for (const QString &dependency : spec.after) {
+            if (!names.contains(dependency)) {
+                result << Tr::tr("\"%1\" waits for \"%2\", which is not an enabled service.")
+                              .arg(spec.name(), dependency);
+            }
+        }
+        if (hasCycle(spec.name())) {
+            result << Tr::tr("\"%1\" waits for itself through other services.").arg(spec.name());
+            break;
+        }
+    }
+    return result;
+}
+
+QStringList ServiceStack::startable(const QSet<QString> &started, const QSet<QString> &ready) const
+{
+    QStringList result;
+    for (const ServiceSpec &spec : services) {
+        if (!spec.enabled || started.contains(spec.name()))
+            continue;
+        if (std::all_of(spec.after.cbegin(), spec.after.cend(),
+                        [&ready](const QString &name) { return ready.contains(name); })) {
+            result << spec.name();
+        }
+    }
+    return result;
+}
+
+QVariantList ServiceStack::toList() const
+{
+    QVariantList list;
+    for (const ServiceSpec &spec : services)
+        list.append(spec.toMap());
+    return list;
+}
+
+ServiceStack ServiceStack::fromList(const QVariantList &list)
+{
+    ServiceStack stack;
+    for (const QVariant &value : list)
+        stack.services.append(ServiceSpec::fromMap(value.toMap()));
+    return stack;
+}
+
+ServiceOutput::ServiceOutput(const QString &tag, const QString &readyPattern)
+    : m_tag(tag)
+{
+    if (!readyPattern.isEmpty())
+        m_readyPattern.setPattern(readyPattern);
+}
+
+QString ServiceOutput::addOutput(const QString &text)
+{
+    QString result;
+    m_lines.addText(text, [&](const QString &line) { result += addLine(line); });
+    return result;
+}
+
+QString ServiceOutput::finish()
+{
+    QString result;
+    m_lines.finish([&](const QString &line) { result = addLine(line); });
+    return result;
+}
+
+QString ServiceOutput::addLine(const QString &line)
+{
+    if (!m_ready && !m_readyPattern.pattern().isEmpty() && m_readyPattern.match(line).hasMatch())
+        m_ready = true;
+    return '[' + m_tag + "] " + line + '\n';
+}
+
+} // namespace Internal
+} // namespace Haskell
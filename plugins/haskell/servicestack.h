@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "linebuffer.h"
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+// One executable of a service stack.
+class ServiceSpec
+{
+public:
+    enum Readiness { WhenStarted, WhenOutputMatches, WhenPortOpen, ReadinessCount };
+
+    static QString readinessName(Readiness readiness);
+
+    // The tag in front of its output, which other services refer to.
+    QString name() const { return tag.isEmpty() ? executable : tag; }
+    QStringList rtsArguments() const;
+
+    QVariantMap toMap() const;
+    static ServiceSpec fromMap(const QVariantMap &map);
+
+    bool operator==(const ServiceSpec &other) const;
+    bool operator!=(const ServiceSpec &other) const { return !(*this == other); }
+
+    bool enabled = true;
+    QString executable; // the build key
+    QString tag;
+    QString arguments;
+    QString rtsOptions; // passed between +RTS and -RTS
+    QStringList after; // the services that have to be ready before it starts
+    Readiness readiness = WhenStarted;
+    QString readyPattern; // matched against each line of its output
+    int readyPort = 0; // on the local host
+};
+
+// Executables that run together. Services start as soon as the services they wait for are
+// ready, all others start at once.
+class ServiceStack
+{
+public:
+    QVector<ServiceSpec> enabledServices() const;
+    const ServiceSpec *service(const QString &name) const;
+
+    // Duplicate names, services to wait for that are unknown, disabled or wait for the service
+    // themselves, and invalid readiness conditions.
+    QStringList problems() const;
+    // The enabled services that did not start yet and whose services to wait for are ready.
+    QStringList startable(const QSet<QString> &started, const QSet<QString> &ready) const;
+
+    QVariantList toList() const;
+    static ServiceStack fromList(const QVariantList &list);
+
+    bool operator==(const ServiceStack &other) const { return services == other.services; }
+    bool operator!=(const ServiceStack &other) const { return !(*this == other); }
+
+    QVector<ServiceSpec> services;
+};
+
+// The output of one service for the combined output: complete lines with the tag of the service
+// in front. Also tells whether a line matched the pattern that makes the service ready.
+class ServiceOutput
+{
+public:
+    explicit ServiceOutput(const QString &tag, const QString &readyPattern = {});
+
+    QString addOutput(const QString &text);
+    QString finish();
+
+    bool isReady() const { return m_ready; }
+
+private:
+    QString addLine(const QString &line);
+
+    QString m_tag;
+    QRegularExpression m_readyPattern;
+    LineBuffer m_lines;
+    bool m_ready = false;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "sourcefingerprint.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+namespace Haskell {
+namespace Internal {
+
+void SourceFingerprint::setExcludedDirectories(const QStringList &directories)
+{
+    m_excludedDirectories.clear();
+    for (const QString &directory : directories)
+        m_excludedDirectories.append(QDir::cleanPath(directory));
+}
+
+QByteArray SourceFingerprint::compute(const QString &directory, const QByteArray &salt)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(salt);
+    scan(QDir::cleanPath(directory), &hash);
+    const QStringList packages = externalPackages(directory);
+    for (const QString &package : packages) {
+        hash.addData(package.toUtf8() + '\n');
+        scan(package, &hash);
+    }
+    return hash.result().toHex();
+}
+
+QByteArray SourceFingerprint::outputs(const QStringList &paths)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString &path : paths) {
+        const QFileInfo fi(path);
+        hash.addData(path.toUtf8() + ':');
+        if (!fi.exists()) {
+            hash.addData("-\n");
+            continue;
+        }
+        hash.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()) + '\n');
+        const QFileInfoList entries = QDir(path).entryInfoList(QDir::AllEntries
+                                                                   | QDir::NoDotAndDotDot,
+                                                               QDir::Name);
+        for (const QFileInfo &entry : entries) {
+            hash.addData(entry.fileName().toUtf8() + ':' + QByteArray::number(entry.size()) + ':'
+                         + QByteArray::number(entry.lastModified().toMSecsSinceEpoch()) + '\n');
+        }
+    }
+    return hash.result().toHex();
+}
+
+QStringList SourceFingerprint::externalPackages(const QString &directory)
+{
+    QFile file(directory + "/stack.yaml");
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    // only the plain path entries of the two lists, e.g. "- ../shared", are local
+    static const QRegularExpression key(R"(^([A-Za-z-]+):)");
+    static const QRegularExpression item(R"(^\s*-\s*["']?(\.{1,2}/[^"'#\s]*|/[^"'#\s]*))");
+    const QString root = QDir::cleanPath(directory);
+    QStringList packages;
+    bool inList = false;
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    for (const QString &line : lines) {
+        const QRegularExpressionMatch keyMatch = key.match(line);
+        if (keyMatch.hasMatch()) {
+            inList = keyMatch.captured(1) == "packages" || keyMatch.captured(1) == "extra-deps";
+            continue;
+        }
+        const QRegularExpressionMatch itemMatch = item.match(line);
+        if (!inList || !itemMatch.hasMatch())
+            continue;
+        const QString package = QDir::cleanPath(QDir(root).absoluteFilePath(itemMatch.captured(1)));
+        if (package != root && !package.startsWith(root + '/') && !packages.contains(package))
+            packages.append(package);
+    }
+    return packages;
+}
+
+bool SourceFingerprint::isSourceFile(const QString &fileName)
+{
+    static const QStringList fileNames = {"stack.yaml",
+                                          "stack.yaml.lock",
+                                          "package.yaml",
+                                          "cabal.project",
+                                          "cabal.project.local",
+                                          "cabal.project.freeze"};
+    static const QStringList suffixes = {"hs", "lhs", "hs-boot", "hsc", "chs", "x", "y",
+                                         "cabal", "c", "h"};
+    if (fileNames.contains(fileName))
+        return true;
+    const int dot = fileName.lastIndexOf('.');
+    return dot > 0 && suffixes.contains(fileName.mid(dot + 1));
+}
+
+QByteArray SourceFingerprint::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll().trimmed();
+}
+
+bool SourceFingerprint::save(const QString &filePath, const QByteArray &fingerprint)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(fingerprint + '\n');
+    return file.commit();
+}
+
+void SourceFingerprint::scan(const QString &directory, QCryptographicHash *hash)
+{
+    // copy, scanning subdirectories can rehash m_listings
+    const Listing entries = listing(directory);
+    // stat even if the listing was cached, an edit in place leaves the directory as it was
+    for (const QString &fileName : entries.files) {
+        const QFileInfo fi(directory + '/' + fileName);
+        if (!fi.exists())
+            continue;
+        hash->addData(fi.filePath().toUtf8());
+        hash->addData(QByteArray::number(fi.size()) + ':'
+                      + QByteArray::number(fi.lastModified().toMSecsSinceEpoch()) + '\n');
+    }
+    for (const QString &subDirectory : entries.directories)
+        scan(directory + '/' + subDirectory, hash);
+}
+
+const SourceFingerprint::Listing &SourceFingerprint::listing(const QString &directory)
+{
+    // adding, removing or renaming entries changes the modification time of the directory
+    const qint64 lastModified = QFileInfo(directory).lastModified().toMSecsSinceEpoch();
+    Listing &listing = m_listings[directory];
+    if (listing.lastModified == lastModified)
+        return listing;
+    listing = {};
+    listing.lastModified = lastModified;
+    const QDir dir(directory);
+    const QFileInfoList entries = dir.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot,
+                                                    QDir::Name);
+    for (const QFileInfo &entry : entries) {
+        if (entry.isDir()) {
+            if (!entry.fileName().startsWith('.') && !entry.isSymLink()
+                    && !m_excludedDirectories.contains(entry.filePath())) {
+                listing.directories.append(entry.fileName());
+            }
+        } else if (isSourceFile(entry.fileName())) {
+            listing.files.append(entry.fileName());
+        }
+    }
+    return listing;
+}
+
+} // namespace Internal
+} // namespace Haskell
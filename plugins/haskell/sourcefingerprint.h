@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QCryptographicHash;
+QT_END_NAMESPACE
+
+namespace Haskell {
+namespace Internal {
+
+// Fingerprints the sources of a stack project from the names, sizes and modification times of
+// its Haskell sources, package manifests and stack.yaml / lock files. Local packages and
+// dependencies that stack.yaml lists outside of the project are scanned as well.
+// Directory listings are cached and only read again when the directory's modification time
+// changes. This saves reading and filtering the directories, not the stat of each source file:
+// writing to a file in place does not change the modification time of its directory.
+class SourceFingerprint
+{
+public:
+    // Absolute paths of directories that are not scanned, e.g. the build directory.
+    // Hidden directories like .stack-work and .git are never scanned.
+    void setExcludedDirectories(const QStringList &directories);
+
+    // The salt is added to the fingerprint, e.g. for the build command line.
+    QByteArray compute(const QString &directory, const QByteArray &salt = {});
+
+    // Fingerprints whether the given files or directories exist, when they were modified, and
+    // the entries of the directories, so deleting build outputs changes the result.
+    static QByteArray outputs(const QStringList &paths);
+    // Absolute paths of the local packages and dependencies in stack.yaml that are outside of
+    // the directory.
+    static QStringList externalPackages(const QString &directory);
+    static bool isSourceFile(const QString &fileName);
+    static QByteArray load(const QString &filePath);
+    static bool save(const QString &filePath, const QByteArray &fingerprint);
+
+private:
+    class Listing
+    {
+    public:
+        qint64 lastModified = -1;
+        QStringList directories;
+        QStringList files;
+    };
+
+    void scan(const QString &directory, QCryptographicHash *hash);
+    const Listing &listing(const QString &directory);
+
+    QHash<QString, Listing> m_listings;
+    QStringList m_excludedDirectories;
+};
+
+} // namespace Internal
+} // namespace Haskell
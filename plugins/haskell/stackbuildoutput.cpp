@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "stackbuildoutput.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QRegularExpression>
+
+namespace Haskell {
+namespace Internal {
+
+StackBuildOutput::StackBuildOutput() = default;
+
+StackBuildOutput::~StackBuildOutput()
+{
+    m_spillFile.close();
+}
+
+bool StackBuildOutput::openSpillFile(const QString &filePath)
+{
+    m_spillFile.close();
+    m_spillFile.setFileName(filePath);
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    return m_spillFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+bool StackBuildOutput::addOutput(const QString &text, Channel channel)
+{
+    if (m_spillFile.isOpen())
+        m_spillFile.write(text.toUtf8());
+    m_lines[int(channel)].addText(text, [this, channel](const QString &line) {
+        if (m_lineHandler)
+            m_lineHandler(line);
+        // keep only the last of consecutive progress lines
+        if (!m_pendingLines.isEmpty() && m_pendingLines.last().channel == channel
+                && isProgressLine(line) && isProgressLine(m_pendingLines.last().text)) {
+            m_pendingLines.last().text = line;
+        } else {
+            m_pendingLines.append({channel, line});
+        }
+    });
+    if (m_pendingLines.size() > m_maximumPendingLines) {
+        const int drop = m_pendingLines.size() - m_maximumPendingLines;
+        m_pendingLines.erase(m_pendingLines.begin(), m_pendingLines.begin() + drop);
+        m_droppedLines += drop;
+    }
+    return !m_pendingLines.isEmpty();
+}
+
+QList<StackBuildOutput::Chunk> StackBuildOutput::takePending()
+{
+    QList<Chunk> result;
+    if (m_droppedLines > 0) {
+        result.append({Channel::StdOut,
+                       QCoreApplication::translate("Haskell::Internal::StackBuildStep",
+                                                   "[%n line(s) not shown, the full log is in %1]",
+                                                   nullptr,
+                                                   m_droppedLines)
+                               .arg(QDir::toNativeSeparators(m_spillFile.fileName()))
+                           + '\n'});
+        m_droppedLines = 0;
+    }
+    for (const Line &line : std::as_const(m_pendingLines)) {
+        if (result.isEmpty() || result.last().channel != line.channel)
+            result.append({line.channel, {}});
+        result.last().text += line.text + '\n';
+    }
+    m_pendingLines.clear();
+    return result;
+}
+
+void StackBuildOutput::finish()
+{
+    if (m_lines[int(Channel::StdOut)].hasIncompleteLine())
+        addOutput("\n", Channel::StdOut);
+    if (m_lines[int(Channel::StdErr)].hasIncompleteLine())
+        addOutput("\n", Channel::StdErr);
+    m_spillFile.close();
+}
+
+bool StackBuildOutput::isProgressLine(QStringView line)
+{
+    static const QRegularExpression compiling(R"(^\[\s*\d+ of \d+\] Compiling )");
+    static const QLatin1String progressPrefixes[] = {QLatin1String("Building "),
+                                                     QLatin1String("Preprocessing "),
+                                                     QLatin1String("Configuring "),
+                                                     QLatin1String("Installing "),
+                                                     QLatin1String("Registering "),
+                                                     QLatin1String("Linking ")};
+    // stack prefixes the output of parallel package builds with "package> "
+    const int prefixEnd = line.indexOf(QLatin1String("> "));
+    if (prefixEnd > 0 && !line.left(prefixEnd).contains(' '))
+        line = line.mid(prefixEnd + 2);
+    if (line.startsWith('['))
+        return compiling.match(line.toString()).hasMatch();
+    for (const QLatin1String &prefix : progressPrefixes) {
+        if (line.startsWith(prefix))
+            return true;
+    }
+    return false;
+}
+
+} // namespace Internal
+} // namespace Haskell
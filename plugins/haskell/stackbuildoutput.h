@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "linebuffer.h"
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+namespace Haskell {
+namespace Internal {
+
+// Batches the output of stack builds for the compile output pane.
+// Everything is written to a spill file, while only a bounded window of lines is kept in memory
+// until it is taken for display. Runs of progress lines like "[12 of 340] Compiling Foo" are
+// collapsed to their last line.
+class StackBuildOutput
+{
+public:
+    enum class Channel { StdOut, StdErr };
+
+    class Chunk
+    {
+    public:
+        Channel channel = Channel::StdOut;
+        QString text;
+    };
+
+    StackBuildOutput();
+    ~StackBuildOutput();
+
+    bool openSpillFile(const QString &filePath);
+    QString spillFilePath() const { return m_spillFile.fileName(); }
+    void setMaximumPendingLines(int lines) { m_maximumPendingLines = lines; }
+    // Called for every complete line, before progress lines are collapsed.
+    void setLineHandler(const std::function<void(const QString &)> &handler)
+    {
+        m_lineHandler = handler;
+    }
+
+    // Returns true if complete lines are pending.
+    bool addOutput(const QString &text, Channel channel);
+    // Returns the pending lines, joined to chunks of consecutive lines from the same channel.
+    QList<Chunk> takePending();
+    // Treats incomplete last lines as complete and closes the spill file.
+    void finish();
+
+    static bool isProgressLine(QStringView line);
+
+private:
+    class Line
+    {
+    public:
+        Channel channel;
+        QString text;
+    };
+
+    QFile m_spillFile;
+    std::function<void(const QString &)> m_lineHandler;
+    QList<Line> m_pendingLines;
+    LineBuffer m_lines[2];
+    int m_maximumPendingLines = 5000;
+    int m_droppedLines = 0;
+};
+
+} // namespace Internal
+} // namespace Haskell
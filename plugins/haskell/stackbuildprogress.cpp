@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "stackbuildprogress.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+// removes the version from dependencies like "text-1.2.4.1"
+static QString packageName(const QString &packageId)
+{
+    static const QRegularExpression version(R"(-[\d.]+$)");
+    return QString(packageId).remove(version);
+}
+
+void StackBuildProgress::setModuleTimings(const QHash<QString, qint64> &timings)
+{
+    m_timings = timings;
+    m_previousTimings.clear();
+    for (auto it = timings.cbegin(); it != timings.cend(); ++it) {
+        const int separator = it.key().indexOf(':');
+        if (separator > 0)
+            m_previousTimings[it.key().left(separator)].insert(it.key().mid(separator + 1), it.value());
+    }
+}
+
+void StackBuildProgress::addLine(QStringView line, qint64 timestamp)
+{
+    // [ 3 of 12] Compiling Foo.Bar ( src/Foo/Bar.hs, ... )
+    static const QRegularExpression compiling(
+        R"(^(?:(\S+)> )?\[\s*(\d+) of (\d+)\] Compiling (\S+))");
+    // text> configure, text-1.2.4.1: copy/register, simple> build (lib + exe)
+    static const QRegularExpression status(
+        R"(^(\S+?)(?:> |: )(configure|build|copy/register)(?: |$))");
+    // Building library for simple-0.1.0.0..
+    static const QRegularExpression building(
+        R"(^(?:\S+> )?Building (?:library|executable|test suite|benchmark|sub-library) (?:'\S+' )?for (\S+?)\.\.)");
+
+    if (!line.contains(' '))
+        return;
+    const QString text = line.toString();
+    QRegularExpressionMatch match = compiling.match(text);
+    if (match.hasMatch()) {
+        const QString name = match.captured(1).isEmpty() ? m_currentPackage
+                                                         : packageName(match.captured(1));
+        Package &package = m_packages[name];
+        finishModule(name, package, timestamp);
+        // modules that are up to date are skipped, and with -j lines can come out of order
+        package.compiledModules = std::max(package.compiledModules, match.captured(2).toInt() - 1);
+        package.totalModules = match.captured(3).toInt();
+        package.currentModule = match.captured(4);
+        package.currentModuleStart = timestamp;
+        package.modules.insert(package.currentModule);
+        return;
+    }
+    match = status.match(text);
+    if (match.hasMatch()) {
+        const QString name = packageName(match.captured(1));
+        Package &package = m_packages[name];
+        if (match.captured(2) == "copy/register") {
+            finishModule(name, package, timestamp);
+            package.finished = true;
+        }
+        return;
+    }
+    match = building.match(text);
+    if (match.hasMatch()) {
+        m_currentPackage = packageName(match.captured(1));
+        m_packages[m_currentPackage];
+    }
+}
+
+void StackBuildProgress::finish(qint64 timestamp)
+{
+    for (auto it = m_packages.begin(); it != m_packages.end(); ++it) {
+        finishModule(it.key(), it.value(), timestamp);
+        it->finished = true;
+    }
+}
+
+int StackBuildProgress::percent() const
+{
+    if (m_packages.isEmpty())
+        return 0;
+    double done = 0;
+    for (const Package &package : m_packages) {
+        if (package.finished)
+            done += 1;
+        else if (package.totalModules > 0)
+            done += double(package.compiledModules) / package.totalModules;
+    }
+    return int(100 * done / m_packages.size());
+}
+
+qint64 StackBuildProgress::estimatedRemainingTime() const
+{
+    qint64 remaining = 0;
+    int building = 0;
+    bool known = false;
+    for (auto it = m_packages.cbegin(); it != m_packages.cend(); ++it) {
+        if (it->finished)
+            continue;
+        if (!it->currentModule.isEmpty())
+            ++building;
+        const qint64 packageRemaining = remainingTime(it.key(), it.value());
+        if (packageRemaining >= 0) {
+            remaining += packageRemaining;
+            known = true;
+        }
+    }
+    if (!known)
+        return -1;
+    // packages that build in parallel share the remaining time
+    return remaining / std::max(building, 1);
+}
+
+int StackBuildProgress::finishedPackages() const
+{
+    return int(std::count_if(m_packages.cbegin(), m_packages.cend(), [](const Package &p) {
+        return p.finished;
+    }));
+}
+
+QHash<QString, qint64> StackBuildProgress::loadModuleTimings(const QString &filePath)
+{
+    QHash<QString, qint64> result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return result;
+    const QJsonObject timings = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = timings.constBegin(); it != timings.constEnd(); ++it)
+        result.insert(it.key(), qint64(it.value().toDouble()));
+    return result;
+}
+
+bool StackBuildProgress::saveModuleTimings(const QString &filePath,
+                                           const QHash<QString, qint64> &timings)
+{
+    QJsonObject object;
+    for (auto it = timings.cbegin(); it != timings.cend(); ++it)
+        object.insert(it.key(), double(it.value()));
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+void StackBuildProgress::finishModule(const QString &packageName, Package &package,
+                                      qint64 timestamp)
+{
+    if (package.currentModule.isEmpty())
+        return;
+    m_timings.insert(packageName + ':' + package.currentModule,
+                     timestamp - package.currentModuleStart);
+    ++package.compiledModules;
+    package.currentModule.clear();
+}
+
+qint64 StackBuildProgress::remainingTime(const QString &packageName, const Package &package) const
+{
+    // modules that compiled in the previous build and did not start in this one yet, the module
+    // that is compiling now is not counted
+    const QHash<QString, qint64> previous = m_previousTimings.value(packageName);
+    if (!previous.isEmpty()) {
+        qint64 remaining = 0;
+        for (auto it = previous.cbegin(); it != previous.cend(); ++it) {
+            if (!package.modules.contains(it.key()))
+                remaining += it.value();
+        }
+        return remaining;
+    }
+    if (package.totalModules <= 0 || package.compiledModules <= 0)
+        return -1;
+    // no history, extrapolate from the modules of this build
+    qint64 spent = 0;
+    int count = 0;
+    for (auto it = m_timings.cbegin(); it != m_timings.cend(); ++it) {
+        if (it.key().startsWith(packageName + ':')) {
+            spent += it.value();
+            ++count;
+        }
+    }
+    if (count == 0)
+        return -1;
+    return spent / count * (package.totalModules - package.compiledModules);
+}
+
+} // namespace Internal
+} // namespace Haskell
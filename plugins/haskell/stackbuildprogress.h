@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+namespace Haskell {
+namespace Internal {
+
+// Tracks the progress of a stack build from its output.
+// Modules are counted from GHC's "[N of M] Compiling Module" lines, packages from stack's
+// "package> build" and "package> copy/register" status lines. Several packages can build in
+// parallel. The time each module took to compile is recorded, and timings from a previous build
+// are used to estimate the remaining time.
+class StackBuildProgress
+{
+public:
+    // Timings in milliseconds, keyed by "package:Module".
+    void setModuleTimings(const QHash<QString, qint64> &timings);
+    QHash<QString, qint64> moduleTimings() const { return m_timings; }
+
+    void addLine(QStringView line, qint64 timestamp);
+    void finish(qint64 timestamp);
+
+    int percent() const;
+    // Returns -1 if there is nothing to base an estimate on.
+    qint64 estimatedRemainingTime() const;
+
+    int startedPackages() const { return m_packages.size(); }
+    int finishedPackages() const;
+
+    static QHash<QString, qint64> loadModuleTimings(const QString &filePath);
+    static bool saveModuleTimings(const QString &filePath, const QHash<QString, qint64> &timings);
+
+private:
+    class Package
+    {
+    public:
+        int compiledModules = 0;
+        int totalModules = 0;
+        bool finished = false;
+        QString currentModule;
+        qint64 currentModuleStart = 0;
+        QSet<QString> modules;
+    };
+
+    void finishModule(const QString &packageName, Package &package, qint64 timestamp);
+    qint64 remainingTime(const QString &packageName, const Package &package) const;
+
+    QHash<QString, Package> m_packages;
+    QHash<QString, qint64> m_timings;
+    QHash<QString, QHash<QString, qint64>> m_previousTimings; // package -> module -> time
+    QString m_currentPackage; // for output without a "package> " prefix
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -25,6 +25,7 @@
 
 #include "stackbuildstep.h"
 
+#include "haskellbuildconfiguration.h"
 #include "haskellconstants.h"
 #include "haskellmanager.h"
 
@@ -33,6 +34,9 @@
 #include <projectexplorer/project.h>
 #include <projectexplorer/projectexplorerconstants.h>
 
+#include <utils/aspects.h>
+#include <utils/runextensions.h>
+
 using namespace ProjectExplorer;
 
 namespace Haskell {
@@ -42,11 +46,28 @@ StackBuildStep::StackBuildStep(ProjectExplorer::BuildStepList *bsl, Utils::Id id
     : AbstractProcessStep(bsl, id)
 {
     setDefaultDisplayName(trDisplayName());
-}
 
-QWidget *StackBuildStep::createConfigWidget()
-{
-    return new QWidget;
+    m_forceBuild = addAspect<Utils::BoolAspect>();
+    m_forceBuild->setSettingsKey("Haskell.StackBuildStep.ForceBuild");
+    m_forceBuild->setLabel(tr("Always run stack build"),
+                           Utils::BoolAspect::LabelPlacement::AtCheckBox);
+    m_forceBuild->setToolTip(tr("Runs \"stack build\" even if no source file, package "
+                                "description or stack.yaml changed since the last successful "
+                                "build."));
+
+    // batch output, so huge builds don't flood the compile output pane line by line
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(100);
+    connect(&m_flushTimer, &QTimer::timeout, this, &StackBuildStep::flushBuildOutput);
+    m_buildOutput.setLineHandler([this](const QString &line) {
+        m_progress.addLine(line, m_buildTimer.elapsed());
+    });
+
+    m_sourceFingerprint = std::make_shared<SourceFingerprint>();
+    connect(&m_fingerprintWatcher, &QFutureWatcherBase::finished, this, [this] {
+        if (!m_fingerprintWatcher.isCanceled())
+            startBuild(m_fingerprintWatcher.result());
+    });
 }
 
 QString StackBuildStep::trDisplayName()
@@ -66,6 +87,162 @@ bool StackBuildStep::init()
     return true;
 }
 
+void StackBuildStep::doRun()
+{
+    // scanning the sources stats every file of the project, which takes a while on big ones
+    const std::shared_ptr<SourceFingerprint> sourceFingerprint = m_sourceFingerprint;
+    sourceFingerprint->setExcludedDirectories({buildDirectory().toString()});
+    const QString projectDirectory = project()->projectDirectory().toString();
+    const QByteArray salt = fingerprintSalt();
+    const QStringList outputs = outputPaths();
+    m_fingerprintWatcher.setFuture(Utils::runAsync([=] {
+        Fingerprint fingerprint;
+        fingerprint.sources = sourceFingerprint->compute(projectDirectory, salt);
+        if (!outputs.isEmpty())
+            fingerprint.outputs = SourceFingerprint::outputs(outputs);
+        return fingerprint;
+    }));
+}
+
+void StackBuildStep::doCancel()
+{
+    if (m_fingerprintWatcher.isRunning()) {
+        m_fingerprintWatcher.cancel();
+        // the canceled scan keeps using the old cache until it returns
+        m_sourceFingerprint = std::make_shared<SourceFingerprint>();
+        emit finished(false);
+        return;
+    }
+    AbstractProcessStep::doCancel();
+}
+
+void StackBuildStep::startBuild(const Fingerprint &fingerprint)
+{
+    const QString fingerprintFile = sourceFingerprintFile(buildDirectory());
+    m_fingerprint = fingerprint.sources;
+    // deleted or cleaned build outputs need a build, even if the sources did not change
+    if (!m_forceBuild->value() && !fingerprint.outputs.isEmpty()
+            && fingerprint.sources + '\n' + fingerprint.outputs
+                   == SourceFingerprint::load(fingerprintFile)) {
+        emit addOutput(tr("Nothing changed since the last successful build, "
+                          "skipping \"stack build\"."),
+                       OutputFormat::NormalMessage);
+        emit progress(100, {});
+        emit finished(true);
+        return;
+    }
+    // a failed or canceled build must not leave the previous fingerprint behind
+    QFile::remove(fingerprintFile);
+
+    const Utils::FilePath buildLog = buildDirectory().pathAppended("qtc-stack-build.log");
+    m_hasBuildLog = m_buildOutput.openSpillFile(buildLog.toString());
+    if (!m_hasBuildLog) {
+        emit addOutput(tr("Cannot write build log \"%1\".").arg(buildLog.toUserOutput()),
+                       OutputFormat::ErrorMessage);
+    }
+
+    m_progress = {};
+    m_progress.setModuleTimings(StackBuildProgress::loadModuleTimings(moduleTimingsFile()));
+    m_buildTimer.start();
+    emit progress(0, {});
+
+    AbstractProcessStep::doRun();
+}
+
+void StackBuildStep::stdOutput(const QString &output)
+{
+    addBuildOutput(output, StackBuildOutput::Channel::StdOut);
+}
+
+void StackBuildStep::stdError(const QString &output)
+{
+    addBuildOutput(output, StackBuildOutput::Channel::StdErr);
+}
+
+void StackBuildStep::finish(Utils::ProcessResult result)
+{
+    m_flushTimer.stop();
+    m_buildOutput.finish();
+    flushBuildOutput();
+    if (result == Utils::ProcessResult::FinishedWithSuccess) {
+        m_progress.finish(m_buildTimer.elapsed());
+        StackBuildProgress::saveModuleTimings(moduleTimingsFile(), m_progress.moduleTimings());
+        // only lists two directories, unlike the scan of the sources
+        const QStringList outputs = outputPaths();
+        if (!outputs.isEmpty()) {
+            SourceFingerprint::save(sourceFingerprintFile(buildDirectory()),
+                                    m_fingerprint + '\n' + SourceFingerprint::outputs(outputs));
+        }
+        // the old paths stay valid while the new ones are queried
+        if (auto bc = qobject_cast<HaskellBuildConfiguration *>(buildConfiguration()))
+            bc->updateStackPaths();
+    }
+    if (m_hasBuildLog) {
+        emit addOutput(tr("Full build log: %1")
+                           .arg(QDir::toNativeSeparators(m_buildOutput.spillFilePath())),
+                       OutputFormat::NormalMessage);
+    }
+    AbstractProcessStep::finish(result);
+}
+
+void StackBuildStep::addBuildOutput(const QString &text, StackBuildOutput::Channel channel)
+{
+    if (m_buildOutput.addOutput(text, channel) && !m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void StackBuildStep::flushBuildOutput()
+{
+    const QList<StackBuildOutput::Chunk> chunks = m_buildOutput.takePending();
+    for (const StackBuildOutput::Chunk &chunk : chunks) {
+        emit addOutput(chunk.text,
+                       chunk.channel == StackBuildOutput::Channel::StdOut ? OutputFormat::Stdout
+                                                                          : OutputFormat::Stderr,
+                       DontAppendNewline);
+    }
+    reportProgress();
+}
+
+void StackBuildStep::reportProgress()
+{
+    QString message = tr("%1 of %2 packages built")
+                          .arg(m_progress.finishedPackages())
+                          .arg(m_progress.startedPackages());
+    const qint64 remaining = m_progress.estimatedRemainingTime();
+    if (remaining >= 0)
+        message += tr(", about %n second(s) left", nullptr, int(remaining / 1000) + 1);
+    emit progress(m_progress.percent(), message);
+}
+
+QString StackBuildStep::moduleTimingsFile() const
+{
+    return buildDirectory().pathAppended("qtc-module-timings.json").toString();
+}
+
+QString StackBuildStep::sourceFingerprintFile(const Utils::FilePath &buildDirectory)
+{
+    return buildDirectory.pathAppended("qtc-source-fingerprint").toString();
+}
+
+QStringList StackBuildStep::outputPaths() const
+{
+    // "stack clean" deletes the dist directory, the executables are installed to bin
+    auto bc = qobject_cast<HaskellBuildConfiguration *>(buildConfiguration());
+    const StackPaths paths = bc ? bc->stackPaths() : StackPaths();
+    if (paths.localInstallRoot.isEmpty())
+        return {};
+    return {project()->projectDirectory().resolvePath(paths.distDirectory).toString(),
+            paths.localInstallRoot.pathAppended("bin").toString()};
+}
+
+QByteArray StackBuildStep::fingerprintSalt() const
+{
+    // changing the command line or the build environment needs a new build as well
+    const ProcessParameters *params = processParameters();
+    return (params->command().toUserOutput() + '\n'
+            + params->environment().toStringList().join('\n')).toUtf8();
+}
+
 StackBuildStepFactory::StackBuildStepFactory()
 {
     registerStep<StackBuildStep>(Constants::C_STACK_BUILD_STEP_ID);
@@ -73,5 +250,41 @@ StackBuildStepFactory::StackBuildStepFactory()
     setSupportedStepList(ProjectExplorer::Constants::BUILDSTEPS_BUILD);
 }
 
+StackCleanStep::StackCleanStep(ProjectExplorer::BuildStepList *bsl, Utils::Id id)
+    : AbstractProcessStep(bsl, id)
+{
+    setDefaultDisplayName(trDisplayName());
+}
+
+QString StackCleanStep::trDisplayName()
+{
+    return tr("Stack Clean");
+}
+
+bool StackCleanStep::init()
+{
+    if (AbstractProcessStep::init()) {
+        const auto projectDir = QDir(project()->projectDirectory().toString());
+        processParameters()->setCommandLine(
+            {HaskellManager::stackExecutable(),
+             {"clean", "--work-dir", projectDir.relativeFilePath(buildDirectory().toString())}});
+        processParameters()->setEnvironment(buildEnvironment());
+    }
+    return true;
+}
+
+void StackCleanStep::doRun()
+{
+    QFile::remove(StackBuildStep::sourceFingerprintFile(buildDirectory()));
+    AbstractProcessStep::doRun();
+}
+
+StackCleanStepFactory::StackCleanStepFactory()
+{
+    registerStep<StackCleanStep>(Constants::C_STACK_CLEAN_STEP_ID);
+    setDisplayName(StackCleanStep::trDisplayName());
+    setSupportedStepList(ProjectExplorer::Constants::BUILDSTEPS_CLEAN);
+}
+
 } // namespace Internal
 } // namespace Haskell
@@ -25,8 +25,20 @@
 
 #pragma once
 
+#include "sourcefingerprint.h"
+#include "stackbuildoutput.h"
+#include "stackbuildprogress.h"
+
 #include <projectexplorer/abstractprocessstep.h>
 
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QTimer>
+
+#include <memory>
+
+namespace Utils { class BoolAspect; }
+
 namespace Haskell {
 namespace Internal {
 
@@ -37,12 +49,43 @@ class StackBuildStep : public ProjectExplorer::AbstractProcessStep
 public:
     StackBuildStep(ProjectExplorer::BuildStepList *bsl, Utils::Id id);
 
-    QWidget *createConfigWidget() override;
-
     static QString trDisplayName();
+    static QString sourceFingerprintFile(const Utils::FilePath &buildDirectory);
 
 protected:
     bool init() override;
+    void doRun() override;
+    void doCancel() override;
+    void stdOutput(const QString &output) override;
+    void stdError(const QString &output) override;
+    void finish(Utils::ProcessResult result) override;
+
+private:
+    class Fingerprint
+    {
+    public:
+        QByteArray sources;
+        QByteArray outputs; // empty if the outputs are not known yet
+    };
+
+    void startBuild(const Fingerprint &fingerprint);
+    QStringList outputPaths() const;
+    void addBuildOutput(const QString &text, StackBuildOutput::Channel channel);
+    void flushBuildOutput();
+    void reportProgress();
+    QString moduleTimingsFile() const;
+    QByteArray fingerprintSalt() const;
+
+    StackBuildOutput m_buildOutput;
+    StackBuildProgress m_progress;
+    QElapsedTimer m_buildTimer;
+    QTimer m_flushTimer;
+    bool m_hasBuildLog = false;
+    // shared with the scan in the worker thread, which can outlive a canceled step
+    std::shared_ptr<SourceFingerprint> m_sourceFingerprint;
+    QFutureWatcher<Fingerprint> m_fingerprintWatcher;
+    QByteArray m_fingerprint;
+    Utils::BoolAspect *m_forceBuild = nullptr;
 };
 
 class StackBuildStepFactory : public ProjectExplorer::BuildStepFactory
@@ -51,5 +94,26 @@ public:
     StackBuildStepFactory();
 };
 
+// Runs "stack clean", and makes the next build run "stack build" even if it fails.
+class StackCleanStep : public ProjectExplorer::AbstractProcessStep
+{
+    Q_OBJECT
+
+public:
+    StackCleanStep(ProjectExplorer::BuildStepList *bsl, Utils::Id id);
+
+    static QString trDisplayName();
+
+protected:
+    bool init() override;
+    void doRun() override;
+};
+
+class StackCleanStepFactory : public ProjectExplorer::BuildStepFactory
+{
+public:
+    StackCleanStepFactory();
+};
+
 } // namespace Internal
 } // namespace Haskell
@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "stackpaths.h"
+
+#include <utils/algorithm.h>
+#include <utils/hostosinfo.h>
+
+#include <QDir>
+#include <QRegularExpression>
+
+namespace Haskell {
+namespace Internal {
+
+QStringList StackPaths::arguments()
+{
+    return {"path",
+            "--local-install-root",
+            "--bin-path",
+            "--dist-dir",
+            "--ghc-package-path",
+            "--local-pkg-db",
+            "--snapshot-pkg-db"};
+}
+
+StackPaths StackPaths::fromOutput(const QString &output)
+{
+    // with several keys, "stack path" prints "key: value" lines
+    StackPaths paths;
+    const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        const int separator = line.indexOf(": ");
+        if (separator < 0)
+            continue;
+        const QString name = line.left(separator);
+        const QString value = line.mid(separator + 2).trimmed();
+        if (name == "local-install-root")
+            paths.localInstallRoot = Utils::FilePath::fromUserInput(value);
+        else if (name == "bin-path")
+            paths.binPath = value.split(Utils::HostOsInfo::pathListSeparator(), Qt::SkipEmptyParts);
+        else if (name == "dist-dir")
+            paths.distDirectory = value;
+        else if (name == "ghc-package-path")
+            paths.ghcPackagePath = value;
+        else if (name == "local-pkg-db")
+            paths.localPackageDatabase = value;
+        else if (name == "snapshot-pkg-db")
+            paths.snapshotPackageDatabase = value;
+    }
+    return paths;
+}
+
+Utils::FilePath StackPaths::executable(const QString &name) const
+{
+    if (localInstallRoot.isEmpty())
+        return {};
+    const Utils::FilePath binary = localInstallRoot.pathAppended(
+        "bin/" + Utils::HostOsInfo::withExecutableSuffix(name));
+    return binary.isExecutableFile() ? binary : Utils::FilePath();
+}
+
+Utils::FilePath StackPaths::buildExecutable(const Utils::FilePath &projectDirectory,
+                                            const QString &component) const
+{
+    if (distDirectory.isEmpty())
+        return {};
+    const QString fileName = Utils::HostOsInfo::withExecutableSuffix(component);
+    const Utils::FilePath binary = projectDirectory.resolvePath(distDirectory)
+                                       .pathAppended("build/" + component + '/' + fileName);
+    return binary.isExecutableFile() ? binary : Utils::FilePath();
+}
+
+QHash<QString, Utils::FilePath> StackPaths::dataDirectories() const
+{
+    // Cabal installs the data files to share/<platform>/<package>-<version>
+    static const QRegularExpression packageId("^(.+)-\\d+(\\.\\d+)*$");
+    QHash<QString, Utils::FilePath> result;
+    if (localInstallRoot.isEmpty())
+        return result;
+    const QDir share(localInstallRoot.pathAppended("share").toString());
+    for (const QString &platform : share.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QDir platformDir(share.filePath(platform));
+        for (const QString &package : platformDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            const QRegularExpressionMatch match = packageId.match(package);
+            if (!match.hasMatch())
+                continue;
+            const QString name = match.captured(1).replace('-', '_') + "_datadir";
+            result.insert(name, Utils::FilePath::fromString(platformDir.filePath(package)));
+        }
+    }
+    return result;
+}
+
+void StackPaths::addToEnvironment(Utils::Environment &environment) const
+{
+    const QString separator(Utils::HostOsInfo::pathListSeparator());
+    const QStringList path = environment.value("PATH").split(separator);
+    const QStringList additionalPath = Utils::filtered(binPath, [&path](const QString &dir) {
+        return !path.contains(dir);
+    });
+    if (!additionalPath.isEmpty())
+        environment.prependOrSet("PATH", additionalPath.join(separator), separator);
+
+    // programs that run GHC or use the GHC API find the packages of the project, its snapshot
+    // and GHC's global ones
+    if (!ghcPackagePath.isEmpty())
+        environment.set("GHC_PACKAGE_PATH", ghcPackagePath);
+    if (!snapshotPackageDatabase.isEmpty()) {
+        environment.set("HASKELL_PACKAGE_SANDBOX", snapshotPackageDatabase);
+        // the empty last entry stands for the global database
+        QStringList sandboxes{snapshotPackageDatabase, QString()};
+        if (!localPackageDatabase.isEmpty())
+            sandboxes.prepend(localPackageDatabase);
+        environment.set("HASKELL_PACKAGE_SANDBOXES", sandboxes.join(separator));
+    }
+    if (!distDirectory.isEmpty())
+        environment.set("HASKELL_DIST_DIR", distDirectory);
+    const QHash<QString, Utils::FilePath> dataDirs = dataDirectories();
+    for (auto it = dataDirs.cbegin(); it != dataDirs.cend(); ++it)
+        environment.set(it.key(), it.value().toUserOutput());
+}
+
+} // namespace Internal
+} // namespace Haskell
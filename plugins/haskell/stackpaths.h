@@ -0,0 +1,63 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <utils/environment.h>
+#include <utils/filepath.h>
+
+#include <QHash>
+#include <QStringList>
+
+namespace Haskell {
+namespace Internal {
+
+// The answer of "stack path" for a project.
+class StackPaths
+{
+public:
+    Utils::FilePath localInstallRoot;
+    QStringList binPath;
+    QString distDirectory; // relative to the project directory
+    QString ghcPackagePath;
+    QString localPackageDatabase;
+    QString snapshotPackageDatabase;
+
+    static QStringList arguments();
+    static StackPaths fromOutput(const QString &output);
+    // Returns an empty path if the executable was not built.
+    Utils::FilePath executable(const QString &name) const;
+    // Test suites and benchmarks are not installed, they stay in the dist directory.
+    Utils::FilePath buildExecutable(const Utils::FilePath &projectDirectory,
+                                    const QString &component) const;
+    // The directories that the data files of the packages were installed to, by the name of the
+    // variable that overrides it for the Paths_ module of the package, like "my_app_datadir".
+    QHash<QString, Utils::FilePath> dataDirectories() const;
+    // Sets up the environment like "stack exec" does.
+    void addToEnvironment(Utils::Environment &environment) const;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,286 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "testoutputparser.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace Haskell {
+namespace Internal {
+
+static int indentation(const QString &line)
+{
+    int i = 0;
+    while (i < line.size() && line.at(i) == ' ')
+        ++i;
+    return i;
+}
+
+TestOutputParser::TestOutputParser(Framework framework)
+    : m_framework(framework)
+{}
+
+TestOutputParser::Framework TestOutputParser::detectFramework(const QString &stanza)
+{
+    static const QRegularExpression hspec(R"(\bhspec\b)");
+    static const QRegularExpression tasty(R"(\btasty\b)");
+    if (hspec.match(stanza).hasMatch())
+        return Hspec;
+    if (tasty.match(stanza).hasMatch())
+        return Tasty;
+    return Plain;
+}
+
+QStringList TestOutputParser::arguments(Framework framework)
+{
+    switch (framework) {
+    case Hspec:
+        // one line per test, with the result at the end
+        return {"--format=checks", "--no-color"};
+    case Tasty:
+        return {"--color=never"};
+    case Plain:
+        break;
+    }
+    return {};
+}
+
+QStringList TestOutputParser::filterArguments(Framework framework,
+                                              const QVector<QStringList> &paths)
+{
+    QStringList result;
+    switch (framework) {
+    case Hspec:
+        for (const QStringList &path : paths)
+            result << "--match" << '/' + path.join('/') + '/';
+        break;
+    case Tasty: {
+        // $0 is the path of the test, joined with dots
+        QStringList conditions;
+        for (const QStringList &path : paths) {
+            QString name = path.join('.');
+            name.replace('\\', "\\\\").replace('"', "\\\"");
+            conditions << "$0 == \"" + name + '"';
+        }
+        if (!conditions.isEmpty())
+            result << "-p" << conditions.join(" || ");
+        break;
+    }
+    case Plain:
+        break;
+    }
+    return result;
+}
+
+QVector<TestCaseResult> TestOutputParser::addOutput(const QString &text)
+{
+    QVector<TestCaseResult> results;
+    m_lines.addText(text, [&](const QString &line) {
+        // progress that was overwritten on a terminal is not part of the line
+        addLine(line.mid(line.lastIndexOf('\r') + 1), &results);
+    });
+    return results;
+}
+
+QVector<TestCaseResult> TestOutputParser::finish()
+{
+    QVector<TestCaseResult> results;
+    m_lines.finish([&](const QString &line) { addLine(line, &results); });
+    finishFailure(&results);
+    return results;
+}
+
+void TestOutputParser::addLine(const QString &line, QVector<TestCaseResult> *results)
+{
+    switch (m_framework) {
+    case Hspec:
+        if (m_inFailureSection)
+            addHspecFailureLine(line, results);
+        else
+            addHspecLine(line, results);
+        break;
+    case Tasty:
+        addTastyLine(line, results);
+        break;
+    case Plain:
+        break;
+    }
+}
+
+void TestOutputParser::addHspecLine(const QString &line, QVector<TestCaseResult> *results)
+{
+    // "    sorts a list [✔]", "    fails [✘]", "    is pending [‐]"
+    static const QRegularExpression item(QString::fromUtf8(R"(^(\s*)(.*) \[(✔|✘|‐)\]$)"));
+    static const QRegularExpression summary(
+        R"(^(Finished in |Randomized with seed|\d+ examples?, ))");
+    const QString trimmed = line.trimmed();
+    if (trimmed.isEmpty())
+        return;
+    if (line == "Failures:") {
+        m_inFailureSection = true;
+        return;
+    }
+    if (trimmed.startsWith("# ") || summary.match(line).hasMatch())
+        return;
+    const QRegularExpressionMatch match = item.match(line);
+    if (!match.hasMatch()) {
+        groupPath(indentation(line), trimmed);
+        return;
+    }
+    TestCaseResult result;
+    result.path = groupPath(match.capturedLength(1), match.captured(2));
+    m_groups.removeLast(); // tests are no groups
+    const QString status = match.captured(3);
+    if (status == QString::fromUtf8("✔")) {
+        result.status = TestCaseResult::Passed;
+    } else if (status == QString::fromUtf8("✘")) {
+        result.status = TestCaseResult::Failed;
+        m_failedPaths.append(result.path);
+    } else {
+        result.status = TestCaseResult::Skipped;
+    }
+    results->append(result);
+}
+
+void TestOutputParser::addHspecFailureLine(const QString &line, QVector<TestCaseResult> *results)
+{
+    //   test/Spec.hs:12:3:
+    //   1) Data.List.sort handles empty
+    //        expected: [1]
+    //         but got: []
+    //
+    //   To rerun use: --match "/Data.List/sort/handles empty/"
+    //
+    // Randomized with seed 1234
+    static const QRegularExpression location(R"(^\s+\S+:\d+:\d+:\s*$)");
+    static const QRegularExpression entry(R"(^\s+(\d+)\) )");
+    if (line.startsWith("Randomized with seed") || line.startsWith("Finished in ")) {
+        finishFailure(results);
+        m_inFailureSection = false;
+        return;
+    }
+    if (line.trimmed().startsWith("To rerun use:"))
+        return;
+    if (location.match(line).hasMatch()) {
+        m_pendingLocation = line.trimmed();
+        return;
+    }
+    const QRegularExpressionMatch match = entry.match(line);
+    if (match.hasMatch()) {
+        finishFailure(results);
+        const int index = match.captured(1).toInt() - 1;
+        if (index >= 0 && index < m_failedPaths.size()) {
+            m_failure = {m_failedPaths.at(index), TestCaseResult::Failed, m_pendingLocation};
+            m_hasFailure = true;
+        }
+        m_pendingLocation.clear();
+        return;
+    }
+    if (!m_hasFailure)
+        return;
+    if (!m_pendingLocation.isEmpty()) {
+        m_failure.message += '\n' + m_pendingLocation;
+        m_pendingLocation.clear();
+    }
+    m_failure.message += '\n' + line.trimmed();
+}
+
+void TestOutputParser::addTastyLine(const QString &line, QVector<TestCaseResult> *results)
+{
+    // Tests
+    //   Unit tests
+    //     List comparison (different length): OK (0.01s)
+    //     List comparison (same length):      FAIL
+    //       test/Test.hs:29:
+    //       expected: LT
+    //        but got: GT
+    //       Use -p '/List comparison (same length)/' to rerun this test only.
+    //
+    // 1 out of 2 tests failed (0.01s)
+    static const QRegularExpression test(R"(^(\s*)(.+):\s+(OK|FAIL|SKIP|IGNORED)\b.*$)");
+    static const QRegularExpression summary(
+        R"(^(All \d+ tests passed|\d+ out of \d+ tests failed))");
+    const QString trimmed = line.trimmed();
+    if (m_hasFailure) {
+        if (trimmed.isEmpty() || indentation(line) > m_failureIndentation) {
+            if (!trimmed.isEmpty())
+                m_failure.message += (m_failure.message.isEmpty() ? "" : "\n") + trimmed;
+            return;
+        }
+        finishFailure(results);
+    }
+    if (trimmed.isEmpty() || summary.match(line).hasMatch())
+        return;
+    const QRegularExpressionMatch match = test.match(line);
+    if (!match.hasMatch()) {
+        // details of passed tests, like the summary of QuickCheck properties
+        if (m_testIndentation >= 0 && indentation(line) > m_testIndentation)
+            return;
+        groupPath(indentation(line), trimmed);
+        m_testIndentation = -1;
+        return;
+    }
+    m_testIndentation = match.capturedLength(1);
+    TestCaseResult result;
+    result.path = groupPath(match.capturedLength(1), match.captured(2).trimmed());
+    m_groups.removeLast();
+    const QString status = match.captured(3);
+    if (status == "FAIL") {
+        m_failure = result;
+        m_failure.status = TestCaseResult::Failed;
+        m_hasFailure = true;
+        m_failureIndentation = match.capturedLength(1);
+        return;
+    }
+    result.status = status == "OK" ? TestCaseResult::Passed : TestCaseResult::Skipped;
+    results->append(result);
+}
+
+// Returns the path of the group with the name and makes it the innermost group.
+QStringList TestOutputParser::groupPath(int indentation, const QString &name)
+{
+    while (!m_groups.isEmpty() && m_groups.last().indentation >= indentation)
+        m_groups.removeLast();
+    m_groups.append({indentation, name});
+    QStringList path;
+    for (const Group &group : std::as_const(m_groups))
+        path << group.name;
+    return path;
+}
+
+void TestOutputParser::finishFailure(QVector<TestCaseResult> *results)
+{
+    if (!m_hasFailure)
+        return;
+    m_failure.message = m_failure.message.trimmed();
+    results->append(m_failure);
+    m_failure = {};
+    m_hasFailure = false;
+}
+
+} // namespace Internal
+} // namespace Haskell
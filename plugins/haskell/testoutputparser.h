@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "linebuffer.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Haskell {
+namespace Internal {
+
+class TestCaseResult
+{
+public:
+    enum Status { Passed, Failed, Skipped };
+
+    QStringList path; // groups, then the test
+    Status status = Passed;
+    QString message;
+};
+
+// Turns the console output of hspec and tasty test suites into results per test, as soon as
+// they are complete. Suites using other frameworks only have a result as a whole.
+class TestOutputParser
+{
+public:
+    enum Framework { Plain, Hspec, Tasty };
+
+    explicit TestOutputParser(Framework framework);
+
+    // Guesses the framework from the test-suite stanza of the cabal file.
+    static Framework detectFramework(const QString &stanza);
+    // The arguments that make the output parseable.
+    static QStringList arguments(Framework framework);
+    // The arguments that run only the tests with the paths. Plain suites always run completely.
+    static QStringList filterArguments(Framework framework, const QVector<QStringList> &paths);
+
+    Framework framework() const { return m_framework; }
+
+    // Failed hspec tests are reported again when their details follow.
+    QVector<TestCaseResult> addOutput(const QString &text);
+    // Treats an incomplete last line as complete and finishes pending results.
+    QVector<TestCaseResult> finish();
+
+private:
+    class Group
+    {
+    public:
+        int indentation;
+        QString name;
+    };
+
+    void addLine(const QString &line, QVector<TestCaseResult> *results);
+    void addHspecLine(const QString &line, QVector<TestCaseResult> *results);
+    void addTastyLine(const QString &line, QVector<TestCaseResult> *results);
+    void addHspecFailureLine(const QString &line, QVector<TestCaseResult> *results);
+    QStringList groupPath(int indentation, const QString &name);
+    void finishFailure(QVector<TestCaseResult> *results);
+
+    Framework m_framework;
+    LineBuffer m_lines;
+    QVector<Group> m_groups;
+    // a failed test whose message is still being read
+    TestCaseResult m_failure;
+    bool m_hasFailure = false;
+    int m_failureIndentation = 0;
+    int m_testIndentation = -1;
+    // hspec lists the details of failures at the end, in the order they happened
+    QVector<QStringList> m_failedPaths;
+    bool m_inFailureSection = false;
+    QString m_pendingLocation;
+};
+
+} // namespace Internal
+} // namespace Haskell
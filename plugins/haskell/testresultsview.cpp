@@ -0,0 +1,282 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "testresultsview.h"
+
+#include "haskellanalysispane.h"
+#include "haskellcoverage.h"
+
+#include <projectexplorer/project.h>
+#include <utils/qtcassert.h>
+
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+using namespace ProjectExplorer;
+
+namespace Haskell {
+namespace Internal {
+
+enum Role { StatusRole = Qt::UserRole, DetailsRole, SuiteRole, PathRole };
+
+static QString itemKey(const QString &suite, const QStringList &path)
+{
+    return QStringList(suite + path).join('\n');
+}
+
+TestResultsView::TestResultsView(Project *project)
+    : m_project(project)
+    , m_runAllButton(new QPushButton(tr("Run All")))
+    , m_rerunFailedButton(new QPushButton(tr("Rerun Failed")))
+    , m_stopButton(new QPushButton(tr("Stop")))
+    , m_summaryLabel(new QLabel)
+    , m_resultTree(new QTreeWidget)
+    , m_details(new QPlainTextEdit)
+{
+    m_resultTree->setHeaderHidden(true);
+    m_resultTree->setUniformRowHeights(true);
+    m_resultTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_details->setReadOnly(true);
+    m_details->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_details->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto toolBar = new QHBoxLayout;
+    toolBar->addWidget(m_runAllButton);
+    toolBar->addWidget(m_rerunFailedButton);
+    toolBar->addWidget(m_stopButton);
+    toolBar->addWidget(m_summaryLabel, 1);
+
+    auto splitter = new QSplitter;
+    splitter->addWidget(m_resultTree);
+    splitter->addWidget(m_details);
+    splitter->setStretchFactor(1, 1);
+
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(toolBar);
+    layout->addWidget(splitter);
+
+    connect(m_runAllButton, &QPushButton::clicked, this, &TestResultsView::runAll);
+    connect(m_rerunFailedButton, &QPushButton::clicked, this, &TestResultsView::rerunFailed);
+    connect(m_stopButton, &QPushButton::clicked, &m_runner, &HaskellTestRunner::cancel);
+    connect(m_resultTree, &QTreeWidget::currentItemChanged, this, &TestResultsView::showDetails);
+    connect(&m_runner, &HaskellTestRunner::message, this, [this](const QString &text) {
+        m_log += text;
+        if (!m_resultTree->currentItem())
+            showDetails();
+    });
+    connect(&m_runner, &HaskellTestRunner::resultsReady, this, &TestResultsView::addResults);
+    connect(&m_runner, &HaskellTestRunner::suiteFinished, this, &TestResultsView::finishSuite);
+    connect(&m_runner, &HaskellTestRunner::finished, this, &TestResultsView::updateState);
+    connect(&m_runner, &HaskellTestRunner::coverageReady, this,
+            [this](const Utils::FilePath &mixDirectory, const Utils::FilePaths &tixFiles) {
+                if (HaskellCoverage *coverage = HaskellCoverage::instance(); coverage && m_project)
+                    coverage->load(m_project->projectDirectory(), mixDirectory, tixFiles);
+            });
+    updateState();
+}
+
+void TestResultsView::runTests(Project *project, bool coverage)
+{
+    HaskellAnalysisPane *pane = HaskellAnalysisPane::instance();
+    QTC_ASSERT(pane && project, return);
+    const QString id = "tests:" + project->projectFilePath().toString();
+    auto view = qobject_cast<TestResultsView *>(pane->result(id));
+    if (!view)
+        view = new TestResultsView(project);
+    pane->showResult(id, tr("Tests: %1").arg(project->displayName()), view);
+    if (!view->m_runner.isRunning())
+        view->m_runner.setCoverage(coverage);
+    view->runAll();
+}
+
+void TestResultsView::runAll()
+{
+    HaskellTestRunner::Selection selection;
+    for (const HaskellTestSuite &suite : HaskellTestRunner::testSuites(m_project))
+        selection.insert(suite.name, {});
+    run(selection);
+}
+
+void TestResultsView::rerunFailed()
+{
+    // suites without any known failed test, for example after a crash, are run completely
+    HaskellTestRunner::Selection selection;
+    for (int i = 0; i < m_resultTree->topLevelItemCount(); ++i) {
+        QTreeWidgetItem *suiteItem = m_resultTree->topLevelItem(i);
+        if (suiteItem->data(0, StatusRole).toInt() != Failed)
+            continue;
+        QVector<QStringList> paths;
+        QList<QTreeWidgetItem *> items{suiteItem};
+        while (!items.isEmpty()) {
+            QTreeWidgetItem *current = items.takeFirst();
+            for (int child = 0; child < current->childCount(); ++child)
+                items.append(current->child(child));
+            if (current != suiteItem && current->childCount() == 0
+                    && current->data(0, StatusRole).toInt() == Failed) {
+                paths.append(current->data(0, PathRole).toStringList());
+            }
+        }
+        selection.insert(suiteItem->data(0, SuiteRole).toString(), paths);
+    }
+    if (!selection.isEmpty())
+        run(selection);
+}
+
+void TestResultsView::run(const HaskellTestRunner::Selection &selection)
+{
+    if (m_runner.isRunning())
+        return;
+    m_resultTree->clear();
+    m_items.clear();
+    m_log.clear();
+    m_passed = m_failed = m_skipped = 0;
+    for (auto it = selection.cbegin(); it != selection.cend(); ++it)
+        setStatus(item(it.key(), {}), Running);
+    m_runner.run(m_project, selection);
+    updateState();
+    showDetails();
+}
+
+void TestResultsView::addResults(const QString &suite, const QVector<TestCaseResult> &results)
+{
+    for (const TestCaseResult &result : results) {
+        QTreeWidgetItem *testItem = item(suite, result.path);
+        testItem->setData(0, DetailsRole, result.message);
+        switch (result.status) {
+        case TestCaseResult::Passed:
+            ++m_passed;
+            setStatus(testItem, Passed);
+            break;
+        case TestCaseResult::Failed:
+            ++m_failed;
+            setStatus(testItem, Failed);
+            // a failed test fails all of its groups
+            for (QTreeWidgetItem *parent = testItem->parent(); parent; parent = parent->parent())
+                setStatus(parent, Failed);
+            break;
+        case TestCaseResult::Skipped:
+            ++m_skipped;
+            setStatus(testItem, Skipped);
+            break;
+        }
+    }
+    updateState();
+}
+
+void TestResultsView::finishSuite(const QString &suite, bool success, const QString &output)
+{
+    QTreeWidgetItem *suiteItem = item(suite, {});
+    suiteItem->setData(0, DetailsRole, output);
+    if (!success || suiteItem->data(0, StatusRole).toInt() == Failed) {
+        setStatus(suiteItem, Failed);
+    } else {
+        setStatus(suiteItem, Passed);
+        // groups are only marked when one of their tests fails
+        QList<QTreeWidgetItem *> items{suiteItem};
+        while (!items.isEmpty()) {
+            QTreeWidgetItem *current = items.takeFirst();
+            for (int child = 0; child < current->childCount(); ++child)
+                items.append(current->child(child));
+            if (current->data(0, StatusRole).toInt() == Running)
+                setStatus(current, Passed);
+        }
+    }
+    if (m_resultTree->currentItem() == suiteItem)
+        showDetails();
+}
+
+void TestResultsView::updateState()
+{
+    const bool running = m_runner.isRunning();
+    m_runAllButton->setEnabled(!running);
+    m_rerunFailedButton->setEnabled(!running && m_failed > 0);
+    m_stopButton->setEnabled(running);
+    QString summary = tr("%n passed, ", nullptr, m_passed) + tr("%n failed", nullptr, m_failed);
+    if (m_skipped > 0)
+        summary += tr(", %n skipped", nullptr, m_skipped);
+    if (running)
+        summary += tr(" (running)");
+    m_summaryLabel->setText(summary);
+}
+
+void TestResultsView::showDetails()
+{
+    // without a selection, the log of the run is shown
+    QTreeWidgetItem *current = m_resultTree->currentItem();
+    const QString text = current ? current->data(0, DetailsRole).toString() : m_log;
+    if (m_details->toPlainText() != text)
+        m_details->setPlainText(text);
+}
+
+QTreeWidgetItem *TestResultsView::item(const QString &suite, const QStringList &path)
+{
+    const QString key = itemKey(suite, path);
+    if (QTreeWidgetItem *existing = m_items.value(key))
+        return existing;
+    QTreeWidgetItem *newItem = nullptr;
+    if (path.isEmpty()) {
+        newItem = new QTreeWidgetItem(m_resultTree, {suite});
+        newItem->setExpanded(true);
+    } else {
+        newItem = new QTreeWidgetItem(item(suite, path.mid(0, path.size() - 1)),
+                                      {path.last()});
+    }
+    newItem->setData(0, SuiteRole, suite);
+    newItem->setData(0, PathRole, path);
+    setStatus(newItem, Running);
+    m_items.insert(key, newItem);
+    return newItem;
+}
+
+void TestResultsView::setStatus(QTreeWidgetItem *item, Status status)
+{
+    item->setData(0, StatusRole, status);
+    switch (status) {
+    case Running:
+        item->setForeground(0, palette().color(QPalette::Text));
+        break;
+    case Passed:
+        item->setForeground(0, QColor(40, 150, 40));
+        break;
+    case Failed:
+        item->setForeground(0, QColor(200, 40, 40));
+        item->setExpanded(true);
+        break;
+    case Skipped:
+        item->setForeground(0, palette().color(QPalette::Disabled, QPalette::Text));
+        break;
+    }
+}
+
+} // namespace Internal
+} // namespace Haskell
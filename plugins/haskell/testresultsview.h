@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "haskelltestrunner.h"
+
+#include <QHash>
+#include <QPointer>
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QPlainTextEdit;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+QT_END_NAMESPACE
+
+namespace ProjectExplorer { class Project; }
+
+namespace Haskell {
+namespace Internal {
+
+// The results of the test suites of a project, updated while the tests run.
+class TestResultsView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TestResultsView(ProjectExplorer::Project *project);
+
+    // Runs all test suites of the project and shows the results in the analysis pane. With
+    // coverage, the suites are built with HPC instrumentation and the coverage is shown afterwards.
+    static void runTests(ProjectExplorer::Project *project, bool coverage = false);
+
+    void runAll();
+    void rerunFailed();
+
+private:
+    enum Status { Running, Passed, Failed, Skipped };
+
+    void run(const HaskellTestRunner::Selection &selection);
+    void addResults(const QString &suite, const QVector<TestCaseResult> &results);
+    void finishSuite(const QString &suite, bool success, const QString &output);
+    void updateState();
+    void showDetails();
+    QTreeWidgetItem *item(const QString &suite, const QStringList &path);
+    void setStatus(QTreeWidgetItem *item, Status status);
+
+    QPointer<ProjectExplorer::Project> m_project;
+    HaskellTestRunner m_runner;
+    QPushButton *m_runAllButton;
+    QPushButton *m_rerunFailedButton;
+    QPushButton *m_stopButton;
+    QLabel *m_summaryLabel;
+    QTreeWidget *m_resultTree;
+    QPlainTextEdit *m_details;
+    QHash<QString, QTreeWidgetItem *> m_items;
+    QString m_log;
+    int m_passed = 0;
+    int m_failed = 0;
+    int m_skipped = 0;
+};
+
+} // namespace Internal
+} // namespace Haskell
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <benchmarkresults.h>
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+class tst_BenchmarkResults : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void criterion();
+    void tastyBench();
+    void invalidCsv();
+    void history();
+    void historyFile();
+    void compare();
+
+private:
+    static QVector<BenchmarkResult> readResults(const QString &fileName);
+};
+
+QVector<BenchmarkResult> tst_BenchmarkResults::readResults(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QVector<BenchmarkResult> results;
+    QString error;
+    if (!parseBenchmarkCsv(file.readAll(), &results, &error))
+        qWarning("%s", qPrintable(error));
+    return results;
+}
+
+void tst_BenchmarkResults::criterion()
+{
+    const QVector<BenchmarkResult> results = readResults(QFINDTESTDATA("data/criterion.csv"));
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(1).name, QString("fib/5"));
+    QCOMPARE(results.at(1).mean, 2.4866e-7);
+    QCOMPARE(results.at(1).uncertainty, (2.5009e-7 - 2.4750e-7) / 2);
+    QCOMPARE(results.at(1).allocated, qint64(-1));
+}
+
+void tst_BenchmarkResults::tastyBench()
+{
+    const QVector<BenchmarkResult> results = readResults(QFINDTESTDATA("data/tasty-bench.csv"));
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(1).name, QString("All.fibonacci numbers.tenth"));
+    QCOMPARE(results.at(1).mean, 637152e-12);
+    QCOMPARE(results.at(1).uncertainty, 46744e-12);
+    QCOMPARE(results.at(1).allocated, qint64(1536));
+    QCOMPARE(results.at(2).name, QString("All.fibonacci numbers.twentieth, \"slow\""));
+    QCOMPARE(results.at(2).mean, 81369531e-12);
+}
+
+void tst_BenchmarkResults::invalidCsv()
+{
+    QVector<BenchmarkResult> results;
+    QString error;
+    QVERIFY(!parseBenchmarkCsv({}, &results, &error));
+    QVERIFY(!parseBenchmarkCsv("benchmarking fib/1\ntime 23.24 ns\n", &results, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!parseBenchmarkCsv("Name,Mean\nfib/1,fast\n", &results, &error));
+    QVERIFY(error.contains("line 2"));
+}
+
+void tst_BenchmarkResults::history()
+{
+    BenchmarkHistory history;
+    history.setMaximumRuns(3);
+    const auto run = [](const QString &commit, double mean) {
+        BenchmarkRun run;
+        run.commit = commit;
+        run.timestamp = QDateTime::currentDateTime();
+        run.results.append({"fib", mean, 0, -1});
+        return run;
+    };
+    QCOMPARE(history.addRun(run("aaa", 1.0)), 0);
+    QCOMPARE(history.defaultBaseline(0), -1);
+    QCOMPARE(history.addRun(run("bbb", 2.0)), 1);
+    QCOMPARE(history.defaultBaseline(1), 0);
+
+    // a run of the same commit replaces the earlier one
+    QCOMPARE(history.addRun(run("aaa", 3.0)), 1);
+    QCOMPARE(history.runs().size(), 2);
+    QCOMPARE(history.runs().at(0).commit, QString("bbb"));
+    QCOMPARE(history.runs().at(1).result("fib")->mean, 3.0);
+    QCOMPARE(history.defaultBaseline(1), 0);
+
+    // outside of version control every run is kept
+    history.addRun(run({}, 4.0));
+    QCOMPARE(history.addRun(run({}, 5.0)), 2);
+    QCOMPARE(history.runs().size(), 3);
+    QCOMPARE(history.runs().at(0).commit, QString("aaa"));
+    QCOMPARE(history.defaultBaseline(2), 1);
+    QVERIFY(!history.runs().at(2).result("fibonacci"));
+}
+
+void tst_BenchmarkResults::historyFile()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString filePath = directory.filePath("history.json");
+    QString error;
+
+    BenchmarkHistory history;
+    QVERIFY(history.load(filePath, &error));
+    QVERIFY(history.runs().isEmpty());
+
+    BenchmarkRun run;
+    run.commit = "3f2a1c9-dirty";
+    run.timestamp = QDateTime(QDate(2023, 4, 1), QTime(12, 30), Qt::UTC);
+    run.results = readResults(QFINDTESTDATA("data/tasty-bench.csv"));
+    history.addRun(run);
+    QVERIFY2(history.save(filePath, &error), qPrintable(error));
+
+    BenchmarkHistory loaded;
+    QVERIFY2(loaded.load(filePath, &error), qPrintable(error));
+    QCOMPARE(loaded.runs().size(), 1);
+    const BenchmarkRun &loadedRun = loaded.runs().first();
+    QCOMPARE(loadedRun.commit, run.commit);
+    QCOMPARE(loadedRun.timestamp, run.timestamp);
+    QCOMPARE(loadedRun.results.size(), 3);
+    QCOMPARE(loadedRun.results.at(1).mean, run.results.at(1).mean);
+    QCOMPARE(loadedRun.results.at(1).uncertainty, run.results.at(1).uncertainty);
+    QCOMPARE(loadedRun.results.at(1).allocated, qint64(1536));
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("{ runs: ");
+    file.close();
+    QVERIFY(!loaded.load(filePath, &error));
+}
+
+void tst_BenchmarkResults::compare()
+{
+    const BenchmarkResult baseline{"fib", 1.0, 0.02, -1};
+    const auto status = [&baseline](double mean, double uncertainty) {
+        return BenchmarkComparison::compare({"fib", mean, uncertainty, -1}, &baseline).status;
+    };
+    QCOMPARE(BenchmarkComparison::compare(baseline, nullptr).status, BenchmarkComparison::New);
+    QCOMPARE(status(1.2, 0.02), BenchmarkComparison::Regression);
+    QCOMPARE(status(0.8, 0.02), BenchmarkComparison::Improvement);
+    // within the noise
+    QCOMPARE(status(1.2, 0.3), BenchmarkComparison::Unchanged);
+    // significant, but below the threshold
+    QCOMPARE(status(1.03, 0.001), BenchmarkComparison::Unchanged);
+    QCOMPARE(BenchmarkComparison::compare({"fib", 1.5, 0, -1}, &baseline).change, 0.5);
+}
+
+QTEST_MAIN(tst_BenchmarkResults)
+
+#include "tst_benchmarkresults.moc"
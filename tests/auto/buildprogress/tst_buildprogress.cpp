@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <stackbuildprogress.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+// A build log line together with the time in milliseconds at which it appeared
+struct LogLine
+{
+    qint64 timestamp;
+    QString text;
+};
+
+class tst_BuildProgress : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void singlePackage();
+    void parallelPackages();
+    void dependencies();
+    void skippedModules();
+    void timings();
+    void estimateFromHistory();
+    void estimateWithoutHistory();
+    void saveAndLoad();
+
+private:
+    static void feed(StackBuildProgress *progress, const QList<LogLine> &log);
+};
+
+void tst_BuildProgress::feed(StackBuildProgress *progress, const QList<LogLine> &log)
+{
+    for (const LogLine &line : log)
+        progress->addLine(line.text, line.timestamp);
+}
+
+void tst_BuildProgress::singlePackage()
+{
+    StackBuildProgress progress;
+    feed(&progress, {
+             {0, "simple> configure (exe)"},
+             {10, "simple> Configuring simple-0.1.0.0..."},
+             {20, "simple> build (exe)"},
+             {30, "simple> Building executable 'simple' for simple-0.1.0.0.."},
+             {40, "simple> [1 of 4] Compiling A"},
+             {140, "simple> [2 of 4] Compiling B"}
+         });
+    QCOMPARE(progress.startedPackages(), 1);
+    QCOMPARE(progress.finishedPackages(), 0);
+    QCOMPARE(progress.percent(), 25);
+    feed(&progress, {
+             {240, "simple> [3 of 4] Compiling C"},
+             {340, "simple> [4 of 4] Compiling Main ( app/Main.hs, .stack-work/Main.o )"}
+         });
+    QCOMPARE(progress.percent(), 75);
+    feed(&progress, {
+             {400, "simple> Linking .stack-work/dist/build/simple/simple ..."},
+             {500, "simple> copy/register"}
+         });
+    QCOMPARE(progress.finishedPackages(), 1);
+    QCOMPARE(progress.percent(), 100);
+}
+
+void tst_BuildProgress::parallelPackages()
+{
+    StackBuildProgress progress;
+    feed(&progress, {
+             {0, "core> build (lib)"},
+             {0, "web> build (lib)"},
+             {10, "core> [1 of 2] Compiling Core.A"},
+             {10, "web> [1 of 4] Compiling Web.A"},
+             {20, "web> [2 of 4] Compiling Web.B"},
+             {30, "core> [2 of 2] Compiling Core.B"},
+             {40, "core> copy/register"},
+         });
+    QCOMPARE(progress.startedPackages(), 2);
+    QCOMPARE(progress.finishedPackages(), 1);
+    // core is done, web has compiled one of four modules
+    QCOMPARE(progress.percent(), (100 + 25) / 2);
+}
+
+void tst_BuildProgress::dependencies()
+{
+    StackBuildProgress progress;
+    feed(&progress, {
+             {0, "text-1.2.4.1: download"},
+             {10, "text-1.2.4.1: configure"},
+             {20, "text-1.2.4.1: build"},
+             {30, "random-1.2.0: build"},
+             {40, "text-1.2.4.1: copy/register"},
+             {50, "Completed 1 action(s)."}
+         });
+    QCOMPARE(progress.startedPackages(), 2);
+    QCOMPARE(progress.finishedPackages(), 1);
+    QCOMPARE(progress.percent(), 50);
+}
+
+void tst_BuildProgress::skippedModules()
+{
+    // without "package> " prefix the package comes from Cabal's "Building" line,
+    // and modules that are up to date don't get a "Compiling" line
+    StackBuildProgress progress;
+    feed(&progress, {
+             {0, "Building library for simple-0.1.0.0.."},
+             {10, "[7 of 10] Compiling G"}
+         });
+    QCOMPARE(progress.startedPackages(), 1);
+    QCOMPARE(progress.percent(), 60);
+    progress.finish(100);
+    QCOMPARE(progress.finishedPackages(), 1);
+    QCOMPARE(progress.percent(), 100);
+}
+
+void tst_BuildProgress::timings()
+{
+    StackBuildProgress progress;
+    feed(&progress, {
+             {0, "simple> [1 of 2] Compiling A"},
+             {250, "simple> [2 of 2] Compiling B"},
+             {400, "simple> copy/register"}
+         });
+    const QHash<QString, qint64> timings = progress.moduleTimings();
+    QCOMPARE(timings.size(), 2);
+    QCOMPARE(timings.value("simple:A"), qint64(250));
+    QCOMPARE(timings.value("simple:B"), qint64(150));
+}
+
+void tst_BuildProgress::estimateFromHistory()
+{
+    StackBuildProgress progress;
+    progress.setModuleTimings({{"simple:A", 1000}, {"simple:B", 2000}, {"simple:C", 3000}});
+    QCOMPARE(progress.estimatedRemainingTime(), qint64(-1));
+    feed(&progress, {{0, "simple> [1 of 3] Compiling A"}});
+    QCOMPARE(progress.estimatedRemainingTime(), qint64(5000));
+    feed(&progress, {{900, "simple> [2 of 3] Compiling B"}});
+    QCOMPARE(progress.estimatedRemainingTime(), qint64(3000));
+    // new timings replace the old ones, others are kept
+    QCOMPARE(progress.moduleTimings().value("simple:A"), qint64(900));
+    QCOMPARE(progress.moduleTimings().value("simple:C"), qint64(3000));
+}
+
+void tst_BuildProgress::estimateWithoutHistory()
+{
+    StackBuildProgress progress;
+    feed(&progress, {
+             {0, "simple> [1 of 5] Compiling A"},
+             {100, "simple> [2 of 5] Compiling B"},
+             {300, "simple> [3 of 5] Compiling C"}
+         });
+    // two modules took 150 ms on average, three are left
+    QCOMPARE(progress.estimatedRemainingTime(), qint64(450));
+}
+
+void tst_BuildProgress::saveAndLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath("timings.json");
+    const QHash<QString, qint64> timings{{"simple:A", 1000}, {"web:Web.Server", 123456}};
+    QVERIFY(StackBuildProgress::saveModuleTimings(filePath, timings));
+    QCOMPARE(StackBuildProgress::loadModuleTimings(filePath), timings);
+    QVERIFY(StackBuildProgress::loadModuleTimings(dir.filePath("missing.json")).isEmpty());
+}
+
+QTEST_MAIN(tst_BuildProgress)
+
+#include "tst_buildprogress.moc"
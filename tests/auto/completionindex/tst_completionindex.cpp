@@ -0,0 +1,231 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <completionindex.h>
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+
+using namespace Haskell::Internal;
+
+static const char shapeModule[]
+    = "module Data.Shape (Shape (..), area, perimeter) where\n"
+      "\n"
+      "import Data.List (sortOn)\n"
+      "\n"
+      "data Shape = Circle Double | Rect Double Double\n"
+      "\n"
+      "area :: Shape -> Double\n"
+      "area (Circle radius) = pi * radius * radius\n"
+      "area (Rect width height) = width * height\n"
+      "\n"
+      "perimeter :: Shape -> Double\n"
+      "perimeter = undefined\n"
+      "\n"
+      "(<+>) :: Shape -> Shape -> Double\n"
+      "a <+> b = area a + area b\n";
+
+static const char mainModule[]
+    = "module Main where\n"
+      "\n"
+      "import qualified Data.Map as Map\n"
+      "import Data.Shape\n"
+      "import Data.Shape qualified as S\n"
+      "import Data.Set qualified\n"
+      "\n"
+      "{- a comment with words -}\n"
+      "main :: IO ()\n"
+      "main = print (Map.size shapes, arrange)\n"
+      "  where\n"
+      "    shapes = Map.fromList [(1, Circle 2)]\n"
+      "    arrange = \"a string\"\n";
+
+static QStringList texts(const QVector<CompletionCandidate> &candidates)
+{
+    QStringList result;
+    for (const CompletionCandidate &candidate : candidates)
+        result.append(candidate.text);
+    return result;
+}
+
+class tst_CompletionIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void symbols();
+    void imports();
+    void withPrefix();
+    void candidates();
+    void qualified();
+    void importedNames();
+    void moduleRenamed();
+    void largeIndex();
+};
+
+void tst_CompletionIndex::symbols()
+{
+    const ModuleSymbols symbols = ModuleSymbols::fromSource(shapeModule);
+    QCOMPARE(symbols.moduleName, QString("Data.Shape"));
+    QCOMPARE(symbols.topLevelNames, QStringList({"Shape", "area", "perimeter"}));
+    QVERIFY(symbols.identifiers.contains("radius"));
+    QVERIFY(symbols.identifiers.contains("Circle"));
+    QVERIFY(symbols.identifiers.contains("sortOn"));
+    QVERIFY(!symbols.identifiers.contains("a")); // too short
+    QVERIFY(!symbols.identifiers.contains("where")); // a keyword
+    QVERIFY(std::is_sorted(symbols.identifiers.cbegin(), symbols.identifiers.cend()));
+
+    const QStringList identifiers = ModuleSymbols::fromSource(mainModule).identifiers;
+    QVERIFY(identifiers.contains("size")); // from Map.size
+    QVERIFY(!identifiers.contains("Map.size"));
+    QVERIFY(!identifiers.contains("comment"));
+    QVERIFY(!identifiers.contains("string"));
+}
+
+void tst_CompletionIndex::imports()
+{
+    const QVector<ModuleImport> imports = ModuleSymbols::fromSource(mainModule).imports;
+    QCOMPARE(imports.size(), 4);
+    QCOMPARE(imports.at(0).module, QString("Data.Map"));
+    QCOMPARE(imports.at(0).alias, QString("Map"));
+    QVERIFY(imports.at(0).qualified);
+    QCOMPARE(imports.at(1).module, QString("Data.Shape"));
+    QCOMPARE(imports.at(1).alias, QString("Data.Shape"));
+    QVERIFY(!imports.at(1).qualified);
+    QCOMPARE(imports.at(2).alias, QString("S"));
+    QVERIFY(imports.at(2).qualified);
+    QCOMPARE(imports.at(3).alias, QString("Data.Set"));
+    QVERIFY(imports.at(3).qualified);
+
+    // the imported names are not taken for an alias
+    const ModuleSymbols symbols = ModuleSymbols::fromSource(shapeModule);
+    QCOMPARE(symbols.imports.size(), 1);
+    QCOMPARE(symbols.imports.at(0).alias, QString("Data.List"));
+}
+
+void tst_CompletionIndex::withPrefix()
+{
+    const QStringList sorted{"Map", "map", "mapM", "mapM_", "mconcat", "zip"};
+    QCOMPARE(CompletionIndex::withPrefix(sorted, "map"), QStringList({"map", "mapM", "mapM_"}));
+    QCOMPARE(CompletionIndex::withPrefix(sorted, "M"), QStringList({"Map"}));
+    QCOMPARE(CompletionIndex::withPrefix(sorted, "zz"), QStringList());
+    QCOMPARE(CompletionIndex::withPrefix(sorted, ""), sorted);
+}
+
+void tst_CompletionIndex::candidates()
+{
+    CompletionIndex index;
+    index.setModule("/p/Data/Shape.hs", ModuleSymbols::fromSource(shapeModule));
+    const ModuleSymbols main = ModuleSymbols::fromSource(mainModule);
+    index.setModule("/p/Main.hs", main);
+
+    const QVector<CompletionCandidate> candidates = index.candidates(main, {}, "ar");
+    QCOMPARE(texts(candidates), QStringList({"area", "arrange"}));
+    QCOMPARE(candidates.at(0).kind, CompletionCandidate::TopLevelName);
+    QCOMPARE(candidates.at(0).module, QString("Data.Shape"));
+    QCOMPARE(candidates.at(1).kind, CompletionCandidate::Identifier);
+
+    const QVector<CompletionCandidate> keywords = index.candidates(main, {}, "wh");
+    QCOMPARE(texts(keywords), QStringList({"where"}));
+    QCOMPARE(keywords.at(0).kind, CompletionCandidate::Keyword);
+
+    // what is typed already is not proposed
+    QCOMPARE(texts(index.candidates(main, {}, "arrange")), QStringList());
+}
+
+void tst_CompletionIndex::qualified()
+{
+    CompletionIndex index;
+    index.setModule("/p/Data/Shape.hs", ModuleSymbols::fromSource(shapeModule));
+    const ModuleSymbols main = ModuleSymbols::fromSource(mainModule);
+
+    QCOMPARE(texts(index.candidates(main, "S", "")),
+             QStringList({"Shape", "area", "perimeter"}));
+    QCOMPARE(texts(index.candidates(main, "Data.Shape", "p")), QStringList({"perimeter"}));
+    QCOMPARE(texts(index.candidates(main, "Shape", "p")), QStringList());
+    // not a project module
+    QCOMPARE(texts(index.candidates(main, "Map", "")), QStringList());
+}
+
+void tst_CompletionIndex::importedNames()
+{
+    CompletionIndex index;
+    index.setModule("/p/Data/Shape.hs", ModuleSymbols::fromSource(shapeModule));
+    const QSet<QString> names = index.importedNames(ModuleSymbols::fromSource(mainModule));
+    QVERIFY(names.contains("area"));
+    QVERIFY(names.contains("Data.Shape.area"));
+    QVERIFY(names.contains("S.perimeter"));
+    QVERIFY(names.contains("S.Shape"));
+    QVERIFY(!names.contains("Map.size")); // not a project module
+    QCOMPARE(names.size(), 9);
+}
+
+void tst_CompletionIndex::moduleRenamed()
+{
+    CompletionIndex index;
+    index.setModule("/p/Shape.hs", ModuleSymbols::fromSource(shapeModule));
+    const ModuleSymbols main = ModuleSymbols::fromSource(mainModule);
+    QCOMPARE(texts(index.candidates(main, "S", "ar")), QStringList({"area"}));
+
+    index.setModule("/p/Shape.hs", ModuleSymbols::fromSource("module Shapes where\narea = 1\n"));
+    QCOMPARE(texts(index.candidates(main, "S", "ar")), QStringList());
+    index.removeModule("/p/Shape.hs");
+    QVERIFY(index.filePaths().isEmpty());
+}
+
+void tst_CompletionIndex::largeIndex()
+{
+    // a million top-level names, and a file importing a hundred of their modules
+    CompletionIndex index;
+    ModuleSymbols main;
+    for (int module = 0; module < 1000; ++module) {
+        ModuleSymbols symbols;
+        symbols.moduleName = QString("Generated.M%1").arg(module);
+        for (int name = 0; name < 1000; ++name)
+            symbols.topLevelNames.append(QString("name%1_%2").arg(name).arg(module));
+        symbols.topLevelNames.sort();
+        index.setModule(QString("/p/M%1.hs").arg(module), symbols);
+        if (module % 10 == 0) {
+            ModuleImport import;
+            import.module = symbols.moduleName;
+            import.alias = import.module;
+            main.imports.append(import);
+        }
+    }
+
+    QVector<CompletionCandidate> candidates;
+    QBENCHMARK {
+        candidates = index.candidates(main, {}, "name99_");
+    }
+    QCOMPARE(candidates.size(), 100);
+    QCOMPARE(candidates.first().text, QString("name99_0"));
+    QCOMPARE(candidates.first().module, QString("Generated.M0"));
+}
+
+QTEST_MAIN(tst_CompletionIndex)
+
+#include "tst_completionindex.moc"
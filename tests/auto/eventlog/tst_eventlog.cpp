@@ -0,0 +1,332 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <eventlog.h>
+
+#include <QDataStream>
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+// Writes eventlogs in GHC's binary format, big endian like QDataStream.
+class EventlogWriter
+{
+public:
+    enum Type : quint16 {
+        CreateThread = 0,
+        RunThread = 1,
+        StopThread = 2,
+        MigrateThread = 4,
+        GcStart = 9,
+        GcEnd = 10,
+        BlockMarker = 18,
+        UserMessage = 19,
+        SparkCounters = 35,
+        CapCreate = 45
+    };
+
+    EventlogWriter()
+        : m_stream(&m_data, QIODevice::WriteOnly)
+    {
+        m_stream.writeRawData("hdrbhetb", 8);
+        addType(CreateThread, 4, "Create thread");
+        addType(RunThread, 4, "Run thread");
+        addType(StopThread, 10, "Stop thread");
+        addType(MigrateThread, 6, "Migrate thread");
+        addType(GcStart, 0, "Start GC");
+        addType(GcEnd, 0, "Finish GC");
+        addType(BlockMarker, 14, "Block marker");
+        addType(UserMessage, 0xffff, "User message");
+        addType(SparkCounters, 56, "Spark counters");
+        addType(CapCreate, 2, "Create capability");
+        m_stream.writeRawData("hetehdredatb", 12);
+    }
+
+    void addEvent(quint16 type, quint64 time, const QByteArray &payload = {})
+    {
+        m_stream << type << time;
+        if (type == UserMessage)
+            m_stream << quint16(payload.size());
+        m_stream.writeRawData(payload.constData(), payload.size());
+    }
+
+    void beginBlock(quint16 capability, quint64 time)
+    {
+        m_blockStart = m_data.size();
+        addEvent(BlockMarker, time, payload(quint32(0), quint64(0), capability));
+    }
+
+    void endBlock()
+    {
+        // the size includes the block marker itself
+        const QByteArray size = payload(quint32(m_data.size() - m_blockStart));
+        m_data.replace(m_blockStart + 10, size.size(), size);
+    }
+
+    QByteArray finish()
+    {
+        m_stream << quint16(0xffff);
+        return m_data;
+    }
+
+    template<typename... Values>
+    static QByteArray payload(Values... values)
+    {
+        QByteArray result;
+        QDataStream stream(&result, QIODevice::WriteOnly);
+        (stream << ... << values);
+        return result;
+    }
+
+private:
+    void addType(quint16 type, quint16 size, const QByteArray &description)
+    {
+        m_stream.writeRawData("etb", 4);
+        m_stream << type << size << quint32(description.size());
+        m_stream.writeRawData(description.constData(), description.size());
+        m_stream << quint32(0);
+        m_stream.writeRawData("ete", 4);
+    }
+
+    QByteArray m_data;
+    QDataStream m_stream;
+    int m_blockStart = 0;
+};
+
+class RecordedEvent
+{
+public:
+    quint16 type;
+    quint64 timestamp;
+    int capability;
+    int payloadSize;
+
+    bool operator==(const RecordedEvent &other) const
+    {
+        return type == other.type && timestamp == other.timestamp
+               && capability == other.capability && payloadSize == other.payloadSize;
+    }
+};
+
+class tst_Eventlog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decode();
+    void decodeInChunks();
+    void invalidInput();
+    void summary();
+    void gcEpisodesInBlocks();
+    void timelineBins();
+
+private:
+    static QByteArray createEventlog();
+    static QVector<RecordedEvent> decodeAll(const QByteArray &data, int chunkSize);
+};
+
+QByteArray tst_Eventlog::createEventlog()
+{
+    using W = EventlogWriter;
+    EventlogWriter writer;
+    writer.addEvent(W::CreateThread, 500, W::payload(quint32(1)));
+    writer.addEvent(W::UserMessage, 900, "hello");
+
+    writer.beginBlock(0, 1000);
+    writer.addEvent(W::RunThread, 1000, W::payload(quint32(1)));
+    writer.addEvent(W::GcStart, 5000);
+    writer.addEvent(W::GcEnd, 6000);
+    writer.addEvent(W::RunThread, 6000, W::payload(quint32(1)));
+    writer.addEvent(W::SparkCounters, 7000,
+                    W::payload(quint64(10), quint64(0), quint64(0), quint64(6), quint64(1),
+                               quint64(3), quint64(0)));
+    writer.addEvent(W::StopThread, 8000, W::payload(quint32(1), quint16(5), quint32(0)));
+    writer.endBlock();
+
+    // the blocks of different capabilities overlap in time
+    writer.beginBlock(1, 2000);
+    writer.addEvent(W::RunThread, 2000, W::payload(quint32(2)));
+    writer.addEvent(W::GcStart, 5100);
+    writer.addEvent(W::GcEnd, 6200);
+    writer.addEvent(W::SparkCounters, 7000,
+                    W::payload(quint64(10), quint64(1), quint64(0), quint64(2), quint64(4),
+                               quint64(3), quint64(0)));
+    writer.addEvent(W::MigrateThread, 7500, W::payload(quint32(2), quint16(0)));
+    writer.endBlock();
+    return writer.finish();
+}
+
+QVector<RecordedEvent> tst_Eventlog::decodeAll(const QByteArray &data, int chunkSize)
+{
+    QVector<RecordedEvent> events;
+    EventlogDecoder decoder([&events](const EventlogEvent &event) {
+        events.append({event.type, event.timestamp, event.capability, event.payloadSize});
+    });
+    for (int i = 0; i < data.size(); i += chunkSize) {
+        if (!decoder.feed(data.mid(i, chunkSize)))
+            return {};
+    }
+    if (!decoder.atEnd())
+        return {};
+    return events;
+}
+
+void tst_Eventlog::decode()
+{
+    const QVector<RecordedEvent> events = decodeAll(createEventlog(), 1 << 20);
+    QCOMPARE(events.size(), 15);
+    QCOMPARE(events.at(0), (RecordedEvent{EventlogWriter::CreateThread, 500, -1, 4}));
+    QCOMPARE(events.at(1), (RecordedEvent{EventlogWriter::UserMessage, 900, -1, 5}));
+    QCOMPARE(events.at(2), (RecordedEvent{EventlogWriter::BlockMarker, 1000, 0, 14}));
+    QCOMPARE(events.at(8), (RecordedEvent{EventlogWriter::StopThread, 8000, 0, 10}));
+    QCOMPARE(events.at(9), (RecordedEvent{EventlogWriter::BlockMarker, 2000, 1, 14}));
+    QCOMPARE(events.at(14), (RecordedEvent{EventlogWriter::MigrateThread, 7500, 1, 6}));
+
+    EventlogDecoder decoder([](const EventlogEvent &) {});
+    QVERIFY(decoder.feed(createEventlog()));
+    QCOMPARE(decoder.eventTypeName(EventlogWriter::GcStart), QString("Start GC"));
+}
+
+void tst_Eventlog::decodeInChunks()
+{
+    const QByteArray data = createEventlog();
+    const QVector<RecordedEvent> expected = decodeAll(data, data.size());
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(decodeAll(data, 1), expected);
+    QCOMPARE(decodeAll(data, 7), expected);
+}
+
+void tst_Eventlog::invalidInput()
+{
+    EventlogDecoder decoder([](const EventlogEvent &) {});
+    QVERIFY(!decoder.feed("not an eventlog"));
+    QVERIFY(!decoder.errorString().isEmpty());
+    QVERIFY(!decoder.feed(createEventlog()));
+
+    // an event type that the header doesn't declare
+    QByteArray data = EventlogWriter().finish();
+    data.chop(2);
+    data += EventlogWriter::payload(quint16(7), quint64(0));
+    EventlogDecoder unknownType([](const EventlogEvent &) {});
+    QVERIFY(!unknownType.feed(data));
+    QVERIFY(unknownType.errorString().contains("7"));
+}
+
+void tst_Eventlog::summary()
+{
+    EventlogAnalysis analysis;
+    EventlogDecoder decoder([&analysis](const EventlogEvent &event) { analysis.addEvent(event); });
+    QVERIFY(decoder.feed(createEventlog()));
+    analysis.finish();
+
+    const EventlogSummary &summary = analysis.summary();
+    QCOMPARE(summary.events, qint64(15));
+    QCOMPARE(summary.capabilities, 2);
+    QCOMPARE(summary.elapsedTime(), qint64(7500));
+    QCOMPARE(summary.threadsCreated, qint64(1));
+    QCOMPARE(summary.threadMigrations, qint64(1));
+    QCOMPARE(summary.mutatorTime, qint64(4000 + 2000 + 3100));
+    QCOMPARE(summary.gcTime, qint64(1000 + 1100));
+    // the collections on both capabilities are one pause of the program
+    QCOMPARE(summary.gcCount, qint64(1));
+    QCOMPARE(summary.gcWallTime, qint64(1200));
+    QCOMPARE(summary.maxGcPause, qint64(1200));
+    QCOMPARE(summary.gcPercent(), 16.0);
+    QCOMPARE(summary.sparksCreated, qint64(20));
+    QCOMPARE(summary.sparksConverted, qint64(8));
+    QCOMPARE(summary.sparksDud, qint64(1));
+    QCOMPARE(summary.sparksGarbageCollected, qint64(5));
+    QCOMPARE(summary.sparksFizzled, qint64(6));
+    QCOMPARE(summary.sparkEfficiency(), 40.0);
+
+    const EventlogTimeline &timeline = analysis.timeline();
+    QCOMPARE(timeline.capabilities(), 2);
+    QCOMPARE(timeline.count(EventlogTimeline::GarbageCollections, 0), qint64(1));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 0), qint64(6000));
+    QCOMPARE(timeline.time(1, EventlogTimeline::GarbageCollection, 0), qint64(1100));
+}
+
+void tst_Eventlog::gcEpisodesInBlocks()
+{
+    using W = EventlogWriter;
+    EventlogWriter writer;
+    writer.addEvent(W::CapCreate, 0, W::payload(quint16(0)));
+    writer.addEvent(W::CapCreate, 0, W::payload(quint16(1)));
+    const QVector<QVector<quint64>> collections = {{1000, 1100, 3000, 3100, 5000, 5100},
+                                                   {1050, 1200, 3000, 3050, 5050, 5300}};
+    for (int cap = 0; cap < collections.size(); ++cap) {
+        writer.beginBlock(cap, 1000);
+        for (int i = 0; i < collections.at(cap).size(); i += 2) {
+            writer.addEvent(W::GcStart, collections.at(cap).at(i));
+            writer.addEvent(W::GcEnd, collections.at(cap).at(i + 1));
+        }
+        writer.endBlock();
+    }
+
+    EventlogAnalysis analysis;
+    EventlogDecoder decoder([&analysis](const EventlogEvent &event) { analysis.addEvent(event); });
+    QVERIFY(decoder.feed(writer.finish()));
+    analysis.finish();
+    // the second capability comes after the first one finished all of its collections
+    const EventlogSummary &summary = analysis.summary();
+    QCOMPARE(summary.capabilities, 2);
+    QCOMPARE(summary.gcCount, qint64(3));
+    QCOMPARE(summary.gcWallTime, qint64(200 + 100 + 300));
+    QCOMPARE(summary.maxGcPause, qint64(300));
+}
+
+void tst_Eventlog::timelineBins()
+{
+    EventlogTimeline timeline(4, 10);
+    timeline.addInterval(0, EventlogTimeline::Mutator, 5, 25);
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 0), qint64(5));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 1), qint64(10));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 2), qint64(5));
+    QCOMPARE(timeline.lastBin(), 2);
+    timeline.addCount(EventlogTimeline::GarbageCollections, 35);
+    QCOMPARE(timeline.lastBin(), 3);
+
+    // past the last bin, pairs of bins are merged
+    timeline.addCount(EventlogTimeline::GarbageCollections, 45);
+    QCOMPARE(timeline.binWidth(), qint64(20));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 0), qint64(15));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 1), qint64(5));
+    QCOMPARE(timeline.count(EventlogTimeline::GarbageCollections, 1), qint64(1));
+    QCOMPARE(timeline.count(EventlogTimeline::GarbageCollections, 2), qint64(1));
+    QCOMPARE(timeline.lastBin(), 2);
+
+    timeline.addInterval(0, EventlogTimeline::Mutator, 70, 90);
+    QCOMPARE(timeline.binWidth(), qint64(40));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 0), qint64(20));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 1), qint64(10));
+    QCOMPARE(timeline.time(0, EventlogTimeline::Mutator, 2), qint64(10));
+    QCOMPARE(timeline.count(EventlogTimeline::GarbageCollections, 0), qint64(1));
+    QCOMPARE(timeline.count(EventlogTimeline::GarbageCollections, 1), qint64(1));
+    QCOMPARE(timeline.lastBin(), 2);
+}
+
+QTEST_MAIN(tst_Eventlog)
+
+#include "tst_eventlog.moc"
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <haskellfolding.h>
+#include <haskelltokenizer.h>
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+
+using namespace Haskell::Internal;
+
+// the folds as "first line-last line", with blank lines taking the deeper level of the lines
+// around them like in the editor
+static QStringList folds(const QString &code)
+{
+    const QStringList lines = code.split('\n');
+    QVector<int> levels;
+    QVector<int> levelsBefore;
+    FoldingState state;
+    for (const QString &line : lines) {
+        levelsBefore.append(state.level);
+        const Tokens tokens = HaskellTokenizer::tokenize(line, state.tokenizerState);
+        levels.append(HaskellFolding::foldingLevel(state, line, tokens));
+    }
+    for (int i = levels.size() - 1; i >= 0; --i) {
+        if (levels.at(i) < 0) {
+            const int levelAfter = i + 1 < levels.size() ? levels.at(i + 1) : 0;
+            levels[i] = std::max(levelsBefore.at(i), levelAfter);
+        }
+    }
+    QStringList result;
+    for (int start = 0; start < levels.size(); ++start) {
+        int end = start;
+        while (end + 1 < levels.size() && levels.at(end + 1) > levels.at(start))
+            ++end;
+        if (end > start)
+            result.append(QString("%1-%2").arg(start).arg(end));
+    }
+    return result;
+}
+
+class tst_Folding : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void folds_data();
+    void folds();
+    void blankLine();
+    void blockState();
+};
+
+void tst_Folding::folds_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("top level") << "f = 1\ng = 2\n" << QStringList();
+    QTest::newRow("where") << "f = g\n"
+                              "  where\n"
+                              "    g = 1\n"
+                              "h = 2"
+                           << QStringList({"0-2", "1-2"});
+    QTest::newRow("instance") << "instance Show T where\n"
+                                 "  show A = \"a\"\n"
+                                 "\n"
+                                 "  show B = \"b\"\n"
+                                 "\n"
+                                 "main = print A"
+                              << QStringList({"0-4"});
+    QTest::newRow("blank after opener") << "main = do\n\n    print 1" << QStringList({"0-2"});
+    QTest::newRow("tabs") << "main = do\n\tprint 1\n        print 2" << QStringList({"0-2"});
+    QTest::newRow("nested comments") << "{- outer\n"
+                                        "   {- inner\n"
+                                        "   -}\n"
+                                        "-}\n"
+                                        "main = pure ()"
+                                     << QStringList({"0-3", "1-2"});
+    QTest::newRow("string gap") << "s = \"a\\\n    \\b\"\nt = 1" << QStringList({"0-1"});
+    QTest::newRow("imports") << "module Main where\n"
+                                "\n"
+                                "import Data.List\n"
+                                "import qualified Data.Map as Map\n"
+                                "\n"
+                                "-- local\n"
+                                "import Foo\n"
+                                "  ( bar\n"
+                                "  , baz )\n"
+                                "\n"
+                                "main = pure ()"
+                             << QStringList({"2-9", "6-9"});
+    QTest::newRow("comment in block") << "f = do\n  -- a\n  pure ()\ng = 1"
+                                      << QStringList({"0-2"});
+}
+
+void tst_Folding::folds()
+{
+    QFETCH(QString, code);
+    QFETCH(QStringList, expected);
+    QCOMPARE(::folds(code), expected);
+}
+
+void tst_Folding::blankLine()
+{
+    FoldingState state;
+    state.level = 32;
+    state.inImports = true;
+    const FoldingState before = state;
+    QCOMPARE(HaskellFolding::foldingLevel(state, "  \t", HaskellTokenizer::tokenize("  \t", -1)),
+             -1);
+    QCOMPARE(state, before);
+    QVERIFY(HaskellFolding::isBlank(" \t"));
+    QVERIFY(!HaskellFolding::isBlank(" x"));
+}
+
+void tst_Folding::blockState()
+{
+    QCOMPARE(FoldingState::fromBlockState(-1), FoldingState());
+    FoldingState state;
+    state.tokenizerState = int(Tokens::State::MultiLineCommentGuard) + 3;
+    state.level = 1234;
+    state.inImports = true;
+    QCOMPARE(FoldingState::fromBlockState(state.toBlockState()), state);
+    state.tokenizerState = int(Tokens::State::None);
+    QCOMPARE(FoldingState::fromBlockState(state.toBlockState()), state);
+    state.inCodeBlock = true;
+    QCOMPARE(FoldingState::fromBlockState(state.toBlockState()), state);
+    state.inImports = false;
+    QCOMPARE(FoldingState::fromBlockState(state.toBlockState()), state);
+    QVERIFY(state.toBlockState() >= 0);
+}
+
+QTEST_MAIN(tst_Folding)
+
+#include "tst_folding.moc"
@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <ghcdiagnostics.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+class tst_GhcDiagnostics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parse();
+    void moduleName();
+    void sourceRoot();
+    void supersededCheck();
+    void delay();
+};
+
+void tst_GhcDiagnostics::parse()
+{
+    const QString output
+        = "[1 of 2] Compiling Data.Shape ( src/Data/Shape.hs, nothing )\n"
+          "\n"
+          "src/Data/Shape.hs:12:5-10: error: [GHC-88464]\n"
+          "    Variable not in scope: radiu :: Double\n"
+          "    Suggested fix: Perhaps use `radius'\n"
+          "   |\n"
+          "12 |     radiu * 2\n"
+          "   |     ^^^^^^\n"
+          "\n"
+          "src/Data/Shape.hs:(20,1)-(22,8): warning: [-Wincomplete-patterns]\n"
+          "    Pattern match(es) are non-exhaustive\n"
+          "    In an equation for `area': Patterns not matched: Square\n"
+          "\r\n"
+          "C:\\p\\Main.hs:3:1: Warning:\n"
+          "    The import of `Data.List' is redundant\n";
+    const QVector<GhcDiagnostic> diagnostics = GhcDiagnostics::parse(output);
+    QCOMPARE(diagnostics.size(), 3);
+
+    const GhcDiagnostic &error = diagnostics.at(0);
+    QCOMPARE(error.filePath, QString("src/Data/Shape.hs"));
+    QCOMPARE(error.severity, GhcDiagnostic::Error);
+    QCOMPARE(error.line, 12);
+    QCOMPARE(error.column, 5);
+    QCOMPARE(error.endLine, 12);
+    QCOMPARE(error.endColumn, 10);
+    QCOMPARE(error.message, QString("[GHC-88464]\n"
+                                    "Variable not in scope: radiu :: Double\n"
+                                    "Suggested fix: Perhaps use `radius'"));
+
+    const GhcDiagnostic &warning = diagnostics.at(1);
+    QCOMPARE(warning.severity, GhcDiagnostic::Warning);
+    QCOMPARE(warning.line, 20);
+    QCOMPARE(warning.column, 1);
+    QCOMPARE(warning.endLine, 22);
+    QCOMPARE(warning.endColumn, 8);
+    QCOMPARE(warning.message, QString("[-Wincomplete-patterns]\n"
+                                      "Pattern match(es) are non-exhaustive\n"
+                                      "In an equation for `area': Patterns not matched: Square"));
+
+    // without -ferror-spans, from older GHC
+    const GhcDiagnostic &old = diagnostics.at(2);
+    QCOMPARE(old.filePath, QString("C:\\p\\Main.hs"));
+    QCOMPARE(old.severity, GhcDiagnostic::Warning);
+    QCOMPARE(old.line, 3);
+    QCOMPARE(old.endColumn, 1);
+    QCOMPARE(old.message, QString("The import of `Data.List' is redundant"));
+
+    QVERIFY(GhcDiagnostics::parse("Linking main ...\n").isEmpty());
+}
+
+void tst_GhcDiagnostics::moduleName()
+{
+    QCOMPARE(GhcDiagnostics::moduleName("{-# LANGUAGE LambdaCase #-}\n"
+                                        "module Data.Shape\n"
+                                        "    ( area\n"
+                                        "    ) where\n"),
+             QString("Data.Shape"));
+    QCOMPARE(GhcDiagnostics::moduleName("module Main (main) where\n"), QString("Main"));
+    QCOMPARE(GhcDiagnostics::moduleName("main = print 1\n"), QString());
+}
+
+void tst_GhcDiagnostics::sourceRoot()
+{
+    QCOMPARE(GhcDiagnostics::sourceRoot("/p/src/Data/Shape.hs", "Data.Shape"),
+             QString("/p/src"));
+    QCOMPARE(GhcDiagnostics::sourceRoot("/p/app/Main.hs", "Main"), QString("/p/app"));
+    QCOMPARE(GhcDiagnostics::sourceRoot("/p/app/Main.hs", ""), QString("/p/app"));
+}
+
+void tst_GhcDiagnostics::supersededCheck()
+{
+    CheckScheduler scheduler;
+    QVERIFY(!scheduler.isChecking());
+    const int first = scheduler.startCheck();
+    QVERIFY(scheduler.isChecking());
+    // an edit cancels it
+    scheduler.cancelCheck();
+    QVERIFY(!scheduler.finishCheck(first, 5000));
+    QCOMPARE(scheduler.delay(), CheckScheduler::minimumDelay);
+
+    const int second = scheduler.startCheck();
+    const int third = scheduler.startCheck();
+    QVERIFY(!scheduler.finishCheck(second, 100));
+    QVERIFY(scheduler.isChecking());
+    QVERIFY(scheduler.finishCheck(third, 4000));
+    QVERIFY(!scheduler.isChecking());
+    QCOMPARE(scheduler.averageDuration(), 4000);
+}
+
+void tst_GhcDiagnostics::delay()
+{
+    CheckScheduler scheduler;
+    QCOMPARE(scheduler.delay(), CheckScheduler::minimumDelay);
+    scheduler.finishCheck(scheduler.startCheck(), 4000);
+    QCOMPARE(scheduler.delay(), 2000);
+    // the latest check weighs most
+    scheduler.finishCheck(scheduler.startCheck(), 1000);
+    QCOMPARE(scheduler.averageDuration(), 3100);
+    QCOMPARE(scheduler.delay(), 1550);
+
+    for (int i = 0; i < 20; ++i)
+        scheduler.finishCheck(scheduler.startCheck(), 100);
+    QCOMPARE(scheduler.delay(), CheckScheduler::minimumDelay);
+    for (int i = 0; i < 20; ++i)
+        scheduler.finishCheck(scheduler.startCheck(), 60000);
+    QCOMPARE(scheduler.delay(), CheckScheduler::maximumDelay);
+}
+
+QTEST_MAIN(tst_GhcDiagnostics)
+
+#include "tst_ghcdiagnostics.moc"
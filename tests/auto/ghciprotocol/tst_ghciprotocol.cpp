@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <ghciprotocol.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+using Channel = GhciProtocol::Channel;
+using Kind = GhciProtocol::Event::Kind;
+
+// Plays the part of GHCi: answers commands from a script and prints the sentinels that the
+// protocol asks for.
+class FakeRepl
+{
+public:
+    struct Answer
+    {
+        QString output;
+        QString errorOutput;
+    };
+
+    void addAnswer(const QString &command, const Answer &answer) { m_script.insert(command, answer); }
+
+    // Returns the output chunks for the input, in the order they would appear on the pipes.
+    QList<QPair<Channel, QString>> run(const QString &input)
+    {
+        QList<QPair<Channel, QString>> result;
+        const QStringList lines = input.split('\n', Qt::SkipEmptyParts);
+        QStringList multiLine;
+        bool inMultiLine = false;
+        for (const QString &line : lines) {
+            if (line == ":{") {
+                inMultiLine = true;
+                multiLine.clear();
+            } else if (line == ":}") {
+                inMultiLine = false;
+                answer(multiLine.join('\n'), &result);
+            } else if (inMultiLine) {
+                multiLine.append(line);
+            } else {
+                answer(line, &result);
+            }
+        }
+        return result;
+    }
+
+private:
+    void answer(const QString &command, QList<QPair<Channel, QString>> *result)
+    {
+        static const QString stdOutPrefix = "System.IO.putStrLn ";
+        static const QString stdErrPrefix = "System.IO.hPutStrLn System.IO.stderr ";
+        if (command.startsWith(stdOutPrefix)) {
+            result->append({Channel::StdOut, decode(command.mid(stdOutPrefix.size())) + '\n'});
+        } else if (command.startsWith(stdErrPrefix)) {
+            result->append({Channel::StdErr, decode(command.mid(stdErrPrefix.size())) + '\n'});
+        } else {
+            const Answer answer = m_script.value(command);
+            if (!answer.output.isEmpty())
+                result->append({Channel::StdOut, answer.output});
+            if (!answer.errorOutput.isEmpty())
+                result->append({Channel::StdErr, answer.errorOutput});
+        }
+    }
+
+    static QString decode(QString literal)
+    {
+        literal = literal.mid(1, literal.size() - 2); // quotes
+        return literal.replace("\\SOH", QString(QChar(0x01))).replace("\\STX", QString(QChar(0x02)));
+    }
+
+    QHash<QString, Answer> m_script;
+};
+
+class Collector
+{
+public:
+    void add(const QList<GhciProtocol::Event> &events)
+    {
+        for (const GhciProtocol::Event &event : events) {
+            switch (event.kind) {
+            case Kind::Output:
+                output[event.id] += event.text;
+                break;
+            case Kind::ErrorOutput:
+                errorOutput[event.id] += event.text;
+                break;
+            case Kind::Finished:
+                finished.append(event.id);
+                break;
+            }
+        }
+    }
+
+    QHash<int, QString> output;
+    QHash<int, QString> errorOutput;
+    QList<int> finished;
+};
+
+class tst_GhciProtocol : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void singleRequest();
+    void pipelinedRequests();
+    void splitChunks();
+    void lateErrorOutput();
+    void unsolicitedOutput();
+    void multiLineCommand();
+
+private:
+    FakeRepl createRepl();
+};
+
+FakeRepl tst_GhciProtocol::createRepl()
+{
+    FakeRepl repl;
+    repl.addAnswer("1 + 1", {"2\n", {}});
+    repl.addAnswer(":type map", {"map :: (a -> b) -> [a] -> [b]\n", {}});
+    repl.addAnswer("foo", {{}, "<interactive>:1:1: error: Variable not in scope: foo\n"});
+    repl.addAnswer("let x = 1\n    y = 2", {{}, {}});
+    return repl;
+}
+
+void tst_GhciProtocol::singleRequest()
+{
+    FakeRepl repl = createRepl();
+    GhciProtocol protocol;
+    Collector collector;
+    for (const auto &chunk : repl.run(protocol.encode(1, "1 + 1")))
+        collector.add(protocol.feed(chunk.first, chunk.second));
+    QCOMPARE(collector.finished, QList<int>{1});
+    QCOMPARE(collector.output.value(1), QString("2\n"));
+    QVERIFY(collector.errorOutput.value(1).isEmpty());
+    QVERIFY(!protocol.hasPendingRequests());
+}
+
+void tst_GhciProtocol::pipelinedRequests()
+{
+    FakeRepl repl = createRepl();
+    GhciProtocol protocol;
+    Collector collector;
+    const QString input = protocol.encode(1, "1 + 1") + protocol.encode(2, ":type map")
+                          + protocol.encode(3, "foo");
+    QVERIFY(protocol.hasPendingRequests());
+    for (const auto &chunk : repl.run(input))
+        collector.add(protocol.feed(chunk.first, chunk.second));
+    QCOMPARE(collector.finished, (QList<int>{1, 2, 3}));
+    QCOMPARE(collector.output.value(1), QString("2\n"));
+    QCOMPARE(collector.output.value(2), QString("map :: (a -> b) -> [a] -> [b]\n"));
+    QVERIFY(collector.output.value(3).isEmpty());
+    QVERIFY(collector.errorOutput.value(3).contains("Variable not in scope"));
+    QVERIFY(!protocol.hasPendingRequests());
+}
+
+void tst_GhciProtocol::splitChunks()
+{
+    // pipes deliver arbitrary pieces, including pieces of a sentinel
+    FakeRepl repl = createRepl();
+    GhciProtocol protocol;
+    Collector collector;
+    const QString input = protocol.encode(1, "1 + 1") + protocol.encode(2, ":type map");
+    for (const auto &chunk : repl.run(input)) {
+        for (const QChar c : chunk.second)
+            collector.add(protocol.feed(chunk.first, QString(c)));
+    }
+    QCOMPARE(collector.finished, (QList<int>{1, 2}));
+    QCOMPARE(collector.output.value(1), QString("2\n"));
+    QCOMPARE(collector.output.value(2), QString("map :: (a -> b) -> [a] -> [b]\n"));
+}
+
+void tst_GhciProtocol::lateErrorOutput()
+{
+    // stderr can lag behind stdout, errors must still be attributed to the right request
+    FakeRepl repl = createRepl();
+    GhciProtocol protocol;
+    Collector collector;
+    const QString input = protocol.encode(1, "foo") + protocol.encode(2, "1 + 1");
+    const QList<QPair<Channel, QString>> chunks = repl.run(input);
+    for (const auto &chunk : chunks) {
+        if (chunk.first == Channel::StdOut)
+            collector.add(protocol.feed(chunk.first, chunk.second));
+    }
+    QVERIFY(collector.finished.isEmpty());
+    QCOMPARE(collector.output.value(2), QString("2\n"));
+    for (const auto &chunk : chunks) {
+        if (chunk.first == Channel::StdErr)
+            collector.add(protocol.feed(chunk.first, chunk.second));
+    }
+    QCOMPARE(collector.finished, (QList<int>{1, 2}));
+    QVERIFY(collector.errorOutput.value(1).contains("Variable not in scope"));
+    QVERIFY(collector.errorOutput.value(2).isEmpty());
+}
+
+void tst_GhciProtocol::unsolicitedOutput()
+{
+    GhciProtocol protocol;
+    Collector collector;
+    protocol.encode(1, ":set prompt \"\"");
+    collector.add(protocol.feed(Channel::StdOut, "Ok, one module loaded.\nghci> "));
+    collector.add(protocol.feed(Channel::StdOut, GhciProtocol::sentinel(1) + '\n'));
+    collector.add(protocol.feed(Channel::StdErr, GhciProtocol::sentinel(1) + '\n'));
+    // output in front of the first sentinel belongs to the first request
+    QCOMPARE(collector.output.value(1), QString("Ok, one module loaded.\nghci> "));
+    QCOMPARE(collector.finished, QList<int>{1});
+    collector.add(protocol.feed(Channel::StdOut, "stray output\n"));
+    QCOMPARE(collector.output.value(-1), QString("stray output\n"));
+}
+
+void tst_GhciProtocol::multiLineCommand()
+{
+    FakeRepl repl = createRepl();
+    GhciProtocol protocol;
+    Collector collector;
+    const QString input = protocol.encode(1, "let x = 1\n    y = 2");
+    QVERIFY(input.startsWith(":{\nlet x = 1\n    y = 2\n:}\n"));
+    for (const auto &chunk : repl.run(input))
+        collector.add(protocol.feed(chunk.first, chunk.second));
+    QCOMPARE(collector.finished, QList<int>{1});
+    QVERIFY(collector.output.value(1).isEmpty());
+}
+
+QTEST_MAIN(tst_GhciProtocol)
+
+#include "tst_ghciprotocol.moc"
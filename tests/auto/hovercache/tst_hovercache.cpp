@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <hovercache.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+static HoverKey key(int column, int revision = 1)
+{
+    return {"/p/Main.hs", revision, 3, column, 4};
+}
+
+class tst_HoverCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void find();
+    void revision();
+    void leastRecentlyUsed();
+};
+
+void tst_HoverCache::find()
+{
+    HoverCache cache;
+    QVERIFY(!cache.find(key(0)));
+    cache.insert(key(0), "area :: Shape -> Double");
+    QVERIFY(cache.find(key(0)));
+    QCOMPARE(*cache.find(key(0)), QString("area :: Shape -> Double"));
+
+    // a failed request is cached as well
+    cache.insert(key(8), {});
+    QVERIFY(cache.find(key(8)));
+    QVERIFY(cache.find(key(8))->isEmpty());
+
+    HoverKey other = key(0);
+    other.filePath = "/p/Other.hs";
+    QVERIFY(!cache.find(other));
+    other = key(0);
+    other.length = 2;
+    QVERIFY(!cache.find(other));
+    QCOMPARE(cache.size(), 2);
+}
+
+void tst_HoverCache::revision()
+{
+    HoverCache cache;
+    cache.insert(key(0, 1), "a :: Int");
+    QVERIFY(!cache.find(key(0, 2)));
+    cache.insert(key(0, 2), "a :: Double");
+    QCOMPARE(*cache.find(key(0, 1)), QString("a :: Int"));
+    QCOMPARE(*cache.find(key(0, 2)), QString("a :: Double"));
+}
+
+void tst_HoverCache::leastRecentlyUsed()
+{
+    HoverCache cache(3);
+    cache.insert(key(0), "a");
+    cache.insert(key(1), "b");
+    cache.insert(key(2), "c");
+    QVERIFY(cache.find(key(0))); // a is used more recently than b now
+    cache.insert(key(3), "d");
+    QCOMPARE(cache.size(), 3);
+    QVERIFY(!cache.find(key(1)));
+    QVERIFY(cache.find(key(0)));
+    QVERIFY(cache.find(key(2)));
+    QVERIFY(cache.find(key(3)));
+}
+
+QTEST_MAIN(tst_HoverCache)
+
+#include "tst_hovercache.moc"
@@ -0,0 +1,201 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <hpccoverage.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+static const char mix[]
+    = "Mix \"src/Data/Stack.hs\" 2024-05-01 10:20:30.123456789 UTC 3735928559 8 "
+      "[(3:1-6:20,TopLevelBox [\"push\"]),"
+      "(4:5-4:30,ExpBox False),"
+      "(5:5-6:20,ExpBox False),"
+      "(5:10-5:14,ExpBox False),"
+      "(6:7-6:11,BinBox CondBinBox True),"
+      "(6:7-6:11,BinBox CondBinBox False),"
+      "(8:1-8:20,TopLevelBox [\"pop\"]),"
+      "(8:9-8:20,LocalBox [\"pop\",\"go\"]),"
+      "(8:12-8:18,ExpBox True)]";
+
+static const char tix[]
+    = "Tix [TixModule \"stack-0.1.0.0-inplace/Data.Stack\" 3735928559 9 "
+      "[4,3,0,0,7,0,0,0,0],"
+      "TixModule \"Main\" 12 2 [1,0]]";
+
+class tst_HpcCoverage : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mix();
+    void mixErrors();
+    void tix();
+    void tixChunks();
+    void tixErrors();
+    void merge();
+    void coverage();
+    void coverageMismatch();
+};
+
+void tst_HpcCoverage::mix()
+{
+    MixModule module;
+    QString error;
+    QVERIFY2(parseMix(::mix, &module, &error), qPrintable(error));
+    QCOMPARE(module.sourceFile, QString("src/Data/Stack.hs"));
+    QCOMPARE(module.hash, qint64(3735928559));
+    QCOMPARE(module.entries.size(), 9);
+    QCOMPARE(module.entries.at(0).kind, MixModule::Entry::TopLevel);
+    QCOMPARE(module.entries.at(0).position.startLine, 3);
+    QCOMPARE(module.entries.at(0).position.endColumn, 20);
+    QCOMPARE(module.entries.at(4).kind, MixModule::Entry::Binary);
+    QVERIFY(module.entries.at(4).value);
+    QVERIFY(!module.entries.at(5).value);
+    QCOMPARE(module.entries.at(7).kind, MixModule::Entry::Local);
+
+    QVERIFY(parseMix("Mix \"Caf\\233.hs\" 2024-05-01 10:20:30 UTC 1 8 []", &module, &error));
+    QCOMPARE(module.sourceFile, QString::fromUtf8("Café.hs"));
+    QVERIFY(module.entries.isEmpty());
+}
+
+void tst_HpcCoverage::mixErrors()
+{
+    MixModule module;
+    QString error;
+    QVERIFY(!parseMix("Tix []", &module, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!parseMix("Mix \"A.hs\" 2024-05-01 10:20:30 UTC 1 8 [(1:1-1:2,ExpBox False)",
+                      &module, &error));
+    QVERIFY(!parseMix("Mix \"A.hs\" 2024-05-01 10:20:30 UTC 1 8 [(1:1,ExpBox False)]",
+                      &module, &error));
+}
+
+void tst_HpcCoverage::tix()
+{
+    TixParser parser;
+    QVERIFY(parser.feed(::tix));
+    QVERIFY2(parser.finish(), qPrintable(parser.errorString()));
+    const QVector<TixModule> modules = parser.takeModules();
+    QCOMPARE(modules.size(), 2);
+    QCOMPARE(modules.at(0).name, QString("stack-0.1.0.0-inplace/Data.Stack"));
+    QCOMPARE(modules.at(0).hash, qint64(3735928559));
+    QCOMPARE(modules.at(0).ticks, QVector<qint64>({4, 3, 0, 0, 7, 0, 0, 0, 0}));
+    QCOMPARE(modules.at(1).name, QString("Main"));
+    QCOMPARE(modules.at(1).ticks, QVector<qint64>({1, 0}));
+}
+
+void tst_HpcCoverage::tixChunks()
+{
+    // modules are available as soon as they are complete
+    const QByteArray data(::tix);
+    const int firstModuleEnd = data.indexOf(']', data.indexOf('[', 4) + 1) + 1;
+    TixParser parser;
+    QVERIFY(parser.feed(data.left(firstModuleEnd - 1)));
+    QVERIFY(parser.takeModules().isEmpty());
+    QVERIFY(parser.feed(data.mid(firstModuleEnd - 1, 1)));
+    QCOMPARE(parser.takeModules().size(), 1);
+
+    TixParser byteParser;
+    QVector<TixModule> modules;
+    for (int i = 0; i < data.size(); ++i) {
+        QVERIFY(byteParser.feed(data.mid(i, 1)));
+        modules += byteParser.takeModules();
+    }
+    QVERIFY(byteParser.finish());
+    QCOMPARE(modules.size(), 2);
+    QCOMPARE(modules.at(0).ticks.size(), 9);
+    QCOMPARE(modules.at(1).hash, qint64(12));
+}
+
+void tst_HpcCoverage::tixErrors()
+{
+    TixParser notTix;
+    QVERIFY(!notTix.feed("Mix [\"A.hs\"]"));
+    QVERIFY(!notTix.errorString().isEmpty());
+
+    TixParser wrongCount;
+    QVERIFY(!wrongCount.feed("Tix [TixModule \"Main\" 12 3 [1,0]]"));
+
+    TixParser truncated;
+    QVERIFY(truncated.feed("Tix [TixModule \"Main\" 12 2 [1,0]"));
+    QVERIFY(!truncated.finish());
+}
+
+void tst_HpcCoverage::merge()
+{
+    QHash<QString, TixModule> modules;
+    mergeTixModules(modules, {{"Main", 12, {1, 0}}, {"Lib", 5, {0, 2}}});
+    mergeTixModules(modules, {{"Main", 12, {2, 3}}, {"Main", 13, {1}}});
+    QCOMPARE(modules.size(), 3);
+    QCOMPARE(modules.value("Main#12").ticks, QVector<qint64>({3, 3}));
+    QCOMPARE(modules.value("Main#13").ticks, QVector<qint64>({1}));
+    QCOMPARE(modules.value("Lib#5").ticks, QVector<qint64>({0, 2}));
+}
+
+void tst_HpcCoverage::coverage()
+{
+    MixModule module;
+    QString error;
+    QVERIFY(parseMix(::mix, &module, &error));
+    TixParser parser;
+    QVERIFY(parser.feed(::tix) && parser.finish());
+    const TixModule ticks = parser.takeModules().first();
+
+    ModuleCoverage coverage;
+    QVERIFY(ModuleCoverage::compute(module, ticks, &coverage));
+    QCOMPARE(coverage.sourceFile, QString("src/Data/Stack.hs"));
+    QCOMPARE(coverage.expressions, 4);
+    QCOMPARE(coverage.coveredExpressions, 1);
+    QCOMPARE(coverage.percent(), 25);
+    QCOMPARE(coverage.topLevelDefinitions, 2);
+    QCOMPARE(coverage.coveredTopLevelDefinitions, 1);
+
+    // the nested expression that was not executed is not listed on its own
+    QCOMPARE(coverage.regions.size(), 3);
+    QCOMPARE(coverage.regions.at(0).kind, CoverageRegion::NotExecuted);
+    QCOMPARE(coverage.regions.at(0).position.startLine, 5);
+    QCOMPARE(coverage.regions.at(0).position.startColumn, 5);
+    QCOMPARE(coverage.regions.at(1).kind, CoverageRegion::AlwaysTrue);
+    QCOMPARE(coverage.regions.at(1).position.startLine, 6);
+    QCOMPARE(coverage.regions.at(2).kind, CoverageRegion::NotExecuted);
+    QCOMPARE(coverage.regions.at(2).position.startLine, 8);
+}
+
+void tst_HpcCoverage::coverageMismatch()
+{
+    MixModule module;
+    QString error;
+    QVERIFY(parseMix(::mix, &module, &error));
+    ModuleCoverage coverage;
+    QVERIFY(!ModuleCoverage::compute(module, {"Main", 12, {1, 0}}, &coverage));
+    QVERIFY(!ModuleCoverage::compute(module, {"Data.Stack", module.hash, {1}}, &coverage));
+}
+
+QTEST_MAIN(tst_HpcCoverage)
+
+#include "tst_hpccoverage.moc"
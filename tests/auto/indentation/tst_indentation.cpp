@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <haskellindentation.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+// the indentation of the last line, after the lines before it
+static int indentation(const QString &code, int indentSize)
+{
+    const QStringList lines = code.split('\n');
+    LayoutState state;
+    for (int i = 0; i < lines.size() - 1; ++i)
+        state = HaskellIndentation::nextState(state, lines.at(i));
+    return HaskellIndentation::indentation(state, lines.last(), indentSize);
+}
+
+class tst_Indentation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void indentation_data();
+    void indentation();
+    void state();
+    void electricLine_data();
+    void electricLine();
+};
+
+void tst_Indentation::indentation_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<int>("indentSize");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("top level") << "main :: IO ()\n" << 4 << 0;
+    QTest::newRow("do at end") << "main = do\n" << 4 << 4;
+    QTest::newRow("indent size") << "main = do\n" << 2 << 2;
+    QTest::newRow("do statement") << "main = do\n    putStrLn \"a\"\n" << 4 << 4;
+    QTest::newRow("do on same line") << "main = do putStrLn \"a\"\n" << 4 << 10;
+    QTest::newRow("offside rule") << "main = do\n"
+                                     "    forM_ xs $ \\x -> do\n"
+                                     "        print x\n"
+                                     "    print 1\n"
+                                  << 4 << 4;
+    QTest::newRow("explicit braces") << "main = do {\n" << 4 << 4;
+    QTest::newRow("continuation") << "foo x =\n" << 4 << 4;
+    QTest::newRow("comment line") << "main = do\n    -- a comment\n" << 4 << 4;
+    QTest::newRow("in comment") << "{- a comment\n" << 4 << -1;
+    QTest::newRow("tabs") << "main = do\n\tprint 1\n" << 4 << 8;
+
+    QTest::newRow("where") << "main = do\n    print x\nwhere" << 4 << 4;
+    QTest::newRow("after where") << "main = print x\n  where\n" << 4 << 6;
+    QTest::newRow("where closes do") << "main = do\n    print x\n  where\n" << 4 << 6;
+    QTest::newRow("where binding") << "main = print x\n  where\n    x = 1\n" << 4 << 4;
+    QTest::newRow("nested where") << "f = g\n  where\n    g = h\n      where h = 1\n" << 4 << 12;
+    QTest::newRow("class") << "class Show a where\n" << 4 << 4;
+    QTest::newRow("instance method") << "instance Show T where\n    show _ = \"T\"\n" << 4 << 4;
+
+    QTest::newRow("module") << "module Foo\n" << 4 << 4;
+    QTest::newRow("module exports") << "module Foo\n"
+                                       "    ( bar\n"
+                                       "    , baz\n"
+                                       "    ) where\n"
+                                    << 4 << 0;
+
+    QTest::newRow("case") << "f m = case m of\n" << 4 << 4;
+    QTest::newRow("alternative") << "f m = case m of\n    Just x -> x\n" << 4 << 4;
+    QTest::newRow("alternative continues") << "f m = case m of\n    Just x ->\n" << 4 << 8;
+    QTest::newRow("lambda case") << "f = \\case\n" << 4 << 4;
+
+    QTest::newRow("guard") << "f x\n| x > 0 = 1" << 4 << 4;
+    QTest::newRow("second guard") << "f x\n    | x > 0 = 1\n| otherwise = 0" << 4 << 4;
+    QTest::newRow("constructors") << "data Shape\n    = Circle\n| Square" << 4 << 4;
+
+    QTest::newRow("if") << "f x = if x\n" << 4 << 10;
+    QTest::newRow("then") << "f x = if x\nthen 1" << 4 << 10;
+    QTest::newRow("else") << "f x = if x\n          then 1\nelse 2" << 4 << 10;
+
+    QTest::newRow("let") << "f = let x = 1\n" << 4 << 8;
+    QTest::newRow("in") << "f = let x = 1\n        y = 2\nin x + y" << 4 << 4;
+    QTest::newRow("let in one line") << "f = let x = 1 in x\n" << 4 << 0;
+
+    QTest::newRow("list") << "xs = [ 1\n" << 4 << 7;
+    QTest::newRow("leading comma") << "xs =\n    [ 1\n    , 2\n, 3" << 4 << 4;
+    QTest::newRow("closing bracket") << "xs =\n    [ 1\n    , 2\n]" << 4 << 4;
+    QTest::newRow("bracket at end") << "foo = bar (\n" << 4 << 4;
+    QTest::newRow("record") << "data P = P\n    { name :: String\n" << 4 << 6;
+}
+
+void tst_Indentation::indentation()
+{
+    QFETCH(QString, code);
+    QFETCH(int, indentSize);
+    QFETCH(int, expected);
+    QCOMPARE(::indentation(code, indentSize), expected);
+}
+
+void tst_Indentation::state()
+{
+    // lines without code keep the state
+    const LayoutState initial = HaskellIndentation::nextState({}, "main = do");
+    QCOMPARE(HaskellIndentation::nextState(initial, "   "), initial);
+    QCOMPARE(HaskellIndentation::nextState(initial, "  -- comment"), initial);
+
+    const LayoutState inBlock = HaskellIndentation::nextState(initial, "    print 1");
+    QCOMPARE(inBlock.contexts.size(), 1);
+    QCOMPARE(inBlock.contexts.first().opener, QString("do"));
+    QCOMPARE(inBlock.contexts.first().column, 4);
+
+    // a block is empty if the next line is not indented further
+    const LayoutState empty = HaskellIndentation::nextState(initial, "foo = 1");
+    QVERIFY(empty.contexts.isEmpty());
+
+    // multi-line comments carry over
+    const LayoutState comment = HaskellIndentation::nextState(inBlock, "    {- print 2");
+    QCOMPARE(comment.contexts, inBlock.contexts);
+    QVERIFY(comment.tokenizerState != -1);
+    const LayoutState afterComment = HaskellIndentation::nextState(comment, "  -} print 3");
+    QCOMPARE(afterComment.tokenizerState, -1);
+    QCOMPARE(afterComment.contexts, inBlock.contexts);
+}
+
+void tst_Indentation::electricLine_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QChar>("typedChar");
+    QTest::addColumn<bool>("electric");
+
+    QTest::newRow("then") << "    then" << QChar('n') << true;
+    QTest::newRow("incomplete") << "  the" << QChar('e') << false;
+    QTest::newRow("else") << "    else" << QChar('e') << true;
+    QTest::newRow("where") << "  where" << QChar('e') << true;
+    QTest::newRow("in") << "in" << QChar('n') << true;
+    QTest::newRow("not first") << "  x = then" << QChar('n') << false;
+    QTest::newRow("bracket") << "  ]" << QChar(']') << true;
+    QTest::newRow("bracket not first") << "  x]" << QChar(']') << false;
+    QTest::newRow("guard") << "  |" << QChar('|') << true;
+    QTest::newRow("empty") << "" << QChar(')') << false;
+}
+
+void tst_Indentation::electricLine()
+{
+    QFETCH(QString, line);
+    QFETCH(QChar, typedChar);
+    QFETCH(bool, electric);
+    QCOMPARE(HaskellIndentation::isElectricLine(line, typedChar), electric);
+}
+
+QTEST_MAIN(tst_Indentation)
+
+#include "tst_indentation.moc"
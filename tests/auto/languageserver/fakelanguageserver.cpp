@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+// A language server that plays a script, to test language clients without
+// haskell-language-server. The script has one JSON object per line:
+//   "expect": the method of the next message the client is expected to send
+//   "result" or "error": the answer to the request
+//   "delay": milliseconds before answering, a $/cancelRequest for the request in the meantime
+//            answers with RequestCancelled instead
+//   "notify": the notifications that are sent to the client after the message
+// Messages that are not in the rest of the script are ignored, requests among them are answered
+// with MethodNotFound, except shutdown. The server exits with 0 after exit if every expected
+// message arrived, otherwise with 1.
+// The script is the first argument that is not an option, or the file in the environment variable
+// FAKE_LANGUAGE_SERVER_SCRIPT when the server is set as language server executable in Qt Creator.
+
+#include "lspframe.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+#include <cstdio>
+
+static const int methodNotFound = -32601;
+static const int requestCancelled = -32800;
+
+class FakeServer
+{
+public:
+    bool readScript(const QString &filePath);
+    void handle(const QJsonObject &message);
+    void endOfInput();
+
+private:
+    void send(const QJsonObject &message);
+    void answer(const QJsonValue &id, const QJsonObject &entry);
+    void answerError(const QJsonValue &id, int code, const QString &text);
+    void finish();
+
+    QVector<QJsonObject> m_script;
+    int m_next = 0; // in the script
+    int m_missed = 0;
+    bool m_finished = false;
+    QHash<QString, QJsonObject> m_delayed; // entries of requests not answered yet, by id
+};
+
+static QString idKey(const QJsonValue &id)
+{
+    return id.toVariant().toString();
+}
+
+bool FakeServer::readScript(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot read script \"%s\"\n", qPrintable(filePath));
+        return false;
+    }
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (!line.trimmed().isEmpty())
+            m_script.append(QJsonDocument::fromJson(line).object());
+    }
+    return true;
+}
+
+void FakeServer::handle(const QJsonObject &message)
+{
+    const QString method = message.value("method").toString();
+    const QJsonValue id = message.value("id");
+    const bool isRequest = !id.isUndefined();
+    if (method == "$/cancelRequest") {
+        const QJsonValue cancelledId = message.value("params").toObject().value("id");
+        if (m_delayed.remove(idKey(cancelledId)) > 0)
+            answerError(cancelledId, requestCancelled, "Request cancelled");
+    }
+
+    int entry = m_next;
+    while (entry < m_script.size() && m_script.at(entry).value("expect").toString() != method)
+        ++entry;
+    if (entry == m_script.size()) {
+        if (method == "shutdown")
+            send({{"jsonrpc", "2.0"}, {"id", id}, {"result", QJsonValue::Null}});
+        else if (isRequest)
+            answerError(id, methodNotFound, "Not in the script: " + method);
+    } else {
+        for (; m_next < entry; ++m_next) {
+            std::fprintf(stderr, "missed %s\n",
+                         qPrintable(m_script.at(m_next).value("expect").toString()));
+            ++m_missed;
+        }
+        const QJsonObject &scripted = m_script.at(m_next++);
+        if (isRequest)
+            answer(id, scripted);
+        for (const QJsonValue &notification : scripted.value("notify").toArray()) {
+            QJsonObject notificationMessage = notification.toObject();
+            notificationMessage.insert("jsonrpc", "2.0");
+            send(notificationMessage);
+        }
+    }
+    if (method == "exit")
+        finish();
+}
+
+void FakeServer::endOfInput()
+{
+    if (m_finished)
+        return;
+    std::fprintf(stderr, "input ended without exit\n");
+    m_finished = true;
+    QCoreApplication::exit(1);
+}
+
+void FakeServer::send(const QJsonObject &message)
+{
+    const QByteArray frame = lspFrame(message);
+    std::fwrite(frame.constData(), 1, size_t(frame.size()), stdout);
+    std::fflush(stdout);
+}
+
+void FakeServer::answer(const QJsonValue &id, const QJsonObject &entry)
+{
+    const int delay = entry.value("delay").toInt();
+    if (delay <= 0) {
+        QJsonObject response{{"jsonrpc", "2.0"}, {"id", id}};
+        if (entry.contains("error"))
+            response.insert("error", entry.value("error"));
+        else
+            response.insert("result", entry.value("result"));
+        send(response);
+        return;
+    }
+    const QString key = idKey(id);
+    m_delayed.insert(key, entry);
+    QTimer::singleShot(delay, [this, id, key] {
+        const auto it = m_delayed.find(key);
+        if (it == m_delayed.end())
+            return; // cancelled
+        QJsonObject entry = it.value();
+        m_delayed.erase(it);
+        entry.remove("delay");
+        answer(id, entry);
+    });
+}
+
+void FakeServer::answerError(const QJsonValue &id, int code, const QString &text)
+{
+    send({{"jsonrpc", "2.0"},
+          {"id", id},
+          {"error", QJsonObject{{"code", code}, {"message", text}}}});
+}
+
+void FakeServer::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+    for (; m_next < m_script.size(); ++m_next) {
+        std::fprintf(stderr, "missed %s\n",
+                     qPrintable(m_script.at(m_next).value("expect").toString()));
+        ++m_missed;
+    }
+    QCoreApplication::exit(m_missed == 0 ? 0 : 1);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QString scriptPath = qEnvironmentVariable("FAKE_LANGUAGE_SERVER_SCRIPT");
+    for (const QString &argument : app.arguments().mid(1)) {
+        if (!argument.startsWith('-'))
+            scriptPath = argument;
+    }
+    FakeServer server;
+    if (!server.readScript(scriptPath))
+        return 2;
+
+    // reads stdin blocking in its own thread, the messages are handled in the main thread
+    QThread *reader = QThread::create([&app, &server] {
+        QFile in;
+        in.open(stdin, QIODevice::ReadOnly);
+        while (true) {
+            int length = -1;
+            QByteArray header;
+            do {
+                header = in.readLine();
+                if (header.isEmpty()) {
+                    QMetaObject::invokeMethod(&app, [&server] { server.endOfInput(); });
+                    return;
+                }
+                const QList<QByteArray> field = header.split(':');
+                if (field.size() == 2 && field.first().trimmed().toLower() == "content-length")
+                    length = field.last().trimmed().toInt();
+            } while (!header.trimmed().isEmpty());
+            const QJsonObject message = QJsonDocument::fromJson(in.read(length)).object();
+            QMetaObject::invokeMethod(&app, [&server, message] { server.handle(message); });
+        }
+    });
+    reader->start();
+    const int result = app.exec();
+    // the reader might still block on stdin
+    reader->terminate();
+    reader->wait();
+    delete reader;
+    return result;
+}
@@ -0,0 +1,56 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "lspframe.h"
+
+#include <QJsonDocument>
+
+static const char headerEnd[] = "\r\n\r\n";
+static const char contentLength[] = "content-length:";
+
+QByteArray lspFrame(const QJsonObject &message)
+{
+    const QByteArray content = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    return "Content-Length: " + QByteArray::number(content.size()) + headerEnd + content;
+}
+
+bool LspFrameReader::next(QJsonObject *message)
+{
+    const int end = m_buffer.indexOf(headerEnd);
+    if (end < 0)
+        return false;
+    int length = -1;
+    for (const QByteArray &header : m_buffer.left(end).split('\n')) {
+        const QByteArray field = header.trimmed().toLower();
+        if (field.startsWith(contentLength))
+            length = field.mid(int(sizeof(contentLength)) - 1).trimmed().toInt();
+    }
+    const int start = end + int(sizeof(headerEnd)) - 1;
+    if (length < 0 || m_buffer.size() < start + length)
+        return false;
+    *message = QJsonDocument::fromJson(m_buffer.mid(start, length)).object();
+    m_buffer.remove(0, start + length);
+    return true;
+}
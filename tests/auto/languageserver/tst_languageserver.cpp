@@ -0,0 +1,199 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "lspframe.h"
+
+#include <QJsonArray>
+#include <QObject>
+#include <QProcess>
+#include <QTemporaryFile>
+#include <QtTest>
+
+// A client talking to the fake language server.
+class Session
+{
+public:
+    explicit Session(const QByteArray &script)
+    {
+        m_script.open();
+        m_script.write(script);
+        m_script.flush();
+        m_process.start(FAKE_LANGUAGE_SERVER, {m_script.fileName()});
+    }
+
+    bool isStarted() { return m_process.waitForStarted(); }
+
+    void request(int id, const QString &method, const QJsonObject &params = {})
+    {
+        m_process.write(lspFrame(
+            {{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", params}}));
+    }
+
+    void notify(const QString &method, const QJsonObject &params = {})
+    {
+        m_process.write(lspFrame({{"jsonrpc", "2.0"}, {"method", method}, {"params", params}}));
+    }
+
+    // Returns the next message from the server, or an empty object after the timeout.
+    QJsonObject receive()
+    {
+        QJsonObject message;
+        while (!m_reader.next(&message)) {
+            if (!m_process.waitForReadyRead(5000))
+                return {};
+            m_reader.append(m_process.readAllStandardOutput());
+        }
+        return message;
+    }
+
+    // Shuts the server down, returns its exit code.
+    int exit()
+    {
+        notify("exit");
+        m_process.closeWriteChannel();
+        if (!m_process.waitForFinished(5000))
+            return -1;
+        return m_process.exitCode();
+    }
+
+private:
+    QTemporaryFile m_script;
+    QProcess m_process;
+    LspFrameReader m_reader;
+};
+
+class tst_LanguageServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void frame();
+    void script();
+    void cancelSuperseded();
+    void missedMessage();
+};
+
+void tst_LanguageServer::frame()
+{
+    const QJsonObject message{{"jsonrpc", "2.0"}, {"method", "initialized"}};
+    const QByteArray frame = lspFrame(message);
+    QVERIFY(frame.startsWith("Content-Length: "));
+
+    // arrives in pieces
+    LspFrameReader reader;
+    QJsonObject read;
+    reader.append(frame.left(10));
+    QVERIFY(!reader.next(&read));
+    reader.append(frame.mid(10, frame.size() - 12));
+    QVERIFY(!reader.next(&read));
+    reader.append(frame.right(2) + frame);
+    QVERIFY(reader.next(&read));
+    QCOMPARE(read, message);
+    QVERIFY(reader.next(&read));
+    QCOMPARE(read, message);
+    QVERIFY(!reader.next(&read));
+}
+
+void tst_LanguageServer::script()
+{
+    Session session(
+        R"({"expect": "initialize", "result": {"capabilities": {"hoverProvider": true}}})" "\n"
+        R"({"expect": "initialized"})" "\n"
+        R"({"expect": "textDocument/didOpen", "notify": [)"
+        R"({"method": "textDocument/publishDiagnostics", "params": {"diagnostics": []}}]})" "\n"
+        R"({"expect": "shutdown", "result": null})" "\n"
+        R"({"expect": "exit"})" "\n");
+    QVERIFY(session.isStarted());
+
+    session.request(1, "initialize");
+    QJsonObject response = session.receive();
+    QCOMPARE(response.value("id").toInt(), 1);
+    QVERIFY(response.value("result").toObject().value("capabilities").toObject()
+                .value("hoverProvider").toBool());
+
+    session.notify("initialized");
+    // not in the script
+    session.notify("workspace/didChangeConfiguration");
+    session.request(2, "textDocument/documentSymbol");
+    response = session.receive();
+    QCOMPARE(response.value("id").toInt(), 2);
+    QCOMPARE(response.value("error").toObject().value("code").toInt(), -32601);
+
+    session.notify("textDocument/didOpen");
+    const QJsonObject notification = session.receive();
+    QCOMPARE(notification.value("method").toString(),
+             QString("textDocument/publishDiagnostics"));
+
+    session.request(3, "shutdown");
+    response = session.receive();
+    QCOMPARE(response.value("id").toInt(), 3);
+    QVERIFY(response.value("result").isNull());
+    QCOMPARE(session.exit(), 0);
+}
+
+void tst_LanguageServer::cancelSuperseded()
+{
+    Session session(
+        R"({"expect": "initialize", "result": {"capabilities": {}}})" "\n"
+        R"({"expect": "textDocument/hover", "delay": 10000, "result": {"contents": "old"}})" "\n"
+        R"({"expect": "textDocument/hover", "result": {"contents": "main :: IO ()"}})" "\n"
+        R"({"expect": "$/cancelRequest"})" "\n"
+        R"({"expect": "exit"})" "\n");
+    QVERIFY(session.isStarted());
+    session.request(1, "initialize");
+    QCOMPARE(session.receive().value("id").toInt(), 1);
+
+    // like the hover of the language client, which cancels the request a new one supersedes
+    session.request(2, "textDocument/hover");
+    session.request(3, "textDocument/hover");
+    session.notify("$/cancelRequest", {{"id", 2}});
+
+    // the current request is answered right away, the superseded one as cancelled
+    QStringList contents;
+    for (int i = 0; i < 2; ++i) {
+        const QJsonObject response = session.receive();
+        QVERIFY(!response.isEmpty());
+        if (response.value("id").toInt() == 2)
+            QCOMPARE(response.value("error").toObject().value("code").toInt(), -32800);
+        else
+            contents.append(response.value("result").toObject().value("contents").toString());
+    }
+    QCOMPARE(contents, QStringList("main :: IO ()"));
+    QCOMPARE(session.exit(), 0);
+}
+
+void tst_LanguageServer::missedMessage()
+{
+    Session session(
+        R"({"expect": "textDocument/didOpen"})" "\n"
+        R"({"expect": "textDocument/didChange"})" "\n"
+        R"({"expect": "exit"})" "\n");
+    QVERIFY(session.isStarted());
+    session.notify("textDocument/didOpen");
+    QCOMPARE(session.exit(), 1);
+}
+
+QTEST_MAIN(tst_LanguageServer)
+
+#include "tst_languageserver.moc"
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <haskelltokenizer.h>
+#include <literatehaskell.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+using LineType = LiterateHaskell::LineType;
+
+Q_DECLARE_METATYPE(LineType)
+
+static const char birdTracks[]
+    = "A module with bird tracks.\n"
+      "\n"
+      "> module Main where\n"
+      ">\n"
+      "> main = print 1 {- a\n"
+      "Prose in a comment.\n"
+      "> b -}\n";
+
+static const char codeBlocks[]
+    = "\\documentclass{article}\n"
+      "\\begin{code}\n"
+      "main = print 1\n"
+      "> x\n"
+      "\\end{code}\n"
+      "> y\n";
+
+class tst_LiterateHaskell : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void isLiterateFile();
+    void lineType_data();
+    void lineType();
+    void unlit();
+    void tokenize();
+};
+
+void tst_LiterateHaskell::isLiterateFile()
+{
+    QVERIFY(LiterateHaskell::isLiterateFile("/p/Main.lhs"));
+    QVERIFY(!LiterateHaskell::isLiterateFile("/p/Main.hs"));
+}
+
+void tst_LiterateHaskell::lineType_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<bool>("inCodeBlock");
+    QTest::addColumn<LineType>("type");
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<int>("codeColumn");
+
+    QTest::newRow("prose") << "Some text." << false << LineType::Prose << "" << 0;
+    QTest::newRow("indented track") << " > x" << false << LineType::Prose << "" << 0;
+    QTest::newRow("bird track") << "> f x = x" << false << LineType::BirdTrack << "f x = x" << 2;
+    QTest::newRow("indented code") << ">   where" << false << LineType::BirdTrack << "  where"
+                                   << 2;
+    QTest::newRow("no space") << ">f x = x" << false << LineType::BirdTrack << "f x = x" << 1;
+    QTest::newRow("empty track") << ">" << false << LineType::BirdTrack << "" << 1;
+    QTest::newRow("begin") << "\\begin{code}" << false << LineType::CodeDelimiter << "" << 0;
+    QTest::newRow("code") << "f x = x" << true << LineType::Code << "f x = x" << 0;
+    QTest::newRow("track in block") << "> x" << true << LineType::Code << "> x" << 0;
+    QTest::newRow("begin in block") << "\\begin{code}" << true << LineType::Code
+                                    << "\\begin{code}" << 0;
+    QTest::newRow("end") << "\\end{code}" << true << LineType::CodeDelimiter << "" << 0;
+    QTest::newRow("end outside") << "\\end{code}" << false << LineType::Prose << "" << 0;
+}
+
+void tst_LiterateHaskell::lineType()
+{
+    QFETCH(QString, line);
+    QFETCH(bool, inCodeBlock);
+    QFETCH(LineType, type);
+    QFETCH(QString, code);
+    QFETCH(int, codeColumn);
+    QCOMPARE(LiterateHaskell::lineType(line, inCodeBlock), type);
+    QCOMPARE(LiterateHaskell::code(line, type), code);
+    QCOMPARE(LiterateHaskell::codeColumn(line, type), codeColumn);
+}
+
+void tst_LiterateHaskell::unlit()
+{
+    QVector<int> codeColumns;
+    QCOMPARE(LiterateHaskell::unlit(birdTracks, &codeColumns),
+             QString("\n"
+                     "\n"
+                     "module Main where\n"
+                     "\n"
+                     "main = print 1 {- a\n"
+                     "\n"
+                     "b -}\n"));
+    QCOMPARE(codeColumns, QVector<int>({0, 0, 2, 1, 2, 0, 2, 0}));
+    QCOMPARE(LiterateHaskell::unlit(codeBlocks),
+             QString("\n"
+                     "\n"
+                     "main = print 1\n"
+                     "> x\n"
+                     "\n"
+                     "y\n"));
+}
+
+void tst_LiterateHaskell::tokenize()
+{
+    // top-level declarations start in the first column of the code
+    const Tokens tokens = HaskellTokenizer::tokenize(
+        LiterateHaskell::code("> area = pi", LineType::BirdTrack), -1);
+    QCOMPARE(tokens.tokenAtColumn(0).type, TokenType::Variable);
+    QCOMPARE(tokens.tokenAtColumn(0).text.toString(), QString("area"));
+    QCOMPARE(tokens.tokenAtColumn(7).text.toString(), QString("pi"));
+
+    // a comment continues in the next code line after prose
+    const QStringList lines = LiterateHaskell::unlit(birdTracks).split('\n');
+    int state = -1;
+    for (int i = 0; i < 6; ++i)
+        state = HaskellTokenizer::tokenize(lines.at(i), state).state;
+    QCOMPARE(state, int(Tokens::State::MultiLineCommentGuard) + 1);
+    QCOMPARE(HaskellTokenizer::tokenize(lines.at(6), state).state, int(Tokens::State::None));
+}
+
+QTEST_MAIN(tst_LiterateHaskell)
+
+#include "tst_literatehaskell.moc"
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <haskelloutline.h>
+#include <literatehaskell.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+static const char module[]
+    = "{-# LANGUAGE LambdaCase #-}\n"
+      "module Data.Shape\n"
+      "  ( Shape (..)\n"
+      "  , area\n"
+      "  ) where\n"
+      "\n"
+      "import qualified Data.Map as Map\n"
+      "import Data.List (sort)\n"
+      "\n"
+      "-- | A shape.\n"
+      "data Shape a = Circle a | Rect a a\n"
+      "  deriving Show\n"
+      "\n"
+      "class Sized s where\n"
+      "  size :: s -> Int\n"
+      "\n"
+      "instance Num a => Sized (Shape a) where\n"
+      "  size _ = 1\n"
+      "\n"
+      "area :: Shape Double\n"
+      "     -> Double\n"
+      "area (Circle r) = pi * r * r\n"
+      "area (Rect w h) = w * h\n"
+      "\n"
+      "{- perimeter :: Shape Double -> Double\n"
+      "perimeter = undefined -}\n"
+      "\n"
+      "x <+> y = x + y\n"
+      "\n"
+      "clamp\n"
+      "  :: Int -> Int\n"
+      "clamp n\n"
+      "  | n < 0 = 0\n"
+      "  | otherwise = n\n";
+
+// kind:name:detail:line
+static QStringList describe(const QVector<OutlineItem> &items)
+{
+    QStringList result;
+    for (const OutlineItem &item : items) {
+        result.append(QString("%1:%2:%3:%4").arg(item.kind).arg(item.name, item.detail)
+                          .arg(item.line));
+    }
+    return result;
+}
+
+static HaskellOutline parse(const QString &code)
+{
+    HaskellOutline outline;
+    outline.update(0, 0, code.split('\n'));
+    return outline;
+}
+
+class tst_Outline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void items();
+    void declarations_data();
+    void declarations();
+    void update_data();
+    void update();
+    void commentStartsLater();
+    void literate();
+};
+
+void tst_Outline::items()
+{
+    const HaskellOutline outline = parse(module);
+    QCOMPARE(outline.lineCount(), 35);
+    QCOMPARE(describe(outline.items()),
+             QStringList({"0:Data.Shape::1",
+                          "1:Data.Map:as Map:6",
+                          "1:Data.List:(sort):7",
+                          "2:Shape:a:10",
+                          "3:Sized:s:13",
+                          "4:Sized (Shape a):Num a:16",
+                          "5:area:Shape Double -> Double:19",
+                          "5:(<+>)::27",
+                          "5:clamp:Int -> Int:29"}));
+}
+
+void tst_Outline::declarations_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("several names") << "f, g :: Int\nf = 1"
+                                   << QStringList({"5:f:Int:0", "5:g:Int:0"});
+    QTest::newRow("operator signature") << "(<+>) :: Int -> Int -> Int"
+                                        << QStringList({"5:(<+>):Int -> Int -> Int:0"});
+    QTest::newRow("backticks") << "x `plus` y = x + y" << QStringList({"5:plus::0"});
+    QTest::newRow("equations") << "f 0 = 1\nf n = n * f (n - 1)" << QStringList({"5:f::0"});
+    QTest::newRow("newtype") << "newtype Age = Age Int" << QStringList({"2:Age::0"});
+    QTest::newRow("type family") << "type family Elem c :: Type"
+                                 << QStringList({"2:Elem:c:0"});
+    QTest::newRow("type instance") << "type instance Elem [e] = e"
+                                   << QStringList({"4:Elem [e]::0"});
+    QTest::newRow("class with context") << "class (Eq a) => Ord a where"
+                                        << QStringList({"3:Ord:a:0"});
+    QTest::newRow("standalone deriving") << "deriving stock instance Show T"
+                                         << QStringList({"4:Show T::0"});
+    QTest::newRow("foreign import") << "foreign import ccall \"sin\" c_sin :: Double -> Double"
+                                    << QStringList({"5:c_sin:Double -> Double:0"});
+    QTest::newRow("pattern synonym") << "pattern Zero :: Int\npattern Zero = 0"
+                                     << QStringList({"5:Zero:Int:0"});
+    QTest::newRow("splice") << "makeLenses ''Shape" << QStringList();
+    QTest::newRow("local definitions") << "f = g\n  where\n    g = 1" << QStringList({"5:f::0"});
+    QTest::newRow("string gap") << "s = \"a\\\n\\b\"\nt = 1"
+                                << QStringList({"5:s::0", "5:t::2"});
+}
+
+void tst_Outline::declarations()
+{
+    QFETCH(QString, code);
+    QFETCH(QStringList, expected);
+    QCOMPARE(describe(parse(code).items()), expected);
+}
+
+void tst_Outline::update_data()
+{
+    QTest::addColumn<int>("firstLine");
+    QTest::addColumn<int>("removedLines");
+    QTest::addColumn<QStringList>("lines");
+
+    QTest::newRow("insert") << 9 << 0 << QStringList({"f = 1", ""});
+    QTest::newRow("remove") << 19 << 2 << QStringList();
+    QTest::newRow("replace") << 10 << 2 << QStringList({"data Shape = Point"});
+    QTest::newRow("open comment") << 5 << 1 << QStringList({"{-"});
+    QTest::newRow("close comment") << 25 << 1 << QStringList({"perimeter = undefined"});
+    QTest::newRow("continue signature") << 21 << 0 << QStringList({"     -> Double"});
+    QTest::newRow("at end") << 35 << 0 << QStringList({"g = 2"});
+}
+
+void tst_Outline::update()
+{
+    QFETCH(int, firstLine);
+    QFETCH(int, removedLines);
+    QFETCH(QStringList, lines);
+
+    // an update gives what parsing the changed module does
+    HaskellOutline outline = parse(module);
+    outline.update(firstLine, removedLines, lines);
+    QStringList changed = QString(module).split('\n');
+    changed.erase(changed.begin() + firstLine, changed.begin() + firstLine + removedLines);
+    for (int i = 0; i < lines.size(); ++i)
+        changed.insert(firstLine + i, lines.at(i));
+    QCOMPARE(outline.lineCount(), changed.size());
+    QCOMPARE(describe(outline.items()), describe(parse(changed.join('\n')).items()));
+}
+
+void tst_Outline::commentStartsLater()
+{
+    // the lines after an edit are only scanned again while their state changes
+    HaskellOutline outline = parse("f = 1\ng = 2\nh = 3");
+    outline.update(1, 1, {"{- g = 2"});
+    QCOMPARE(describe(outline.items()), QStringList({"5:f::0"}));
+    outline.update(1, 1, {"g = 2"});
+    QCOMPARE(describe(outline.items()), QStringList({"5:f::0", "5:g::1", "5:h::2"}));
+}
+
+void tst_Outline::literate()
+{
+    // the bird tracks do not make the declarations continuations
+    const QString source = "A module with bird tracks.\n"
+                           "\n"
+                           "> module Main where\n"
+                           "> import Data.List (sort)\n"
+                           "\n"
+                           "Sorts the lines of the input.\n"
+                           "\n"
+                           "> main :: IO ()\n"
+                           "> main = interact sorted\n"
+                           ">   where sorted = unlines . sort . lines\n";
+    QCOMPARE(describe(parse(LiterateHaskell::unlit(source)).items()),
+             QStringList({"0:Main::2", "1:Data.List:(sort):3", "5:main:IO ():7"}));
+}
+
+QTEST_MAIN(tst_Outline)
+
+#include "tst_outline.moc"
@@ -0,0 +1,274 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <outputlog.h>
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+class tst_OutputLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lines();
+    void memoryLimit();
+    void spillFile();
+    void search();
+    void searchSkipsBlocks();
+    void searchChannels();
+    void fullBlocks();
+    void mergeBlocks();
+    void requiredLiteral_data();
+    void requiredLiteral();
+};
+
+static QStringList texts(const QVector<OutputLog::Line> &lines)
+{
+    QStringList result;
+    for (const OutputLog::Line &line : lines)
+        result << line.text;
+    return result;
+}
+
+void tst_OutputLog::lines()
+{
+    OutputLog log;
+    log.addOutput("first\r\nsec", OutputLog::Channel::StdOut);
+    log.addOutput("error\n", OutputLog::Channel::StdErr);
+    log.addOutput("ond\nthird", OutputLog::Channel::StdOut);
+    QCOMPARE(log.lineCount(), qint64(3));
+    const QVector<OutputLog::Line> lines = log.takeNewLines();
+    QCOMPARE(texts(lines), QStringList({"first", "error", "second"}));
+    QCOMPARE(lines.at(1).channel, OutputLog::Channel::StdErr);
+    QCOMPARE(lines.at(2).number, qint64(2));
+    QVERIFY(log.takeNewLines().isEmpty());
+
+    log.finish();
+    QCOMPARE(texts(log.takeNewLines()), QStringList({"third"}));
+}
+
+void tst_OutputLog::memoryLimit()
+{
+    OutputLog log(4096);
+    for (int i = 0; i < 1000; ++i)
+        log.addOutput(QString("line %1\n").arg(i), OutputLog::Channel::StdOut);
+    QCOMPARE(log.lineCount(), qint64(1000));
+    const std::deque<OutputLog::Line> &recent = log.recentLines();
+    QVERIFY(recent.size() < 1000);
+    QVERIFY(recent.size() > 10);
+    QCOMPARE(recent.back().text, QString("line 999"));
+    QCOMPARE(recent.front().number, qint64(1000 - recent.size()));
+
+    // new lines that were dropped in between are not returned
+    QCOMPARE(log.takeNewLines().size(), int(recent.size()));
+
+    // lines without a newline do not grow without bound
+    log.addOutput(QString(100 * 1024, 'x'), OutputLog::Channel::StdOut);
+    QCOMPARE(log.lineCount(), qint64(1001));
+}
+
+void tst_OutputLog::spillFile()
+{
+    QTemporaryDir directory;
+    const QString filePath = directory.filePath("output.log");
+    {
+        OutputLog log(1024);
+        QVERIFY(log.openSpillFile(filePath));
+        log.setBlockSize(10);
+        for (int i = 0; i < 25; ++i)
+            log.addOutput(QString("line %1\n").arg(i), OutputLog::Channel::StdOut);
+        const QVector<OutputLog::Block> blocks = log.blocks();
+        QCOMPARE(blocks.size(), 3);
+        QCOMPARE(blocks.at(1).firstLine, qint64(10));
+        QCOMPARE(blocks.at(2).lineCount, 5);
+
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QByteArray contents = file.readAll();
+        QCOMPARE(contents.count('\n'), 25);
+        QCOMPARE(contents.mid(int(blocks.at(1).offset), 9), QByteArray("Oline 10\n"));
+    }
+    // the log is temporary
+    QVERIFY(!QFile::exists(filePath));
+}
+
+void tst_OutputLog::search()
+{
+    QTemporaryDir directory;
+    OutputLog log;
+    QVERIFY(log.openSpillFile(directory.filePath("output.log")));
+    log.setBlockSize(4);
+    for (int i = 0; i < 20; ++i) {
+        log.addOutput(i % 5 == 0 ? QString("Request %1 failed: timeout\n").arg(i)
+                                 : QString("Request %1 done\n").arg(i),
+                      OutputLog::Channel::StdOut);
+    }
+    const QVector<OutputLog::Block> blocks = log.blocks();
+
+    QVector<qint64> matches;
+    const QRegularExpression pattern("FAILED: \\w+", QRegularExpression::CaseInsensitiveOption);
+    OutputLog::search(log.spillFilePath(), blocks, pattern, [&](const OutputLog::Line &line) {
+        matches.append(line.number);
+        return true;
+    });
+    QCOMPARE(matches, QVector<qint64>({0, 5, 10, 15}));
+
+    // the callback stops the search
+    matches.clear();
+    OutputLog::search(log.spillFilePath(), blocks, pattern, [&](const OutputLog::Line &line) {
+        matches.append(line.number);
+        return matches.size() < 2;
+    });
+    QCOMPARE(matches.size(), 2);
+}
+
+void tst_OutputLog::searchSkipsBlocks()
+{
+    QTemporaryDir directory;
+    OutputLog log;
+    QVERIFY(log.openSpillFile(directory.filePath("output.log")));
+    log.setBlockSize(100);
+    for (int i = 0; i < 1000; ++i)
+        log.addOutput(QString("GET /index.html 200\n"), OutputLog::Channel::StdOut);
+    log.addOutput("Exception: connection reset\n", OutputLog::Channel::StdErr);
+    const QVector<OutputLog::Block> blocks = log.blocks();
+    QCOMPARE(blocks.size(), 11);
+
+    QStringList matches;
+    const int readBlocks = OutputLog::search(log.spillFilePath(), blocks,
+                                             QRegularExpression("exception: .*reset"),
+                                             [&](const OutputLog::Line &line) {
+                                                 matches.append(line.text);
+                                                 return true;
+                                             });
+    QCOMPARE(readBlocks, 1);
+    QVERIFY(matches.isEmpty()); // the pattern is case sensitive
+
+    const int allBlocks = OutputLog::search(log.spillFilePath(), blocks,
+                                            QRegularExpression("\\d+$"),
+                                            [](const OutputLog::Line &) { return true; });
+    QCOMPARE(allBlocks, 11);
+}
+
+void tst_OutputLog::searchChannels()
+{
+    QTemporaryDir directory;
+    OutputLog log;
+    QVERIFY(log.openSpillFile(directory.filePath("output.log")));
+    log.addOutput("Listening on port 8080\n", OutputLog::Channel::StdOut);
+    log.addOutput("Error: port 8081 in use\n", OutputLog::Channel::StdErr);
+
+    QVector<OutputLog::Line> matches;
+    OutputLog::search(log.spillFilePath(), log.blocks(), QRegularExpression("port"),
+                      [&](const OutputLog::Line &line) {
+                          matches.append(line);
+                          return true;
+                      });
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(matches.at(0).channel, OutputLog::Channel::StdOut);
+    QCOMPARE(matches.at(0).text, QString("Listening on port 8080"));
+    QCOMPARE(matches.at(1).channel, OutputLog::Channel::StdErr);
+    QCOMPARE(matches.at(1).text, QString("Error: port 8081 in use"));
+}
+
+void tst_OutputLog::fullBlocks()
+{
+    QTemporaryDir directory;
+    OutputLog log;
+    QVERIFY(log.openSpillFile(directory.filePath("output.log")));
+    for (int i = 0; i < 1000; ++i) {
+        const quint64 id = quint64(i + 1) * 0x9E3779B97F4A7C15ull;
+        log.addOutput(QString("request %1\n").arg(id, 16, 16, QChar('0')),
+                      OutputLog::Channel::StdOut);
+    }
+    // the lines would fit into one block, but its set would be full
+    const QVector<OutputLog::Block> blocks = log.blocks();
+    QVERIFY(blocks.size() > 1);
+    qint64 lines = 0;
+    for (const OutputLog::Block &block : blocks) {
+        QVERIFY(block.trigrams.count() < block.trigrams.size() / 2);
+        lines += block.lineCount;
+    }
+    QCOMPARE(lines, qint64(1000));
+}
+
+void tst_OutputLog::mergeBlocks()
+{
+    QTemporaryDir directory;
+    OutputLog log;
+    QVERIFY(log.openSpillFile(directory.filePath("output.log")));
+    log.setBlockSize(10);
+    log.setMaximumBlockCount(4);
+    for (int i = 0; i < 100; ++i)
+        log.addOutput(QString("line %1\n").arg(i), OutputLog::Channel::StdOut);
+    const QVector<OutputLog::Block> blocks = log.blocks();
+    QVERIFY(blocks.size() <= 4);
+    qint64 nextLine = 0;
+    for (const OutputLog::Block &block : blocks) {
+        QCOMPARE(block.firstLine, nextLine);
+        nextLine += block.lineCount;
+    }
+    QCOMPARE(nextLine, qint64(100));
+
+    QVector<qint64> matches;
+    OutputLog::search(log.spillFilePath(), blocks, QRegularExpression("^line 42$"),
+                      [&](const OutputLog::Line &line) {
+                          matches.append(line.number);
+                          return true;
+                      });
+    QCOMPARE(matches, QVector<qint64>({42}));
+}
+
+void tst_OutputLog::requiredLiteral_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("literal");
+
+    QTest::newRow("plain") << "timeout" << "timeout";
+    QTest::newRow("classes") << "\\d+ requests? in \\d+ms" << " request";
+    QTest::newRow("escaped") << "GET /api\\.v2" << "GET /api.v2";
+    QTest::newRow("optional") << "colou?r" << "colo";
+    QTest::newRow("repeated") << "ab{2,3}cdefg" << "cdefg";
+    QTest::newRow("group") << "(connection )?reset" << "reset";
+    QTest::newRow("alternatives") << "error|warning" << "";
+    QTest::newRow("character class") << "[Ee]rror code" << "rror code";
+    QTest::newRow("any") << "a.b" << "a";
+}
+
+void tst_OutputLog::requiredLiteral()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, literal);
+    QCOMPARE(OutputLog::requiredLiteral(pattern), literal);
+}
+
+QTEST_MAIN(tst_OutputLog)
+
+#include "tst_outputlog.moc"
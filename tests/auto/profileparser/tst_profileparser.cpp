@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <profileparser.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+class tst_ProfileParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void timeProfile();
+    void legacyTimeProfile();
+    void invalidTimeProfile();
+    void heapProfile();
+    void incompleteHeapProfile();
+    void invalidHeapProfile();
+};
+
+void tst_ProfileParser::timeProfile()
+{
+    QFile file(QFINDTESTDATA("data/fib.prof"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TimeProfile profile;
+    QString error;
+    QVERIFY2(parseTimeProfile(&file, &profile, &error), qPrintable(error));
+    QCOMPARE(profile.command, QString("fib +RTS -p -hT -RTS 25"));
+    QCOMPARE(profile.totalTime, 1.52);
+    QCOMPARE(profile.totalTicks, qint64(1520));
+    QCOMPARE(profile.totalAlloc, qint64(1234567890));
+
+    QCOMPARE(profile.root.children.size(), size_t(1));
+    const CostCentre &main = profile.root.children.at(0);
+    QCOMPARE(main.name, QString("MAIN"));
+    QCOMPARE(main.source, QString("<built-in>"));
+    QCOMPARE(main.inheritedTime, 100.0);
+    QCOMPARE(main.children.size(), size_t(2));
+    QCOMPARE(main.children.at(0).module, QString("GHC.IO.Handle.FD"));
+
+    const CostCentre &caf = main.children.at(1);
+    QCOMPARE(caf.children.size(), size_t(1));
+    const CostCentre &mainFunction = caf.children.at(0);
+    QCOMPARE(mainFunction.name, QString("main"));
+    QCOMPARE(mainFunction.number, 237);
+    QCOMPARE(mainFunction.children.size(), size_t(2));
+
+    const CostCentre &fib = mainFunction.children.at(0);
+    QCOMPARE(fib.name, QString("fib"));
+    QCOMPARE(fib.module, QString("Main"));
+    QCOMPARE(fib.source, QString("app/Main.hs:(8,1)-(10,29)"));
+    QCOMPARE(fib.number, 239);
+    QCOMPARE(fib.entries, qint64(242785));
+    QCOMPARE(fib.individualTime, 92.1);
+    QCOMPARE(fib.individualAlloc, 95.0);
+    QCOMPARE(fib.inheritedTime, 92.1);
+    QCOMPARE(fib.inheritedAlloc, 95.0);
+    QCOMPARE(fib.ticks, qint64(-1));
+    QVERIFY(fib.children.empty());
+    QCOMPARE(mainFunction.children.at(1).source, QString("app/Main.hs:6:12-25"));
+}
+
+void tst_ProfileParser::legacyTimeProfile()
+{
+    // GHC before 8.0 has no SRC column, +RTS -P adds ticks and bytes
+    QFile file(QFINDTESTDATA("data/legacy.prof"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TimeProfile profile;
+    QString error;
+    QVERIFY2(parseTimeProfile(&file, &profile, &error), qPrintable(error));
+    QCOMPARE(profile.totalAlloc, qint64(4096));
+    QCOMPARE(profile.root.children.size(), size_t(1));
+    const CostCentre &main = profile.root.children.at(0);
+    QCOMPARE(main.children.size(), size_t(1));
+    const CostCentre &loop = main.children.at(0);
+    QCOMPARE(loop.name, QString("loop"));
+    QVERIFY(loop.source.isEmpty());
+    QCOMPARE(loop.entries, qint64(10));
+    QCOMPARE(loop.individualTime, 100.0);
+    QCOMPARE(loop.ticks, qint64(20));
+    QCOMPARE(loop.bytes, qint64(2048));
+}
+
+void tst_ProfileParser::invalidTimeProfile()
+{
+    QBuffer buffer;
+    buffer.setData("JOB \"fib\"\nBEGIN_SAMPLE 0.00\n");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    TimeProfile profile;
+    QString error;
+    QVERIFY(!parseTimeProfile(&buffer, &profile, &error));
+    QVERIFY(!error.isEmpty());
+
+    QBuffer truncated;
+    truncated.setData("COST CENTRE MODULE no. entries %time %alloc %time %alloc\n\nMAIN MAIN 1 0\n");
+    QVERIFY(truncated.open(QIODevice::ReadOnly));
+    QVERIFY(!parseTimeProfile(&truncated, &profile, &error));
+}
+
+void tst_ProfileParser::heapProfile()
+{
+    QFile file(QFINDTESTDATA("data/fib.hp"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    HeapProfile profile;
+    QString error;
+    QVERIFY2(parseHeapProfile(&file, &profile, &error), qPrintable(error));
+    QCOMPARE(profile.job, QString("fib +RTS -p -hT -RTS 25"));
+    QCOMPARE(profile.sampleUnit, QString("seconds"));
+    QCOMPARE(profile.valueUnit, QString("bytes"));
+    QCOMPARE(profile.marks, QList<double>{0.15});
+    QCOMPARE(profile.bands,
+             QStringList({"ghc-prim:GHC.Types.:", "THUNK", "MUT_ARR_PTRS_CLEAN",
+                          "base:GHC.Base.Just (Maybe)"}));
+    QCOMPARE(profile.samples.size(), 4);
+    QCOMPARE(profile.samples.at(1).time, 0.1);
+    QCOMPARE(profile.samples.at(1).values.value(0), qint64(4800));
+    QCOMPARE(profile.samples.at(2).values.value(0), qint64(9600));
+    QCOMPARE(profile.samples.at(2).values.value(3), qint64(32));
+    QVERIFY(profile.samples.at(3).values.isEmpty());
+    QCOMPARE(profile.bandsByPeak(), (QList<int>{0, 1, 2, 3}));
+}
+
+void tst_ProfileParser::incompleteHeapProfile()
+{
+    // the RTS writes samples while the program runs, a crash leaves the last one open
+    QBuffer buffer;
+    buffer.setData("JOB \"server\"\nSAMPLE_UNIT \"seconds\"\nVALUE_UNIT \"bytes\"\n"
+                   "BEGIN_SAMPLE 0.5\nTHUNK\t100\nARR_WORDS\t2000\n");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    HeapProfile profile;
+    QString error;
+    QVERIFY2(parseHeapProfile(&buffer, &profile, &error), qPrintable(error));
+    QCOMPARE(profile.samples.size(), 1);
+    QCOMPARE(profile.samples.at(0).values.size(), 2);
+    QCOMPARE(profile.bandsByPeak(), (QList<int>{1, 0}));
+}
+
+void tst_ProfileParser::invalidHeapProfile()
+{
+    QFile file(QFINDTESTDATA("data/fib.prof"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    HeapProfile profile;
+    QString error;
+    QVERIFY(!parseHeapProfile(&file, &profile, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(tst_ProfileParser)
+
+#include "tst_profileparser.moc"
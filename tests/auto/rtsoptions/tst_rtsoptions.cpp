@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <rtsoptions.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+static const char threadedInfo[] = R"( [("GHC RTS", "YES")
+ ,("GHC version", "9.4.7")
+ ,("RTS way", "rts_thr")
+ ,("Build platform", "x86_64-unknown-linux")
+ ,("Flag -with-rtsopts", "")
+ ]
+)";
+
+class tst_RtsOptions : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void arguments();
+    void presets();
+    void settings();
+    void sizes_data();
+    void sizes();
+    void rtsInfo();
+    void problems();
+};
+
+void tst_RtsOptions::arguments()
+{
+    RtsOptions options;
+    QVERIFY(options.arguments().isEmpty());
+    options.capabilities = 0;
+    options.allocationArea = "64m";
+    options.allocationChunkSize = "4m";
+    options.parallelGc = false;
+    options.suggestedHeapSize = "1g";
+    options.maximumHeapSize = "2g";
+    options.idleGc = false;
+    options.nonmovingGc = true;
+    options.additionalOptions = " -s  -xc";
+    QCOMPARE(options.arguments(),
+             QStringList({"-N", "-A64m", "-n4m", "-qg", "-H1g", "-M2g", "-I0", "--nonmoving-gc",
+                          "-s", "-xc"}));
+    options = {};
+    options.capabilities = 4;
+    QCOMPARE(options.arguments(), QStringList("-N4"));
+}
+
+void tst_RtsOptions::presets()
+{
+    QCOMPARE(RtsOptions().matchingPreset(), RtsOptions::Custom);
+    for (int i = RtsOptions::Custom + 1; i < RtsOptions::PresetCount; ++i) {
+        const auto preset = RtsOptions::Preset(i);
+        RtsOptions options = RtsOptions::preset(preset);
+        QVERIFY(!options.arguments().isEmpty());
+        QCOMPARE(options.matchingPreset(), preset);
+        // additional options don't change the preset
+        options.additionalOptions = "-s";
+        QCOMPARE(options.matchingPreset(), preset);
+        options.maximumHeapSize = "1g";
+        QCOMPARE(options.matchingPreset(), RtsOptions::Custom);
+    }
+    QVERIFY(RtsOptions::preset(RtsOptions::LowLatency).arguments().contains("--nonmoving-gc"));
+}
+
+void tst_RtsOptions::settings()
+{
+    RtsOptions options = RtsOptions::preset(RtsOptions::Throughput);
+    options.maximumHeapSize = "3g";
+    options.additionalOptions = "-s";
+    QCOMPARE(RtsOptions::fromMap(options.toMap()), options);
+    QCOMPARE(RtsOptions::fromMap({}), RtsOptions());
+}
+
+void tst_RtsOptions::sizes_data()
+{
+    QTest::addColumn<QString>("size");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("empty") << "" << true;
+    QTest::newRow("bytes") << "4096" << true;
+    QTest::newRow("megabytes") << "64m" << true;
+    QTest::newRow("gigabytes") << "2G" << true;
+    QTest::newRow("fraction") << "1.5g" << true;
+    QTest::newRow("unit only") << "m" << false;
+    QTest::newRow("unknown unit") << "64x" << false;
+    QTest::newRow("negative") << "-1m" << false;
+}
+
+void tst_RtsOptions::sizes()
+{
+    QFETCH(QString, size);
+    QFETCH(bool, valid);
+    QCOMPARE(RtsOptions::isValidSize(size), valid);
+}
+
+void tst_RtsOptions::rtsInfo()
+{
+    RtsInfo info = RtsInfo::fromOutput(threadedInfo, {});
+    QVERIFY(info.valid);
+    QVERIFY(info.threaded);
+    QVERIFY(info.rtsOptionsEnabled);
+    QCOMPARE(info.ghcVersion, QString("9.4.7"));
+
+    info = RtsInfo::fromOutput(QString(threadedInfo).replace("rts_thr", "rts_v"),
+                               "prog: the flag -A1m requires the program to be built with "
+                               "-rtsopts\n");
+    QVERIFY(info.valid);
+    QVERIFY(!info.threaded);
+    QVERIFY(!info.rtsOptionsEnabled);
+
+    QVERIFY(!RtsInfo::fromOutput("Hello, world!\n", {}).valid);
+}
+
+void tst_RtsOptions::problems()
+{
+    RtsOptions options;
+    options.allocationArea = "lots";
+    QCOMPARE(options.problems().size(), 1);
+    options.allocationArea.clear();
+
+    const RtsInfo threaded = RtsInfo::fromOutput(threadedInfo, {});
+    RtsInfo nonThreaded = threaded;
+    nonThreaded.threaded = false;
+    RtsInfo noRtsOptions = threaded;
+    noRtsOptions.rtsOptionsEnabled = false;
+
+    // without options nothing can be rejected
+    QVERIFY(options.problems(noRtsOptions).isEmpty());
+
+    options.capabilities = 0;
+    options.parallelGc = false;
+    QVERIFY(options.problems(threaded).isEmpty());
+    QCOMPARE(options.problems(nonThreaded).size(), 2);
+    QCOMPARE(options.problems(noRtsOptions).size(), 1);
+    // the executable is unknown
+    QVERIFY(options.problems().isEmpty());
+
+    options = {};
+    options.nonmovingGc = true;
+    RtsInfo oldGhc = threaded;
+    oldGhc.ghcVersion = "8.8.4";
+    QVERIFY(options.problems(threaded).isEmpty());
+    QCOMPARE(options.problems(oldGhc).size(), 1);
+}
+
+QTEST_MAIN(tst_RtsOptions)
+
+#include "tst_rtsoptions.moc"
@@ -0,0 +1,192 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <rtsstats.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+// written by "+RTS -S<file>"
+static const char verboseOutput[]
+    = "/home/user/service/.stack-work/install/bin/service +RTS -S/tmp/rts-stats-1.txt \n"
+      "    Alloc    Copied     Live     GC     GC      TOT      TOT  Page Flts\n"
+      "    bytes     bytes     bytes   user   elap     user     elap\n"
+      "   4194288    859848    907128  0.002  0.002    0.203    0.204    0    0  (Gen:  0)\n"
+      "   4194288   1210888   1258168  0.003  0.003    0.498    0.502    0    0  (Gen:  0)\n"
+      "   4194288   2469232   3727296  0.010  0.012    1.301    1.312    0    0  (Gen:  1)\n"
+      "   4194304     12032   3735328  0.000  0.001    3.118    3.125    0    0  (Gen:  0)\n"
+      "    786432     45112   3710256  0.004  0.004    3.122    3.129    0    0  (Gen:  1)\n"
+      "\n"
+      "      17,563,600 bytes allocated in the heap\n"
+      "       4,597,112 bytes copied during GC\n"
+      "       3,735,328 bytes maximum residency (2 sample(s))\n"
+      "          43,744 bytes maximum slop\n"
+      "              10 MiB total memory in use (0 MB lost due to fragmentation)\n"
+      "\n"
+      "                                     Tot time (elapsed)  Avg pause  Max pause\n"
+      "  Gen  0         3 colls,     0 par    0.005s   0.006s     0.0020s    0.0030s\n"
+      "  Gen  1         2 colls,     0 par    0.014s   0.016s     0.0080s    0.0120s\n"
+      "\n"
+      "  INIT    time    0.000s  (  0.000s elapsed)\n"
+      "  MUT     time    3.103s  (  3.107s elapsed)\n"
+      "  GC      time    0.019s  (  0.022s elapsed)\n"
+      "  EXIT    time    0.000s  (  0.000s elapsed)\n"
+      "  Total   time    3.122s  (  3.129s elapsed)\n"
+      "\n"
+      "  %GC     time       0.0%  (0.0% elapsed)\n"
+      "\n"
+      "  Alloc rate    5,660,199 bytes per MUT second\n"
+      "\n"
+      "  Productivity  99.4% of total user, 99.3% of total elapsed\n"
+      "\n";
+
+// written by "+RTS -s --machine-readable"
+static const char machineReadableOutput[]
+    = " [(\"GC_cpu_seconds\", \"0.019\")\n"
+      " ,(\"bytes allocated\", \"17563600\")\n"
+      " ,(\"num_GCs\", \"5\")\n"
+      " ,(\"max_bytes_used\", \"3735328\")\n"
+      " ,(\"mutator_wall_seconds\", \"3.0\")\n"
+      " ,(\"GC_wall_seconds\", \"1.0\")\n"
+      " ,(\"total_wall_seconds\", \"4.0\")\n"
+      " ]\n";
+
+class tst_RtsStats : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void verbose();
+    void chunks();
+    void machineReadable();
+    void series();
+    void maximumPoints();
+};
+
+void tst_RtsStats::verbose()
+{
+    RtsStatsParser parser;
+    QVector<GcSample> samples = parser.addOutput(verboseOutput);
+    samples += parser.finish();
+    QCOMPARE(samples.size(), 5);
+    QCOMPARE(samples.at(0).allocatedBytes, qint64(4194288));
+    QCOMPARE(samples.at(0).copiedBytes, qint64(859848));
+    QCOMPARE(samples.at(0).liveBytes, qint64(907128));
+    QCOMPARE(samples.at(0).gcElapsedTime, 0.002);
+    QCOMPARE(samples.at(0).totalElapsedTime, 0.204);
+    QCOMPARE(samples.at(0).generation, 0);
+    QCOMPARE(samples.at(2).generation, 1);
+    QCOMPARE(samples.at(4).allocatedBytes, qint64(786432));
+
+    const RtsSummary summary = parser.summary();
+    QVERIFY(summary.isValid());
+    QCOMPARE(summary.bytesAllocated, qint64(17563600));
+    QCOMPARE(summary.maximumResidency, qint64(3735328));
+    QCOMPARE(summary.collections, 5);
+    QCOMPARE(summary.maximumPause, 0.012);
+    QCOMPARE(summary.mutatorElapsedTime, 3.107);
+    QCOMPARE(summary.gcElapsedTime, 0.022);
+    QCOMPARE(summary.totalElapsedTime, 3.129);
+    QCOMPARE(summary.productivity, 99.3);
+}
+
+void tst_RtsStats::chunks()
+{
+    // the file is read while the runtime system writes it
+    const QString output = QString::fromLatin1(verboseOutput);
+    RtsStatsParser parser;
+    QVector<GcSample> samples;
+    for (int i = 0; i < output.size(); i += 13)
+        samples += parser.addOutput(output.mid(i, 13));
+    samples += parser.finish();
+    QCOMPARE(samples.size(), 5);
+    QCOMPARE(samples.at(3).liveBytes, qint64(3735328));
+    QCOMPARE(parser.summary().collections, 5);
+
+    RtsStatsParser incomplete;
+    QVERIFY(incomplete.addOutput("   4194288    859848    907128  0.002").isEmpty());
+    QVERIFY(!incomplete.summary().isValid());
+    QCOMPARE(incomplete.addOutput("  0.002    0.203    0.204    0    0  (Gen:  0)\n").size(), 1);
+}
+
+void tst_RtsStats::machineReadable()
+{
+    RtsStatsParser parser;
+    QVERIFY(parser.addOutput(machineReadableOutput).isEmpty());
+    const RtsSummary summary = parser.summary();
+    QCOMPARE(summary.bytesAllocated, qint64(17563600));
+    QCOMPARE(summary.maximumResidency, qint64(3735328));
+    QCOMPARE(summary.collections, 5);
+    QCOMPARE(summary.maximumPause, -1.0);
+    QCOMPARE(summary.productivity, 75.0);
+}
+
+void tst_RtsStats::series()
+{
+    RtsStatsParser parser;
+    RtsStatsSeries series;
+    for (const GcSample &sample : parser.addOutput(verboseOutput))
+        series.addSample(sample);
+
+    // no collections from 2 s to 3 s
+    const QVector<RtsStatsSeries::Point> &points = series.points();
+    QCOMPARE(points.size(), 3);
+    QCOMPARE(points.at(0).time, 0.0);
+    QCOMPARE(points.at(0).collections, 2);
+    QCOMPARE(points.at(0).liveBytes, qint64(1258168));
+    QCOMPARE(points.at(0).allocationRate, 2 * 4194288.0);
+    QCOMPARE(points.at(0).maximumPause, 0.003);
+    QVERIFY(qAbs(points.at(0).productivity - 100 * (1 - 0.005 / 0.502)) < 1e-9);
+    QCOMPARE(points.at(1).time, 1.0);
+    QVERIFY(qAbs(points.at(1).productivity - 100 * (1 - 0.012 / 0.81)) < 1e-9);
+    QCOMPARE(points.at(2).time, 3.0);
+    QCOMPARE(points.at(2).collections, 2);
+    QCOMPARE(points.at(2).allocationRate, 4194304.0 + 786432.0);
+
+    QCOMPARE(series.collections(), 5);
+    QCOMPARE(series.peakLiveBytes(), qint64(3735328));
+    QCOMPARE(series.maximumPause(), 0.012);
+}
+
+void tst_RtsStats::maximumPoints()
+{
+    RtsStatsSeries series(0.5, 10);
+    GcSample sample;
+    for (int i = 0; i < 100; ++i) {
+        sample.totalElapsedTime = i * 0.5;
+        sample.liveBytes = i;
+        series.addSample(sample);
+    }
+    QCOMPARE(series.points().size(), 10);
+    QCOMPARE(series.points().first().time, 45.0);
+    QCOMPARE(series.points().last().liveBytes, qint64(99));
+    QCOMPARE(series.collections(), 100);
+    QCOMPARE(series.interval(), 0.5);
+}
+
+QTEST_MAIN(tst_RtsStats)
+
+#include "tst_rtsstats.moc"
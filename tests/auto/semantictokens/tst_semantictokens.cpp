@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <literatehaskell.h>
+#include <semantictokens.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+static const char source[]
+    = "module Main where\n"
+      "\n"
+      "import Data.Shape\n"
+      "\n"
+      "area :: Shape -> Double\n"
+      "area (Circle radius) = pi * radius * radius\n"
+      "\n"
+      "main = print (area c)\n"
+      "  where c = Circle 1\n"
+      "a <+> b = area a + area b\n"
+      "f area = area\n"
+      "g a = (a :: a)\n"
+      "{- area\n"
+      "area -}\n";
+
+static SemanticToken token(int line, int column, int length, SemanticToken::Kind kind)
+{
+    SemanticToken result;
+    result.line = line;
+    result.column = column;
+    result.length = length;
+    result.kind = kind;
+    return result;
+}
+
+class tst_SemanticTokens : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromLines();
+    void encode();
+    void diff();
+    void insertedLine();
+    void changedLines();
+    void literate();
+};
+
+void tst_SemanticTokens::fromLines()
+{
+    const QVector<SemanticToken> tokens
+        = SemanticTokens::fromLines(QString(source).split('\n'), {"area", "main", "f", "g"});
+    const QVector<SemanticToken> expected{
+        token(5, 0, 4, SemanticToken::FunctionDeclaration),
+        token(5, 13, 6, SemanticToken::Parameter),
+        token(5, 28, 6, SemanticToken::Parameter),
+        token(5, 37, 6, SemanticToken::Parameter),
+        token(7, 0, 4, SemanticToken::FunctionDeclaration),
+        token(7, 14, 4, SemanticToken::Function),
+        // infix definition
+        token(9, 0, 1, SemanticToken::Parameter),
+        token(9, 6, 1, SemanticToken::Parameter),
+        token(9, 10, 4, SemanticToken::Function),
+        token(9, 15, 1, SemanticToken::Parameter),
+        token(9, 19, 4, SemanticToken::Function),
+        token(9, 24, 1, SemanticToken::Parameter),
+        // parameters shadow functions
+        token(10, 0, 1, SemanticToken::FunctionDeclaration),
+        token(10, 2, 4, SemanticToken::Parameter),
+        token(10, 9, 4, SemanticToken::Parameter),
+        // types are not code
+        token(11, 0, 1, SemanticToken::FunctionDeclaration),
+        token(11, 2, 1, SemanticToken::Parameter),
+        token(11, 7, 1, SemanticToken::Parameter)};
+    QCOMPARE(tokens, expected);
+}
+
+void tst_SemanticTokens::encode()
+{
+    const QVector<SemanticToken> tokens{token(0, 0, 4, SemanticToken::FunctionDeclaration),
+                                        token(0, 6, 2, SemanticToken::Parameter),
+                                        token(2, 3, 1, SemanticToken::Function)};
+    const QVector<int> data = SemanticTokens::encode(tokens);
+    QCOMPARE(data, QVector<int>({0, 0, 4, 1, 0, 0, 6, 2, 2, 0, 2, 3, 1, 0, 0}));
+    QCOMPARE(SemanticTokens::decode(data), tokens);
+}
+
+void tst_SemanticTokens::diff()
+{
+    const QVector<int> before = SemanticTokens::encode(
+        {token(0, 0, 4, SemanticToken::Function), token(1, 2, 1, SemanticToken::Parameter),
+         token(3, 0, 1, SemanticToken::Function)});
+    const QVector<int> after = SemanticTokens::encode(
+        {token(0, 0, 4, SemanticToken::Function), token(1, 2, 3, SemanticToken::Parameter),
+         token(1, 8, 3, SemanticToken::Parameter), token(3, 0, 1, SemanticToken::Function)});
+
+    const SemanticTokensEdit edit = SemanticTokens::diff(before, after);
+    QCOMPARE(edit.start, 5);
+    QCOMPARE(edit.deleteCount, 5);
+    QCOMPARE(edit.data.size(), 10);
+    QCOMPARE(SemanticTokens::apply(before, edit), after);
+
+    QVERIFY(SemanticTokens::diff(after, after).isEmpty());
+    const SemanticTokensEdit removeAll = SemanticTokens::diff(after, {});
+    QCOMPARE(removeAll.deleteCount, after.size());
+    QVERIFY(SemanticTokens::apply(after, removeAll).isEmpty());
+}
+
+void tst_SemanticTokens::insertedLine()
+{
+    // only the token right after an inserted line changes
+    QStringList lines = QString(source).split('\n');
+    const QSet<QString> names{"area", "main", "f", "g"};
+    const QVector<int> before = SemanticTokens::encode(SemanticTokens::fromLines(lines, names));
+    lines.insert(6, "-- a comment");
+    const QVector<int> after = SemanticTokens::encode(SemanticTokens::fromLines(lines, names));
+    const SemanticTokensEdit edit = SemanticTokens::diff(before, after);
+    QCOMPARE(edit.start, 4 * 5);
+    QCOMPARE(edit.deleteCount, 5);
+    QCOMPARE(edit.data.size(), 5);
+    QCOMPARE(edit.data.first(), 3); // the line, relative to the previous token
+}
+
+void tst_SemanticTokens::changedLines()
+{
+    const QVector<SemanticToken> before{token(0, 0, 4, SemanticToken::Function),
+                                        token(5, 2, 1, SemanticToken::Parameter),
+                                        token(9, 0, 1, SemanticToken::Function)};
+    QVector<SemanticToken> after = before;
+    after[1].column = 3;
+    SemanticTokensEdit edit = SemanticTokens::diff(SemanticTokens::encode(before),
+                                                   SemanticTokens::encode(after));
+    LineRange lines = SemanticTokens::changedLines(after, edit);
+    QCOMPARE(lines.first, 0);
+    QCOMPARE(lines.last, 9);
+
+    // the last token removed
+    after.removeLast();
+    edit = SemanticTokens::diff(SemanticTokens::encode(before), SemanticTokens::encode(after));
+    lines = SemanticTokens::changedLines(after, edit);
+    QCOMPARE(lines.first, 0);
+    QCOMPARE(lines.last, -1);
+}
+
+void tst_SemanticTokens::literate()
+{
+    QVector<int> codeColumns;
+    const QString code = LiterateHaskell::unlit("Squares a number.\n"
+                                                "\n"
+                                                "> square :: Int -> Int\n"
+                                                "> square x = x * x",
+                                                &codeColumns);
+    QCOMPARE(codeColumns, QVector<int>({0, 0, 2, 2}));
+    const QVector<SemanticToken> tokens = SemanticTokens::fromLines(code.split('\n'), {"square"});
+    const QVector<SemanticToken> expected{token(3, 0, 6, SemanticToken::FunctionDeclaration),
+                                          token(3, 7, 1, SemanticToken::Parameter),
+                                          token(3, 11, 1, SemanticToken::Parameter),
+                                          token(3, 15, 1, SemanticToken::Parameter)};
+    QCOMPARE(tokens, expected);
+}
+
+QTEST_MAIN(tst_SemanticTokens)
+
+#include "tst_semantictokens.moc"
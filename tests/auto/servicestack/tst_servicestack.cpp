@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <servicestack.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+Q_DECLARE_METATYPE(ServiceSpec)
+
+static ServiceSpec service(const QString &executable, const QStringList &after = {})
+{
+    ServiceSpec spec;
+    spec.executable = executable;
+    spec.after = after;
+    return spec;
+}
+
+class tst_ServiceStack : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void startable();
+    void problems_data();
+    void problems();
+    void map();
+    void output();
+};
+
+void tst_ServiceStack::startable()
+{
+    ServiceStack stack;
+    stack.services = {service("db"), service("cache"), service("api", {"db", "cache"}),
+                      service("worker", {"db"}), service("web", {"api"})};
+    stack.services[1].tag = "redis";
+    stack.services[2].after = QStringList{"db", "redis"};
+    QVERIFY(stack.problems().isEmpty());
+
+    // everything that waits for nothing starts at once
+    QSet<QString> started;
+    QSet<QString> ready;
+    QCOMPARE(stack.startable(started, ready), QStringList({"db", "redis"}));
+    started << "db" << "redis";
+    QVERIFY(stack.startable(started, ready).isEmpty());
+    ready << "db";
+    QCOMPARE(stack.startable(started, ready), QStringList({"worker"}));
+    started << "worker";
+    ready << "redis";
+    QCOMPARE(stack.startable(started, ready), QStringList({"api"}));
+    started << "api";
+    ready << "api";
+    QCOMPARE(stack.startable(started, ready), QStringList({"web"}));
+
+    // disabled services don't start
+    stack.services[4].enabled = false;
+    QVERIFY(stack.startable(started, ready).isEmpty());
+    QVERIFY(!stack.service("web"));
+    QCOMPARE(stack.service("redis")->executable, QString("cache"));
+    QCOMPARE(stack.enabledServices().size(), 4);
+}
+
+void tst_ServiceStack::problems_data()
+{
+    QTest::addColumn<QVector<ServiceSpec>>("services");
+    QTest::addColumn<QStringList>("problems");
+
+    QTest::newRow("none") << QVector<ServiceSpec>{service("db"), service("api", {"db"})}
+                          << QStringList();
+    QTest::newRow("unknown")
+        << QVector<ServiceSpec>{service("api", {"db"})}
+        << QStringList("\"api\" waits for \"db\", which is not an enabled service.");
+    QTest::newRow("duplicate") << QVector<ServiceSpec>{service("api"), service("api")}
+                               << QStringList("There is more than one service named \"api\".");
+    QTest::newRow("self") << QVector<ServiceSpec>{service("api", {"api"})}
+                          << QStringList("\"api\" waits for itself through other services.");
+    QTest::newRow("cycle")
+        << QVector<ServiceSpec>{service("a", {"c"}), service("b", {"a"}), service("c", {"b"})}
+        << QStringList("\"a\" waits for itself through other services.");
+    QTest::newRow("no executable") << QVector<ServiceSpec>{service("")}
+                                   << QStringList("A service has no executable.");
+
+    ServiceSpec pattern = service("api");
+    pattern.readiness = ServiceSpec::WhenOutputMatches;
+    pattern.readyPattern = "listening (on";
+    ServiceSpec port = service("db");
+    port.readiness = ServiceSpec::WhenPortOpen;
+    QTest::newRow("conditions")
+        << QVector<ServiceSpec>{pattern, port}
+        << QStringList({"The output pattern of \"api\" is invalid.",
+                        "The port of \"db\" is invalid."});
+    pattern.readyPattern.clear();
+    QTest::newRow("empty pattern")
+        << QVector<ServiceSpec>{pattern}
+        << QStringList("The output pattern of \"api\" is empty.");
+}
+
+void tst_ServiceStack::problems()
+{
+    QFETCH(QVector<ServiceSpec>, services);
+    QFETCH(QStringList, problems);
+    ServiceStack stack;
+    stack.services = services;
+    QCOMPARE(stack.problems(), problems);
+}
+
+void tst_ServiceStack::map()
+{
+    ServiceSpec spec = service("api", {"db", "cache"});
+    spec.enabled = false;
+    spec.tag = "http";
+    spec.arguments = "--port 8080";
+    spec.rtsOptions = "-N4  -A64m";
+    spec.readiness = ServiceSpec::WhenPortOpen;
+    spec.readyPort = 8080;
+    ServiceStack stack;
+    stack.services = {service("db"), spec};
+    QCOMPARE(ServiceStack::fromList(stack.toList()), stack);
+    QCOMPARE(spec.rtsArguments(), QStringList({"-N4", "-A64m"}));
+    QCOMPARE(spec.name(), QString("http"));
+
+    const ServiceSpec defaults = ServiceSpec::fromMap({{"Executable", "db"}});
+    QVERIFY(defaults.enabled);
+    QCOMPARE(defaults.readiness, ServiceSpec::WhenStarted);
+    QCOMPARE(ServiceSpec::fromMap({{"Readiness", 42}}).readiness, ServiceSpec::WhenStarted);
+}
+
+void tst_ServiceStack::output()
+{
+    ServiceOutput output("api", R"(^Listening on port \d+)");
+    QCOMPARE(output.addOutput("Loading configuration\nListen"),
+             QString("[api] Loading configuration\n"));
+    QVERIFY(!output.isReady());
+    QCOMPARE(output.addOutput("ing on port 8080\r\n"), QString("[api] Listening on port 8080\n"));
+    QVERIFY(output.isReady());
+    QCOMPARE(output.addOutput("GET /"), QString());
+    QCOMPARE(output.finish(), QString("[api] GET /\n"));
+    QCOMPARE(output.finish(), QString());
+
+    ServiceOutput noPattern("db");
+    QCOMPARE(noPattern.addOutput("ready\n"), QString("[db] ready\n"));
+    QVERIFY(!noPattern.isReady());
+}
+
+QTEST_MAIN(tst_ServiceStack)
+
+#include "tst_servicestack.moc"
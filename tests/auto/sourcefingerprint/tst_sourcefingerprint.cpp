@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <sourcefingerprint.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+class tst_SourceFingerprint : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void unchanged();
+    void modifiedFile();
+    void addedFile();
+    void removedFile();
+    void ignoredFiles();
+    void excludedDirectories();
+    void salt();
+    void externalPackages();
+    void outputs();
+    void saveAndLoad();
+    void isSourceFile_data();
+    void isSourceFile();
+
+private:
+    void writeFile(const QString &relativePath, const QByteArray &contents);
+    void setModified(const QString &relativePath, const QDateTime &time);
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+void tst_SourceFingerprint::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+    writeFile("stack.yaml", "resolver: lts-16.0\n");
+    writeFile("simple.cabal", "name: simple\n");
+    writeFile("src/Lib.hs", "module Lib where\n");
+    writeFile("app/Main.hs", "main = pure ()\n");
+}
+
+void tst_SourceFingerprint::unchanged()
+{
+    SourceFingerprint fingerprint;
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(fingerprint.compute(m_dir->path()), first);
+    // a fresh cache gives the same result
+    QCOMPARE(SourceFingerprint().compute(m_dir->path()), first);
+}
+
+void tst_SourceFingerprint::modifiedFile()
+{
+    SourceFingerprint fingerprint;
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    // same size, only the modification time differs
+    setModified("src/Lib.hs", QDateTime::currentDateTime().addSecs(10));
+    QVERIFY(fingerprint.compute(m_dir->path()) != first);
+}
+
+void tst_SourceFingerprint::addedFile()
+{
+    SourceFingerprint fingerprint;
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    // directory modification times are coarse, wait for them to differ
+    QTest::qSleep(50);
+    writeFile("src/Lib/Internal.hs", "module Lib.Internal where\n");
+    QVERIFY(fingerprint.compute(m_dir->path()) != first);
+}
+
+void tst_SourceFingerprint::removedFile()
+{
+    SourceFingerprint fingerprint;
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    QVERIFY(QFile::remove(m_dir->filePath("app/Main.hs")));
+    QVERIFY(fingerprint.compute(m_dir->path()) != first);
+}
+
+void tst_SourceFingerprint::ignoredFiles()
+{
+    SourceFingerprint fingerprint;
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    writeFile("README.md", "# simple\n");
+    writeFile(".stack-work/dist/build/Lib.o", "object");
+    writeFile("src/Lib.hs~", "backup");
+    QCOMPARE(fingerprint.compute(m_dir->path()), first);
+}
+
+void tst_SourceFingerprint::excludedDirectories()
+{
+    SourceFingerprint fingerprint;
+    fingerprint.setExcludedDirectories({m_dir->filePath("build")});
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    writeFile("build/autogen/Paths_simple.hs", "module Paths_simple where\n");
+    QCOMPARE(fingerprint.compute(m_dir->path()), first);
+}
+
+void tst_SourceFingerprint::salt()
+{
+    SourceFingerprint fingerprint;
+    QVERIFY(fingerprint.compute(m_dir->path(), "stack build")
+            != fingerprint.compute(m_dir->path(), "stack build --fast"));
+}
+
+void tst_SourceFingerprint::externalPackages()
+{
+    QTemporaryDir shared;
+    QVERIFY(shared.isValid());
+    const QString sharedPath = QDir::cleanPath(shared.path());
+    writeFile("stack.yaml",
+              "resolver: lts-16.0\n"
+              "packages:\n"
+              "- .\n"
+              "- ./sub\n"
+              "- " + sharedPath.toUtf8() + "\n"
+              "extra-deps:\n"
+              "- acme-missiles-0.3\n"
+              "- git: https://example.com/repo.git\n");
+    QCOMPARE(SourceFingerprint::externalPackages(m_dir->path()), QStringList(sharedPath));
+
+    SourceFingerprint fingerprint;
+    const QByteArray first = fingerprint.compute(m_dir->path());
+    QTest::qSleep(50);
+    QFile file(shared.filePath("Shared.hs"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QVERIFY(fingerprint.compute(m_dir->path()) != first);
+}
+
+void tst_SourceFingerprint::outputs()
+{
+    writeFile("build/dist/setup-config", "config");
+    writeFile("build/install/bin/simple", "binary");
+    const QStringList paths = {m_dir->filePath("build/dist"),
+                               m_dir->filePath("build/install/bin")};
+    const QByteArray first = SourceFingerprint::outputs(paths);
+    QCOMPARE(SourceFingerprint::outputs(paths), first);
+    QVERIFY(QFile::remove(m_dir->filePath("build/install/bin/simple")));
+    const QByteArray deleted = SourceFingerprint::outputs(paths);
+    QVERIFY(deleted != first);
+    // like "stack clean"
+    QVERIFY(QDir(m_dir->filePath("build/dist")).removeRecursively());
+    QVERIFY(SourceFingerprint::outputs(paths) != deleted);
+}
+
+void tst_SourceFingerprint::saveAndLoad()
+{
+    const QString filePath = m_dir->filePath(".stack-work/qtc-source-fingerprint");
+    QVERIFY(SourceFingerprint::load(filePath).isEmpty());
+    QVERIFY(QDir().mkpath(m_dir->filePath(".stack-work")));
+    const QByteArray fingerprint = SourceFingerprint().compute(m_dir->path());
+    QVERIFY(SourceFingerprint::save(filePath, fingerprint));
+    QCOMPARE(SourceFingerprint::load(filePath), fingerprint);
+}
+
+void tst_SourceFingerprint::isSourceFile_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<bool>("result");
+
+    QTest::newRow("module") << "Main.hs" << true;
+    QTest::newRow("literate") << "Main.lhs" << true;
+    QTest::newRow("boot") << "Lib.hs-boot" << true;
+    QTest::newRow("hsc") << "Bindings.hsc" << true;
+    QTest::newRow("cabal") << "simple.cabal" << true;
+    QTest::newRow("hpack") << "package.yaml" << true;
+    QTest::newRow("stack") << "stack.yaml" << true;
+    QTest::newRow("lock") << "stack.yaml.lock" << true;
+    QTest::newRow("c") << "cbits.c" << true;
+    QTest::newRow("other yaml") << "ci.yaml" << false;
+    QTest::newRow("object") << "Main.o" << false;
+    QTest::newRow("hidden") << ".hs" << false;
+    QTest::newRow("backup") << "Main.hs~" << false;
+}
+
+void tst_SourceFingerprint::isSourceFile()
+{
+    QFETCH(QString, fileName);
+    QFETCH(bool, result);
+    QCOMPARE(SourceFingerprint::isSourceFile(fileName), result);
+}
+
+void tst_SourceFingerprint::writeFile(const QString &relativePath, const QByteArray &contents)
+{
+    const QString filePath = m_dir->filePath(relativePath);
+    QVERIFY(QDir().mkpath(QFileInfo(filePath).absolutePath()));
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+}
+
+void tst_SourceFingerprint::setModified(const QString &relativePath, const QDateTime &time)
+{
+    QFile file(m_dir->filePath(relativePath));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(time, QFileDevice::FileModificationTime));
+}
+
+QTEST_MAIN(tst_SourceFingerprint)
+
+#include "tst_sourcefingerprint.moc"
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <stackpaths.h>
+
+#include <utils/hostosinfo.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+class tst_StackPaths : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromOutput();
+    void environment();
+    void dataDirectories();
+    void emptyPaths();
+
+private:
+    static QString pathList(const QStringList &paths);
+};
+
+QString tst_StackPaths::pathList(const QStringList &paths)
+{
+    return paths.join(Utils::HostOsInfo::pathListSeparator());
+}
+
+void tst_StackPaths::fromOutput()
+{
+    const QString output = "local-install-root: /p/.stack-work/install/x86_64-linux/abc/9.2.5\n"
+                           "bin-path: " + pathList({"/p/.stack-work/bin", "/s/bin"}) + "\n"
+                           "dist-dir: .stack-work/dist/x86_64-linux/Cabal-3.6.3.0\n"
+                           "ghc-package-path: " + pathList({"/p/db", "/s/db", "/g/db"}) + "\n"
+                           "local-pkg-db: /p/db\n"
+                           "snapshot-pkg-db: /s/db\n";
+    const StackPaths paths = StackPaths::fromOutput(output);
+    QCOMPARE(paths.localInstallRoot.toString(),
+             QString("/p/.stack-work/install/x86_64-linux/abc/9.2.5"));
+    QCOMPARE(paths.binPath, QStringList({"/p/.stack-work/bin", "/s/bin"}));
+    QCOMPARE(paths.distDirectory, QString(".stack-work/dist/x86_64-linux/Cabal-3.6.3.0"));
+    QCOMPARE(paths.ghcPackagePath, pathList({"/p/db", "/s/db", "/g/db"}));
+    QCOMPARE(paths.localPackageDatabase, QString("/p/db"));
+    QCOMPARE(paths.snapshotPackageDatabase, QString("/s/db"));
+}
+
+void tst_StackPaths::environment()
+{
+    // the variables that "stack exec" sets besides its own
+    StackPaths paths;
+    paths.binPath = QStringList({"/p/bin", "/usr/bin"});
+    paths.distDirectory = ".stack-work/dist/x86_64-linux/Cabal-3.6.3.0";
+    paths.ghcPackagePath = pathList({"/p/db", "/s/db", "/g/db"});
+    paths.localPackageDatabase = "/p/db";
+    paths.snapshotPackageDatabase = "/s/db";
+
+    Utils::Environment environment;
+    environment.set("PATH", "/usr/bin");
+    paths.addToEnvironment(environment);
+    QCOMPARE(environment.value("PATH"), pathList({"/p/bin", "/usr/bin"}));
+    QCOMPARE(environment.value("GHC_PACKAGE_PATH"), pathList({"/p/db", "/s/db", "/g/db"}));
+    QCOMPARE(environment.value("HASKELL_PACKAGE_SANDBOX"), QString("/s/db"));
+    QCOMPARE(environment.value("HASKELL_PACKAGE_SANDBOXES"), pathList({"/p/db", "/s/db", ""}));
+    QCOMPARE(environment.value("HASKELL_DIST_DIR"),
+             QString(".stack-work/dist/x86_64-linux/Cabal-3.6.3.0"));
+}
+
+void tst_StackPaths::dataDirectories()
+{
+    QTemporaryDir root;
+    QVERIFY(QDir(root.path()).mkpath("share/x86_64-linux-ghc-9.2.5/my-app-0.1.0.0"));
+    QVERIFY(QDir(root.path()).mkpath("share/x86_64-linux-ghc-9.2.5/lib-1.2"));
+    QVERIFY(QDir(root.path()).mkpath("share/x86_64-linux-ghc-9.2.5/doc"));
+    StackPaths paths;
+    paths.localInstallRoot = Utils::FilePath::fromString(root.path());
+
+    const QString platform = root.filePath("share/x86_64-linux-ghc-9.2.5/");
+    const QHash<QString, Utils::FilePath> dataDirs = paths.dataDirectories();
+    QCOMPARE(dataDirs.size(), 2);
+    QCOMPARE(dataDirs.value("my_app_datadir").toString(), platform + "my-app-0.1.0.0");
+    QCOMPARE(dataDirs.value("lib_datadir").toString(), platform + "lib-1.2");
+
+    Utils::Environment environment;
+    paths.addToEnvironment(environment);
+    QCOMPARE(environment.value("my_app_datadir"),
+             QDir::toNativeSeparators(platform + "my-app-0.1.0.0"));
+}
+
+void tst_StackPaths::emptyPaths()
+{
+    // a failed "stack path" changes nothing
+    Utils::Environment environment;
+    environment.set("PATH", "/usr/bin");
+    StackPaths().addToEnvironment(environment);
+    QCOMPARE(environment.toStringList(), QStringList("PATH=/usr/bin"));
+}
+
+QTEST_MAIN(tst_StackPaths)
+
+#include "tst_stackpaths.moc"
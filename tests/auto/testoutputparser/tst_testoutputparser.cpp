@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <testoutputparser.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Haskell::Internal;
+
+static const char hspecOutput[]
+    = "Data.List\n"
+      "  sort\n"
+      "    sorts a list [✔]\n"
+      "    handles empty lists [✘]\n"
+      "  reverse\n"
+      "    is pending [‐]\n"
+      "    is an involution [✘]\n"
+      "\n"
+      "Failures:\n"
+      "\n"
+      "  test/Spec.hs:12:3: \n"
+      "  1) Data.List.sort handles empty lists\n"
+      "       expected: [1]\n"
+      "        but got: []\n"
+      "\n"
+      "  To rerun use: --match \"/Data.List/sort/handles empty lists/\"\n"
+      "\n"
+      "  test/Spec.hs:20:5: \n"
+      "  2) Data.List.reverse is an involution\n"
+      "       Falsifiable (after 3 tests)\n"
+      "\n"
+      "Randomized with seed 1234\n"
+      "\n"
+      "Finished in 0.0012 seconds\n"
+      "4 examples, 2 failures, 1 pending\n";
+
+static const char tastyOutput[]
+    = "Tests\n"
+      "  Unit tests\n"
+      "    List comparison (different length): OK (0.01s)\n"
+      "    List comparison (same length): FAIL\n"
+      "      test/Test.hs:29:\n"
+      "      expected: LT\n"
+      "       but got: GT\n"
+      "  Properties\n"
+      "    reverse: OK (0.02s)\n"
+      "      +++ OK, passed 100 tests.\n"
+      "\n"
+      "1 out of 3 tests failed (0.03s)\n";
+
+class tst_TestOutputParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void hspec();
+    void tasty();
+    void chunks();
+    void plain();
+    void filterArguments();
+    void detectFramework_data();
+    void detectFramework();
+};
+
+void tst_TestOutputParser::hspec()
+{
+    TestOutputParser parser(TestOutputParser::Hspec);
+    QVector<TestCaseResult> results = parser.addOutput(QString::fromUtf8(hspecOutput));
+    results += parser.finish();
+    QCOMPARE(results.size(), 6);
+    QCOMPARE(results.at(0).path, QStringList({"Data.List", "sort", "sorts a list"}));
+    QCOMPARE(results.at(0).status, TestCaseResult::Passed);
+    QCOMPARE(results.at(1).path, QStringList({"Data.List", "sort", "handles empty lists"}));
+    QCOMPARE(results.at(1).status, TestCaseResult::Failed);
+    QVERIFY(results.at(1).message.isEmpty());
+    QCOMPARE(results.at(2).path, QStringList({"Data.List", "reverse", "is pending"}));
+    QCOMPARE(results.at(2).status, TestCaseResult::Skipped);
+    QCOMPARE(results.at(3).status, TestCaseResult::Failed);
+
+    // the details of failures follow at the end
+    QCOMPARE(results.at(4).path, results.at(1).path);
+    QCOMPARE(results.at(4).status, TestCaseResult::Failed);
+    QCOMPARE(results.at(4).message,
+             QString("test/Spec.hs:12:3:\nexpected: [1]\nbut got: []"));
+    QCOMPARE(results.at(5).path, QStringList({"Data.List", "reverse", "is an involution"}));
+    QCOMPARE(results.at(5).message, QString("test/Spec.hs:20:5:\nFalsifiable (after 3 tests)"));
+}
+
+void tst_TestOutputParser::tasty()
+{
+    TestOutputParser parser(TestOutputParser::Tasty);
+    QVector<TestCaseResult> results = parser.addOutput(tastyOutput);
+    results += parser.finish();
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(0).path,
+             QStringList({"Tests", "Unit tests", "List comparison (different length)"}));
+    QCOMPARE(results.at(0).status, TestCaseResult::Passed);
+    QCOMPARE(results.at(1).path,
+             QStringList({"Tests", "Unit tests", "List comparison (same length)"}));
+    QCOMPARE(results.at(1).status, TestCaseResult::Failed);
+    QCOMPARE(results.at(1).message, QString("test/Test.hs:29:\nexpected: LT\nbut got: GT"));
+    QCOMPARE(results.at(2).path, QStringList({"Tests", "Properties", "reverse"}));
+    QCOMPARE(results.at(2).status, TestCaseResult::Passed);
+}
+
+void tst_TestOutputParser::chunks()
+{
+    // results do not depend on how the output is split, and come as soon as they are known
+    const QString output = QString::fromUtf8(tastyOutput);
+    TestOutputParser parser(TestOutputParser::Tasty);
+    QVector<TestCaseResult> results;
+    for (int i = 0; i < output.size(); i += 7)
+        results += parser.addOutput(output.mid(i, 7));
+    results += parser.finish();
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(1).message, QString("test/Test.hs:29:\nexpected: LT\nbut got: GT"));
+
+    TestOutputParser hspecParser(TestOutputParser::Hspec);
+    QVERIFY(hspecParser.addOutput("Data.List\n  sorts a list [").isEmpty());
+    const QVector<TestCaseResult> hspecResults = hspecParser.addOutput(
+        QString::fromUtf8("✔]\r\n"));
+    QCOMPARE(hspecResults.size(), 1);
+    QCOMPARE(hspecResults.at(0).path, QStringList({"Data.List", "sorts a list"}));
+
+    // progress overwritten with a carriage return
+    TestOutputParser progressParser(TestOutputParser::Hspec);
+    const QVector<TestCaseResult> progressResults = progressParser.addOutput(
+        QString::fromUtf8("Data.List\n  sorts a list [ ]\r  sorts a list [✔]\n"));
+    QCOMPARE(progressResults.size(), 1);
+    QCOMPARE(progressResults.at(0).status, TestCaseResult::Passed);
+}
+
+void tst_TestOutputParser::plain()
+{
+    TestOutputParser parser(TestOutputParser::Plain);
+    QVERIFY(parser.addOutput(tastyOutput).isEmpty());
+    QVERIFY(parser.finish().isEmpty());
+    QVERIFY(TestOutputParser::arguments(TestOutputParser::Plain).isEmpty());
+}
+
+void tst_TestOutputParser::filterArguments()
+{
+    const QVector<QStringList> paths{{"Data.List", "sort", "handles empty lists"},
+                                     {"Tests", "say \"hi\""}};
+    QCOMPARE(TestOutputParser::filterArguments(TestOutputParser::Hspec, paths),
+             QStringList({"--match", "/Data.List/sort/handles empty lists/",
+                          "--match", "/Tests/say \"hi\"/"}));
+    QCOMPARE(TestOutputParser::filterArguments(TestOutputParser::Tasty, paths),
+             QStringList({"-p",
+                          "$0 == \"Data.List.sort.handles empty lists\""
+                          " || $0 == \"Tests.say \\\"hi\\\"\""}));
+    QVERIFY(TestOutputParser::filterArguments(TestOutputParser::Plain, paths).isEmpty());
+    QVERIFY(TestOutputParser::filterArguments(TestOutputParser::Tasty, {}).isEmpty());
+}
+
+void tst_TestOutputParser::detectFramework_data()
+{
+    QTest::addColumn<QString>("stanza");
+    QTest::addColumn<int>("framework");
+
+    QTest::newRow("hspec") << "type: exitcode-stdio-1.0\nbuild-depends: base, hspec >= 2.9\n"
+                           << int(TestOutputParser::Hspec);
+    QTest::newRow("tasty") << "build-depends:\n  base\n, tasty\n, tasty-hunit\n"
+                           << int(TestOutputParser::Tasty);
+    QTest::newRow("hspec-discover") << "build-tool-depends: hspec-discover:hspec-discover\n"
+                                    << int(TestOutputParser::Hspec);
+    QTest::newRow("plain") << "build-depends: base, QuickCheck\n"
+                           << int(TestOutputParser::Plain);
+}
+
+void tst_TestOutputParser::detectFramework()
+{
+    QFETCH(QString, stanza);
+    QFETCH(int, framework);
+    QCOMPARE(int(TestOutputParser::detectFramework(stanza)), framework);
+}
+
+QTEST_MAIN(tst_TestOutputParser)
+
+#include "tst_testoutputparser.moc"
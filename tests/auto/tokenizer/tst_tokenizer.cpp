@@ -86,6 +86,12 @@ private slots:
     void op_data();
     void op();
 
+    void delimiters_data();
+    void delimiters();
+
+    void code();
+    void expression();
+
 private:
     void setupData();
     void addRow(const char *name,
@@ -725,6 +731,57 @@ void tst_Tokenizer::op()
     checkData();
 }
 
+void tst_Tokenizer::delimiters_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<int>("startState");
+    QTest::addColumn<QString>("delimiters"); // the character and column of each
+
+    const int inComment = int(Tokens::State::MultiLineCommentGuard) + 1;
+    QTest::newRow("brackets") << "f (x, [y]) {a = 1}" << -1 << "(2 [6 ]8 )9 {11 }17";
+    QTest::newRow("in string") << "g \"(\" ')' [1]" << -1 << "[10 ]12";
+    QTest::newRow("in line comment") << "h -- (x)" << -1 << "";
+    QTest::newRow("comment") << "(x {- (y) -})" << -1 << "(0 {3 }11 )12";
+    QTest::newRow("nested comment") << "{- a {- b -} c" << -1 << "{0 {5 }11";
+    QTest::newRow("comment end") << "c -} (d)" << inComment << "}3 (5 )7";
+    QTest::newRow("comment brace") << "{-} x -}" << -1 << "{0 }7";
+}
+
+void tst_Tokenizer::delimiters()
+{
+    QFETCH(QString, input);
+    QFETCH(int, startState);
+    QFETCH(QString, delimiters);
+    QStringList actual;
+    for (const Delimiter &delimiter : HaskellTokenizer::tokenize(input, startState).delimiters()) {
+        QCOMPARE(delimiter.opening, QString("([{").contains(delimiter.character));
+        actual.append(delimiter.character + QString::number(delimiter.column));
+    }
+    QCOMPARE(actual.join(' '), delimiters);
+}
+
+void tst_Tokenizer::code()
+{
+    const QVector<Token> code = HaskellTokenizer::tokenize("f x = {- y -} [x] -- z", -1).code();
+    QStringList texts;
+    for (const Token &token : code)
+        texts.append(token.text.toString());
+    QCOMPARE(texts, QStringList({"f", "x", "=", "[", "x", "]"}));
+    QVERIFY(code.at(2).isKeyword("="));
+    QVERIFY(!code.at(0).isKeyword("f"));
+    QVERIFY(code.at(3).isSpecial("([{"));
+    QVERIFY(!code.at(3).isSpecial(")]}"));
+    QVERIFY(!code.at(2).isSpecial("="));
+}
+
+void tst_Tokenizer::expression()
+{
+    QStringList expressions;
+    for (const Token &token : HaskellTokenizer::tokenize("Just x <> y :| z = 1", -1).code())
+        expressions.append(token.expression());
+    QCOMPARE(expressions, QStringList({"Just", "x", "(<>)", "y", "(:|)", "z", "", ""}));
+}
+
 QTEST_MAIN(tst_Tokenizer)
 
 #include "tst_tokenizer.moc"